@@ -94,6 +94,14 @@ check_c_source_compiles("
      return 0;
   }" AK_HAVE_FCNTL_H )
 
+if( AK_HAVE_FCNTL_H )
+    check_c_source_compiles("
+      #include <fcntl.h>
+      int main( void ) {
+         return posix_fadvise( 0, 0, 0, POSIX_FADV_SEQUENTIAL );
+      }" AK_HAVE_POSIX_FADVISE )
+endif()
+
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
   #include <limits.h>
@@ -19,6 +19,48 @@ if( AK_HAVE_BUILTIN_MULQ_GCC )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MULQ_GCC" )
 endif()
 
+# -------------------------------------------------------------------------------------------------- #
+# поддержка команд mulx (BMI2) и adcx/adox (ADX) проверяется только при наличии mulq;
+# наличие команд в процессоре определяется во время выполнения
+if( AK_HAVE_BUILTIN_MULQ_GCC )
+  check_c_source_compiles("
+    #include <cpuid.h>
+    int main( void ) {
+      unsigned long long t[2] = { 1, 2 }, u = 3;
+      unsigned int a = 0, b = 0, c = 0, d = 0;
+      __get_cpuid_count( 7, 0, &a, &b, &c, &d );
+      __asm__ volatile ( \"movq %1, %%rdx; \"
+                         \"xorl %%r10d, %%r10d; \"
+                         \"mulxq 8*(0+1)(%0), %%r8, %%r9; \"
+                         \"adoxq %%r10, %%r8; \"
+                         \"adcxq 8*0(%0), %%r8; \"
+                         \"movq %%r8, 8*0(%0); \"
+                         : : \"r\" (t), \"rm\" (u) : \"rdx\", \"r8\", \"r9\", \"r10\", \"cc\", \"memory\" );
+      return ( int )( t[0] + b );
+    }" AK_HAVE_BUILTIN_MULX_ADX )
+
+  if( AK_HAVE_BUILTIN_MULX_ADX )
+      set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MULX_ADX" )
+  endif()
+endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <emmintrin.h>
+  int main( void ) {
+
+   long long x[2] = { 1, 2 };
+   __m128i a = _mm_loadu_si128(( const __m128i *) x );
+   __m128i b = _mm_xor_si128( a, _mm_unpackhi_epi64( a, a ));
+
+  return ( int )_mm_cvtsi128_si64( b );
+ }" AK_HAVE_BUILTIN_XOR_SI128 )
+
+if( AK_HAVE_BUILTIN_XOR_SI128 )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_XOR_SI128" )
+endif()
+
 # -------------------------------------------------------------------------------------------------- #
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
@@ -53,3 +95,80 @@ check_c_source_compiles("
 if( AK_HAVE_BUILTIN_MM256_SLL )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MM256_SLL" )
 endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  __attribute__(( target( \"avx512f,avx512bw\" )))
+  static int test( void ) {
+    return __builtin_cpu_supports( \"avx512f\" );
+  }
+  int main( void ) {
+
+   __builtin_cpu_init();
+   if( __builtin_cpu_supports( \"avx2\" )) return test();
+
+  return 0;
+ }" AK_HAVE_BUILTIN_CPU_SUPPORTS )
+
+if( AK_HAVE_BUILTIN_CPU_SUPPORTS )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_CPU_SUPPORTS" )
+endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <immintrin.h>
+  __attribute__(( target( \"avx512f,avx512bw,avx512vbmi,gfni\" )))
+  static void test( const char *table, long long *out ) {
+
+   __m512i x = _mm512_loadu_si512( table ), y = _mm512_loadu_si512( table + 64 );
+   __m512i s = _mm512_mask_blend_epi8( _mm512_movepi8_mask( x ),
+                                       _mm512_permutex2var_epi8( x, y, x ), y );
+   __m512i m = _mm512_gf2p8mul_epi8( _mm512_shuffle_epi8( s, y ), x );
+
+   _mm512_storeu_si512( out, _mm512_ternarylogic_epi64( m, s,
+                       _mm512_gf2p8affine_epi64_epi8( x, _mm512_set1_epi64( 0x0102040810204080LL ), 0 ),
+                                                                                         0x96 ));
+  }
+  int main( void ) {
+
+   char table[128] = { 0 };
+   long long out[8];
+   test( table, out );
+
+  return 0;
+ }" AK_HAVE_BUILTIN_MM512 )
+
+if( AK_HAVE_BUILTIN_MM512 )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MM512" )
+endif()
+
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <immintrin.h>
+  __attribute__(( target( \"avx2\" )))
+  static void test( const char *table, long long *out ) {
+
+   __m256i x = _mm256_loadu_si256(( const __m256i *) table ),
+           y = _mm256_loadu_si256(( const __m256i *)( table + 32 ));
+   __m256i s = _mm256_shuffle_epi8( x, _mm256_adds_epu8( _mm256_xor_si256( x, y ),
+                                                                   _mm256_set1_epi8( 0x70 )));
+   __m256i t = _mm256_unpacklo_epi8( s, _mm256_srli_epi16( y, 4 ));
+
+   _mm256_storeu_si256(( __m256i *) out, _mm256_inserti128_si256( t,
+                                                              _mm256_castsi256_si128( s ), 1 ));
+  }
+  int main( void ) {
+
+   char table[64] = { 0 };
+   long long out[4];
+   test( table, out );
+
+  return 0;
+ }" AK_HAVE_BUILTIN_MM256 )
+
+if( AK_HAVE_BUILTIN_MM256 )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MM256" )
+endif()
@@ -83,9 +83,15 @@ else()
     endif()
 
   else()
-    if( LIBAKRYPT_PTHREAD )
+
+    find_package( Threads )
+    if( CMAKE_USE_PTHREADS_INIT )
+      message("-- Searching pthread - done ")
+      set( LIBAKRYPT_PTHREAD ON )
+      set( LIBAKRYPT_LIBS ${LIBAKRYPT_LIBS} ${CMAKE_THREAD_LIBS_INIT} )
       set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_PTHREAD_H" )
     endif()
+
   endif()
 endif()
 
@@ -0,0 +1,112 @@
+/* Тестовый пример, проверяющий совпадение результатов многопоточной и последовательной
+   реализаций режимов гаммирования CTR и CTR-ACPKM.
+
+   Для каждого алгоритма блочного шифрования и каждого значения опции openssl_compability
+   сравниваются зашифрованные данные, итоговое значение синхропосылки и ресурс ключа.
+
+   test-ctr-parallel.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+ #include <libakrypt-internal.h>
+
+ static ak_uint8 key[32] = {
+     0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+     0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88 };
+
+ static ak_uint8 iv[16] = {
+     0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe };
+
+/* количество потоков, используемых при тестировании */
+ #define threads (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int compare( const char *mode, ak_bckey one, ak_bckey two,
+                                                  ak_uint8 *out1, ak_uint8 *out2, size_t size )
+{
+  int result = ak_true;
+
+  if( memcmp( out1, out2, size )) result = ak_false;
+  if( memcmp( one->ivector, two->ivector, one->bsize )) result = ak_false;
+  if( one->key.resource.value.counter != two->key.resource.value.counter ) result = ak_false;
+
+  printf(" %s (%s, %u bytes): %s\n", one->key.oid->name[0], mode, (unsigned int) size,
+                                                                    result ? "Ok" : "Wrong" );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_cipher( ak_function_bckey_create *create,
+                                             ak_uint8 *in, ak_uint8 *out1, ak_uint8 *out2, size_t size )
+{
+  size_t half = 0, section = 0;
+  int result = ak_true;
+  struct bckey one, two;
+
+  create( &one ); ak_bckey_set_key( &one, key, sizeof( key ));
+  create( &two ); ak_bckey_set_key( &two, key, sizeof( key ));
+
+ /* режим гаммирования: данные обрабатываются за два вызова,
+    второй вызов продолжает использовать внутреннее значение синхропосылки */
+  half = ( size/( 3*one.bsize ))*one.bsize;
+  memset( out1, 0, size ); memset( out2, 1, size );
+  ak_bckey_ctr( &one, in, out1, half, iv, one.bsize >> 1 );
+  ak_bckey_ctr( &one, in+half, out1+half, size-half, NULL, 0 );
+  ak_bckey_ctr_parallel( &two, in, out2, half, iv, two.bsize >> 1, threads );
+  ak_bckey_ctr_parallel( &two, in+half, out2+half, size-half, NULL, 0, threads );
+  if( !compare( "ctr", &one, &two, out1, out2, size )) result = ak_false;
+
+ /* режим ACPKM: используется максимально допустимая длина секции */
+  section = one.bsize*(( one.bsize == 8 ) ? 128 : 512 );
+  ak_bckey_set_key( &one, key, sizeof( key ));
+  ak_bckey_set_key( &two, key, sizeof( key ));
+  memset( out1, 0, size ); memset( out2, 1, size );
+  ak_bckey_ctr_acpkm( &one, in, out1, size, section, iv, one.bsize >> 1 );
+  ak_bckey_ctr_acpkm_parallel( &two, in, out2, size, section, iv, two.bsize >> 1, threads );
+  memset( one.ivector, 0, sizeof( one.ivector ));
+  memset( two.ivector, 0, sizeof( two.ivector ));
+  if( !compare( "acpkm", &one, &two, out1, out2, size )) result = ak_false;
+
+  ak_bckey_destroy( &one );
+  ak_bckey_destroy( &two );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  int oc = 0, result = ak_true;
+  size_t idx = 0, sizes[2], maxsize = 0;
+  ak_uint8 *in = NULL, *out1 = NULL, *out2 = NULL;
+
+ /* объем данных позволяет распределить их между всеми потоками;
+    второе значение не кратно длине блока */
+  sizes[0] = 4*threads*ak_bckey_thread_min_blocks*16;
+  sizes[1] = maxsize = sizes[0] + 13;
+
+  if(( in = malloc( maxsize )) == NULL ) return EXIT_FAILURE;
+  if(( out1 = malloc( maxsize )) == NULL ) { free( in ); return EXIT_FAILURE; }
+  if(( out2 = malloc( maxsize )) == NULL ) { free( in ); free( out1 ); return EXIT_FAILURE; }
+  for( idx = 0; idx < maxsize; idx++ ) in[idx] = ( ak_uint8 )( 31*idx + ( idx >> 8 ));
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+  for( oc = 0; oc < 2; oc++ ) {
+     ak_libakrypt_set_openssl_compability( oc ? ak_true : ak_false );
+     printf("openssl_compability = %d\n", oc );
+     for( idx = 0; idx < 2; idx++ ) {
+        if( !test_cipher( ak_bckey_create_magma, in, out1, out2, sizes[idx] )) result = ak_false;
+        if( !test_cipher( ak_bckey_create_kuznechik, in, out1, out2, sizes[idx] )) result = ak_false;
+     }
+  }
+
+  free( in ); free( out1 ); free( out2 );
+  ak_libakrypt_destroy();
+
+ if( result ) return EXIT_SUCCESS;
+  else return EXIT_FAILURE;
+}
@@ -0,0 +1,169 @@
+/* Тестовый пример, проверяющий совпадение результатов вычисления хеш-кода и имитовставки
+   для файлов (файлы отображаются в память) и для тех же данных, расположенных в оперативной
+   памяти. Дополнительно проверяется отображение файла в память с ненулевым смещением
+   и потоковое чтение больших файлов.
+
+   test-file-mmap.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+ static const char *filename = "test-file-mmap.dat";
+
+/* количество повторений потокового чтения одного файла */
+ #define repeats (64)
+
+ static ak_uint8 key[32] = {
+     0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+     0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88 };
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int create_file( ak_uint8 *data, size_t size )
+{
+  struct file fp;
+
+  if( ak_file_create_to_write( &fp, filename ) != ak_error_ok ) return ak_false;
+  if( size > 0 ) {
+    if( ak_file_write( &fp, data, size ) != ( ssize_t )size ) {
+      ak_file_close( &fp );
+      return ak_false;
+    }
+  }
+  ak_file_close( &fp );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_offset( ak_uint8 *data, size_t size, size_t offset )
+{
+  struct file fp;
+  ak_uint8 *ptr = NULL;
+  int result = ak_true;
+
+  if(( ptr = ak_file_mmap( &fp, filename, readonly, offset )) == NULL ) {
+    printf(" mmap (%u bytes, offset %u): Wrong\n", (unsigned int) size, (unsigned int) offset );
+    return ak_false;
+  }
+  if( memcmp( ptr, data + offset, size - offset )) result = ak_false;
+  if( ak_file_unmap( &fp, ptr ) != ak_error_ok ) result = ak_false;
+
+  printf(" mmap (%u bytes, offset %u): %s\n", (unsigned int) size, (unsigned int) offset,
+                                                                      result ? "Ok" : "Wrong" );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_size( ak_hash hctx, ak_hmac mctx, ak_uint8 *data, size_t size )
+{
+  int result = ak_true;
+  ak_uint8 out1[64], out2[64];
+
+  if( !create_file( data, size )) return ak_false;
+
+  memset( out1, 0, sizeof( out1 )); memset( out2, 1, sizeof( out2 ));
+  ak_hash_ptr( hctx, data, size, out1, sizeof( out1 ));
+  ak_hash_file( hctx, filename, out2, sizeof( out2 ));
+  if( memcmp( out1, out2, ak_hash_get_tag_size( hctx ))) result = ak_false;
+
+  memset( out1, 0, sizeof( out1 )); memset( out2, 1, sizeof( out2 ));
+  ak_hmac_ptr( mctx, data, size, out1, sizeof( out1 ));
+  ak_hmac_file( mctx, filename, out2, sizeof( out2 ));
+  if( memcmp( out1, out2, ak_hmac_get_tag_size( mctx ))) result = ak_false;
+
+  printf(" hash & hmac (%u bytes): %s\n", (unsigned int) size, result ? "Ok" : "Wrong" );
+
+ /* проверяем отображение с ненулевым смещением, в том числе не кратным размеру страницы */
+  if( size > 1 ) {
+    if( !test_offset( data, size, 1 )) result = ak_false;
+    if( !test_offset( data, size, size - 1 )) result = ak_false;
+    if( size > 4097 ) {
+      if( !test_offset( data, size, 4096 )) result = ak_false;
+      if( !test_offset( data, size, 4097 )) result = ak_false;
+    }
+  }
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_reader_once( ak_uint8 *data, size_t size, size_t *bufsize )
+{
+  ssize_t len = 0;
+  size_t total = 0;
+  ak_pointer ptr = NULL;
+  int result = ak_true;
+  struct file_reader reader;
+
+ /* проверяем, что фрагменты в точности повторяют содержимое файла */
+  if( ak_file_reader_open( &reader, filename, 0 ) != ak_error_ok ) return ak_false;
+  *bufsize = reader.size;
+  while(( len = ak_file_reader_next( &reader, &ptr )) > 0 ) {
+    if(( total + len > size ) || memcmp( ptr, data + total, len )) result = ak_false;
+    total += len;
+  }
+  if(( len < 0 ) || ( total != size )) result = ak_false;
+  if( ak_file_reader_next( &reader, &ptr ) != 0 ) result = ak_false;
+  if( ak_file_reader_close( &reader ) != ak_error_ok ) result = ak_false;
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_reader( ak_hash hctx, ak_hmac mctx, ak_uint8 *data, size_t size )
+{
+  size_t idx = 0, bufsize = 0;
+  int result = ak_true;
+
+ /* чтение повторяется многократно, поскольку ошибки синхронизации
+    с потоком опережающего чтения проявляются не при каждом запуске */
+  for( idx = 0; idx < repeats; idx++ )
+     if( !test_reader_once( data, size, &bufsize )) result = ak_false;
+  printf(" reader (%u bytes, %u bytes buffer, %u times): %s\n", (unsigned int) size,
+                     (unsigned int) bufsize, (unsigned int) repeats, result ? "Ok" : "Wrong" );
+ /* сравниваем результаты обработки файла и обработки тех же данных в памяти */
+ return result & test_size( hctx, mctx, data, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  struct hash hctx;
+  struct hmac mctx;
+  int result = ak_true;
+  ak_uint8 *data = NULL;
+  size_t idx = 0, sizes[] = { 0, 1, 63, 4095, 4096, 100003 },
+         large[] = { 2097152, 3145741 }; /* ровно два буффера и три буффера с остатком */
+
+  if(( data = malloc( large[1] )) == NULL ) return EXIT_FAILURE;
+  for( idx = 0; idx < large[1]; idx++ ) data[idx] = ( ak_uint8 )( 17*idx + ( idx >> 9 ));
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) {
+    free( data );
+    return ak_libakrypt_destroy();
+  }
+
+  ak_hash_create_streebog512( &hctx );
+  ak_hmac_create_streebog512( &mctx );
+  ak_hmac_set_key( &mctx, key, sizeof( key ));
+
+  for( idx = 0; idx < sizeof( sizes )/sizeof( size_t ); idx++ )
+     if( !test_size( &hctx, &mctx, data, sizes[idx] )) result = ak_false;
+
+ /* файлы, превышающие размер буффера, считываются фрагментами несколько раз подряд */
+  ak_libakrypt_set_option( "file_reader_buffer_size", ak_file_reader_min_buffer_size );
+  for( idx = 0; idx < sizeof( large )/sizeof( size_t ); idx++ ) {
+     if( !create_file( data, large[idx] )) result = ak_false;
+      else if( !test_reader( &hctx, &mctx, data, large[idx] )) result = ak_false;
+  }
+
+  ak_hash_destroy( &hctx );
+  ak_hmac_destroy( &mctx );
+  remove( filename );
+  free( data );
+  ak_libakrypt_destroy();
+
+ if( result ) return EXIT_SUCCESS;
+  else return EXIT_FAILURE;
+}
@@ -0,0 +1,127 @@
+/* Тестовый пример, проверяющий древовидное хеширование файлов.
+
+   Проверяется совпадение хеш-кодов файла и области памяти, вычисление хеш-кодов листьев
+   по частям, а также проверка отдельных фрагментов файла после его изменения.
+
+   test-hash-tree.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+ static const char *filename = "test-hash-tree.dat";
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int create_file( ak_uint8 *data, size_t size )
+{
+  struct file fp;
+
+  if( ak_file_create_to_write( &fp, filename ) != ak_error_ok ) return ak_false;
+  if( ak_file_write( &fp, data, size ) != ( ssize_t )size ) {
+    ak_file_close( &fp );
+    return ak_false;
+  }
+  ak_file_close( &fp );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_tree( ak_function_create_object *create, ak_uint8 *data, size_t size )
+{
+  struct hash_tree tctx;
+  int result = ak_true;
+  size_t hsize = 0, half = 0;
+  ak_uint64 count = 0, modified = 0;
+  ak_uint8 *leaves = NULL, *parts = NULL, out1[64], out2[64];
+
+  create( &tctx );
+  ak_hash_tree_set_chunk_size( &tctx, 4*ak_hash_tree_min_chunk_size );
+  hsize = ak_hash_tree_get_tag_size( &tctx );
+  count = ak_hash_tree_get_leaves_count( &tctx, size );
+  leaves = malloc( count*hsize );
+  parts = malloc( count*hsize );
+  if(( leaves == NULL ) || ( parts == NULL )) { result = ak_false; goto exit; }
+
+ /* хеш-коды файла и области памяти совпадают */
+  if( !create_file( data, size )) { result = ak_false; goto exit; }
+  memset( out1, 0, sizeof( out1 )); memset( out2, 1, sizeof( out2 ));
+  ak_hash_tree_ptr( &tctx, data, size, out1, sizeof( out1 ));
+  ak_hash_tree_file( &tctx, filename, out2, sizeof( out2 ));
+  if( memcmp( out1, out2, hsize )) result = ak_false;
+  printf(" %s: file (%u bytes): %s\n", tctx.oid->name[0], (unsigned int) size,
+                                                                      result ? "Ok" : "Wrong" );
+
+ /* хеш-коды листьев, вычисленные за один и за два вызова, совпадают */
+  half = ( size_t )( count/2 );
+  ak_hash_tree_leaves_file( &tctx, filename, 0, count, leaves, count*hsize );
+  ak_hash_tree_leaves_file( &tctx, filename, 0, half, parts, half*hsize );
+  ak_hash_tree_leaves_file( &tctx, filename, half, count - half,
+                                                       parts + half*hsize, ( count - half )*hsize );
+  if( memcmp( leaves, parts, count*hsize )) result = ak_false;
+  memset( out2, 1, sizeof( out2 ));
+  ak_hash_tree_root( &tctx, leaves, count, size, out2, sizeof( out2 ));
+  if( memcmp( out1, out2, hsize )) result = ak_false;
+  printf(" %s: leaves (%u leaves): %s\n", tctx.oid->name[0], (unsigned int) count,
+                                                                      result ? "Ok" : "Wrong" );
+
+ /* проверяем неизмененный файл, затем изменяем один октет */
+  if( ak_hash_tree_verify_file( &tctx, filename, leaves, count, out1, 0, size )
+                                                                   != ak_error_ok ) result = ak_false;
+  modified = size/2;
+  data[modified] ^= 0x01;
+  if( !create_file( data, size )) result = ak_false;
+  data[modified] ^= 0x01;
+
+ /* фрагменты, не содержащие измененный октет, проходят проверку */
+  if( ak_hash_tree_verify_file( &tctx, filename, leaves, count, out1, 0,
+                                    modified - modified%tctx.chunk ) != ak_error_ok ) result = ak_false;
+  if( ak_hash_tree_verify_file( &tctx, filename, leaves, count, out1,
+       modified - modified%tctx.chunk + tctx.chunk, 1 ) != ak_error_ok ) result = ak_false;
+ /* фрагмент, содержащий измененный октет, не проходит проверку */
+  if( ak_hash_tree_verify_file( &tctx, filename, leaves, count, out1, modified, 1 )
+                                                          != ak_error_not_equal_data ) result = ak_false;
+ /* измененные хеш-коды листьев не проходят проверку */
+  leaves[0] ^= 0x01;
+  if( ak_hash_tree_verify_file( &tctx, filename, leaves, count, out1, 0, 0 )
+                                                          != ak_error_not_equal_data ) result = ak_false;
+  printf(" %s: verify: %s\n", tctx.oid->name[0], result ? "Ok" : "Wrong" );
+
+  exit:
+  if( leaves ) free( leaves );
+  if( parts ) free( parts );
+  ak_hash_tree_destroy( &tctx );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  size_t idx = 0, size = 11*4*ak_hash_tree_min_chunk_size + 1234;
+  int result = ak_true;
+  ak_uint8 *data = NULL;
+
+  if(( data = malloc( size )) == NULL ) return EXIT_FAILURE;
+  for( idx = 0; idx < size; idx++ ) data[idx] = ( ak_uint8 )( 29*idx + ( idx >> 10 ));
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) {
+    free( data );
+    return ak_libakrypt_destroy();
+  }
+ /* ошибки, возникающие при проверке измененного файла, ожидаемы */
+  ak_log_set_level( ak_log_none );
+
+  if( !test_tree( ( ak_function_create_object *) ak_hash_tree_create_streebog256, data, size ))
+    result = ak_false;
+  if( !test_tree( ( ak_function_create_object *) ak_hash_tree_create_streebog512, data, size ))
+    result = ak_false;
+
+  remove( filename );
+  free( data );
+  ak_libakrypt_destroy();
+
+ if( result ) return EXIT_SUCCESS;
+  else return EXIT_FAILURE;
+}
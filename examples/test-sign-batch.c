@@ -0,0 +1,101 @@
+/* Тестовый пример, проверяющий совместную проверку массива электронных подписей.
+
+   Подписи вырабатываются для сообщений различной длины с использованием двух ключей,
+   определенных на различных эллиптических кривых; часть подписей искажается.
+   Результаты функции ak_verifykey_verify_batch() сравниваются с результатами
+   последовательной проверки каждой подписи.
+
+   test-sign-batch.c
+*/
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* количество проверяемых подписей */
+ #define count (150)
+
+ int main( void )
+{
+  size_t i = 0;
+  struct signkey sk[2];
+  struct verifykey pk[2];
+  struct random generator;
+  int result = EXIT_SUCCESS;
+  ak_uint8 data[count][80], signs[count][128], hashes[count][64];
+  ak_verifykey keys[count];
+  ak_pointer ptrs[count], sptrs[count], hptrs[count];
+  size_t sizes[count], hsizes[count], threads[3] = { 1, 4, 0 }, t = 0;
+  bool_t expected[count], results[count];
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( NULL )) return ak_libakrypt_destroy();
+  if( ak_random_create_lcg( &generator ) != ak_error_ok ) {
+    ak_libakrypt_destroy();
+    return EXIT_FAILURE;
+  }
+
+ /* создаем ключи на 256-ти и 512-ти битных кривых */
+  ak_signkey_create_streebog256( sk );
+  ak_signkey_create_streebog512( sk+1 );
+  for( i = 0; i < 2; i++ ) {
+     ak_signkey_set_key_random( sk+i, &generator );
+     ak_skey_set_resource_values( &sk[i].key, key_using_resource,
+                                  "digital_signature_count_resource", 0, time(NULL)+2592000 );
+     ak_verifykey_create_from_signkey( pk+i, sk+i );
+  }
+
+ /* вырабатываем подписи, искажая часть из них */
+  for( i = 0; i < count; i++ ) {
+     keys[i] = pk + ( i%3 == 0 );
+     sizes[i] = i%sizeof( data[i] );
+     ak_random_ptr( &generator, data[i], sizeof( data[i] ));
+     ptrs[i] = data[i];
+     sptrs[i] = signs[i];
+     ak_signkey_sign_ptr( sk + ( i%3 == 0 ), &generator, data[i], sizes[i],
+                                                                       signs[i], sizeof( signs[i] ));
+     if( i%7 == 3 ) signs[i][i%64] ^= 0x10;
+     if( i%11 == 5 ) data[i][0] ^= 0x01;
+
+     ak_hash_ptr( &keys[i]->ctx, data[i], sizes[i], hashes[i], sizeof( hashes[i] ));
+     hptrs[i] = hashes[i];
+     hsizes[i] = ak_hash_get_tag_size( &keys[i]->ctx );
+     expected[i] = ak_verifykey_verify_ptr( keys[i], data[i], sizes[i], signs[i] );
+     if( expected[i] != ( i%7 != 3 && ( i%11 != 5 || sizes[i] == 0 ))) {
+       printf("sequential verification of signature %u is Wrong\n", (unsigned int)i );
+       result = EXIT_FAILURE;
+     }
+  }
+
+ /* проверяем подписи для сообщений и для хеш-кодов с различным количеством потоков */
+  for( t = 0; t < 3; t++ ) {
+     memset( results, 0xff, sizeof( results ));
+     if( ak_verifykey_verify_batch( keys, ptrs, sizes, sptrs, count,
+                                                ak_false, results, threads[t] ) != ak_error_ok ) {
+       result = EXIT_FAILURE;
+     }
+     if( memcmp( results, expected, sizeof( results ))) {
+       printf("batch verification of messages (%u threads) is Wrong\n", (unsigned int)threads[t] );
+       result = EXIT_FAILURE;
+     }
+     memset( results, 0xff, sizeof( results ));
+     if( ak_verifykey_verify_batch( keys, hptrs, hsizes, sptrs, count,
+                                                 ak_true, results, threads[t] ) != ak_error_ok ) {
+       result = EXIT_FAILURE;
+     }
+     if( memcmp( results, expected, sizeof( results ))) {
+       printf("batch verification of hashes (%u threads) is Wrong\n", (unsigned int)threads[t] );
+       result = EXIT_FAILURE;
+     }
+  }
+  if( result == EXIT_SUCCESS ) printf("batch verification: Ok\n");
+
+  for( i = 0; i < 2; i++ ) {
+     ak_signkey_destroy( sk+i );
+     ak_verifykey_destroy( pk+i );
+  }
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
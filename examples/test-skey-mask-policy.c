@@ -0,0 +1,168 @@
+/* Тестовый пример, проверяющий политики проверки контрольной суммы и смены маски
+   секретного ключа.
+
+   Для каждого алгоритма блочного шифрования и каждой политики проверяется, что
+   зашифрованные данные совпадают с результатом, полученным при политике по умолчанию,
+   что маска ключа сменяется только при выполнении условия политики и что искажение
+   ключа обнаруживается не позднее, чем через заданное политикой количество вызовов
+   (или по истечении заданного интервала времени).
+
+   test-skey-mask-policy.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <time.h>
+ #include <libakrypt.h>
+
+ static ak_uint8 key[32] = {
+     0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+     0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88 };
+
+ static ak_uint8 iv[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xab, 0xce, 0xf0 };
+
+/* количество обрабатываемых пакетов и их длина */
+ #define packets (12)
+ #define packet_size (64)
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_policy( ak_function_bckey_create *create, mask_policy_t type,
+                                                      ak_uint64 value, size_t period, ak_uint8 *in )
+{
+  size_t i = 0;
+  int result = ak_true;
+  struct bckey one, two;
+  ak_uint8 out1[packet_size], out2[packet_size], mask[64];
+
+  create( &one ); ak_bckey_set_key( &one, key, sizeof( key ));
+  create( &two ); ak_bckey_set_key( &two, key, sizeof( key ));
+  if( ak_skey_set_mask_policy( &two.key, type, value ) != ak_error_ok ) result = ak_false;
+
+ /* результаты зашифрования совпадают, маска сменяется только раз в period вызовов */
+  for( i = 1; i <= packets; i++ ) {
+     memcpy( mask, two.key.key, two.key.key_size );
+     ak_bckey_ctr( &one, in + i*packet_size, out1, packet_size, iv, one.bsize >> 1 );
+     ak_bckey_ctr( &two, in + i*packet_size, out2, packet_size, iv, two.bsize >> 1 );
+     if( memcmp( out1, out2, packet_size )) result = ak_false;
+     if(( memcmp( mask, two.key.key, two.key.key_size ) != 0 ) != ( i%period == 0 ))
+       result = ak_false;
+  }
+
+ /* искажение ключа обнаруживается не позднее, чем через period вызовов */
+  two.key.key[0] ^= 0x01;
+  for( i = 1; i <= period; i++ )
+     if( ak_bckey_ctr( &two, in, out2, packet_size, iv, two.bsize >> 1 )
+                                                       == ak_error_wrong_key_icode ) break;
+  if( i > period ) result = ak_false;
+
+  printf(" %s (%s, %u): %s\n", two.key.oid->name[0], ak_libakrypt_get_mask_policy_name( type ),
+                                                     (unsigned int) value, result ? "Ok" : "Wrong" );
+  ak_bckey_destroy( &one );
+  ak_bckey_destroy( &two );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* ожидание начала следующей секунды */
+ static time_t next_second( void )
+{
+  time_t now = time( NULL );
+  while( time( NULL ) == now );
+ return time( NULL );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_time_policy( ak_function_bckey_create *create, ak_uint8 *in )
+{
+  size_t i = 0;
+  int result = ak_true;
+  struct bckey one, two;
+  ak_uint8 out1[packet_size], out2[packet_size], mask[64];
+
+  create( &one ); ak_bckey_set_key( &one, key, sizeof( key ));
+  create( &two ); ak_bckey_set_key( &two, key, sizeof( key ));
+
+ /* политика устанавливается в начале секунды, поэтому все вызовы цикла
+    выполняются до истечения интервала и маска не изменяется */
+  next_second();
+  if( ak_skey_set_mask_policy( &two.key, time_interval_mask_policy, 1 ) != ak_error_ok )
+    result = ak_false;
+  memcpy( mask, two.key.key, two.key.key_size );
+  for( i = 1; i <= packets; i++ ) {
+     ak_bckey_ctr( &one, in + i*packet_size, out1, packet_size, iv, one.bsize >> 1 );
+     ak_bckey_ctr( &two, in + i*packet_size, out2, packet_size, iv, two.bsize >> 1 );
+     if( memcmp( out1, out2, packet_size )) result = ak_false;
+  }
+  if( memcmp( mask, two.key.key, two.key.key_size ) != 0 ) result = ak_false;
+
+ /* по истечении интервала маска сменяется */
+  next_second();
+  ak_bckey_ctr( &two, in, out2, packet_size, iv, two.bsize >> 1 );
+  if( memcmp( mask, two.key.key, two.key.key_size ) == 0 ) result = ak_false;
+
+ /* искажение ключа обнаруживается по истечении интервала */
+  two.key.key[0] ^= 0x01;
+  next_second();
+  if( ak_bckey_ctr( &two, in, out2, packet_size, iv, two.bsize >> 1 )
+                                                   != ak_error_wrong_key_icode ) result = ak_false;
+
+  printf(" %s (%s, 1): %s\n", two.key.oid->name[0],
+          ak_libakrypt_get_mask_policy_name( time_interval_mask_policy ), result ? "Ok" : "Wrong" );
+  ak_bckey_destroy( &one );
+  ak_bckey_destroy( &two );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* проверка того, что режим выработки имитовставки сменяет маску в том же вызове,
+   в котором выполнена проверка контрольной суммы */
+ static int test_cmac_policy( ak_function_bckey_create *create, ak_uint8 *in )
+{
+  size_t i = 0;
+  int result = ak_true;
+  struct bckey two;
+  ak_uint8 out[16], mask[64];
+
+  create( &two ); ak_bckey_set_key( &two, key, sizeof( key ));
+  if( ak_skey_set_mask_policy( &two.key, call_count_mask_policy, 2 ) != ak_error_ok )
+    result = ak_false;
+  for( i = 1; i <= 4; i++ ) {
+     memcpy( mask, two.key.key, two.key.key_size );
+     ak_bckey_cmac( &two, in, packet_size, out, two.bsize );
+     if(( memcmp( mask, two.key.key, two.key.key_size ) != 0 ) != ( i%2 == 0 ))
+       result = ak_false;
+     if( two.key.flags&ak_key_flag_mask_due ) result = ak_false;
+  }
+
+  printf(" %s (cmac, %s, 2): %s\n", two.key.oid->name[0],
+              ak_libakrypt_get_mask_policy_name( call_count_mask_policy ), result ? "Ok" : "Wrong" );
+  ak_bckey_destroy( &two );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  size_t i = 0;
+  int result = EXIT_SUCCESS;
+  ak_uint8 in[( packets+1 )*packet_size];
+
+  ak_libakrypt_create( NULL );
+  for( i = 0; i < sizeof( in ); i++ ) in[i] = ( ak_uint8 )( 7*i+1 );
+
+  if( !test_policy( ak_bckey_create_magma, every_call_mask_policy, 0, 1, in ))
+    result = EXIT_FAILURE;
+  if( !test_policy( ak_bckey_create_magma, call_count_mask_policy, 4, 4, in ))
+    result = EXIT_FAILURE;
+  if( !test_policy( ak_bckey_create_kuznechik, call_count_mask_policy, 3, 3, in ))
+    result = EXIT_FAILURE;
+  if( !test_policy( ak_bckey_create_kuznechik, byte_count_mask_policy,
+                                                          5*packet_size, 5, in ))
+    result = EXIT_FAILURE;
+  if( !test_time_policy( ak_bckey_create_magma, in )) result = EXIT_FAILURE;
+  if( !test_cmac_policy( ak_bckey_create_kuznechik, in )) result = EXIT_FAILURE;
+
+  ak_libakrypt_destroy();
+ return result;
+}
@@ -0,0 +1,81 @@
+/* Тестовый пример, проверяющий выработку случайных данных из запаса масок секретного ключа.
+
+   Генератор ключа и эталонный генератор инициализируются одним и тем же значением,
+   после чего проверяется, что фрагменты, выдаваемые функцией ak_skey_get_random_from_pool(),
+   совпадают с выходом эталонного генератора, который заполняет запас по мере его
+   исчерпания; фрагменты, превышающие размер запаса, вырабатываются генератором напрямую
+   и не изменяют запас.
+
+   test-skey-mask-pool.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+ #include <libakrypt-internal.h>
+
+ static ak_uint8 seed[4] = { 0x01, 0x23, 0x45, 0x67 };
+
+/* ----------------------------------------------------------------------------------------------- */
+/* эталонная модель запаса: копия буфера и смещение в нем */
+ static ak_uint8 pool[ak_key_mask_pool_size];
+ static size_t offset = ak_key_mask_pool_size;
+
+/* ----------------------------------------------------------------------------------------------- */
+/* получение фрагмента из запаса ключа и сравнение его с эталонным значением */
+ static int test_request( ak_skey skey, ak_random reference, size_t size )
+{
+  int result = ak_true;
+  ak_uint8 out[2*ak_key_mask_pool_size], expected[2*ak_key_mask_pool_size];
+  const char *type = "pool";
+
+  if( size > ak_key_mask_pool_size ) {
+    ak_random_ptr( reference, expected, ( ssize_t )size );
+    type = "direct";
+  } else {
+      if( size > ak_key_mask_pool_size - offset ) {
+        ak_random_ptr( reference, pool, ak_key_mask_pool_size );
+        offset = 0;
+        type = "refill";
+      }
+      memcpy( expected, pool + offset, size );
+      offset += size;
+    }
+
+  memset( out, 0, sizeof( out ));
+  if( ak_skey_get_random_from_pool( skey, out, size ) != ak_error_ok ) result = ak_false;
+  if( memcmp( out, expected, size )) result = ak_false;
+  if( skey->pool.offset != offset ) result = ak_false;
+
+  printf(" %3u bytes (%s, offset %3u): %s\n", (unsigned int) size, type,
+                                       (unsigned int) skey->pool.offset, result ? "Ok" : "Wrong" );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  size_t i = 0;
+  struct skey skey;
+  struct random reference;
+  int result = EXIT_SUCCESS;
+ /* последовательность запросов: заполнение запаса, точное исчерпание, пересечение
+    границы запаса, запросы, превышающие его размер, и запрос всего запаса */
+  size_t sizes[] = { 32, 200, 280, 1, 100, 300, 600, 64, 100, 512, 513, 8 };
+
+  ak_libakrypt_create( NULL );
+  ak_skey_create( &skey, 32 );
+  ak_random_create_lcg( &reference );
+  ak_random_randomize( &skey.generator, seed, sizeof( seed ));
+  ak_random_randomize( &reference, seed, sizeof( seed ));
+  skey.pool.offset = ak_key_mask_pool_size;
+
+  for( i = 0; i < sizeof( sizes )/sizeof( size_t ); i++ )
+     if( !test_request( &skey, &reference, sizes[i] )) result = EXIT_FAILURE;
+
+  ak_random_destroy( &reference );
+  ak_skey_destroy( &skey );
+  ak_libakrypt_destroy();
+ return result;
+}
@@ -0,0 +1,279 @@
+/* Тестовый пример, проверяющий совпадение результатов вычисления кратных точек
+   эллиптических кривых различными способами.
+
+   Для всех эллиптических кривых, известных библиотеке, результат вычисления кратной
+   образующей точки с помощью лесенки Монтгомери сравнивается с результатом последовательных
+   удвоений и сложений в проективных координатах. Результат вычисления кратной
+   образующей точки с использованием предварительно вычисленной таблицы, а также
+   результат вычисления суммы кратных точек [u]P + [v]Q сравниваются
+   с результатами, полученными с помощью лесенки Монтгомери. Кроме того, проверяется
+   совместное приведение точек к аффинной форме. Предварительно для модулей p и q каждой кривой
+   проверяются алгебраические свойства умножения Монтгомери, реализация которого
+   выбирается библиотекой в зависимости от возможностей процессора, а для кривых со
+   специализированной арифметикой по модулю p она сравнивается с арифметикой Монтгомери.
+
+   test-wcurve-pow.c
+*/
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* количество случайных значений степени кратности для каждой кривой */
+ #define iterations (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int compare( ak_wpoint wp1, ak_wpoint wp2, ak_wcurve wc )
+{
+  ak_wpoint_reduce( wp1, wc );
+  ak_wpoint_reduce( wp2, wc );
+  if( ak_mpzn_cmp( wp1->x, wp2->x, wc->size )) return ak_false;
+  if( ak_mpzn_cmp( wp1->y, wp2->y, wc->size )) return ak_false;
+  if( ak_mpzn_cmp( wp1->z, wp2->z, wc->size )) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* вычисление кратной точки методом "удвоение-сложение" в проективных координатах */
+ static void reference_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, ak_wcurve wc )
+{
+  long long int i = 0;
+
+  ak_wpoint_set_as_unit( wq, wc );
+  for( i = 64*wc->size - 1; i >= 0; i-- ) {
+     ak_wpoint_double( wq, wc );
+     if(( k[i >> 6] >> ( i&0x3f ))&1 ) ak_wpoint_add( wq, wp, wc );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* проверка умножения Монтгомери по модулю m: перевод в представление Монтгомери и обратно,
+   коммутативность и дистрибутивность, в том числе для граничных значений 0, 1, m-1;
+   проверка возведения в квадрат, в степень и обращения */
+ static int test_montgomery( ak_uint64 *m, ak_uint64 *r2, ak_uint64 n0, const size_t size,
+                                                                              ak_random generator )
+{
+  size_t i = 0;
+  ak_mpzn512 x, y, u, s, t, w, one = ak_mpzn512_one;
+
+  for( i = 0; i < 4*iterations; i++ ) {
+     switch( i ) {
+       case 0: ak_mpzn_set_ui( x, size, 0 ); ak_mpzn_sub( y, m, one, size ); break;
+       case 1: ak_mpzn_set_ui( x, size, 1 ); ak_mpzn_sub( y, m, one, size ); break;
+       case 2: ak_mpzn_sub( x, m, one, size ); ak_mpzn_sub( y, m, one, size ); break;
+       default: ak_mpzn_set_random_modulo( x, m, size, generator );
+                ak_mpzn_set_random_modulo( y, m, size, generator );
+     }
+     ak_mpzn_set_random_modulo( u, m, size, generator );
+
+    /* x -> xR -> x */
+     ak_mpzn_mul_montgomery( t, x, r2, m, n0, size );
+     ak_mpzn_mul_montgomery( t, t, one, m, n0, size );
+     if( ak_mpzn_cmp( t, x, size )) return ak_false;
+
+    /* xy = yx */
+     ak_mpzn_mul_montgomery( t, x, y, m, n0, size );
+     ak_mpzn_mul_montgomery( w, y, x, m, n0, size );
+     if( ak_mpzn_cmp( t, w, size )) return ak_false;
+     if( ak_mpzn_cmp( t, m, size ) >= 0 ) return ak_false;
+
+    /* x(y+u) = xy + xu */
+     ak_mpzn_add_montgomery( s, y, u, m, size );
+     ak_mpzn_mul_montgomery( w, x, s, m, n0, size );
+     ak_mpzn_mul_montgomery( s, x, u, m, n0, size );
+     ak_mpzn_add_montgomery( t, t, s, m, size );
+     if( ak_mpzn_cmp( t, w, size )) return ak_false;
+
+    /* x^2 = xx */
+     ak_mpzn_sqr_montgomery( t, x, m, n0, size );
+     ak_mpzn_mul_montgomery( w, x, x, m, n0, size );
+     if( ak_mpzn_cmp( t, w, size )) return ak_false;
+
+    /* x^{u+1} = x^ux, в том числе для u = 0 */
+     if( i == 0 ) ak_mpzn_set_ui( u, size, 0 );
+     ak_mpzn_modpow_montgomery( t, x, u, m, n0, size );
+     ak_mpzn_mul_montgomery( t, t, x, m, n0, size );
+     ak_mpzn_add( s, u, one, size );
+     ak_mpzn_modpow_montgomery( w, x, s, m, n0, size );
+     if( ak_mpzn_cmp( t, w, size )) return ak_false;
+
+    /* x^{-1} = x^{m-2}, для x = 0 оба значения равны нулю */
+     ak_mpzn_set_ui( s, size, 2 );
+     ak_mpzn_sub( s, m, s, size );
+     ak_mpzn_modpow_montgomery( w, x, s, m, n0, size );
+     ak_mpzn_inverse_montgomery( t, x, m, r2, size );
+     if( ak_mpzn_cmp( t, w, size )) return ak_false;
+
+    /* обычный обратный вычет: x x^{-1} = 1 */
+     ak_mpzn_inverse_montgomery( t, x, m, NULL, size );
+     ak_mpzn_mul_montgomery( t, t, x, m, n0, size );
+     ak_mpzn_mul_montgomery( t, t, r2, m, n0, size );
+     if( !ak_mpzn_cmp_ui( t, size, i == 0 ? 0 : 1 )) return ak_false;
+  }
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* проверка специализированной арифметики кривой: результаты сравниваются с результатами
+   вычислений в арифметике Монтгомери, для которой mont( mont( x, y ), r2 ) = xy (mod p) */
+ static int test_field( ak_wcurve wc, ak_random generator )
+{
+  size_t i = 0;
+  const struct wfield *fd = wc->field;
+  ak_mpzn512 x, y, t, w, one = ak_mpzn512_one;
+
+  for( i = 0; i < 4*iterations; i++ ) {
+     switch( i ) {
+       case 0: ak_mpzn_set_ui( x, wc->size, 0 ); ak_mpzn_sub( y, wc->p, one, wc->size ); break;
+       case 1: ak_mpzn_set_ui( x, wc->size, 1 ); ak_mpzn_sub( y, wc->p, one, wc->size ); break;
+       case 2: ak_mpzn_sub( x, wc->p, one, wc->size ); ak_mpzn_sub( y, wc->p, one, wc->size ); break;
+       default: ak_mpzn_set_random_modulo( x, wc->p, wc->size, generator );
+                ak_mpzn_set_random_modulo( y, wc->p, wc->size, generator );
+     }
+     ak_mpzn_mul_montgomery( w, x, y, wc->p, wc->n, wc->size );
+     ak_mpzn_mul_montgomery( w, w, wc->r2, wc->p, wc->n, wc->size );
+     fd->mul( t, x, y, wc->p, wc->size );
+     if( ak_mpzn_cmp( t, w, wc->size )) return ak_false;
+
+     ak_mpzn_mul_montgomery( w, x, x, wc->p, wc->n, wc->size );
+     ak_mpzn_mul_montgomery( w, w, wc->r2, wc->p, wc->n, wc->size );
+     fd->sqr( t, x, wc->p, wc->size );
+     if( ak_mpzn_cmp( t, w, wc->size )) return ak_false;
+
+     ak_mpzn_add_montgomery( w, x, y, wc->p, wc->size );
+     fd->add( t, x, y, wc->p, wc->size );
+     if( ak_mpzn_cmp( t, w, wc->size )) return ak_false;
+
+     ak_mpzn_sub_montgomery( w, x, y, wc->p, wc->size );
+     fd->sub( t, x, y, wc->p, wc->size );
+     if( ak_mpzn_cmp( t, w, wc->size )) return ak_false;
+
+     if( ak_mpzn_cmp_ui( x, wc->size, 0 )) continue;
+     fd->inverse( t, x, wc->p, wc->size );
+     fd->mul( t, t, x, wc->p, wc->size );
+     if( !ak_mpzn_cmp_ui( t, wc->size, 1 )) return ak_false;
+  }
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int test_curve( ak_oid oid, ak_random generator )
+{
+  size_t i = 0;
+  int result = ak_true;
+  ak_mpzn512 k, v, one = ak_mpzn512_one;
+  struct wpoint wp1, wp2, wq, wt, pts[ iterations + 5 ], red[ iterations + 5 ];
+  ak_wcurve wc = ( ak_wcurve ) oid->data;
+
+  if( !test_montgomery( wc->p, wc->r2, wc->n, wc->size, generator )) {
+    printf(" %s: montgomery multiplication modulo p is Wrong\n", oid->name[0] );
+    result = ak_false;
+  }
+  if( !test_montgomery( wc->q, wc->r2q, wc->nq, wc->size, generator )) {
+    printf(" %s: montgomery multiplication modulo q is Wrong\n", oid->name[0] );
+    result = ak_false;
+  }
+
+  if(( wc->field != NULL ) && !test_field( wc, generator )) {
+    printf(" %s: %s arithmetic is Wrong\n", oid->name[0], wc->field->name );
+    result = ak_false;
+  }
+
+  for( i = 0; i < iterations + 4; i++ ) {
+    /* граничные значения: 1, 2, q-1, q-2, затем случайные вычеты */
+     switch( i ) {
+       case 0: ak_mpzn_set_ui( k, wc->size, 1 ); break;
+       case 1: ak_mpzn_set_ui( k, wc->size, 2 ); break;
+       case 2: ak_mpzn_sub( k, wc->q, one, wc->size ); break;
+       case 3: ak_mpzn_sub( k, wc->q, one, wc->size ); ak_mpzn_sub( k, k, one, wc->size ); break;
+       default: ak_mpzn_set_random_modulo( k, wc->q, wc->size, generator );
+     }
+     reference_pow( &wp1, &wc->point, k, wc );
+     ak_wpoint_set_wpoint( pts+i, &wp1, wc );
+     ak_wpoint_pow( &wp2, &wc->point, k, wc->size, wc );
+     if( !compare( &wp1, &wp2, wc )) {
+       printf(" %s: variable base multiplication for k = %s is Wrong\n",
+                                                 oid->name[0], ak_mpzn_to_hexstr( k, wc->size ));
+       result = ak_false;
+     }
+
+     ak_wpoint_pow( &wp1, &wc->point, k, wc->size, wc );
+     ak_wpoint_pow_fixed_base( &wp2, k, wc->size, wc );
+     if( !compare( &wp1, &wp2, wc )) {
+       printf(" %s: fixed base multiplication for k = %s is Wrong\n",
+                                                 oid->name[0], ak_mpzn_to_hexstr( k, wc->size ));
+       result = ak_false;
+     }
+
+    /* сумма кратных точек [k]P + [v]Q, где Q = [k+1]P; в том числе для v = 0 и v = q-1 */
+     ak_mpzn_add( v, k, one, wc->size );
+     ak_wpoint_pow( &wq, &wc->point, v, wc->size, wc );
+     ak_wpoint_reduce( &wq, wc );
+     switch( i ) {
+       case 0: ak_mpzn_set_ui( v, wc->size, 0 ); break;
+       case 1: ak_mpzn_sub( v, wc->q, one, wc->size ); break;
+       default: ak_mpzn_set_random_modulo( v, wc->q, wc->size, generator );
+     }
+     ak_wpoint_pow( &wp1, &wc->point, k, wc->size, wc );
+     ak_wpoint_pow( &wt, &wq, v, wc->size, wc );
+     ak_wpoint_add( &wp1, &wt, wc );
+     ak_wpoint_pow_sum( &wp2, k, &wq, v, wc->size, wc );
+     if( !compare( &wp1, &wp2, wc )) {
+       printf(" %s: sum of multiples for u = %s", oid->name[0], ak_mpzn_to_hexstr( k, wc->size ));
+       printf(" and v = %s is Wrong\n", ak_mpzn_to_hexstr( v, wc->size ));
+       result = ak_false;
+     }
+  }
+
+ /* нулевая степень кратности и кратные бесконечно удаленной точки дают бесконечно удаленную точку */
+  ak_mpzn_set_ui( k, wc->size, 0 );
+  ak_wpoint_pow( &wp1, &wc->point, k, wc->size, wc );
+  ak_wpoint_pow_fixed_base( &wp2, k, wc->size, wc );
+  ak_wpoint_set_as_unit( &wt, wc );
+  ak_wpoint_pow( &wq, &wt, v, wc->size, wc );
+  if( !ak_mpzn_cmp_ui( wp1.z, wc->size, 0 ) || !ak_mpzn_cmp_ui( wp2.z, wc->size, 0 ) ||
+      !ak_mpzn_cmp_ui( wq.z, wc->size, 0 )) {
+    printf(" %s: multiplication giving the point at infinity is Wrong\n", oid->name[0] );
+    result = ak_false;
+  }
+
+ /* совместное приведение точек к аффинной форме, в том числе бесконечно удаленной точки */
+  ak_wpoint_set_as_unit( pts+i, wc );
+  memcpy( red, pts, sizeof( red ));
+  ak_wpoint_reduce_batch( red, iterations + 5, wc );
+  for( i = 0; i < iterations + 5; i++ ) {
+     ak_wpoint_reduce( pts+i, wc );
+     if( memcmp( pts+i, red+i, sizeof( struct wpoint ))) {
+       printf(" %s: batch reduction of point %u is Wrong\n", oid->name[0], (unsigned int)i );
+       result = ak_false;
+     }
+  }
+  printf(" %s: %s\n", oid->name[0], result ? "Ok" : "Wrong" );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  ak_oid oid = NULL;
+  struct random generator;
+  int result = ak_true;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  ak_random_create_lcg( &generator );
+
+  oid = ak_oid_find_by_engine( identifier );
+  while( oid != NULL ) {
+    if( oid->mode == wcurve_params )
+      if( !test_curve( oid, &generator )) result = ak_false;
+    oid = ak_oid_findnext_by_engine( oid, identifier );
+  }
+
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+
+ if( result ) return EXIT_SUCCESS;
+  else return EXIT_FAILURE;
+}
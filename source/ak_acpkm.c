@@ -6,6 +6,9 @@
 /*  - содержит реализацию криптографических алгоритмов семейства ACPKM из Р 1323565.1.017—2018     */
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \details Функция вычисляет новое значение секретного ключа в соответствии с соотношениями
@@ -46,12 +49,12 @@
          bkey->encrypt( &bkey->key, acpkm +8, new_key +8 );
          bkey->encrypt( &bkey->key, acpkm +16, new_key +16 );
          bkey->encrypt( &bkey->key, acpkm +24, new_key +24 );
-         counter = ak_libakrypt_get_option_by_name( "acpkm_section_magma_block_count" );
+         counter = ak_libakrypt_get_option( acpkm_section_magma_block_count_option );
          break;
       case 16: /* шифр с длиной блока 128 бит */
          bkey->encrypt( &bkey->key, acpkm, new_key );
          bkey->encrypt( &bkey->key, acpkm +16, new_key +16 );
-         counter = ak_libakrypt_get_option_by_name( "acpkm_section_kuznechik_block_count" );
+         counter = ak_libakrypt_get_option( acpkm_section_kuznechik_block_count_option );
          break;
       default: return ak_error_message( ak_error_wrong_block_cipher,
                                            __func__ , "incorrect block size of block cipher key" );
@@ -69,80 +72,206 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-#ifdef AK_LITTLE_ENDIAN
-  #define acpkm_block64 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
-              ctr[0] += 1;\
-              ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
-              outptr++; inptr++;\
-           }
-
-  #define acpkm_block128 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
-              if(( ctr[0] += 1 ) == 0 ) ctr[1]++;\
-              ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
-              ((ak_uint64 *) outptr)[1] = yaout[1] ^ ((ak_uint64 *) inptr)[1];\
-              outptr += 2; inptr += 2;\
-           }
-
-#else
-  #define acpkm_block64 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
-              ctr[0] = bswap_64( ctr[0] ); ctr[0] += 1; ctr[0] = bswap_64( ctr[0] );\
-              ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
-              outptr++; inptr++;\
-           }
-
-  #define acpkm_block128 {\
-              nkey.encrypt( &nkey.key, ctr, yaout );\
-              ctr[0] = bswap_64( ctr[0] ); ctr[0] += 1; ctr[0] = bswap_64( ctr[0] );\
-              if( ctr[0] == 0 ) { \
-                ctr[1] = bswap_64( ctr[0] ); ctr[1] += 1; ctr[1] = bswap_64( ctr[0] );\
-              }\
-              ((ak_uint64 *) outptr)[0] = yaout[0] ^ ((ak_uint64 *) inptr)[0];\
-              ((ak_uint64 *) outptr)[1] = yaout[1] ^ ((ak_uint64 *) inptr)[1];\
-              outptr += 2; inptr += 2;\
-           }
-#endif
+/*! \brief Функция гаммирует заданное количество блоков данных.
 
+    Последовательные значения счетчика вырабатываются группами, после чего каждая группа
+    зашифровывается за один вызов функции bckey.encrypt_blocks. Указатели на входные и выходные
+    данные, а также значение счетчика, сдвигаются на количество обработанных блоков.           */
 /* ----------------------------------------------------------------------------------------------- */
-/*! В режиме `ACPKM` для шифрования используется операция гаммирования - операция сложения
-    открытого (зашифровываемого) текста с гаммой, вырабатываемой шифром, по модулю два.
-    Поэтому, для зашифрования и расшифрования информациии используется одна и та же функция.
+ static void ak_bckey_ctr_acpkm_blocks( ak_bckey nkey, ak_uint64 *ctr,
+                                      ak_uint64 **inptr, ak_uint64 **outptr, ssize_t blocks )
+{
+  ssize_t idx = 0, cnt = 0, words = ( ssize_t )( nkey->bsize >> 3 );
+  ak_uint64 ctrs[2*ak_bckey_gamma_blocks], gamma[2*ak_bckey_gamma_blocks];
+
+  while( blocks > 0 ) {
+    cnt = ak_min( blocks, ak_bckey_gamma_blocks );
+    for( idx = 0; idx < cnt; idx++ ) {
+       if( words == 1 ) {
+         ctrs[idx] = ctr[0];
+        #ifdef AK_LITTLE_ENDIAN
+         ctr[0] += 1;
+        #else
+         ctr[0] = bswap_64( bswap_64( ctr[0] ) + 1 );
+        #endif
+       } else {
+           ctrs[2*idx] = ctr[0];
+           ctrs[2*idx+1] = ctr[1];
+          #ifdef AK_LITTLE_ENDIAN
+           if(( ctr[0] += 1 ) == 0 ) ctr[1]++;
+          #else
+           ctr[0] = bswap_64( bswap_64( ctr[0] ) + 1 );
+           if( ctr[0] == 0 ) ctr[1] = bswap_64( bswap_64( ctr[1] ) + 1 );
+          #endif
+         }
+    }
+    nkey->encrypt_blocks( &nkey->key, ctrs, gamma, ( size_t )cnt );
+    for( idx = 0; idx < cnt*words; idx++ ) (*outptr)[idx] = gamma[idx] ^ (*inptr)[idx];
+    (*outptr) += cnt*words; (*inptr) += cnt*words;
+    blocks -= cnt;
+  }
+}
 
-    В процессе шифрования исходные данные разбиваются на секции фиксированной длины, после чего
-    каждая секция шифруется на своем ключе. Длина секции является параметром алгоритма и
-    не должна превосходить величины, определяемой одной из следующих технических характеристик
-    (опций)
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция увеличивает значение счетчика режима `ACPKM` на заданную величину. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_bckey_ctr_acpkm_seek( ak_bckey nkey, ak_uint64 *ctr, ak_uint64 count )
+{
+ #ifdef AK_LITTLE_ENDIAN
+  ak_uint64 low = ctr[0] + count;
+  if(( nkey->bsize == 16 ) && ( low < ctr[0] )) ctr[1]++;
+  ctr[0] = low;
+ #else
+  ak_uint64 low = bswap_64( ctr[0] ) + count;
+  if(( nkey->bsize == 16 ) && ( low < bswap_64( ctr[0] ))) ctr[1] = bswap_64( bswap_64( ctr[1] ) + 1 );
+  ctr[0] = bswap_64( low );
+ #endif
+}
 
-     - `ackpm_section_magma_block_count`,
-     - `ackpm_section_kuznechik_block_count`.
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает заданное количество последовательных секций.
 
-    Значение синхропосылки `iv` копируется во временную область памяти и, в ходе выполнения
-    функции, не изменяется. Повторный вызов функции ak_bckey_ctr_acpkm() с нулевым
-    указатетем на синхропосылу, как в случае функции ak_bckey_ctr(), не допускается.
+    Каждая секция гаммируется на своем ключе, после чего ключ `nkey` заменяется ключом
+    следующей секции. Если указатель `inptr` равен NULL, данные не обрабатываются: сдвигается
+    только значение счетчика, а ключи секций вычисляются так же, как и при шифровании.
 
-    @param bkey Контекст ключа алгоритма блочного шифрования,
-    используемый для шифрования и порождения цепочки производных ключей.
-    @param in Указатель на область памяти, где хранятся входные
-    (зашифровываемые/расшифровываемые) данные
-    @param out Указатель на область памяти, куда помещаются выходные
-    (расшифровываемые/зашифровываемые) данные; этот указатель может совпадать с in
-    @param size Размер зашировываемых данных (в байтах). Длина зашифровываемых данных может
-    принимать любое значение, не превосходящее \f$ 2^{\frac{8n}{2}-1}\f$, где \f$ n \f$
-    длина блока алгоритма шифрования (8 или 16 байт).
+    @param next Флаг вычисления ключа, следующего за ключом последней секции.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_ctr_acpkm_run( ak_bckey nkey, ak_uint64 *ctr, ak_uint64 **inptr,
+                    ak_uint64 **outptr, ssize_t sections, ssize_t seclen, const bool_t next )
+{
+  ssize_t idx = 0;
+  int error = ak_error_ok;
 
-    @param section_size Размер одной секции в байтах. Данная величина должна быть кратна длине блока
-    используемого алгоритма шифрования.
+  for( idx = 0; idx < sections; idx++ ) {
+     if( inptr != NULL ) ak_bckey_ctr_acpkm_blocks( nkey, ctr, inptr, outptr, seclen );
+       else ak_bckey_ctr_acpkm_seek( nkey, ctr, ( ak_uint64 )seclen );
+     if(( idx < sections - 1 ) || next )
+       if(( error = ak_bckey_next_acpkm_key( nkey )) != ak_error_ok ) break;
+  }
+ return error;
+}
 
-    @param iv имитовставка
-    @param iv_size длина имитовставки (в байтах)
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Контекст потока, выполняющего шифрование последовательности секций. */
+ typedef struct bckey_acpkm_thread {
+  /*! \brief Ключ, используемый для шифрования первой секции. */
+   struct bckey key;
+  /*! \brief Значение счетчика для первого блока первой секции. */
+   ak_uint64 ctr[2];
+  /*! \brief Указатель на входные данные. */
+   ak_uint64 *in;
+  /*! \brief Указатель на выходные данные. */
+   ak_uint64 *out;
+  /*! \brief Количество обрабатываемых секций. */
+   ssize_t sections;
+  /*! \brief Количество блоков в одной секции. */
+   ssize_t seclen;
+  /*! \brief Код ошибки, возникшей в ходе выполнения потока. */
+   int error;
+  /*! \brief Флаг успешного запуска потока. */
+   bool_t started;
+  /*! \brief Идентификатор потока. */
+   pthread_t thread;
+ } *ak_bckey_acpkm_thread;
 
-    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
-    возвращается \ref ak_error_ok (ноль)                                                           */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_bckey_ctr_acpkm( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
-                                                 size_t section_size, ak_pointer iv, size_t iv_size)
+/*! \brief Функция, выполняемая отдельным потоком. */
+ static void *ak_bckey_acpkm_thread_run( void *ptr )
+{
+  ak_bckey_acpkm_thread th = ( ak_bckey_acpkm_thread ) ptr;
+  th->error = ak_bckey_ctr_acpkm_run( &th->key, th->ctr,
+                                               &th->in, &th->out, th->sections, th->seclen, ak_false );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция шифрования последовательности секций с использованием нескольких потоков.
+
+    Секции распределяются между потоками непрерывными фрагментами. Вызывающий поток
+    последовательно вычисляет производные ключи: как только получен ключ первой секции
+    очередного фрагмента, его копия передается новому потоку, который далее самостоятельно
+    вычисляет ключи для остальных секций своего фрагмента. После завершения функции
+    ключ `nkey`, значение счетчика и указатели на данные соответствуют состоянию после
+    последовательной обработки всех секций.
+
+    Если объем данных слишком мал для распределения между потоками, функция не выполняет
+    никаких действий и не изменяет значение `sections`; в противном случае, после
+    обработки, `sections` принимает нулевое значение.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_ctr_acpkm_sections( ak_bckey nkey, ak_uint64 *ctr, ak_uint64 **inptr,
+                       ak_uint64 **outptr, ssize_t *sections, ssize_t seclen, size_t threads )
+{
+  size_t idx = 0, jdx = 0, count = 0;
+  int error = ak_error_ok;
+  ssize_t chunk = 0, offset = 0, words = ( ssize_t )( nkey->bsize >> 3 );
+  ak_bckey_acpkm_thread ths = NULL;
+
+ /* определяем количество фрагментов */
+  count = ak_min( threads, ( size_t ) *sections );
+  count = ak_min( count, ( size_t )(( *sections*seclen )/ak_bckey_thread_min_blocks ));
+  if( count < 2 ) return ak_error_ok;
+  chunk = *sections/( ssize_t )count;
+
+  if(( ths = ak_object_aligned_malloc( count*sizeof( struct bckey_acpkm_thread ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  memset( ths, 0, count*sizeof( struct bckey_acpkm_thread ));
+
+  for( idx = 0; idx < count; idx++ ) {
+    /* формируем задание для очередного потока */
+     if(( error = ak_bckey_create_copy( &ths[idx].key, nkey )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect duplication of block cipher key" );
+       break;
+     }
+     ths[idx].ctr[0] = ctr[0]; ths[idx].ctr[1] = ctr[1];
+     ths[idx].in = *inptr + offset*seclen*words;
+     ths[idx].out = *outptr + offset*seclen*words;
+     ths[idx].sections = chunk + (( idx == 0 ) ? *sections%( ssize_t )count : 0 );
+     ths[idx].seclen = seclen;
+     ths[idx].started = ( pthread_create( &ths[idx].thread, NULL,
+                                ak_bckey_acpkm_thread_run, ths+idx ) == 0 ) ? ak_true : ak_false;
+     if( !ths[idx].started ) ak_bckey_acpkm_thread_run( ths+idx );
+
+    /* вычисляем ключ и счетчик для первой секции следующего фрагмента */
+     if(( error = ak_bckey_ctr_acpkm_run( nkey, ctr, NULL, NULL,
+                                         ths[idx].sections, seclen, ak_true )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect key generation" );
+       idx++;
+       break;
+     }
+     offset += ths[idx].sections;
+  }
+
+ /* дожидаемся завершения потоков */
+  for( jdx = 0; jdx < ak_min( idx, count ); jdx++ ) {
+     if( ths[jdx].started ) pthread_join( ths[jdx].thread, NULL );
+     if(( error == ak_error_ok ) && ( ths[jdx].error != ak_error_ok ))
+       error = ak_error_message( ths[jdx].error, __func__, "incorrect key generation in thread" );
+     ak_bckey_destroy( &ths[jdx].key );
+  }
+  free( ths );
+
+  if( error == ak_error_ok ) {
+    *inptr += *sections*seclen*words;
+    *outptr += *sections*seclen*words;
+    *sections = 0;
+  }
+ return error;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Реализация режима `ACPKM`; параметры функции совпадают с параметрами
+    функции ak_bckey_ctr_acpkm_parallel().                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_ctr_acpkm_threads( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                              size_t section_size, ak_pointer iv, size_t iv_size, size_t threads )
 {
   struct bckey nkey;
   int error = ak_error_ok;
@@ -153,10 +282,6 @@
   if( section_size%bkey->bsize != 0 )
     return ak_error_message( ak_error_wrong_block_cipher_length,
                                __func__ , "the length of section is not divided by block length" );
- /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                                  "incorrect integrity code of secret key value" );
  /* проверяем размер синхропосылки */
   if( iv == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                    "using null pointer to initialization vector" );
@@ -168,18 +293,18 @@
                                                              а также устанавливаем синхропосылку */
   switch( bkey->bsize ) {
     case 8:
-       maxseclen = ak_libakrypt_get_option_by_name( "acpkm_section_magma_block_count" );
-       mcount = ak_libakrypt_get_option_by_name( "magma_cipher_resource" )/maxseclen;
+       maxseclen = ak_libakrypt_get_option( acpkm_section_magma_block_count_option );
+       mcount = ak_libakrypt_get_option( magma_cipher_resource_option )/maxseclen;
        #ifdef AK_LITTLE_ENDIAN
-         ctr[0] = ((ak_uint64 *)iv)[0] << 32;
+         ctr[0] = (( ak_uint64 )(( ak_uint32 *)iv)[0] ) << 32;
        #else
          ctr[0] = ((ak_uint32 *)iv)[0];
        #endif
       break;
 
     case 16:
-       maxseclen = ak_libakrypt_get_option_by_name( "acpkm_section_kuznechik_block_count" );
-       mcount = ak_libakrypt_get_option_by_name( "kuznechik_cipher_resource" )/maxseclen;
+       maxseclen = ak_libakrypt_get_option( acpkm_section_kuznechik_block_count_option );
+       mcount = ak_libakrypt_get_option( kuznechik_cipher_resource_option )/maxseclen;
        ctr[1] = ((ak_uint64 *) iv)[0];
       break;
     default: return ak_error_message( ak_error_wrong_block_cipher,
@@ -201,41 +326,45 @@
        else bkey->key.resource.value.counter--;
      }
 
+ /* проверяем целостность ключа; после проверки ключ обязательно перемаскируется */
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                                  "incorrect integrity code of secret key value" );
  /* теперь размножаем исходный ключ */
-  if(( error = ak_bckey_create_and_set_bckey( &nkey, bkey )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect key duplication" );
+  if(( error = ak_bckey_create_and_set_bckey( &nkey, bkey )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect key duplication" );
+    goto labmask;
+  }
  /* и меняем ресурс для производного ключа */
   nkey.key.resource.value.counter = maxseclen;
 
  /* дальнейшие криптографические действия применяются к новому экземпляру ключа */
   sections = ( ssize_t )( size/section_size );
   tail = ( ssize_t )( size - ( size_t )( sections*seclen )*nkey.bsize );
+ #ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && ( sections > 1 )) {
+    if(( error = ak_bckey_ctr_acpkm_sections( &nkey, ctr,
+                                  &inptr, &outptr, &sections, seclen, threads )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect multithreaded encryption of sections" );
+      goto labex;
+    }
+  }
+ #else
+  (void) threads;
+ #endif
   if( sections > 0 ) {
-    do{
-       switch( nkey.bsize ) { /* обрабатываем одну секцию */
-         case 8: for( j = 0; j < seclen; j++ ) acpkm_block64; break;
-         case 16: for( j = 0; j < seclen; j++ ) acpkm_block128; break;
-         default: ak_error_message( ak_error_wrong_block_cipher,
-                                           __func__ , "incorrect block size of block cipher key" );
-       }
-      /* вычисляем следующий ключ */
-       if(( error = ak_bckey_next_acpkm_key( &nkey )) != ak_error_ok ) {
-         ak_error_message_fmt( error, __func__, "incorrect key generation after %u sections",
-                                                                         (unsigned int) sections );
-         goto labex;
-       }
-    } while( --sections > 0 );
+   /* обрабатываем секции, вычисляя ключ для каждой следующей секции */
+    if(( error = ak_bckey_ctr_acpkm_run( &nkey, ctr,
+                                     &inptr, &outptr, sections, seclen, ak_true )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect key generation" );
+      goto labex;
+    }
   } /* конец обработки случая, когда sections > 0 */
 
   if( tail ) { /* теперь обрабатываем фрагмент данных, не кратный длине секции */
-    if(( seclen = tail/(ssize_t)( nkey.bsize )) > 0 ) {
-       switch( nkey.bsize ) { /* обрабатываем данные, кратные длине блока */
-         case 8: for( j = 0; j < seclen; j++ ) acpkm_block64; break;
-         case 16: for( j = 0; j < seclen; j++ ) acpkm_block128; break;
-         default: ak_error_message( ak_error_wrong_block_cipher,
-                                            __func__ , "incorrect block size of block cipher key" );
-       }
-    }
+   /* обрабатываем данные, кратные длине блока */
+    if(( seclen = tail/(ssize_t)( nkey.bsize )) > 0 )
+      ak_bckey_ctr_acpkm_blocks( &nkey, ctr, &inptr, &outptr, seclen );
   /* остался последний фрагмент, длина которого меньше длины блока
                       в качестве гаммы мы используем старшие байты */
     if(( tail -= seclen*(ssize_t)( nkey.bsize )) > 0 ) {
@@ -246,9 +375,85 @@
   }
 
   labex: ak_bckey_destroy( &nkey );
+ /* перемаскируем исходный ключ */
+  labmask:
+  if( ak_skey_set_mask_with_policy( &bkey->key ) != ak_error_ok )
+    ak_error_message( ak_error_get_value(), __func__ , "wrong remasking of secret key" );
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! В режиме `ACPKM` для шифрования используется операция гаммирования - операция сложения
+    открытого (зашифровываемого) текста с гаммой, вырабатываемой шифром, по модулю два.
+    Поэтому, для зашифрования и расшифрования информациии используется одна и та же функция.
+
+    В процессе шифрования исходные данные разбиваются на секции фиксированной длины, после чего
+    каждая секция шифруется на своем ключе. Длина секции является параметром алгоритма и
+    не должна превосходить величины, определяемой одной из следующих технических характеристик
+    (опций)
+
+     - `ackpm_section_magma_block_count`,
+     - `ackpm_section_kuznechik_block_count`.
+
+    Значение синхропосылки `iv` копируется во временную область памяти и, в ходе выполнения
+    функции, не изменяется. Повторный вызов функции ak_bckey_ctr_acpkm() с нулевым
+    указатетем на синхропосылу, как в случае функции ak_bckey_ctr(), не допускается.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования,
+    используемый для шифрования и порождения цепочки производных ключей.
+    @param in Указатель на область памяти, где хранятся входные
+    (зашифровываемые/расшифровываемые) данные
+    @param out Указатель на область памяти, куда помещаются выходные
+    (расшифровываемые/зашифровываемые) данные; этот указатель может совпадать с in
+    @param size Размер зашировываемых данных (в байтах). Длина зашифровываемых данных может
+    принимать любое значение, не превосходящее \f$ 2^{\frac{8n}{2}-1}\f$, где \f$ n \f$
+    длина блока алгоритма шифрования (8 или 16 байт).
+
+    @param section_size Размер одной секции в байтах. Данная величина должна быть кратна длине блока
+    используемого алгоритма шифрования.
+
+    @param iv имитовставка
+    @param iv_size длина имитовставки (в байтах)
+
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_ctr_acpkm( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                                                 size_t section_size, ak_pointer iv, size_t iv_size)
+{
+  return ak_bckey_ctr_acpkm_threads( bkey, in, out, size, section_size, iv, iv_size, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует режим `ACPKM` так же, как функция ak_bckey_ctr_acpkm(), однако
+    шифрование секций распределяется между несколькими потоками. Секции обрабатываются
+    непрерывными фрагментами; производный ключ для первой секции каждого фрагмента вычисляется
+    вызывающим потоком, остальные ключи фрагмента - потоком, выполняющим его шифрование.
+    Результат шифрования и изменение ресурса ключа `bkey` совпадают с результатом
+    последовательной реализации.
+
+    Каждый поток обрабатывает не менее \ref ak_bckey_thread_min_blocks блоков;
+    для данных меньшего объема, а также в случае, когда библиотека собрана без поддержки
+    потоков, функция выполняет последовательное шифрование.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования.
+    @param in Указатель на входные данные.
+    @param out Указатель на выходные данные; этот указатель может совпадать с in.
+    @param size Размер зашировываемых данных (в байтах).
+    @param section_size Размер одной секции в байтах.
+    @param iv имитовставка
+    @param iv_size длина имитовставки (в байтах)
+    @param threads Максимальное количество используемых потоков.
+
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_ctr_acpkm_parallel( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                               size_t section_size, ak_pointer iv, size_t iv_size, size_t threads )
+{
+  return ak_bckey_ctr_acpkm_threads( bkey, in, out, size, section_size, iv, iv_size, threads );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_libakrypt_test_acpkm( void )
 {
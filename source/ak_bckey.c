@@ -4,7 +4,10 @@
 /*  Файл ak_bckey.c                                                                                */
 /*  - содержит реализацию общих функций для алгоритмов блочного шифрования.                        */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция устанавливает параметры алгоритма блочного шифрования, передаваемые в качестве
@@ -13,6 +16,8 @@
 
     - bkey.encrypt -- алгоритм зашифрования одного блока
     - bkey.decrypt -- алгоритм расшифрования одного блока
+    - bkey.encrypt_blocks -- алгоритм зашифрования последовательности независимых блоков
+    - bkey.decrypt_blocks -- алгоритм расшифрования последовательности независимых блоков
     - bkey.shedule_keys -- алгоритм развертки ключа и генерации раундовых ключей
     - bkey.delete_keys -- функция удаления раундовых ключей
 
@@ -52,6 +57,8 @@
   bkey->ivector_size =  0;
   bkey->encrypt =       NULL;
   bkey->decrypt =       NULL;
+  bkey->encrypt_blocks = NULL;
+  bkey->decrypt_blocks = NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
 
@@ -86,6 +93,8 @@
   bkey->bsize =            0;
   bkey->encrypt =       NULL;
   bkey->decrypt =       NULL;
+  bkey->encrypt_blocks = NULL;
+  bkey->decrypt_blocks = NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
 
@@ -154,7 +163,7 @@
                                        "using a constant value for secret key with wrong length" );
 
  /* дополнительный переворот ключа для алгоритма Магма (в режиме совместимости с openssl) */
-  if(( ak_libakrypt_get_option_by_name( "openssl_compability" ) == 1 ) &&
+  if(( ak_libakrypt_get_option( openssl_compability_option ) == 1 ) &&
                                          ( strncmp( bkey->key.oid->name[0], "magma", 5 ) == 0 )) {
     int i = 0;
     ak_uint8 revkey[32];
@@ -178,13 +187,13 @@
   }
  /* устанавливаем ресурс использования секретного ключа */
   switch( bkey->bsize ) {
-    case  8: if(( error = ak_skey_set_resource_values( &bkey->key,
-                      block_counter_resource, "magma_cipher_resource", 0, 0 )) != ak_error_ok )
+    case  8: if(( error = ak_skey_set_resource_values_by_index( &bkey->key, block_counter_resource,
+                                             magma_cipher_resource_option, 0, 0 )) != ak_error_ok )
        ak_error_message( error, __func__, "incorrect assigning \"magma_cipher_resource\" option" );
       break;
 
-    case 16: if(( error = ak_skey_set_resource_values( &bkey->key,
-                     block_counter_resource, "kuznechik_cipher_resource", 0, 0 )) != ak_error_ok )
+    case 16: if(( error = ak_skey_set_resource_values_by_index( &bkey->key, block_counter_resource,
+                                         kuznechik_cipher_resource_option, 0, 0 )) != ak_error_ok )
        ak_error_message( error, __func__,
                                       "incorrect assigning \"kuznechik_cipher_resource\" option" );
       break;
@@ -227,13 +236,13 @@
 
  /* устанавливаем ресурс использования секретного ключа */
   switch( bkey->bsize ) {
-    case  8: if(( error = ak_skey_set_resource_values( &bkey->key,
-                      block_counter_resource, "magma_cipher_resource", 0, 0 )) != ak_error_ok )
+    case  8: if(( error = ak_skey_set_resource_values_by_index( &bkey->key, block_counter_resource,
+                                             magma_cipher_resource_option, 0, 0 )) != ak_error_ok )
        ak_error_message( error, __func__, "incorrect assigning \"magma_cipher_resource\" option" );
       break;
 
-    case 16: if(( error = ak_skey_set_resource_values( &bkey->key,
-                     block_counter_resource, "kuznechik_cipher_resource", 0, 0 )) != ak_error_ok )
+    case 16: if(( error = ak_skey_set_resource_values_by_index( &bkey->key, block_counter_resource,
+                                         kuznechik_cipher_resource_option, 0, 0 )) != ak_error_ok )
        ak_error_message( error, __func__,
                                       "incorrect assigning \"kuznechik_cipher_resource\" option" );
       break;
@@ -284,13 +293,13 @@
 
  /* устанавливаем ресурс использования секретного ключа */
   switch( bkey->bsize ) {
-    case  8: if(( error = ak_skey_set_resource_values( &bkey->key,
-                      block_counter_resource, "magma_cipher_resource", 0, 0 )) != ak_error_ok )
+    case  8: if(( error = ak_skey_set_resource_values_by_index( &bkey->key, block_counter_resource,
+                                             magma_cipher_resource_option, 0, 0 )) != ak_error_ok )
        ak_error_message( error, __func__, "incorrect assigning \"magma_cipher_resource\" option" );
       break;
 
-    case 16: if(( error = ak_skey_set_resource_values( &bkey->key,
-                     block_counter_resource, "kuznechik_cipher_resource", 0, 0 )) != ak_error_ok )
+    case 16: if(( error = ak_skey_set_resource_values_by_index( &bkey->key, block_counter_resource,
+                                         kuznechik_cipher_resource_option, 0, 0 )) != ak_error_ok )
        ak_error_message( error, __func__,
                                       "incorrect assigning \"kuznechik_cipher_resource\" option" );
       break;
@@ -342,6 +351,47 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! В отличие от функции ak_bckey_create_and_set_bckey(), функция учитывает переворот ключа
+    алгоритма Магма, выполняемый в режиме совместимости с openssl, и гарантирует, что
+    раундовые ключи создаваемого контекста совпадают с раундовыми ключами `rkey`.
+    Функция используется для передачи копий ключа потокам при многопоточном шифровании.
+
+    @param bkey Контекст создаваемого ключа.
+    @param rkey Контекст ключа, значение которого копируется.
+
+    @return В случае успеха возвращается значение \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_create_copy( ak_bckey bkey, ak_bckey rkey )
+{
+  size_t i = 0;
+  ak_uint8 revkey[32];
+  int error = ak_error_ok;
+
+  if(( error = ak_bckey_create_and_set_bckey( bkey, rkey )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect duplication of block cipher key" );
+  if(( ak_libakrypt_get_option( openssl_compability_option ) != 1 ) ||
+                                  ( strncmp( rkey->key.oid->name[0], "magma", 5 ) != 0 ))
+    return error;
+
+ /* ключ был перевернут дважды, присваиваем его повторно */
+  if(( error = rkey->key.unmask( &rkey->key )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect unmasking block cipher context" );
+    goto labex;
+  }
+  for( i = 0; i < sizeof( revkey ); i++ ) revkey[i] = rkey->key.key[sizeof( revkey )-1-i];
+  rkey->key.set_mask( &rkey->key );
+  error = ak_bckey_set_key( bkey, revkey, sizeof( revkey ));
+  ak_ptr_wipe( revkey, sizeof( revkey ), &bkey->key.generator );
+  if( error == ak_error_ok ) return error;
+  ak_error_message( error, __func__, "incorrect assigning a new key value" );
+
+  labex:
+   ak_bckey_destroy( bkey );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                             теперь реализация режимов шифрования                                */
 /* ----------------------------------------------------------------------------------------------- */
@@ -359,7 +409,6 @@
 {
   size_t blocks = 0;
   int error = ak_error_ok;
-  ak_uint64 *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
 
  /* выполняем проверку размера входных данных */
   if( size%bkey->bsize != 0 )
@@ -367,7 +416,7 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -377,25 +426,14 @@
                                                    __func__ , "low resource of block cipher key" );
    else bkey->key.resource.value.counter -= blocks;
 
- /* теперь приступаем к зашифрованию данных */
-  switch( bkey->bsize ) {
-    case  8: /* шифр с длиной блока 64 бита */
-      do {
-        bkey->encrypt( &bkey->key, inptr++, outptr++ );
-      } while( --blocks > 0 );
-    break;
-
-    case 16: /* шифр с длиной блока 128 бит */
-      do {
-        bkey->encrypt( &bkey->key, inptr, outptr );
-        inptr+=2; outptr+=2;
-      } while( --blocks > 0 );
-    break;
-    default: return ak_error_message( ak_error_wrong_block_cipher,
+ /* теперь приступаем к зашифрованию данных;
+    блоки в режиме простой замены независимы, поэтому обрабатываются за один вызов */
+  if(( bkey->bsize != 8 ) && ( bkey->bsize != 16 ))
+    return ak_error_message( ak_error_wrong_block_cipher,
                                           __func__ , "incorrect block size of block cipher key" );
-  }
+  bkey->encrypt_blocks( &bkey->key, in, out, blocks );
  /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return ak_error_ok;
@@ -416,7 +454,6 @@
 {
   size_t blocks = 0;
   int error = ak_error_ok;
-  ak_uint64 *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
 
  /* выполняем проверку размера входных данных */
   if( size%bkey->bsize != 0 )
@@ -424,7 +461,7 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -434,87 +471,235 @@
                                                    __func__ , "low resource of block cipher key" );
    else bkey->key.resource.value.counter -= blocks;
 
- /* теперь приступаем к расшифрованию данных */
-  switch( bkey->bsize ) {
-    case  8: /* шифр с длиной блока 64 бита */
-      do {
-        bkey->decrypt( &bkey->key, inptr++, outptr++ );
-      } while( --blocks > 0 );
-    break;
-
-    case 16: /* шифр с длиной блока 128 бит */
-      do {
-        bkey->decrypt( &bkey->key, inptr, outptr );
-        inptr+=2; outptr+=2;
-      } while( --blocks > 0 );
-    break;
-    default: return ak_error_message( ak_error_wrong_block_cipher,
+ /* теперь приступаем к расшифрованию данных;
+    блоки в режиме простой замены независимы, поэтому обрабатываются за один вызов */
+  if(( bkey->bsize != 8 ) && ( bkey->bsize != 16 ))
+    return ak_error_message( ak_error_wrong_block_cipher,
                                           __func__ , "incorrect block size of block cipher key" );
-  }
+  bkey->decrypt_blocks( &bkey->key, in, out, blocks );
  /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return ak_error_ok;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Поскольку в режиме гаммирования операцией шифрования является сложение открытого текста по
-    модулю два с последовательностью, вырабатываемой блочным шифром из заданной синхропосылки,
-    то для зашифрования и расшифрования информациии используется одна и та же функция.
+/*! \brief Функция возвращает значение счетчика, хранящееся в синхропосылке режима гаммирования.
 
-    Значение синхропосылки `iv` копируется в контекст секретного ключа (область памяти, на которую
-    указывает `iv` не изменяется) и преобразуется в ходе реализации режима гаммирования.
-    Преобразованное значение сохраняется в контексте секретного ключа в буффере `skey.ivector`.
-    Данное значение может быть использовано при повторном вызове функции ak_bckey_ctr().
-    Следующий пример иллюстрирует сказанное.
+    @param bsize Длина блока алгоритма блочного шифрования (в байтах).
+    @param ivector Текущее значение синхропосылки.
+    @param oc Флаг режима совместимости с openssl.
+    @return Значение счетчика.                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_bckey_ctr_get_counter( size_t bsize, ak_uint8 *ivector, int oc )
+{
+  if( bsize == 8 ) {
+   #ifndef AK_LITTLE_ENDIAN
+    return oc ? ((ak_uint64 *)ivector)[0] : bswap_64( ((ak_uint64 *)ivector)[0] );
+   #else
+    return oc ? bswap_64( ((ak_uint64 *)ivector)[0] ) : ((ak_uint64 *)ivector)[0];
+   #endif
+  }
+ #ifndef AK_LITTLE_ENDIAN
+  return bswap_64( ((ak_uint64 *)ivector)[oc] );
+ #else
+  return ((ak_uint64 *)ivector)[oc];
+ #endif
+}
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция помещает значение счетчика в синхропосылку режима гаммирования.
 
-\code
- // bkey - ключ алгоритма "Магма"
- // шифрование буффера с данными одним фрагментом
-  ak_bckey_ctr( bkey, in, out, size, iv, 4 );
+    @param bsize Длина блока алгоритма блочного шифрования (в байтах).
+    @param ivector Изменяемое значение синхропосылки.
+    @param x Значение счетчика.
+    @param oc Флаг режима совместимости с openssl.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_bckey_ctr_set_counter( size_t bsize, ak_uint8 *ivector, ak_uint64 x, int oc )
+{
+  if( bsize == 8 ) {
+   #ifndef AK_LITTLE_ENDIAN
+    ((ak_uint64 *)ivector)[0] = oc ? x : bswap_64( x );
+   #else
+    ((ak_uint64 *)ivector)[0] = oc ? bswap_64( x ) : x;
+   #endif
+  } else {
+   /* за элементарное сложение с единицей приходится платить одним разворотом */
+    #ifdef AK_LITTLE_ENDIAN
+     ((ak_uint64 *)ivector)[oc] = oc ? bswap_64( x ) : x;
+    #else
+     ((ak_uint64 *)ivector)[oc] = oc ? x : bswap_64( x );
+    #endif                   /* здесь мы не учитываем знак переноса
+                                     потому что объем данных на одном ключе не должен
+                                     превышать 2^64 блоков (контролируется через ресурс ключа) */
+    }
+}
 
- // тот же результат может быть получен за три последовательных вызова
-  ak_bckey_ctr( bkey, in, out, 16, iv, 4 );
-  ak_bckey_ctr( bkey, in+16, out+16, 16, NULL, 0 );
-  ak_bckey_ctr( bkey, in+32, out+32, size-32, NULL, 0 );
- //   для того, чтобы использовать внутреннее значение синхропосылки,
- //                мы передаем нулевые значения последних параметров
- //        использовать данную возможность можно только в том случае,
- // когда длина переданных в функцию ранее данных кратна длине блока
-\endcode
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция гаммирования последовательности блоков в режиме гаммирования.
+
+    Последовательные значения счетчика вырабатываются группами по \ref ak_bckey_gamma_blocks
+    значений и зашифровываются за один вызов функции bckey.encrypt_blocks.
+    После выполнения функции синхропосылка `ivector` содержит следующее значение счетчика.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования.
+    @param ivector Значение синхропосылки для первого обрабатываемого блока.
+    @param x Значение счетчика, соответствующее синхропосылке `ivector`.
+    @param inptr Указатель на входные данные.
+    @param outptr Указатель на выходные данные.
+    @param blocks Количество обрабатываемых блоков.
+    @param oc Флаг режима совместимости с openssl.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_bckey_ctr_blocks( ak_bckey bkey, ak_uint8 *ivector, ak_uint64 x,
+                               ak_uint64 *inptr, ak_uint64 *outptr, ak_int64 blocks, int oc )
+{
+  ak_int64 idx = 0, cnt = 0;
+  const ak_int64 words = ( ak_int64 )( bkey->bsize >> 3 );
+  ak_uint64 ctrs[2*ak_bckey_gamma_blocks], gamma[2*ak_bckey_gamma_blocks];
+
+  while( blocks > 0 ) {
+   /* вырабатываем несколько последовательных значений счетчика */
+    cnt = ak_min( blocks, ak_bckey_gamma_blocks );
+    for( idx = 0; idx < cnt; idx++ ) {
+       ctrs[words*idx] = ((ak_uint64 *)ivector)[0];
+       if( words > 1 ) ctrs[words*idx+1] = ((ak_uint64 *)ivector)[1];
+       ak_bckey_ctr_set_counter( bkey->bsize, ivector, ++x, oc );
+    }
+   /* и зашифровываем их за один вызов */
+    bkey->encrypt_blocks( &bkey->key, ctrs, gamma, (size_t) cnt );
+    for( idx = 0; idx < words*cnt; idx++ ) *outptr++ = *inptr++ ^ gamma[idx];
+    blocks -= cnt;
+  }
+}
 
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Контекст потока, выполняющего гаммирование фрагмента данных. */
+ typedef struct bckey_ctr_thread {
+  /*! \brief Копия ключа алгоритма блочного шифрования. */
+   struct bckey key;
+  /*! \brief Синхропосылка для первого блока фрагмента. */
+   ak_uint8 ivector[16];
+  /*! \brief Значение счетчика для первого блока фрагмента. */
+   ak_uint64 x;
+  /*! \brief Указатель на входные данные. */
+   ak_uint64 *in;
+  /*! \brief Указатель на выходные данные. */
+   ak_uint64 *out;
+  /*! \brief Количество блоков во фрагменте. */
+   ak_int64 blocks;
+  /*! \brief Флаг режима совместимости с openssl. */
+   int oc;
+  /*! \brief Флаг успешного запуска потока. */
+   bool_t started;
+  /*! \brief Идентификатор потока. */
+   pthread_t thread;
+ } *ak_bckey_ctr_thread;
 
- В приведенном выше фрагменте исходный буффер сначала зашифровывается за один вызов функции,
- а потом фрагментами, длина которых кратна длине блока используемого алгоритма блочного шифрования.
- Результаты зашифрования должны совпадать в обоих случаях. Указанное поведение функции позволяет
- зашифровывать данные в случае, когда они поступают фрагментами, например из сети, или когда хранение
- данных полностью в оперативной памяти нецелесообразно (например, шифрование больших файлов).
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция, выполняемая отдельным потоком. */
+ static void *ak_bckey_ctr_thread_run( void *ptr )
+{
+  ak_bckey_ctr_thread th = ( ak_bckey_ctr_thread ) ptr;
+  ak_bckey_ctr_blocks( &th->key, th->ivector, th->x, th->in, th->out, th->blocks, th->oc );
+ return NULL;
+}
 
-    @param bkey Контекст ключа алгоритма блочного шифрования, на котором происходит
-    зашифрование или расшифрование информации.
-    @param in Указатель на область памяти, где хранятся входные (открытые) данные.
-    @param out Указатель на область памяти, куда помещаются зашифрованные данные
-    (этот указатель может совпадать с `in`).
-    @param size Размер зашировываемых данных (в байтах).
-    @param iv Указатель на произвольную область памяти - синхропосылку. Область памяти, на
-    которую указывает `iv` не изменяется.
-    @param iv_size Длина синхропосылки в байтах. Согласно  стандарту ГОСТ Р 34.13-2015 длина
-    синхропосылки должна быть ровно в два раза меньше, чем длина блока, то есть 4 байта для Магмы
-    и 8 байт для Кузнечика. Значение `iv_size`, отличное от указанных, может привести к
-    возникновению ошибки.
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция гаммирования последовательности блоков с использованием нескольких потоков.
 
-    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
-    возвращается \ref ak_error_ok (ноль)                                                           */
+    Данные разбиваются на фрагменты, содержащие не менее \ref ak_bckey_thread_min_blocks блоков.
+    Первый фрагмент обрабатывается вызывающим потоком с использованием ключа `bkey`,
+    остальные фрагменты - дополнительными потоками, каждый из которых использует собственную
+    копию ключа (функции маскирования ключа не допускают одновременного вызова из разных потоков).
+    Значение счетчика для каждого фрагмента вычисляется по его смещению, поэтому результат
+    совпадает с результатом функции ak_bckey_ctr_blocks().
+
+    Если объем данных слишком мал для распределения между потоками, функция не выполняет
+    никаких действий и не изменяет значение `blocks`; в противном случае, после
+    обработки, `blocks` принимает нулевое значение, а указатели на данные смещаются
+    за последний обработанный блок.
+
+    Ресурс ключа `bkey` уменьшается вызывающей функцией, копии ключа используются только
+    внутри данной функции и уничтожаются после завершения потоков.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_bckey_ctr( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
-                                                                     ak_pointer iv, size_t iv_size )
+ static int ak_bckey_ctr_blocks_parallel( ak_bckey bkey, ak_uint64 x, ak_uint64 **inptr,
+                           ak_uint64 **outptr, ak_int64 *blocks, int oc, size_t threads )
+{
+  size_t idx = 0, count = 0;
+  int error = ak_error_ok;
+  ak_int64 chunk = 0, first = 0, offset = 0;
+  const ak_int64 words = ( ak_int64 )( bkey->bsize >> 3 );
+  ak_bckey_ctr_thread ths = NULL;
+
+ /* определяем количество фрагментов */
+  count = ak_min( threads, ( size_t )( *blocks/ak_bckey_thread_min_blocks ));
+  if( count < 2 ) return ak_error_ok;
+  chunk = *blocks/( ak_int64 )count;
+  first = offset = chunk + *blocks%( ak_int64 )count;
+
+  if(( ths = ak_object_aligned_malloc(( count-1 )*sizeof( struct bckey_ctr_thread ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  memset( ths, 0, ( count-1 )*sizeof( struct bckey_ctr_thread ));
+
+ /* создаем копии ключа и вычисляем начальные значения счетчиков */
+  for( idx = 0; idx < count-1; idx++ ) {
+     if(( error = ak_bckey_create_copy( &ths[idx].key, bkey )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect duplication of block cipher key" );
+       while( idx > 0 ) ak_bckey_destroy( &ths[--idx].key );
+       free( ths );
+       return error;
+     }
+     memcpy( ths[idx].ivector, bkey->ivector, bkey->bsize );
+     ak_bckey_ctr_set_counter( bkey->bsize, ths[idx].ivector,
+                                                     ths[idx].x = x + ( ak_uint64 )offset, oc );
+     ths[idx].in = *inptr + offset*words;
+     ths[idx].out = *outptr + offset*words;
+     ths[idx].blocks = chunk;
+     ths[idx].oc = oc;
+     offset += chunk;
+  }
+
+ /* запускаем потоки и обрабатываем первый фрагмент */
+  for( idx = 0; idx < count-1; idx++ )
+     ths[idx].started = ( pthread_create( &ths[idx].thread, NULL,
+                                   ak_bckey_ctr_thread_run, ths+idx ) == 0 ) ? ak_true : ak_false;
+  ak_bckey_ctr_blocks( bkey, bkey->ivector, x, *inptr, *outptr, first, oc );
+
+ /* дожидаемся завершения потоков; фрагменты, для которых поток не был создан,
+    обрабатываем самостоятельно */
+  for( idx = 0; idx < count-1; idx++ ) {
+     if( ths[idx].started ) pthread_join( ths[idx].thread, NULL );
+       else ak_bckey_ctr_thread_run( ths+idx );
+     ak_bckey_destroy( &ths[idx].key );
+  }
+  free( ths );
+
+ /* устанавливаем значение счетчика, следующее за последним обработанным блоком */
+  ak_bckey_ctr_set_counter( bkey->bsize, bkey->ivector, x + ( ak_uint64 )*blocks, oc );
+  *inptr += *blocks*words;
+  *outptr += *blocks*words;
+  *blocks = 0;
+
+ return ak_error_ok;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Реализация режима гаммирования; параметры функции совпадают с параметрами
+    функции ak_bckey_ctr_parallel().                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_bckey_ctr_threads( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                                                     ak_pointer iv, size_t iv_size, size_t threads )
 {
   ak_int64 blocks = (ak_int64)( size/bkey->bsize ),
              tail = (ak_int64)( size%bkey->bsize );
   ak_uint64 x, yaout[2], *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
-  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
   if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                 "wrong value for \"openssl_compability\" option" );
@@ -524,7 +709,7 @@
                                     __func__, "using secret key context with undefined key value" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                    "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -561,53 +746,27 @@
     }
 
  /* обработка основного массива данных (кратного длине блока) */
-  switch( bkey->bsize ) {
-    case  8: /* шифр с длиной блока 64 бита (Магма) */
-      while( blocks > 0 ) {
-        #ifndef AK_LITTLE_ENDIAN
-          x = oc ? ((ak_uint64 *)bkey->ivector)[0] : bswap_64( ((ak_uint64 *)bkey->ivector)[0] );
-        #else
-          x = oc ? bswap_64( ((ak_uint64 *)bkey->ivector)[0] ) : ((ak_uint64 *)bkey->ivector)[0];
-        #endif
-          bkey->encrypt( &bkey->key, bkey->ivector, yaout );
-          *outptr = *inptr ^ yaout[0];
-          outptr++; inptr++;
-
-        #ifndef AK_LITTLE_ENDIAN
-          ((ak_uint64 *)bkey->ivector)[0] = oc ? ++x : bswap_64( ++x );
-        #else
-          ((ak_uint64 *)bkey->ivector)[0] = oc ? bswap_64( ++x ) : ++x;
-        #endif
-        --blocks;
-      }
-    break;
-
-    case 16: /* шифр с длиной блока 128 бит (Кузнечик) */
-     #ifndef AK_LITTLE_ENDIAN
-      x = bswap_64( ((ak_uint64 *)bkey->ivector)[oc] );
-     #else
-      x = ((ak_uint64 *)bkey->ivector)[oc];
-     #endif
-
-      while( blocks > 0 ) {
-          bkey->encrypt( &bkey->key, bkey->ivector, yaout );
-          *outptr = *inptr ^ yaout[0]; outptr++; inptr++;
-          *outptr = *inptr ^ yaout[1]; outptr++; inptr++;
-
-       /* за элементарное сложение с единицей приходится платить одним разворотом */
-        #ifdef AK_LITTLE_ENDIAN
-         ((ak_uint64 *)bkey->ivector)[oc] = oc ? bswap_64(++x) : ++x;
-        #else
-          ((ak_uint64 *)bkey->ivector)[oc] = oc ? ++x : bswap_64( ++x );
-        #endif                    /* здесь мы не учитываем знак переноса
-                                     потому что объем данных на одном ключе не должен
-                                     превышать 2^64 блоков (контролируется через ресурс ключа) */
-        --blocks;
-      }
-    break;
-
-    default: return ak_error_message( ak_error_wrong_block_cipher,
+  if(( bkey->bsize != 8 ) && ( bkey->bsize != 16 ))
+    return ak_error_message( ak_error_wrong_block_cipher,
                                           __func__ , "incorrect block size of block cipher key" );
+  x = ak_bckey_ctr_get_counter( bkey->bsize, bkey->ivector, oc );
+ #ifdef AK_HAVE_PTHREAD_H
+  if(( threads > 1 ) && ( blocks > 1 )) {
+    if(( error = ak_bckey_ctr_blocks_parallel( bkey, x,
+                                      &inptr, &outptr, &blocks, oc, threads )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect multithreaded encryption of blocks" );
+     /* ключ использовался для проверки и должен быть перемаскирован и в случае ошибки */
+      if( ak_skey_set_mask_with_policy( &bkey->key ) != ak_error_ok )
+        ak_error_message( ak_error_get_value(), __func__ , "wrong remasking of secret key" );
+      return error;
+    }
+  }
+ #else
+  (void) threads;
+ #endif
+  if( blocks > 0 ) {
+    ak_bckey_ctr_blocks( bkey, bkey->ivector, x, inptr, outptr, blocks, oc );
+    inptr += blocks*( bkey->bsize >> 3 ); outptr += blocks*( bkey->bsize >> 3 );
   }
 
  /* обрабатываем хвост сообщения */
@@ -633,12 +792,98 @@
   }
 
  /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Поскольку в режиме гаммирования операцией шифрования является сложение открытого текста по
+    модулю два с последовательностью, вырабатываемой блочным шифром из заданной синхропосылки,
+    то для зашифрования и расшифрования информациии используется одна и та же функция.
+
+    Значение синхропосылки `iv` копируется в контекст секретного ключа (область памяти, на которую
+    указывает `iv` не изменяется) и преобразуется в ходе реализации режима гаммирования.
+    Преобразованное значение сохраняется в контексте секретного ключа в буффере `skey.ivector`.
+    Данное значение может быть использовано при повторном вызове функции ak_bckey_ctr().
+    Следующий пример иллюстрирует сказанное.
+
+
+\code
+ // bkey - ключ алгоритма "Магма"
+ // шифрование буффера с данными одним фрагментом
+  ak_bckey_ctr( bkey, in, out, size, iv, 4 );
+
+ // тот же результат может быть получен за три последовательных вызова
+  ak_bckey_ctr( bkey, in, out, 16, iv, 4 );
+  ak_bckey_ctr( bkey, in+16, out+16, 16, NULL, 0 );
+  ak_bckey_ctr( bkey, in+32, out+32, size-32, NULL, 0 );
+ //   для того, чтобы использовать внутреннее значение синхропосылки,
+ //                мы передаем нулевые значения последних параметров
+ //        использовать данную возможность можно только в том случае,
+ // когда длина переданных в функцию ранее данных кратна длине блока
+\endcode
+
+
+ В приведенном выше фрагменте исходный буффер сначала зашифровывается за один вызов функции,
+ а потом фрагментами, длина которых кратна длине блока используемого алгоритма блочного шифрования.
+ Результаты зашифрования должны совпадать в обоих случаях. Указанное поведение функции позволяет
+ зашифровывать данные в случае, когда они поступают фрагментами, например из сети, или когда хранение
+ данных полностью в оперативной памяти нецелесообразно (например, шифрование больших файлов).
+
+    @param bkey Контекст ключа алгоритма блочного шифрования, на котором происходит
+    зашифрование или расшифрование информации.
+    @param in Указатель на область памяти, где хранятся входные (открытые) данные.
+    @param out Указатель на область памяти, куда помещаются зашифрованные данные
+    (этот указатель может совпадать с `in`).
+    @param size Размер зашировываемых данных (в байтах).
+    @param iv Указатель на произвольную область памяти - синхропосылку. Область памяти, на
+    которую указывает `iv` не изменяется.
+    @param iv_size Длина синхропосылки в байтах. Согласно  стандарту ГОСТ Р 34.13-2015 длина
+    синхропосылки должна быть ровно в два раза меньше, чем длина блока, то есть 4 байта для Магмы
+    и 8 байт для Кузнечика. Значение `iv_size`, отличное от указанных, может привести к
+    возникновению ошибки.
+
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_ctr( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                                                                     ak_pointer iv, size_t iv_size )
+{
+  return ak_bckey_ctr_threads( bkey, in, out, size, iv, iv_size, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует режим гаммирования, аналогично функции ak_bckey_ctr(), однако обработка
+    больших объемов данных распределяется между несколькими потоками. Поскольку блоки гаммы
+    вырабатываются независимо друг от друга, каждый поток обрабатывает свой фрагмент данных,
+    начиная со значения счетчика, определяемого смещением фрагмента. Результат шифрования,
+    значение синхропосылки, сохраняемое в контексте ключа, а также изменение ресурса ключа
+    полностью совпадают с результатами последовательной реализации.
+
+    Каждый поток обрабатывает не менее \ref ak_bckey_thread_min_blocks блоков;
+    для данных меньшего объема, а также в случае, когда библиотека собрана без поддержки
+    потоков, функция выполняет последовательное шифрование.
+
+    @param bkey Контекст ключа алгоритма блочного шифрования.
+    @param in Указатель на область памяти, где хранятся входные (открытые) данные.
+    @param out Указатель на область памяти, куда помещаются зашифрованные данные
+    (этот указатель может совпадать с `in`).
+    @param size Размер зашировываемых данных (в байтах).
+    @param iv Указатель на синхропосылку (см. описание функции ak_bckey_ctr()).
+    @param iv_size Длина синхропосылки в байтах.
+    @param threads Максимальное количество используемых потоков.
+
+    @return В случае возникновения ошибки функция возвращает ее код, в противном случае
+    возвращается \ref ak_error_ok (ноль)                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_ctr_parallel( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
+                                                     ak_pointer iv, size_t iv_size, size_t threads )
+{
+  return ak_bckey_ctr_threads( bkey, in, out, size, iv, iv_size, threads );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  int ak_bckey_encrypt_cbc( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
                                                                     ak_pointer iv, size_t iv_size )
@@ -646,7 +891,7 @@
    ak_int64 blocks = 0;
    ak_uint64 yaout[2], z = iv_size / bkey->bsize;
    ak_uint64 *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out, *ivector = (ak_uint64 *)bkey->ivector;
-   int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+   int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
    if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                  "wrong value for \"openssl_compability\" option" );
@@ -657,7 +902,7 @@
                              __func__ , "the length of input data is not divided by block length" );
 
   /* проверяем целостность ключа */
-   if( bkey->key.check_icode( &bkey->key ) != ak_true )
+   if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
      return ak_error_message( ak_error_wrong_key_icode,
                                          __func__, "incorrect integrity code of secret key value" );
   /* уменьшаем значение ресурса ключа */
@@ -707,7 +952,7 @@
                                            __func__ , "incorrect block size of block cipher key" );
    }
   /* перемаскируем ключ */
-   if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+   if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
      ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
   return ak_error_ok;
@@ -720,7 +965,7 @@
   ak_int64 blocks = 0;
   ak_uint64 yaout[2], z = iv_size / bkey->bsize;
   ak_uint64 *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out, *ivector = (ak_uint64 *)bkey->ivector;
-  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
   if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                 "wrong value for \"openssl_compability\" option" );
@@ -731,7 +976,7 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -782,7 +1027,7 @@
                                           __func__ , "incorrect block size of block cipher key" );
   }
  /* перемаскируем ключ */
-  if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
  return ak_error_ok;
@@ -792,17 +1037,18 @@
  int ak_bckey_ofb( ak_bckey bkey, ak_pointer in, ak_pointer out, size_t size,
                                                                      ak_pointer iv, size_t iv_size )
 {
+  size_t idx = 0;
   ak_uint8 *vecptr = NULL;
   ak_int64 blocks = (ak_int64)( size/bkey->bsize ),
              tail = (ak_int64)( size%bkey->bsize );
   ak_uint64 yaout[2], *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
-  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
   unsigned long counter = 0, z = iv_size / bkey->bsize; /* во сколько раз синхрпосылка длиннее блока */
 
   if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                "wrong value for \"openssl_compability\" option" );
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                    "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -830,7 +1076,18 @@
   /* поднимаем значение флага: синхропосылка установлена */
    bkey->key.flags = ( bkey->key.flags&( ~ak_key_flag_not_ctr ))^ak_key_flag_not_ctr;
 
-   /* обработка основного массива данных (кратного длине блока) */
+   /* синхропосылка состоит из z независимых регистров, поэтому очередные z блоков
+      гаммы вырабатываются за один вызов функции зашифрования */
+    if( z > 0 ) {
+      while( blocks >= (ak_int64) z ) {
+        bkey->encrypt_blocks( &bkey->key, bkey->ivector, bkey->ivector, z );
+        for( idx = 0; idx < ( z*bkey->bsize ) >> 3; idx++ )
+           *outptr++ = *inptr++ ^ ((ak_uint64 *)bkey->ivector)[idx];
+        blocks -= (ak_int64) z;
+      }
+    }
+
+   /* обработка оставшихся блоков (кратных длине блока) */
     switch( bkey->bsize ) {
         case 8: /* шифр с длиной блока 64 бита */
             while( blocks > 0 ) {
@@ -880,7 +1137,7 @@
    }
 
   /* перемаскируем ключ */
-   if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+   if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
      ak_error_message( error, __func__ , "wrong remasking of secret key" );
 
   return error;
@@ -894,13 +1151,13 @@
               tail = (ak_int64)( size%bkey->bsize );
    ak_uint8 *vecptr = NULL;
    ak_uint64 yaout[2], *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
-   int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+   int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
    unsigned long i = 0, z = iv_size / bkey->bsize; // во сколько раз синхрпосылка длиннее блока
 
    if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                  "wrong value for \"openssl_compability\" option" );
   /* проверяем целостность ключа */
-   if( bkey->key.check_icode( &bkey->key ) != ak_true )
+   if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
      return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                     "incorrect integrity code of secret key value" );
   /* уменьшаем значение ресурса ключа */
@@ -974,7 +1231,7 @@
      memset( bkey->ivector, 0, sizeof( bkey->ivector ));
      bkey->key.flags = bkey->key.flags&( ~ak_key_flag_not_ctr );
      /* перемаскируем ключ */
-     if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+     if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
         ak_error_message( error, __func__ , "wrong remasking of secret key" );
    }
    return error;
@@ -988,13 +1245,13 @@
               tail = (ak_int64)( size%bkey->bsize );
    ak_uint8 *vecptr = NULL;
    ak_uint64 yaout[2], *inptr = (ak_uint64 *)in, *outptr = (ak_uint64 *)out;
-   int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+   int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
    unsigned long i = 0, z = iv_size / bkey->bsize; // во сколько раз синхрпосылка длиннее блока
 
    if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                  "wrong value for \"openssl_compability\" option" );
   /* проверяем целостность ключа */
-   if( bkey->key.check_icode( &bkey->key ) != ak_true )
+   if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
      return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                     "incorrect integrity code of secret key value" );
   /* уменьшаем значение ресурса ключа */
@@ -1068,7 +1325,7 @@
      memset( bkey->ivector, 0, sizeof( bkey->ivector ));
      bkey->key.flags = bkey->key.flags&( ~ak_key_flag_not_ctr );
      /* перемаскируем ключ */
-     if(( error = bkey->key.set_mask( &bkey->key )) != ak_error_ok )
+     if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
         ak_error_message( error, __func__ , "wrong remasking of secret key" );
    }
    return error;
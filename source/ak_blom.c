@@ -426,7 +426,7 @@
   struct file fs;
   int error = ak_error_ok;
   struct random generator;
-  size_t memsize, iter = ak_libakrypt_get_option_by_name( "pbkdf2_iteration_count" );
+  size_t memsize, iter = ak_libakrypt_get_option( pbkdf2_iteration_count_option );
   struct bckey ekey, ikey;
   size_t i, j, blocks, lblocks, ltail;
   ak_uint8 iv[16], buffer[1024], *ptr = NULL;
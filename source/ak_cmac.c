@@ -4,7 +4,7 @@
 /*  Файл ak_cmac.c                                                                                 */
 /*  - содержит реализацию общих функций для алгоритмов блочного шифрования.                        */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет имитовставку от заданной области памяти фиксированного размера.
@@ -26,7 +26,8 @@
  int ak_bckey_cmac( ak_bckey bkey, ak_pointer in,
                                           const size_t size, ak_pointer out, const size_t out_size )
 {
-  ak_int64 i = 0, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" ),
+  int error = ak_error_ok;
+  ak_int64 i = 0, oc = (int) ak_libakrypt_get_option( openssl_compability_option ),
         #ifdef AK_LITTLE_ENDIAN
            one64[2] = { 0x02, 0x00 },
         #else
@@ -43,16 +44,15 @@
                                                            "using null pointer to result buffer" );
   if( !out_size ) return ak_error_message( ak_error_zero_length, __func__,
                                                             "using zero length of result buffer" );
- /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                                  "incorrect integrity code of secret key value" );
-
- /* уменьшаем значение ресурса ключа */
+ /* проверяем ресурс ключа */
   if( bkey->key.resource.value.counter < ( blocks + ( tail > 0 )))
     return ak_error_message( ak_error_low_key_resource, __func__ ,
                                                               "low resource of block cipher key" );
-   else bkey->key.resource.value.counter -= ( blocks + ( tail > 0 )); /* уменьшаем ресурс ключа */
+ /* проверяем целостность ключа; после проверки ключ обязательно перемаскируется */
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                                  "incorrect integrity code of secret key value" );
+  bkey->key.resource.value.counter -= ( blocks + ( tail > 0 )); /* уменьшаем ресурс ключа */
 
   memset( akey, 0, sizeof( akey ));
   memset( yaout, 0, sizeof( yaout ));
@@ -125,11 +125,14 @@
           break;
   }
 
- /* копируем нужную часть результирующего массива и завершаем работу */
+ /* копируем нужную часть результирующего массива */
  if( oc ) memcpy( out, (ak_uint8 *)akey, ak_min( out_size, bkey->bsize ));
   else memcpy( out, (ak_uint8 *)akey+( out_size > bkey->bsize ? 0 : bkey->bsize-out_size ),
                                                                   ak_min( out_size, bkey->bsize ));
- return ak_error_ok;
+ /* перемаскируем ключ */
+  if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong remasking of secret key" );
+ return error;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -191,6 +194,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_bckey_cmac_update( ak_bckey bkey, const ak_pointer in, const size_t size )
 {
+  int error = ak_error_ok;
   ak_int64 i, blocks = 0;
   ak_uint64 *yaout = NULL, *inptr = (ak_uint64 *)in;
 
@@ -198,17 +202,16 @@
                                                         "using null pointer to block cipher key" );
   if(( size%bkey->bsize ) != 0 ) return ak_error_message( ak_error_wrong_length, __func__,
                                                                 "using a data with wrong length" );
- /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
-    return ak_error_message( ak_error_wrong_key_icode, __func__,
-                                                  "incorrect integrity code of secret key value" );
-
- /* уменьшаем значение ресурса ключа */
+ /* проверяем ресурс ключа */
   blocks = (ak_int64)size/bkey->bsize;
   if( bkey->key.resource.value.counter < ( blocks + 1 ))
     return ak_error_message( ak_error_low_key_resource, __func__ ,
                                                               "low resource of block cipher key" );
-   else bkey->key.resource.value.counter -= blocks; /* уменьшаем ресурс ключа */
+ /* проверяем целостность ключа; после проверки ключ обязательно перемаскируется */
+  if( ak_skey_check_icode_with_policy( &bkey->key, size ) != ak_true )
+    return ak_error_message( ak_error_wrong_key_icode, __func__,
+                                                  "incorrect integrity code of secret key value" );
+  bkey->key.resource.value.counter -= blocks; /* уменьшаем ресурс ключа */
 
  /* основной цикл */
   yaout = (ak_uint64 *) bkey->ivector;
@@ -231,7 +234,10 @@
             break;
   }
 
- return ak_error_ok;
+ /* перемаскируем ключ */
+  if(( error = ak_skey_set_mask_with_policy( &bkey->key )) != ak_error_ok )
+    ak_error_message( error, __func__ , "wrong remasking of secret key" );
+ return error;
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -267,7 +273,7 @@
  int ak_bckey_cmac_finalize( ak_bckey bkey, const ak_pointer in, const size_t size,
                                                            ak_pointer out, const size_t out_size )
 {
-  ak_int64 oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" ),
+  ak_int64 oc = (int) ak_libakrypt_get_option( openssl_compability_option ),
         #ifdef AK_LITTLE_ENDIAN
            one64[2] = { 0x02, 0x00 };
         #else
@@ -4,7 +4,7 @@
 /*  Файл ak_curves.с                                                                               */
 /*  - содержит реализацию функций для работы с эллиптическими кривыми.                             */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_STRING_H
@@ -15,6 +15,105 @@
 #ifdef AK_HAVE_STRINGS_H
  #include <strings.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Арифметика по модулям вида \f$ p = 2^n - c \f$.
+
+    Используется кривыми id-tc26-gost-3410-2012-256-paramSetA, id-rfc4357-gost-3410-2001-paramSetA
+    (\f$ p = 2^{256} - 617 \f$), id-tc26-gost-3410-2012-512-paramSetA и
+    id-tc26-gost-3410-2012-512-paramSetC (\f$ p = 2^{512} - 569 \f$).                              */
+/* ----------------------------------------------------------------------------------------------- */
+ const struct wfield ak_wfield_pseudo_mersenne = {
+  ak_mpzn_mul_pseudo_mersenne,
+  ak_mpzn_sqr_pseudo_mersenne,
+  ak_mpzn_add_pseudo_mersenne,
+  ak_mpzn_sub_pseudo_mersenne,
+  ak_mpzn_inverse_pseudo_mersenne,
+  ak_mpzn_is_pseudo_mersenne,
+  "pseudo-mersenne"
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                  арифметика по модулю p, используемая при вычислениях с точками                 */
+/* ----------------------------------------------------------------------------------------------- */
+/* Если для кривой определена специализированная арифметика (поле field), то функции вызывают ее;
+   в противном случае используется арифметика Монтгомери. Поскольку формулы сложения и удвоения
+   точек однородны, в обоих случаях координаты точек хранятся в одном и том же виде,
+   а различается лишь представление констант (единицы и обратных элементов).                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_mul( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, ak_wcurve ec )
+{
+  if( ec->field == NULL ) ak_mpzn_mul_montgomery( z, x, y, ec->p, ec->n, ec->size );
+   else ec->field->mul( z, x, y, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_sqr( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  if( ec->field == NULL ) ak_mpzn_sqr_montgomery( z, x, ec->p, ec->n, ec->size );
+   else ec->field->sqr( z, x, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_add( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, ak_wcurve ec )
+{
+  if( ec->field == NULL ) ak_mpzn_add_montgomery( z, x, y, ec->p, ec->size );
+   else ec->field->add( z, x, y, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_sub( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y, ak_wcurve ec )
+{
+  if( ec->field == NULL ) ak_mpzn_sub_montgomery( z, x, y, ec->p, ec->size );
+   else ec->field->sub( z, x, y, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wcurve_lshift( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  if( ec->field == NULL ) ak_mpzn_lshift_montgomery( z, x, ec->p, ec->size );
+   else ec->field->add( z, x, x, ec->p, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение на коэффициент \f$ a \f$ кривой.
+    \details Коэффициент хранится в представлении Монтгомери, поэтому умножение Монтгомери
+    дает произведение в том же представлении, что и у множителя x, для обоих видов арифметики.     */
+ static inline void ak_wcurve_mul_a( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  ak_mpzn_mul_montgomery( z, x, ec->a, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Единица в используемом представлении вычетов. */
+ static inline void ak_wcurve_one( ak_uint64 *z, ak_wcurve ec )
+{
+  ak_mpznmax one = ak_mpznmax_one;
+
+  if( ec->field == NULL ) ak_mpzn_mul_montgomery( z, one, ec->r2, ec->p, ec->n, ec->size );
+   else ak_mpzn_set_ui( z, ec->size, 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перевод вычета из используемого представления в обычное. */
+ static inline void ak_wcurve_from( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  ak_mpznmax one = ak_mpznmax_one;
+
+  if( ec->field == NULL ) ak_mpzn_mul_montgomery( z, x, one, ec->p, ec->n, ec->size );
+   else ak_mpzn_set( z, x, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обращение вычета в используемом представлении. */
+ static inline void ak_wcurve_inverse( ak_uint64 *z, ak_uint64 *x, ak_wcurve ec )
+{
+  if( ec->field == NULL ) ak_mpzn_inverse_montgomery( z, x, ec->p, ec->r2, ec->size );
+   else ec->field->inverse( z, x, ec->p, ec->size );
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет величину \f$\Delta \equiv -16(4a^3 + 27b^2) \pmod{p} \f$, зависящую
@@ -109,6 +208,8 @@
      - проверяется, что модуль кривой (простое число \f$ p \f$) удовлетворяет неравенству
        \f$ 2^{n-32} < p < 2^n \f$, где \f$ n \f$ это либо 256, либо 512 в зависимости от
        параметров кривой,
+     - если для кривой определена специализированная арифметика, то проверяется, что модуль
+       \f$ p \f$ имеет допустимый для нее вид,
      - проверяется, что дискриминант кривой отличен от нуля по модулю \f$ p \f$,
      - проверяется, что фиксированная точка кривой, содержащаяся в контексте эллиптической кривой,
        действительно принадлежит эллиптической кривой,
@@ -150,6 +251,10 @@
   if( ak_mpzn_cmp( temp, ec->p, ec->size ) != 0 )
     return ak_error_message( ak_error_wrong_endian, __func__,
                                                "incorrect convertation string to mpzn integer" );
+ /* проверяем, что модуль допускает использование специализированной арифметики */
+  if(( ec->field != NULL ) && ( ec->field->check( ec->p, ec->size ) != ak_true ))
+    return ak_error_message( ak_error_curve_prime_modulo, __func__ ,
+                                      "elliptic curve modulo is not supported by field arithmetic" );
  /* проверяем, что дискриминант кривой отличен от нуля */
   if(( error = ak_wcurve_discriminant_is_ok( ec )) != ak_error_ok )
     return ak_error_message( ak_error_curve_discriminant, __func__ ,
@@ -391,25 +496,24 @@
   memset( t, 0, sizeof(ak_uint64)*ak_mpznmax_size );
   memset( s, 0, sizeof(ak_uint64)*ak_mpznmax_size );
 
- /* Проверяем принадлежность точки заданной кривой */
-  ak_mpzn_set( t, ec->a, ec->size );
-  ak_mpzn_mul_montgomery( t, t, wp->x, ec->p, ec->n, ec->size );
-  ak_mpzn_set( s, ec->b, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина (ax+bz)
+ /* Проверяем принадлежность точки заданной кривой;
+    коэффициенты a и b хранятся в представлении Монтгомери (см. ak_wcurve_mul_a()) */
+  ak_wcurve_mul_a( t, wp->x, ec );
+  ak_mpzn_mul_montgomery( s, wp->z, ec->b, ec->p, ec->n, ec->size );
+  ak_wcurve_add( t, t, s, ec ); // теперь в t величина (ax+bz)
 
   ak_mpzn_set( s, wp->z, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
+  ak_wcurve_sqr( s, s, ec );
+  ak_wcurve_mul( t, t, s, ec ); // теперь в t величина (ax+bz)z^2
 
   ak_mpzn_set( s, wp->x, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->x, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина x^3 + (ax+bz)z^2
+  ak_wcurve_sqr( s, s, ec );
+  ak_wcurve_mul( s, s, wp->x, ec );
+  ak_wcurve_add( t, t, s, ec ); // теперь в t величина x^3 + (ax+bz)z^2
 
   ak_mpzn_set( s, wp->y, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
+  ak_wcurve_sqr( s, s, ec );
+  ak_wcurve_mul( s, s, wp->z, ec ); // теперь в s величина x^3 + (ax+bz)z^2
 
   if( ak_mpzn_cmp( t, s, ec->size )) return ak_false;
  return ak_true;
@@ -451,30 +555,30 @@
    return;
  }
  // dbl-2007-bl
- ak_mpzn_mul_montgomery( u1, wp->x, wp->x, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u2, wp->z, wp->z, ec->p, ec->n, ec->size );
- ak_mpzn_lshift_montgomery( u4, u1, ec->p, ec->size );
- ak_mpzn_add_montgomery( u4, u4, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( u3, u2, ec->a, ec->p, ec->n, ec->size );
- ak_mpzn_add_montgomery( u3, u3, u4, ec->p, ec->size );  // u3 = az^2 + 3x^2
- ak_mpzn_mul_montgomery( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
- ak_mpzn_lshift_montgomery( u4, u4, ec->p, ec->size );   // u4 = 2yz
- ak_mpzn_mul_montgomery( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
- ak_mpzn_lshift_montgomery( u6, u5, ec->p, ec->size ); // u6 = 2u5
- ak_mpzn_mul_montgomery( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
- ak_mpzn_lshift_montgomery( u1, u7, ec->p, ec->size );
+ ak_wcurve_sqr( u1, wp->x, ec );
+ ak_wcurve_sqr( u2, wp->z, ec );
+ ak_wcurve_lshift( u4, u1, ec );
+ ak_wcurve_add( u4, u4, u1, ec );
+ ak_wcurve_mul_a( u3, u2, ec );
+ ak_wcurve_add( u3, u3, u4, ec );  // u3 = az^2 + 3x^2
+ ak_wcurve_mul( u4, wp->y, wp->z, ec );
+ ak_wcurve_lshift( u4, u4, ec );   // u4 = 2yz
+ ak_wcurve_mul( u5, wp->y, u4, ec ); // u5 = 2y^2z
+ ak_wcurve_lshift( u6, u5, ec ); // u6 = 2u5
+ ak_wcurve_mul( u7, u6, wp->x, ec ); // u7 = 8xy^2z
+ ak_wcurve_lshift( u1, u7, ec );
  ak_mpzn_sub( u1, ec->p, u1, ec->size );
- ak_mpzn_mul_montgomery( u2, u3, u3, ec->p, ec->n, ec->size );
- ak_mpzn_add_montgomery( u2, u2, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->x, u2, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u6, u6, u5, ec->p, ec->n, ec->size );
+ ak_wcurve_sqr( u2, u3, ec );
+ ak_wcurve_add( u2, u2, u1, ec );
+ ak_wcurve_mul( wp->x, u2, u4, ec );
+ ak_wcurve_mul( u6, u6, u5, ec );
  ak_mpzn_sub( u6, ec->p, u6, ec->size );
  ak_mpzn_sub( u2, ec->p, u2, ec->size );
- ak_mpzn_add_montgomery( u2, u2, u7, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->y, u2, u3, ec->p, ec->n, ec->size );
- ak_mpzn_add_montgomery( wp->y, wp->y, u6, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->z, u4, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
+ ak_wcurve_add( u2, u2, u7, ec );
+ ak_wcurve_mul( wp->y, u2, u3, ec );
+ ak_wcurve_add( wp->y, wp->y, u6, ec );
+ ak_wcurve_sqr( wp->z, u4, ec );
+ ak_wcurve_mul( wp->z, wp->z, u4, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -522,11 +626,11 @@
   }
   // поскольку удвоение точки с помощью формул сложения дает бесконечно удаленную точку,
   // необходимо выполнить проверку
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul( u1, wp1->x, wp2->z, ec );
+  ak_wcurve_mul( u2, wp2->x, wp1->z, ec );
   if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) { // случай совпадения х-координат точки
-    ak_mpzn_mul_montgomery( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
-    ak_mpzn_mul_montgomery( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+    ak_wcurve_mul( u1, wp1->y, wp2->z, ec );
+    ak_wcurve_mul( u2, wp2->y, wp1->z, ec );
     if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) // случай полного совпадения точек
       ak_wpoint_double( wp1, ec );
      else ak_wpoint_set_as_unit( wp1, ec );
@@ -534,31 +638,31 @@
   }
 
   //add-1998-cmo-2
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
+  ak_wcurve_mul( u1, wp1->x, wp2->z, ec );
+  ak_wcurve_mul( u2, wp1->y, wp2->z, ec );
   ak_mpzn_sub( u2, ec->p, u2, ec->size );
-  ak_mpzn_mul_montgomery( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( u4, u4, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u5, u4, u4, ec->p, ec->n, ec->size );
+  ak_wcurve_mul( u3, wp1->z, wp2->z, ec );
+  ak_wcurve_mul( u4, wp2->y, wp1->z, ec );
+  ak_wcurve_add( u4, u4, u2, ec );
+  ak_wcurve_sqr( u5, u4, ec );
   ak_mpzn_sub( u7, ec->p, u1, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( wp1->x, wp1->x, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u7, wp1->x, wp1->x, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u6, u7, wp1->x, ec->p, ec->n, ec->size);
-  ak_mpzn_mul_montgomery( u1, u7, u1, ec->p, ec->n, ec->size );
-  ak_mpzn_lshift_montgomery( u7, u1, ec->p, ec->size );
-  ak_mpzn_add_montgomery( u7, u7, u6, ec->p, ec->size );
+  ak_wcurve_mul( wp1->x, wp2->x, wp1->z, ec );
+  ak_wcurve_add( wp1->x, wp1->x, u7, ec );
+  ak_wcurve_sqr( u7, wp1->x, ec );
+  ak_wcurve_mul( u6, u7, wp1->x, ec );
+  ak_wcurve_mul( u1, u7, u1, ec );
+  ak_wcurve_lshift( u7, u1, ec );
+  ak_wcurve_add( u7, u7, u6, ec );
   ak_mpzn_sub( u7, ec->p, u7, ec->size );
-  ak_mpzn_mul_montgomery( u5, u5, u3, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( u5, u5, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, u2, u6, ec->p, ec->n, ec->size );
+  ak_wcurve_mul( u5, u5, u3, ec );
+  ak_wcurve_add( u5, u5, u7, ec );
+  ak_wcurve_mul( wp1->x, wp1->x, u5, ec );
+  ak_wcurve_mul( u2, u2, u6, ec );
   ak_mpzn_sub( u5, ec->p, u5, ec->size );
-  ak_mpzn_add_montgomery( u1, u1, u5, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->y, u4, u1, ec->p, ec->n, ec->size );
-  ak_mpzn_add_montgomery( wp1->y, wp1->y, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->z, u6, u3, ec->p, ec->n, ec->size );
+  ak_wcurve_add( u1, u1, u5, ec );
+  ak_wcurve_mul( wp1->y, u4, u1, ec );
+  ak_wcurve_add( wp1->y, wp1->y, u2, ec );
+  ak_wcurve_mul( wp1->z, u6, u3, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -571,29 +675,920 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_reduce( ak_wpoint wp, ak_wcurve ec )
 {
- ak_mpznmax u, one = ak_mpznmax_one;
+ ak_mpznmax u;
  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
    ak_wpoint_set_as_unit( wp, ec );
    return;
  }
 
- ak_mpzn_set_ui( u, ec->size, 2 );
- ak_mpzn_sub( u, ec->p, u, ec->size );
- ak_mpzn_modpow_montgomery( u, wp->z, u, ec->p, ec->n, ec->size ); // u <- z^{p-2} (mod p)
- ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
+ ak_wcurve_inverse( u, wp->z, ec ); // u <- z^{-1} (mod p)
+ ak_wcurve_from( u, u, ec );
 
- ak_mpzn_mul_montgomery( wp->x, wp->x, u, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->y, wp->y, u, ec->p, ec->n, ec->size );
+ ak_wcurve_mul( wp->x, wp->x, u, ec );
+ ak_wcurve_mul( wp->y, wp->y, u, ec );
  ak_mpzn_set_ui( wp->z, ec->size, 1 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Совместное обращение вычетов в используемом кривой представлении.
+
+    Для арифметики Монтгомери вызывается функция ak_mpzn_inverse_batch_montgomery();
+    для специализированной арифметики используется тот же прием: одно обращение
+    произведения всех вычетов и три умножения на каждый вычет.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_inverse_batch( ak_uint64 **x, const size_t count, ak_uint64 *buffer,
+                                                                                    ak_wcurve ec )
+{
+  size_t i = 0;
+  ak_mpznmax u, t;
+
+  if( ec->field == NULL ) {
+    ak_mpzn_inverse_batch_montgomery( x, count, buffer, ec->p, ec->n, ec->r2, ec->size );
+    return;
+  }
+  if( !count ) return;
+ /* прямой проход: buffer[i] = x[0]*...*x[i] */
+  ak_mpzn_set( buffer, x[0], ec->size );
+  for( i = 1; i < count; i++ )
+     ak_wcurve_mul( buffer +i*ec->size, buffer +(i-1)*ec->size, x[i], ec );
+
+  ak_wcurve_inverse( u, buffer +(count-1)*ec->size, ec );
+
+ /* обратный проход: u = (x[0]*...*x[i])^{-1} */
+  for( i = count-1; i > 0; i-- ) {
+     ak_wcurve_mul( t, u, buffer +(i-1)*ec->size, ec );
+     ak_wcurve_mul( u, u, x[i], ec );
+     ak_mpzn_set( x[i], t, ec->size );
+  }
+  ak_mpzn_set( x[0], u, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество точек, совместно приводимых к аффинной форме за одно обращение. */
+ #define ak_wpoint_reduce_batch_size   (64)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Совместное приведение массива точек к аффинной форме.
+
+    Если флаг `internal` ложен, то точки приводятся к виду \f$ (x:y:1) \f$, совпадающему
+    с результатом функции ak_wpoint_reduce(). В противном случае аффинные координаты
+    точек сохраняются в представлении, используемом арифметикой кривой (представлении
+    Монтгомери, либо обычном представлении для кривых со специализированной арифметикой),
+    а координата \f$ z \f$ принимает значение единицы в этом представлении; такие точки
+    используются в таблицах кратных точек при сложении в смешанных координатах.                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_reduce_batch_internal( ak_wpoint wp, const size_t count,
+                                                            const bool_t internal, ak_wcurve ec )
+{
+  size_t i = 0, j = 0, cnt = 0;
+  ak_mpznmax unit;
+  ak_uint64 *z[ ak_wpoint_reduce_batch_size ];
+  ak_wpoint pts[ ak_wpoint_reduce_batch_size ];
+  ak_uint64 buffer[ ak_wpoint_reduce_batch_size*ak_mpzn512_size ];
+
+  ak_wcurve_one( unit, ec );
+  for( i = 0; i < count; i = j ) {
+    /* выбираем очередную группу точек, отличных от бесконечно удаленной */
+     for( j = i, cnt = 0; ( j < count ) && ( cnt < ak_wpoint_reduce_batch_size ); j++ ) {
+        if( ak_mpzn_cmp_ui( wp[j].z, ec->size, 0 ) == ak_true ) {
+          ak_wpoint_set_as_unit( wp+j, ec );
+          continue;
+        }
+        pts[cnt] = wp+j;
+        z[cnt++] = wp[j].z;
+     }
+     ak_wcurve_inverse_batch( z, cnt, buffer, ec );
+     while( cnt-- > 0 ) {
+        if( !internal )
+          ak_wcurve_from( pts[cnt]->z, pts[cnt]->z, ec );
+        ak_wcurve_mul( pts[cnt]->x, pts[cnt]->x, pts[cnt]->z, ec );
+        ak_wcurve_mul( pts[cnt]->y, pts[cnt]->y, pts[cnt]->z, ec );
+        if( internal ) ak_mpzn_set( pts[cnt]->z, unit, ec->size );
+         else ak_mpzn_set_ui( pts[cnt]->z, ec->size, 1 );
+     }
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция приводит к аффинной форме массив из `count` точек. Вместо отдельного обращения
+    координаты \f$ z \f$ для каждой точки выполняется совместное обращение
+    (см. ak_mpzn_inverse_batch_montgomery()), что заменяет одно обращение на
+    одну точку тремя умножениями. Результат совпадает с результатом последовательного
+    вызова функции ak_wpoint_reduce() для каждой точки массива.
+
+    @param wp Массив точек кривой, которые приводятся к аффинной форме
+    @param count Количество точек в массиве
+    @param ec Эллиптическая кривая, которой принадлежат точки                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_reduce_batch( ak_wpoint wp, const size_t count, ak_wcurve ec )
+{
+  ak_wpoint_reduce_batch_internal( wp, count, ak_false, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                               вычисления в координатах Якоби                                    */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет, что коэффициент \f$ a \f$ эллиптической кривой равен \f$ -3 \f$.
+
+    Для таких кривых (например, для кривых id-tc26-gost-3410-2012-512-paramSetA и
+    id-tc26-gost-3410-2012-256-paramSetB) удвоение точки в координатах Якоби
+    выполняется с меньшим количеством умножений.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_is_a_minus_three( ak_wcurve ec )
+{
+  ak_mpznmax t, three = ak_mpznmax_zero;
+
+  three[0] = 3;
+  ak_mpzn_mul_montgomery( three, three, ec->r2, ec->p, ec->n, ec->size );
+  ak_mpzn_sub( t, ec->p, ec->a, ec->size );
+ return ( ak_mpzn_cmp( t, three, ec->size ) == 0 ) ? ak_true : ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование точки из проективных координат в координаты Якоби.
+
+    Точке \f$ P = (x:y:z) \f$ сопоставляется тройка \f$ (X:Y:Z) = (xz:yz^2:z) \f$,
+    для которой аффинные координаты точки равны \f$ (X/Z^2, Y/Z^3) \f$.
+    Вычисления выполняются в арифметике, определенной для кривой (см. \ref wfield).              */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_jacobian_set( ak_wpoint wj, ak_wpoint wp, ak_wcurve ec )
+{
+  ak_mpznmax t;
+
+  ak_wcurve_sqr( t, wp->z, ec );
+  ak_wcurve_mul( wj->y, wp->y, t, ec );
+  ak_wcurve_mul( wj->x, wp->x, wp->z, ec );
+  if( wj != wp ) ak_mpzn_set( wj->z, wp->z, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование точки из координат Якоби \f$ (X:Y:Z) \f$ в проективные
+    координаты \f$ (XZ:Y:Z^3) \f$.                                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_jacobian_get( ak_wpoint wp, ak_wpoint wj, ak_wcurve ec )
+{
+  ak_mpznmax t;
+
+  ak_wcurve_mul( wp->x, wj->x, wj->z, ec );
+  if( wp != wj ) ak_mpzn_set( wp->y, wj->y, ec->size );
+  ak_wcurve_sqr( t, wj->z, ec );
+  ak_wcurve_mul( wp->z, t, wj->z, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки, заданной в координатах Якоби.
+
+    Для кривых с коэффициентом \f$ a = -3 \f$ используются соотношения dbl-2001-b
+    (3M + 5S), в общем случае -- соотношения dbl-2007-bl (1M + 8S + 1M на умножение на \f$ a \f$),
+    см. <a href="http://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian.html">Explicit-Formulas
+    Database</a>.
+
+    \code
+      dbl-2001-b:                          dbl-2007-bl:
+        delta = Z^2                          XX = X^2, YY = Y^2, YYYY = YY^2, ZZ = Z^2
+        gamma = Y^2                          S = 2*((X+YY)^2-XX-YYYY)
+        beta = X*gamma                       M = 3*XX+a*ZZ^2
+        alpha = 3*(X-delta)*(X+delta)        X3 = M^2-2*S
+        X3 = alpha^2-8*beta                  Y3 = M*(S-X3)-8*YYYY
+        Z3 = (Y+Z)^2-gamma-delta             Z3 = (Y+Z)^2-YY-ZZ
+        Y3 = alpha*(4*beta-X3)-8*gamma^2
+    \endcode
+
+    @param wj удваиваемая точка в координатах Якоби.
+    @param minus3 флаг того, что коэффициент \f$ a \f$ кривой равен \f$ -3 \f$.
+    @param ec эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_jacobian_double( ak_wpoint wj, const bool_t minus3, ak_wcurve ec )
+{
+  ak_mpznmax u1, u2, u3, u4, u5;
+
+  if( ak_mpzn_cmp_ui( wj->z, ec->size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( wj->y, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_as_unit( wj, ec );
+    return;
+  }
+
+  ak_wcurve_sqr( u1, wj->z, ec ); // u1 = Z^2
+  ak_wcurve_sqr( u2, wj->y, ec ); // u2 = Y^2
+ /* Z3 = (Y+Z)^2 - Y^2 - Z^2 */
+  ak_wcurve_add( u5, wj->y, wj->z, ec );
+  ak_wcurve_sqr( u5, u5, ec );
+  ak_wcurve_sub( u5, u5, u2, ec );
+  ak_wcurve_sub( wj->z, u5, u1, ec );
+
+  if( minus3 ) {
+    ak_wcurve_mul( u3, wj->x, u2, ec ); // u3 = beta = X*Y^2
+    ak_wcurve_sub( u4, wj->x, u1, ec );
+    ak_wcurve_add( u5, wj->x, u1, ec );
+    ak_wcurve_mul( u4, u4, u5, ec );
+    ak_wcurve_lshift( u5, u4, ec );
+    ak_wcurve_add( u4, u4, u5, ec );        // u4 = alpha = 3(X-Z^2)(X+Z^2)
+    ak_wcurve_lshift( u3, u3, ec );
+    ak_wcurve_lshift( u3, u3, ec );         // u3 = 4*beta
+    ak_wcurve_sqr( u2, u2, ec ); // u2 = Y^4
+  } else {
+    ak_wcurve_sqr( u3, wj->x, ec ); // u3 = X^2
+    ak_wcurve_sqr( u1, u1, ec );
+    ak_wcurve_mul_a( u1, u1, ec );
+    ak_wcurve_lshift( u4, u3, ec );
+    ak_wcurve_add( u4, u4, u3, ec );
+    ak_wcurve_add( u4, u4, u1, ec );        // u4 = M = 3X^2 + aZ^4
+    ak_wcurve_add( u5, wj->x, u2, ec );
+    ak_wcurve_sqr( u5, u5, ec );
+    ak_wcurve_sub( u5, u5, u3, ec );
+    ak_wcurve_sqr( u2, u2, ec ); // u2 = Y^4
+    ak_wcurve_sub( u5, u5, u2, ec );
+    ak_wcurve_lshift( u3, u5, ec );         // u3 = S = 4XY^2
+  }
+ /* в обоих случаях u2 = Y^4, u3 = 4XY^2, u4 = M, тогда X3 = M^2 - 2*u3 */
+  ak_wcurve_sqr( u5, u4, ec );
+  ak_wcurve_lshift( u1, u3, ec );
+  ak_wcurve_sub( wj->x, u5, u1, ec );
+ /* Y3 = M*(u3 - X3) - 8Y^4 */
+  ak_wcurve_sub( u3, u3, wj->x, ec );
+  ak_wcurve_mul( u3, u3, u4, ec );
+  ak_wcurve_lshift( u2, u2, ec );
+  ak_wcurve_lshift( u2, u2, ec );
+  ak_wcurve_lshift( u2, u2, ec );
+  ak_wcurve_sub( wj->y, u3, u2, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Завершающий шаг сложения точек в координатах Якоби.
+
+    По значениям \f$ U_1 \f$, \f$ S_1 \f$, \f$ H = U_2 - U_1 \f$ и \f$ r = 2(S_2 - S_1) \f$
+    функция вычисляет координаты \f$ X_3 \f$ и \f$ Y_3 \f$ суммы точек:
+    \code
+      I = (2*H)^2, J = H*I, V = U1*I
+      X3 = r^2-J-2*V
+      Y3 = r*(V-X3)-2*S1*J
+    \endcode                                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_jacobian_add_finalize( ak_wpoint wj, ak_uint64 *u1, ak_uint64 *s1,
+                                                     ak_uint64 *h, ak_uint64 *r, ak_wcurve ec )
+{
+  ak_mpznmax i, j;
+
+  ak_wcurve_lshift( i, h, ec );
+  ak_wcurve_sqr( i, i, ec );
+  ak_wcurve_mul( j, h, i, ec );
+  ak_wcurve_mul( u1, u1, i, ec );   // u1 = V
+  ak_wcurve_sqr( i, r, ec );
+  ak_wcurve_sub( i, i, j, ec );
+  ak_wcurve_sub( i, i, u1, ec );
+  ak_wcurve_sub( wj->x, i, u1, ec );
+  ak_wcurve_sub( u1, u1, wj->x, ec );
+  ak_wcurve_mul( u1, u1, r, ec );
+  ak_wcurve_mul( j, j, s1, ec );
+  ak_wcurve_lshift( j, j, ec );
+  ak_wcurve_sub( wj->y, u1, j, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точек, заданных в координатах Якоби (соотношения add-2007-bl, 11M + 5S).
+
+    \code
+      Z1Z1 = Z1^2, Z2Z2 = Z2^2
+      U1 = X1*Z2Z2, U2 = X2*Z1Z1
+      S1 = Y1*Z2*Z2Z2, S2 = Y2*Z1*Z1Z1
+      H = U2-U1, r = 2*(S2-S1)
+      Z3 = ((Z1+Z2)^2-Z1Z1-Z2Z2)*H
+    \endcode
+    Координаты \f$ X_3, Y_3 \f$ вычисляются функцией ak_wpoint_jacobian_add_finalize().
+
+    @param wj первое слагаемое, в которое помещается результат.
+    @param wk второе слагаемое.
+    @param minus3 флаг того, что коэффициент \f$ a \f$ кривой равен \f$ -3 \f$.
+    @param ec эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_jacobian_add( ak_wpoint wj, ak_wpoint wk, const bool_t minus3, ak_wcurve ec )
+{
+  ak_mpznmax z1z1, z2z2, u1, u2, s1, s2;
+
+  if( ak_mpzn_cmp_ui( wk->z, ec->size, 0 ) == ak_true ) return;
+  if( ak_mpzn_cmp_ui( wj->z, ec->size, 0 ) == ak_true ) {
+    ak_wpoint_set_wpoint( wj, wk, ec );
+    return;
+  }
+
+  ak_wcurve_sqr( z1z1, wj->z, ec );
+  ak_wcurve_sqr( z2z2, wk->z, ec );
+  ak_wcurve_mul( u1, wj->x, z2z2, ec );
+  ak_wcurve_mul( u2, wk->x, z1z1, ec );
+  ak_wcurve_mul( s1, wj->y, wk->z, ec );
+  ak_wcurve_mul( s1, s1, z2z2, ec );
+  ak_wcurve_mul( s2, wk->y, wj->z, ec );
+  ak_wcurve_mul( s2, s2, z1z1, ec );
+  ak_wcurve_sub( u2, u2, u1, ec );         // u2 = H
+  ak_wcurve_sub( s2, s2, s1, ec );
+  ak_wcurve_lshift( s2, s2, ec );          // s2 = r
+
+ /* случай совпадения x-координат: удвоение или бесконечно удаленная точка */
+  if( ak_mpzn_cmp_ui( u2, ec->size, 0 ) == ak_true ) {
+    if( ak_mpzn_cmp_ui( s2, ec->size, 0 ) == ak_true ) ak_wpoint_jacobian_double( wj, minus3, ec );
+     else ak_wpoint_set_as_unit( wj, ec );
+    return;
+  }
+
+  ak_wcurve_add( wj->z, wj->z, wk->z, ec );
+  ak_wcurve_sqr( wj->z, wj->z, ec );
+  ak_wcurve_sub( wj->z, wj->z, z1z1, ec );
+  ak_wcurve_sub( wj->z, wj->z, z2z2, ec );
+  ak_wcurve_mul( wj->z, wj->z, u2, ec );
+  ak_wpoint_jacobian_add_finalize( wj, u1, s1, u2, s2, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точки в координатах Якоби с точкой, заданной аффинными координатами
+    во внутреннем представлении (смешанные координаты, соотношения madd-2007-bl, 7M + 4S).
+
+    \code
+      Z1Z1 = Z1^2
+      U2 = X2*Z1Z1, S2 = Y2*Z1*Z1Z1
+      H = U2-X1, r = 2*(S2-Y1)
+      Z3 = (Z1+H)^2-Z1Z1-H^2
+    \endcode
+    Координаты \f$ X_3, Y_3 \f$ вычисляются функцией ak_wpoint_jacobian_add_finalize()
+    при \f$ U_1 = X_1, S_1 = Y_1 \f$.
+
+    @param wj первое слагаемое в координатах Якоби, в которое помещается результат.
+    @param x аффинная координата x второго слагаемого.
+    @param y аффинная координата y второго слагаемого.
+    @param minus3 флаг того, что коэффициент \f$ a \f$ кривой равен \f$ -3 \f$.
+    @param ec эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_jacobian_add_affine( ak_wpoint wj, ak_uint64 *x, ak_uint64 *y,
+                                                             const bool_t minus3, ak_wcurve ec )
+{
+  ak_mpznmax z1z1, u1, s1, u2, s2;
+
+  if( ak_mpzn_cmp_ui( wj->z, ec->size, 0 ) == ak_true ) {
+    ak_mpzn_set( wj->x, x, ec->size );
+    ak_mpzn_set( wj->y, y, ec->size );
+    ak_wcurve_one( wj->z, ec );
+    return;
+  }
+
+  ak_wcurve_sqr( z1z1, wj->z, ec );
+  ak_wcurve_mul( u2, x, z1z1, ec );
+  ak_wcurve_mul( s2, y, wj->z, ec );
+  ak_wcurve_mul( s2, s2, z1z1, ec );
+  ak_wcurve_sub( u2, u2, wj->x, ec );      // u2 = H
+  ak_wcurve_sub( s2, s2, wj->y, ec );
+  ak_wcurve_lshift( s2, s2, ec );          // s2 = r
+
+ /* случай совпадения x-координат: удвоение или бесконечно удаленная точка */
+  if( ak_mpzn_cmp_ui( u2, ec->size, 0 ) == ak_true ) {
+    if( ak_mpzn_cmp_ui( s2, ec->size, 0 ) == ak_true ) ak_wpoint_jacobian_double( wj, minus3, ec );
+     else ak_wpoint_set_as_unit( wj, ec );
+    return;
+  }
+
+  ak_mpzn_set( u1, wj->x, ec->size );
+  ak_mpzn_set( s1, wj->y, ec->size );
+  ak_wcurve_add( wj->z, wj->z, u2, ec );
+  ak_wcurve_sqr( wj->z, wj->z, ec );
+  ak_wcurve_sub( wj->z, wj->z, z1z1, ec );
+  ak_wcurve_sqr( z1z1, u2, ec );
+  ak_wcurve_sub( wj->z, wj->z, z1z1, ec );
+  ak_wpoint_jacobian_add_finalize( wj, u1, s1, u2, s2, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                          вычисления в скрученной форме Эдвардса                                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры эллиптических кривых, бирационально эквивалентных скрученным кривым Эдвардса.
+
+    Рекомендации Р 50.1.114-2016 определяют кривые id-tc26-gost-3410-2012-256-paramSetA и
+    id-tc26-gost-3410-2012-512-paramSetC как кривые в форме Вейерштрасса, эквивалентные
+    скрученным кривым Эдвардса \f$ eu^2 + v^2 = 1 + du^2v^2 \f$ с параметром \f$ e = 1 \f$.
+    Переход между формами задается соотношениями
+    \f$ x = s\frac{1+v}{1-v} + t, \quad y = s\frac{1+v}{(1-v)u} \f$,
+    где \f$ s = (e-d)/4, \quad t = (e+d)/6 \f$. Поскольку величина \f$ d \f$ является
+    квадратичным невычетом, а \f$ e \f$ -- квадратичным вычетом, формулы сложения точек
+    кривой Эдвардса полны, то есть справедливы для любых двух точек кривой.
+
+    Константы хранятся в обычном представлении; кривая определяется своими параметрами
+    \f$ p, a, b \f$, а не адресом контекста.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static const struct wcurve_edwards_parameters {
+  /*! \brief Эллиптическая кривая в короткой форме Вейерштрасса. */
+   const struct wcurve *curve;
+  /*! \brief Величина \f$ s = (e-d)/4 \pmod{p} \f$. */
+   ak_uint64 s[ak_mpzn512_size];
+  /*! \brief Величина \f$ t = (e+d)/6 \pmod{p} \f$. */
+   ak_uint64 t[ak_mpzn512_size];
+  /*! \brief Параметр \f$ d \f$ кривой Эдвардса. */
+   ak_uint64 d[ak_mpzn512_size];
+ } wcurve_edwards_parameters[] = {
+  { &id_tc26_gost_3410_2012_256_paramSetA,
+    { 0x06b74f34a48e0ecdLL, 0x35188275da3fd942LL, 0xaa1d0f18c14ab9fbLL, 0x7e7e82520f9f015fLL },
+    { 0xa63075dce7a14aaaLL, 0x8744fe5c192ac47eLL, 0x8e974b44d478d958LL, 0x0100fe73f595ff15LL },
+    { 0xe522c32d6dc7bffbLL, 0x2b9df62897009af7LL, 0x578bc39cfad51813LL, 0x0605f6b7c183fa81LL }},
+  { &id_tc26_gost_3410_2012_512_paramSetC,
+    { 0xcd73f4913304621eLL, 0x5b97cc0f50f57752LL, 0x3ec74c6f06187258LL, 0xd653187d6ba8fe53LL,
+      0x0875d7e77bebef18LL, 0x952ff4aaf99c7385LL, 0x3b168c30c829006cLL, 0x186c289cffa09c98LL },
+    { 0x21b2b249ddfd1271LL, 0x6d9acd4b1f5c5b1eLL, 0xd625cd0b5145091aLL, 0xc6734501b83a011dLL,
+      0xfa5c1abb02b80b44LL, 0x9c8ab238aeed0851LL, 0xd89ba28a2539ffb7LL, 0x9a628f975594ecefLL },
+    { 0xca302dbb33ee7550LL, 0x91a0cfc2bc2a22b4LL, 0x04e2ce43e79e369eLL, 0xa6b39e0a515c06b3LL,
+      0xde28a0621050439cLL, 0xab402d54198e31ebLL, 0x13a5cf3cdf5bfe4dLL, 0x9e4f5d8c017d8d9fLL }}
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Константы перехода к форме Эдвардса во внутреннем представлении вычетов. */
+ typedef struct wedwards {
+  /*! \brief Величина \f$ s \f$. */
+   ak_uint64 s[ak_mpzn512_size];
+  /*! \brief Величина \f$ t \f$. */
+   ak_uint64 t[ak_mpzn512_size];
+  /*! \brief Параметр \f$ d \f$ кривой Эдвардса. */
+   ak_uint64 d[ak_mpzn512_size];
+ } *ak_wedwards;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Точка кривой Эдвардса в расширенных проективных координатах.
+
+    Четверка \f$ (X:Y:T:Z) \f$ задает точку \f$ (u,v) = (X/Z, Y/Z) \f$, при этом
+    \f$ T = XY/Z \f$. Нейтральным элементом группы является точка \f$ (0:1:0:1) \f$.            */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct epoint {
+  /*! \brief Координата \f$ X \f$. */
+   ak_uint64 x[ak_mpzn512_size];
+  /*! \brief Координата \f$ Y \f$. */
+   ak_uint64 y[ak_mpzn512_size];
+  /*! \brief Координата \f$ T \f$. */
+   ak_uint64 t[ak_mpzn512_size];
+  /*! \brief Координата \f$ Z \f$. */
+   ak_uint64 z[ak_mpzn512_size];
+ } *ak_epoint;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет, эквивалентна ли кривая скрученной кривой Эдвардса, и, если да,
+    вычисляет константы перехода к форме Эдвардса.
+
+    @param ed Контекст, в который помещаются константы.
+    @param ec Эллиптическая кривая.
+    @return Функция возвращает \ref ak_true, если кривая эквивалентна кривой Эдвардса.
+    В противном случае возвращается \ref ak_false.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wcurve_edwards_set( ak_wedwards ed, ak_wcurve ec )
+{
+  size_t i = 0;
+  const struct wcurve_edwards_parameters *ep = NULL;
+
+  for( i = 0; i < sizeof( wcurve_edwards_parameters )/sizeof( wcurve_edwards_parameters[0] ); i++ ) {
+     ep = &wcurve_edwards_parameters[i];
+     if(( ep->curve->size != ec->size ) ||
+        ( ak_mpzn_cmp( (ak_uint64 *)ep->curve->p, ec->p, ec->size ) != 0 ) ||
+        ( ak_mpzn_cmp( (ak_uint64 *)ep->curve->a, ec->a, ec->size ) != 0 ) ||
+        ( ak_mpzn_cmp( (ak_uint64 *)ep->curve->b, ec->b, ec->size ) != 0 )) continue;
+
+     if( ec->field == NULL ) {
+       ak_mpzn_mul_montgomery( ed->s, (ak_uint64 *)ep->s, ec->r2, ec->p, ec->n, ec->size );
+       ak_mpzn_mul_montgomery( ed->t, (ak_uint64 *)ep->t, ec->r2, ec->p, ec->n, ec->size );
+       ak_mpzn_mul_montgomery( ed->d, (ak_uint64 *)ep->d, ec->r2, ec->p, ec->n, ec->size );
+     } else {
+         ak_mpzn_set( ed->s, (ak_uint64 *)ep->s, ec->size );
+         ak_mpzn_set( ed->t, (ak_uint64 *)ep->t, ec->size );
+         ak_mpzn_set( ed->d, (ak_uint64 *)ep->d, ec->size );
+       }
+     return ak_true;
+  }
+ return ak_false;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Присвоение точке кривой Эдвардса значения нейтрального элемента \f$ (0:1:0:1) \f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_set_as_unit( ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpzn_set_ui( ep->x, ec->size, 0 );
+  ak_mpzn_set_ui( ep->t, ec->size, 0 );
+  ak_wcurve_one( ep->y, ec );
+  ak_mpzn_set( ep->z, ep->y, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переход от точки кривой в форме Вейерштрасса к точке кривой Эдвардса.
+
+    Для точки \f$ (X:Y:Z) \f$ вычисляются величины \f$ A = X - tZ \f$,
+    \f$ B_{-} = A - sZ \f$, \f$ B_{+} = A + sZ \f$, после чего точка кривой Эдвардса
+    принимает вид \f$ (AB_{+} : B_{-}Y : AB_{-} : YB_{+}) \f$. Бесконечно удаленной точке
+    сопоставляется нейтральный элемент.
+
+    @return Функция возвращает \ref ak_false, если точка является исключительной для
+    отображения (точка второго порядка); в этом случае вычисления должны выполняться
+    в форме Вейерштрасса.                                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_set_wpoint( ak_epoint ep, ak_wpoint wp, ak_wedwards ed, ak_wcurve ec )
+{
+  ak_mpznmax a, bm, bp;
+
+  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
+    ak_epoint_set_as_unit( ep, ec );
+    return ak_true;
+  }
+  ak_wcurve_mul( a, ed->t, wp->z, ec );
+  ak_wcurve_sub( a, wp->x, a, ec );
+  ak_wcurve_mul( bp, ed->s, wp->z, ec );
+  ak_wcurve_sub( bm, a, bp, ec );
+  ak_wcurve_add( bp, a, bp, ec );
+
+  ak_wcurve_mul( ep->z, wp->y, bp, ec );
+  if( ak_mpzn_cmp_ui( ep->z, ec->size, 0 ) == ak_true ) return ak_false;
+  ak_wcurve_mul( ep->x, a, bp, ec );
+  ak_wcurve_mul( ep->y, bm, wp->y, ec );
+  ak_wcurve_mul( ep->t, a, bm, ec );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переход от точки кривой Эдвардса к точке кривой в форме Вейерштрасса.
+
+    Для точки \f$ (X:Y:T:Z) \f$ вычисляется точка
+    \f$ ((s(Z+Y) + t(Z-Y))X : s(Z+Y)Z : (Z-Y)X) \f$. Точкам \f$ (0:\pm 1) \f$ сопоставляются
+    бесконечно удаленная точка и точка \f$ (t:0:1) \f$ второго порядка.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_get_wpoint( ak_wpoint wp, ak_epoint ep, ak_wedwards ed, ak_wcurve ec )
+{
+  ak_mpznmax zp, zm, u;
+
+  if( ak_mpzn_cmp_ui( ep->x, ec->size, 0 ) == ak_true ) {
+    if( ak_mpzn_cmp( ep->y, ep->z, ec->size ) == 0 ) ak_wpoint_set_as_unit( wp, ec );
+     else {
+       ak_mpzn_set( wp->x, ed->t, ec->size );
+       ak_mpzn_set_ui( wp->y, ec->size, 0 );
+       ak_wcurve_one( wp->z, ec );
+     }
+    return;
+  }
+  ak_wcurve_add( zp, ep->z, ep->y, ec );
+  ak_wcurve_sub( zm, ep->z, ep->y, ec );
+  ak_wcurve_mul( zp, zp, ed->s, ec );
+  ak_wcurve_mul( u, zm, ed->t, ec );
+  ak_wcurve_add( u, u, zp, ec );
+
+  ak_wcurve_mul( wp->y, zp, ep->z, ec );
+  ak_wcurve_mul( wp->z, zm, ep->x, ec );
+  ak_wcurve_mul( wp->x, u, ep->x, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удвоение точки кривой Эдвардса в расширенных координатах.
+
+    Используются соотношения dbl-2008-hwcd из работы H.Hisil, K.Wong, G.Carter, E.Dawson,
+    <a href="http://eprint.iacr.org/2008/522">Twisted Edwards curves revisited</a>, 2008.
+
+    \code
+      A = X1^2
+      B = Y1^2
+      C = 2*Z1^2
+      E = (X1+Y1)^2-A-B
+      G = A+B
+      F = G-C
+      H = A-B
+      X3 = E*F
+      Y3 = G*H
+      T3 = E*H
+      Z3 = F*G
+    \endcode
+
+    Координата \f$ T \f$ при удвоении не используется, поэтому ее вычисление может быть
+    опущено, если следующей операцией также является удвоение.
+
+    @param ep Удваиваемая точка.
+    @param extended Флаг необходимости вычисления координаты \f$ T \f$.
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_double( ak_epoint ep, const bool_t extended, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, e, g;
+
+  ak_wcurve_sqr( a, ep->x, ec );
+  ak_wcurve_sqr( b, ep->y, ec );
+  ak_wcurve_sqr( c, ep->z, ec );
+  ak_wcurve_lshift( c, c, ec );
+  ak_wcurve_add( e, ep->x, ep->y, ec );
+  ak_wcurve_sqr( e, e, ec );
+  ak_wcurve_add( g, a, b, ec );
+  ak_wcurve_sub( e, e, g, ec );
+  ak_wcurve_sub( c, g, c, ec );    // c = F
+  ak_wcurve_sub( a, a, b, ec );    // a = H
+
+  ak_wcurve_mul( ep->x, e, c, ec );
+  ak_wcurve_mul( ep->y, g, a, ec );
+  if( extended ) ak_wcurve_mul( ep->t, e, a, ec );
+  ak_wcurve_mul( ep->z, c, g, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение точки кривой Эдвардса с точкой, для которой вычислено значение \f$ dT \f$.
+
+    Используются полные соотношения add-2008-hwcd (см. ak_epoint_double()),
+    справедливые для любых, в том числе совпадающих, точек кривой.
+
+    \code
+      A = X1*X2
+      B = Y1*Y2
+      C = T1*dT2
+      D = Z1*Z2
+      E = (X1+Y1)*(X2+Y2)-A-B
+      F = D-C
+      G = D+C
+      H = B-A
+      X3 = E*F
+      Y3 = G*H
+      T3 = E*H
+      Z3 = F*G
+    \endcode
+
+    @param ep Первое слагаемое, в которое помещается результат.
+    @param x Координата \f$ X_2 \f$ второго слагаемого.
+    @param y Координата \f$ Y_2 \f$ второго слагаемого.
+    @param dt Величина \f$ dT_2 \f$ для второго слагаемого.
+    @param z Координата \f$ Z_2 \f$ второго слагаемого; если значение равно NULL,
+    то второе слагаемое задано аффинными координатами (\f$ Z_2 = 1 \f$).
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_add_internal( ak_epoint ep, ak_uint64 *x, ak_uint64 *y, ak_uint64 *dt,
+                                                                     ak_uint64 *z, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, e, f;
+
+  ak_wcurve_mul( a, ep->x, x, ec );
+  ak_wcurve_mul( b, ep->y, y, ec );
+  ak_wcurve_mul( c, ep->t, dt, ec );
+  if( z != NULL ) ak_wcurve_mul( ep->z, ep->z, z, ec );
+  ak_wcurve_add( e, ep->x, ep->y, ec );
+  ak_wcurve_add( f, x, y, ec );
+  ak_wcurve_mul( e, e, f, ec );
+  ak_wcurve_sub( e, e, a, ec );
+  ak_wcurve_sub( e, e, b, ec );
+  ak_wcurve_sub( f, ep->z, c, ec );
+  ak_wcurve_add( c, ep->z, c, ec );   // c = G
+  ak_wcurve_sub( b, b, a, ec );       // b = H
+
+  ak_wcurve_mul( ep->x, e, f, ec );
+  ak_wcurve_mul( ep->y, c, b, ec );
+  ak_wcurve_mul( ep->t, e, b, ec );
+  ak_wcurve_mul( ep->z, f, c, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение двух точек кривой Эдвардса, заданных расширенными координатами. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_add( ak_epoint ep1, ak_epoint ep2, ak_wedwards ed, ak_wcurve ec )
+{
+  ak_mpznmax dt;
+
+  ak_wcurve_mul( dt, ep2->t, ed->d, ec );
+  ak_epoint_add_internal( ep1, ep2->x, ep2->y, dt, ep2->z, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция переводит массив точек кривой в форме Вейерштрасса в аффинные точки
+    кривой Эдвардса.
+
+    Для каждой точки в массив `out` последовательно помещаются величины \f$ u, v, duv \f$
+    во внутреннем представлении. Координаты \f$ Z \f$ обращаются совместно
+    (см. ak_wcurve_inverse_batch()).
+
+    @return Функция возвращает \ref ak_false, если одна из точек является исключительной
+    для отображения, либо если не удалось выделить память.                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_set_affine_array( ak_uint64 *out, struct wpoint *wp, const size_t count,
+                                                                   ak_wedwards ed, ak_wcurve ec )
+{
+  size_t i = 0;
+  bool_t result = ak_false;
+  struct epoint *ep = NULL;
+  ak_uint64 **z = NULL, *buffer = NULL, *ptr = NULL;
+
+  if((( ep = malloc( count*sizeof( struct epoint ))) == NULL ) ||
+     (( z = malloc( count*sizeof( ak_uint64 * ))) == NULL ) ||
+     (( buffer = malloc( count*ec->size*sizeof( ak_uint64 ))) == NULL )) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    goto exit;
+  }
+  for( i = 0; i < count; i++ ) {
+     if( !ak_epoint_set_wpoint( ep+i, wp+i, ed, ec )) goto exit;
+     z[i] = ep[i].z;
+  }
+  ak_wcurve_inverse_batch( z, count, buffer, ec );
+  for( i = 0, ptr = out; i < count; i++, ptr += 3*ec->size ) {
+     ak_wcurve_mul( ptr, ep[i].x, ep[i].z, ec );
+     ak_wcurve_mul( ptr +ec->size, ep[i].y, ep[i].z, ec );
+     ak_wcurve_mul( ptr +2*ec->size, ptr, ptr +ec->size, ec );
+     ak_wcurve_mul( ptr +2*ec->size, ptr +2*ec->size, ed->d, ec );
+  }
+  result = ak_true;
+
+ exit:
+  if( buffer != NULL ) free( buffer );
+  if( z != NULL ) free( z );
+  if( ep != NULL ) free( ep );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                      вычисление кратных точек с фиксированной шириной окна                      */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ширина окна, используемая при вычислении кратной произвольной точки. */
+ #define ak_wpoint_pow_width    (5)
+/*! \brief Количество нечетных кратных точки, вычисляемых для окна заданной ширины. */
+ #define ak_wpoint_pow_entries  ( 1 << ( ak_wpoint_pow_width - 1 ))
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает `count` бит вычета \f$ k \f$, начиная с бита с номером `pos`. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_mpzn_get_bits( ak_uint64 *k, const size_t size,
+                                                            const size_t pos, const size_t count )
+{
+  size_t idx = pos >> 6, shift = pos&0x3f;
+  ak_uint64 value = 0;
+
+  if( idx < size ) value = k[idx] >> shift;
+  if(( shift > 0 ) && ( idx+1 < size )) value |= k[idx+1] << ( 64 - shift );
+ return value&(( (ak_uint64)1 << count ) - 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Присвоение по маске: \f$ z \f$ принимает значение \f$ x \f$, если маска состоит
+    из единиц, и не изменяется, если маска равна нулю.                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_set_masked( ak_uint64 *z, ak_uint64 *x, const ak_uint64 mask,
+                                                                                const size_t size )
+{
+  size_t i = 0;
+  for( i = 0; i < size; i++ ) z[i] = ( z[i]&~mask )|( x[i]&mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выбирает из таблицы точку \f$ \pm[2\cdot index+1]P \f$, заданную
+    в координатах Якоби, просматривая все точки таблицы.
+
+    Время работы функции не зависит от значения индекса и знака выбираемой точки.
+
+    @param wp Точка, в которую помещается результат.
+    @param table Нечетные кратные \f$ P, [3]P, \ldots \f$ точки \f$ P \f$.
+    @param index Индекс выбираемой точки.
+    @param negate Маска: все единицы, если у выбранной точки необходимо изменить знак, и ноль иначе.
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_jacobian_select( ak_wpoint wp, struct wpoint *table,
+                                          const ak_uint64 index, const ak_uint64 negate, ak_wcurve ec )
+{
+  size_t j = 0;
+  ak_uint64 mask, ny[ak_mpzn512_size];
+
+  for( j = 0; j < ak_wpoint_pow_entries; j++ ) {
+     mask = ( ak_uint64 )0 - ((( j^index ) - 1 ) >> 63 );
+     ak_mpzn_set_masked( wp->x, table[j].x, mask, ec->size );
+     ak_mpzn_set_masked( wp->y, table[j].y, mask, ec->size );
+     ak_mpzn_set_masked( wp->z, table[j].z, mask, ec->size );
+  }
+ /* точка -P имеет координаты (X:-Y:Z) */
+  ak_mpzn_sub( ny, ec->p, wp->y, ec->size );
+  ak_mpzn_set_masked( wp->y, ny, negate, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выбирает из таблицы точку \f$ \pm[2\cdot index+1]P \f$ кривой Эдвардса,
+    просматривая все точки таблицы.
+
+    Точки таблицы хранятся в расширенных координатах, при этом вместо координаты \f$ T \f$
+    хранится величина \f$ dT \f$; точка \f$ -P \f$ имеет координаты \f$ (-X:Y:-T:Z) \f$.
+    Время работы функции не зависит от значения индекса и знака выбираемой точки.                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_select( ak_epoint ep, struct epoint *table,
+                                          const ak_uint64 index, const ak_uint64 negate, ak_wcurve ec )
+{
+  size_t j = 0;
+  ak_uint64 mask, nv[ak_mpzn512_size];
+
+  for( j = 0; j < ak_wpoint_pow_entries; j++ ) {
+     mask = ( ak_uint64 )0 - ((( j^index ) - 1 ) >> 63 );
+     ak_mpzn_set_masked( ep->x, table[j].x, mask, ec->size );
+     ak_mpzn_set_masked( ep->y, table[j].y, mask, ec->size );
+     ak_mpzn_set_masked( ep->t, table[j].t, mask, ec->size );
+     ak_mpzn_set_masked( ep->z, table[j].z, mask, ec->size );
+  }
+  ak_mpzn_sub( nv, ec->p, ep->x, ec->size );
+  ak_mpzn_set_masked( ep->x, nv, negate, ec->size );
+  ak_mpzn_sub( nv, ec->p, ep->t, ec->size );
+  ak_mpzn_set_masked( ep->t, nv, negate, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет цифру представления степени кратности с фиксированной шириной окна.
+
+    Для нечетного числа \f$ k \f$ представление имеет вид \f$ k = \sum_{i=0}^{n-1} d_i2^{wi} \f$,
+    где все цифры \f$ d_i \f$ нечетны, \f$ |d_i| < 2^w \f$, а старшая цифра положительна.
+    Вместо четного числа \f$ k \f$ используется число \f$ k+1 \f$.
+
+    @param k Степень кратности.
+    @param size Размер степени кратности в машинных словах.
+    @param i Номер цифры.
+    @param top Флаг того, что вычисляется старшая цифра.
+    @param sign Маска, в которую помещается знак цифры (все единицы для отрицательной цифры).
+    @return Индекс \f$ (|d_i| - 1)/2 \f$ точки в таблице нечетных кратных.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_mpzn_get_window_digit( ak_uint64 *k, const size_t size,
+                                             const size_t i, const bool_t top, ak_uint64 *sign )
+{
+  ak_uint64 v;
+
+  if( top ) {
+    *sign = 0;
+    return ( ak_mpzn_get_bits( k, size, i*ak_wpoint_pow_width, ak_wpoint_pow_width )|1 ) >> 1;
+  }
+  v = ak_mpzn_get_bits( k, size, i*ak_wpoint_pow_width, ak_wpoint_pow_width+1 )|1;
+  v -= (ak_uint64)1 << ak_wpoint_pow_width;
+  *sign = ( ak_uint64 )(( ak_int64 )v >> 63 );
+ return ((( v^*sign ) - *sign ) >> 1 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление кратной точки на кривой, эквивалентной кривой Эдвардса.
+
+    Используется тот же алгоритм, что и в функции ak_wpoint_pow(), однако сложения
+    и удвоения выполняются по полным формулам в расширенных координатах Эдвардса,
+    поэтому ни одна из операций не содержит ветвлений.
+
+    @return Функция возвращает \ref ak_false, если кривая не эквивалентна кривой Эдвардса,
+    либо исходная точка является исключительной; в этом случае результат не вычисляется.          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wpoint_pow_edwards( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size,
+                                                                                    ak_wcurve ec )
+{
+  size_t i = 0, j = 0;
+  struct wedwards ed;
+  struct epoint Q, R, table[ ak_wpoint_pow_entries ];
+  ak_uint64 index, sign, even = ( k[0]&1 ) - 1;
+  const size_t windows = ( 64*size + ak_wpoint_pow_width - 1 )/ak_wpoint_pow_width;
+
+  if( !ak_wcurve_edwards_set( &ed, ec )) return ak_false;
+  if( !ak_epoint_set_wpoint( table, wp, &ed, ec )) return ak_false;
+
+ /* нечетные кратные P, [3]P, ..., для которых вместо T хранится величина dT */
+  memcpy( &R, table, sizeof( struct epoint ));
+  ak_epoint_double( &R, ak_true, ec );
+  ak_wcurve_mul( R.t, R.t, ed.d, ec );
+  for( j = 1; j < ak_wpoint_pow_entries; j++ ) {
+     memcpy( table+j, table+j-1, sizeof( struct epoint ));
+     ak_epoint_add_internal( table+j, R.x, R.y, R.t, R.z, ec );
+  }
+  for( j = 0; j < ak_wpoint_pow_entries; j++ )
+     ak_wcurve_mul( table[j].t, table[j].t, ed.d, ec );
+
+ /* основной цикл: w удвоений и одно сложение для каждой цифры */
+  index = ak_mpzn_get_window_digit( k, size, windows-1, ak_true, &sign );
+  ak_epoint_select( &R, table, index, sign, ec );
+  ak_epoint_set_as_unit( &Q, ec );
+  ak_epoint_add_internal( &Q, R.x, R.y, R.t, R.z, ec );
+  for( i = windows-1; i > 0; i-- ) {
+     for( j = 1; j < ak_wpoint_pow_width; j++ ) ak_epoint_double( &Q, ak_false, ec );
+     ak_epoint_double( &Q, ak_true, ec );
+     index = ak_mpzn_get_window_digit( k, size, i-1, ak_false, &sign );
+     ak_epoint_select( &R, table, index, sign, ec );
+     ak_epoint_add_internal( &Q, R.x, R.y, R.t, R.z, ec );
+  }
+
+ /* для четного k было вычислено значение [k+1]P, поэтому вычитаем P */
+  ak_epoint_select( &R, table, 0, ( ak_uint64 )-1, ec );
+  memcpy( table, &Q, sizeof( struct epoint ));
+  ak_epoint_add_internal( table, R.x, R.y, R.t, R.z, ec );
+  ak_mpzn_set_masked( Q.x, table[0].x, even, ec->size );
+  ak_mpzn_set_masked( Q.y, table[0].y, even, ec->size );
+  ak_mpzn_set_masked( Q.z, table[0].z, even, ec->size );
+  ak_epoint_get_wpoint( wq, &Q, &ed, ec );
+
+ /* очищаем временные данные */
+  memset( table, 0, sizeof( table ));
+  memset( &Q, 0, sizeof( struct epoint ));
+  memset( &R, 0, sizeof( struct epoint ));
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
     функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
     равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
 
-    При вычислении используется метод `лесенки Монтгомери`, выравнивающий время работы алгоритма
-    вне зависимости от вида числа \f$ k \f$.
+    При вычислении используется метод с фиксированной шириной окна \f$ w = 5 \f$:
+    вычисляются нечетные кратные \f$ P, [3]P, \ldots, [2^w-1]P \f$, после чего
+    степень кратности представляется в виде \f$ k = \sum_i d_i2^{wi} \f$ с нечетными цифрами
+    \f$ |d_i| < 2^w \f$ (для четного \f$ k \f$ используется \f$ k+1 \f$ с последующим
+    вычитанием точки \f$ P \f$). Для каждой цифры выполняется \f$ w \f$ удвоений и одно сложение,
+    а точка таблицы выбирается с помощью масок, просмотром всех точек таблицы.
+    Тем самым, последовательность выполняемых операций и адреса, к которым выполняется обращение,
+    не зависят от значения \f$ k \f$.
+
+    Промежуточные вычисления выполняются в координатах Якоби, а для кривых, эквивалентных
+    скрученным кривым Эдвардса (см. \ref wcurve_edwards_parameters), -- в расширенных
+    координатах Эдвардса. В последнем случае все сложения выполняются по полным формулам;
+    в координатах Якоби сложение содержит проверку совпадения слагаемых, которая для точек
+    простого порядка \f$ q \f$ может сработать лишь с пренебрежимо малой вероятностью.
 
     \b Для \b информации:
      \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
@@ -609,25 +1604,700 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
 {
-  ak_uint64 uk = 0;
-  long long int i, j;
-  struct wpoint Q, R; /* две точки из лесенки Монтгомери */
-
- /* начальные значения для переменных */
-  ak_wpoint_set_as_unit( &Q, ec );
-  ak_wpoint_set_wpoint( &R, wp, ec );
-
- /* полный цикл по всем(!) битам числа k */
-  for( i = size-1; i >= 0; i-- ) {
-     uk = k[i];
-     for( j = 0; j < 64; j++ ) {
-       if( uk&0x8000000000000000LL ) { ak_wpoint_add( &Q, &R, ec ); ak_wpoint_double( &R, ec ); }
-        else { ak_wpoint_add( &R, &Q, ec ); ak_wpoint_double( &Q, ec ); }
-       uk <<= 1;
+  size_t i = 0, j = 0, windows = 0;
+  struct wpoint Q, R, table[ ak_wpoint_pow_entries ];
+  ak_uint64 index, sign, even;
+  bool_t minus3 = ak_false;
+
+  if(( size == 0 ) || ( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true )) {
+    ak_wpoint_set_as_unit( wq, ec );
+    return;
+  }
+  if( ak_wpoint_pow_edwards( wq, wp, k, size, ec )) return;
+  minus3 = ak_wcurve_is_a_minus_three( ec );
+  even = ( k[0]&1 ) - 1;
+  windows = ( 64*size + ak_wpoint_pow_width - 1 )/ak_wpoint_pow_width;
+
+ /* нечетные кратные P, [3]P, ... в координатах Якоби */
+  ak_wpoint_jacobian_set( table, wp, ec );
+  ak_wpoint_set_wpoint( &R, table, ec );
+  ak_wpoint_jacobian_double( &R, minus3, ec );
+  for( j = 1; j < ak_wpoint_pow_entries; j++ ) {
+     ak_wpoint_set_wpoint( table+j, table+j-1, ec );
+     ak_wpoint_jacobian_add( table+j, &R, minus3, ec );
+  }
+
+ /* основной цикл: w удвоений и одно сложение для каждой цифры */
+  index = ak_mpzn_get_window_digit( k, size, windows-1, ak_true, &sign );
+  ak_wpoint_jacobian_select( &Q, table, index, sign, ec );
+  for( i = windows-1; i > 0; i-- ) {
+     for( j = 0; j < ak_wpoint_pow_width; j++ ) ak_wpoint_jacobian_double( &Q, minus3, ec );
+     index = ak_mpzn_get_window_digit( k, size, i-1, ak_false, &sign );
+     ak_wpoint_jacobian_select( &R, table, index, sign, ec );
+     ak_wpoint_jacobian_add( &Q, &R, minus3, ec );
+  }
+
+ /* для четного k было вычислено значение [k+1]P, поэтому вычитаем P */
+  ak_wpoint_jacobian_select( &R, table, 0, ( ak_uint64 )-1, ec );
+  ak_wpoint_set_wpoint( table, &Q, ec );
+  ak_wpoint_jacobian_add( table, &R, minus3, ec );
+  ak_mpzn_set_masked( Q.x, table[0].x, even, ec->size );
+  ak_mpzn_set_masked( Q.y, table[0].y, even, ec->size );
+  ak_mpzn_set_masked( Q.z, table[0].z, even, ec->size );
+
+ /* возвращаемся к проективным координатам */
+  ak_wpoint_jacobian_get( wq, &Q, ec );
+
+ /* очищаем временные данные */
+  memset( table, 0, sizeof( table ));
+  memset( &Q, 0, sizeof( struct wpoint ));
+  memset( &R, 0, sizeof( struct wpoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                  вычисление кратных точек для образующей точки эллиптической кривой             */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ширина окна, используемая при вычислении кратной образующей точки. */
+ #define ak_wpoint_fixed_base_width    (5)
+/*! \brief Количество точек таблицы, соответствующих одному окну. */
+ #define ak_wpoint_fixed_base_entries  ( 1 << ( ak_wpoint_fixed_base_width - 1 ))
+/*! \brief Ширина окна wNAF-представления, используемая для образующей точки при вычислении
+    суммы кратных точек. */
+ #define ak_wpoint_wnaf_base_width     (7)
+/*! \brief Ширина окна wNAF-представления, используемая для произвольной точки. */
+ #define ak_wpoint_wnaf_width          (5)
+/*! \brief Максимальное количество эллиптических кривых, для которых хранятся таблицы. */
+ #define ak_wcurve_fixed_base_tables   (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Таблица кратных образующей точки эллиптической кривой. */
+ typedef struct wcurve_fixed_base {
+  /*! \brief Копия параметров эллиптической кривой, для которой вычислена таблица. */
+   struct wcurve curve;
+  /*! \brief Аффинные координаты точек \f$ [(2j+1)2^{wi}]P \f$ во внутреннем представлении. */
+   ak_uint64 *table;
+  /*! \brief Нечетные кратные \f$ [2j+1]P \f$ образующей точки, используемые при вычислении
+      суммы кратных точек; аффинные координаты точек хранятся во внутреннем представлении. */
+   struct wpoint *odd;
+  /*! \brief Количество координат одной точки таблицы: две координаты \f$ (x, y) \f$ для
+      точек кривой в форме Вейерштрасса и три величины \f$ (u, v, duv) \f$ для точек
+      кривой Эдвардса. */
+   size_t coordinates;
+  /*! \brief Константы перехода к форме Эдвардса; используются, если кривая эквивалентна
+      скрученной кривой Эдвардса. */
+   struct wedwards edwards;
+  /*! \brief Нечетные кратные образующей точки в форме Эдвардса, хранящиеся так же,
+      как и точки таблицы; в этом случае массив odd не используется. */
+   ak_uint64 *eodd;
+ } *ak_wcurve_fixed_base;
+
+/*! \brief Таблицы кратных точек, вычисленные для используемых эллиптических кривых. */
+ static struct wcurve_fixed_base wcurve_fixed_base_tables[ ak_wcurve_fixed_base_tables ];
+/*! \brief Количество вычисленных таблиц. */
+ static size_t wcurve_fixed_base_count = 0;
+#ifdef AK_HAVE_PTHREAD_H
+/*! \brief Мьютекс, защищающий доступ к таблицам кратных точек. */
+ static pthread_mutex_t wcurve_fixed_base_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество окон, на которые разбивается степень кратности.
+
+    Перед вычислением к степени кратности \f$ k \f$ может быть прибавлен порядок \f$ q \f$,
+    поэтому учитывается один дополнительный бит.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline size_t ak_wpoint_fixed_base_windows( const size_t size )
+{
+  return ( 64*size + ak_wpoint_fixed_base_width )/ak_wpoint_fixed_base_width;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет таблицу кратных образующей точки эллиптической кривой.
+
+    Для каждого окна \f$ i \f$ в таблицу помещаются аффинные координаты точек
+    \f$ [(2j+1)2^{wi}]P \f$, где \f$ 0 \leq j < 2^{w-1}\f$, \f$ w \f$ -- ширина окна.
+    Координаты хранятся во внутреннем представлении, что позволяет складывать точки таблицы
+    с точками, заданными в координатах Якоби, без дополнительных преобразований.
+    Для кривых, эквивалентных кривым Эдвардса, в таблицу помещаются величины \f$ (u, v, duv) \f$
+    (см. ak_epoint_set_affine_array()).
+
+    @param ec Эллиптическая кривая.
+    @param ed Константы перехода к форме Эдвардса, либо NULL.
+    @return Указатель на созданную таблицу. В случае ошибки возвращается NULL.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 *ak_wcurve_fixed_base_table_new( ak_wcurve ec, ak_wedwards ed )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 *table = NULL, *ptr = NULL;
+  struct wpoint base, dbl, *pts = NULL, *cur = NULL;
+  const size_t windows = ak_wpoint_fixed_base_windows( ec->size );
+  const size_t count = windows*ak_wpoint_fixed_base_entries;
+
+  if(( table = malloc( count*( ed == NULL ? 2 : 3 )*ec->size*sizeof( ak_uint64 ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    return NULL;
+  }
+  if(( pts = malloc( count*sizeof( struct wpoint ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    free( table );
+    return NULL;
+  }
+
+  cur = pts;
+  ak_wpoint_set( &base, ec );
+  for( i = 0; i < windows; i++ ) {
+    /* последовательно вычисляем нечетные кратные точки base */
+     ak_wpoint_set_wpoint( &dbl, &base, ec );
+     ak_wpoint_double( &dbl, ec );
+     ak_wpoint_set_wpoint( cur, &base, ec );
+     for( j = 1; j < ak_wpoint_fixed_base_entries; j++, cur++ ) {
+        ak_wpoint_set_wpoint( cur+1, cur, ec );
+        ak_wpoint_add( cur+1, &dbl, ec );
+     }
+     cur++;
+    /* переходим к следующему окну: base <- [2^w]base */
+     for( j = 0; j < ak_wpoint_fixed_base_width; j++ ) ak_wpoint_double( &base, ec );
+  }
+
+  if( ed != NULL ) {
+    if( !ak_epoint_set_affine_array( table, pts, count, ed, ec )) {
+      free( table );
+      table = NULL;
+    }
+    free( pts );
+    return table;
+  }
+
+ /* приводим все точки к аффинной форме и сохраняем их координаты */
+  ak_wpoint_reduce_batch_internal( pts, count, ak_true, ec );
+  for( i = 0, ptr = table; i < count; i++ ) {
+     memcpy( ptr, pts[i].x, ec->size*sizeof( ak_uint64 )); ptr += ec->size;
+     memcpy( ptr, pts[i].y, ec->size*sizeof( ak_uint64 )); ptr += ec->size;
+  }
+  free( pts );
+ return table;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет нечетные кратные \f$ P, [3]P, \ldots, [2count-1]P \f$ заданной точки.
+
+    @param odd Массив, в который помещаются точки; должен содержать `count` элементов.
+    @param wp Точка \f$ P \f$.
+    @param count Количество вычисляемых точек.
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_odd_multiples( struct wpoint *odd, ak_wpoint wp,
+                                                                const size_t count, ak_wcurve ec )
+{
+  size_t j = 0;
+  struct wpoint dbl;
+
+  ak_wpoint_set_wpoint( &dbl, wp, ec );
+  ak_wpoint_double( &dbl, ec );
+  ak_wpoint_set_wpoint( odd, wp, ec );
+  for( j = 1; j < count; j++ ) {
+     ak_wpoint_set_wpoint( odd+j, odd+j-1, ec );
+     ak_wpoint_add( odd+j, &dbl, ec );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает таблицы кратных образующей точки эллиптической кривой.
+
+    Таблицы вычисляются при первом обращении к ним и хранятся до завершения работы
+    с библиотекой (см. ak_wcurve_destroy_fixed_base_tables()).
+
+    @param ec Эллиптическая кривая.
+    @return Указатель на таблицы. Если таблицы не могут быть вычислены, возвращается NULL.         */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_wcurve_fixed_base ak_wcurve_get_fixed_base( ak_wcurve ec )
+{
+  size_t i = 0;
+  struct wedwards ed;
+  bool_t edwards = ak_false;
+  struct wpoint *odd = NULL;
+  ak_wcurve_fixed_base fb = NULL;
+  ak_uint64 *table = NULL, *eodd = NULL;
+  const size_t ocount = 1 << ( ak_wpoint_wnaf_base_width - 2 );
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &wcurve_fixed_base_mutex );
+#endif
+ /* кривая определяется своими параметрами, а не адресом контекста */
+  for( i = 0; i < wcurve_fixed_base_count; i++ ) {
+     ak_wcurve wc = &wcurve_fixed_base_tables[i].curve;
+     if(( wc->size == ec->size ) &&
+        ( ak_mpzn_cmp( wc->p, ec->p, ec->size ) == 0 ) &&
+        ( ak_mpzn_cmp( wc->a, ec->a, ec->size ) == 0 ) &&
+        ( ak_mpzn_cmp( wc->point.x, ec->point.x, ec->size ) == 0 ) &&
+        ( ak_mpzn_cmp( wc->point.y, ec->point.y, ec->size ) == 0 ) &&
+        ( ak_mpzn_cmp( wc->point.z, ec->point.z, ec->size ) == 0 ) &&
+        ( wc->field == ec->field )) {
+       fb = &wcurve_fixed_base_tables[i];
+       goto exit;
+     }
+  }
+  if( wcurve_fixed_base_count < ak_wcurve_fixed_base_tables ) {
+    edwards = ak_wcurve_edwards_set( &ed, ec );
+    if(( odd = malloc( sizeof( struct wpoint )*ocount )) == NULL ) {
+      ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+      goto exit;
+    }
+    ak_wpoint_odd_multiples( odd, &ec->point, ocount, ec );
+    if( edwards ) {
+     /* для кривых Эдвардса нечетные кратные хранятся в том же виде, что и точки таблицы */
+      if(( eodd = malloc( ocount*3*ec->size*sizeof( ak_uint64 ))) == NULL ) {
+        ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+        free( odd );
+        goto exit;
+      }
+      if( !ak_epoint_set_affine_array( eodd, odd, ocount, &ed, ec )) {
+        free( eodd );
+        free( odd );
+        goto exit;
+      }
+      free( odd );
+      odd = NULL;
+    } else ak_wpoint_reduce_batch_internal( odd, ocount, ak_true, ec );
+
+    if(( table = ak_wcurve_fixed_base_table_new( ec, edwards ? &ed : NULL )) == NULL ) {
+      if( odd != NULL ) free( odd );
+      if( eodd != NULL ) free( eodd );
+      goto exit;
+    }
+
+    fb = &wcurve_fixed_base_tables[wcurve_fixed_base_count++];
+    memcpy( &fb->curve, ec, sizeof( struct wcurve ));
+    fb->table = table;
+    fb->odd = odd;
+    fb->eodd = eodd;
+    fb->coordinates = edwards ? 3 : 2;
+    if( edwards ) memcpy( &fb->edwards, &ed, sizeof( struct wedwards ));
+    if( ak_log_get_level() >= ak_log_maximum )
+      ak_error_message_fmt( ak_error_ok, __func__, "fixed base tables for curve with p = %s created",
+                                                         ak_mpzn_to_hexstr( ec->p, ec->size ));
+  }
+
+ exit:
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &wcurve_fixed_base_mutex );
+#endif
+ return fb;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция освобождает память, занятую таблицами кратных точек. Функция вызывается
+    при завершении работы с библиотекой.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_destroy_fixed_base_tables( void )
+{
+  size_t i = 0;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &wcurve_fixed_base_mutex );
+#endif
+  for( i = 0; i < wcurve_fixed_base_count; i++ ) {
+     free( wcurve_fixed_base_tables[i].table );
+     free( wcurve_fixed_base_tables[i].odd );
+     free( wcurve_fixed_base_tables[i].eodd );
+     memset( &wcurve_fixed_base_tables[i], 0, sizeof( struct wcurve_fixed_base ));
+  }
+  wcurve_fixed_base_count = 0;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &wcurve_fixed_base_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выбирает точку из таблицы, просматривая все точки окна.
+
+    Время работы функции не зависит от значения индекса и знака выбираемой точки.
+
+    @param wp Точка, в которую помещаются аффинные координаты выбранной точки.
+    @param entries Указатель на точки окна.
+    @param index Индекс выбираемой точки.
+    @param negate Маска: все единицы, если у выбранной точки необходимо изменить знак, и ноль иначе.
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_fixed_base_select( ak_wpoint wp, ak_uint64 *entries,
+                                          const ak_uint64 index, const ak_uint64 negate, ak_wcurve ec )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 mask, ny[ak_mpzn512_size];
+
+  memset( wp->x, 0, ec->size*sizeof( ak_uint64 ));
+  memset( wp->y, 0, ec->size*sizeof( ak_uint64 ));
+  for( j = 0; j < ak_wpoint_fixed_base_entries; j++, entries += 2*ec->size ) {
+     mask = ( ak_uint64 )0 - ((( j^index ) - 1 ) >> 63 );
+     for( i = 0; i < ec->size; i++ ) {
+        wp->x[i] |= entries[i]&mask;
+        wp->y[i] |= entries[ec->size+i]&mask;
+     }
+  }
+ /* точка -P имеет координаты (x, p-y) */
+  ak_mpzn_sub( ny, ec->p, wp->y, ec->size );
+  for( i = 0; i < ec->size; i++ ) wp->y[i] = ( wp->y[i]&~negate )|( ny[i]&negate );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выбирает точку кривой Эдвардса из таблицы, просматривая все точки окна.
+
+    Выбранные величины \f$ (u, v, duv) \f$ помещаются в координаты \f$ X, Y, T \f$ точки;
+    точка \f$ -P \f$ имеет координаты \f$ (-u, v) \f$. Время работы функции не зависит
+    от значения индекса и знака выбираемой точки.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_fixed_base_select( ak_epoint ep, ak_uint64 *entries,
+                                          const ak_uint64 index, const ak_uint64 negate, ak_wcurve ec )
+{
+  size_t i = 0, j = 0;
+  ak_uint64 mask, nx[ak_mpzn512_size], nt[ak_mpzn512_size];
+
+  memset( ep->x, 0, ec->size*sizeof( ak_uint64 ));
+  memset( ep->y, 0, ec->size*sizeof( ak_uint64 ));
+  memset( ep->t, 0, ec->size*sizeof( ak_uint64 ));
+  for( j = 0; j < ak_wpoint_fixed_base_entries; j++, entries += 3*ec->size ) {
+     mask = ( ak_uint64 )0 - ((( j^index ) - 1 ) >> 63 );
+     for( i = 0; i < ec->size; i++ ) {
+        ep->x[i] |= entries[i]&mask;
+        ep->y[i] |= entries[ec->size+i]&mask;
+        ep->t[i] |= entries[2*ec->size+i]&mask;
      }
   }
- /* копируем полученный результат */
-  ak_wpoint_set_wpoint( wq, &Q, ec );
+  ak_mpzn_sub( nx, ec->p, ep->x, ec->size );
+  ak_mpzn_sub( nt, ec->p, ep->t, ec->size );
+  for( i = 0; i < ec->size; i++ ) {
+     ep->x[i] = ( ep->x[i]&~negate )|( nx[i]&negate );
+     ep->t[i] = ( ep->t[i]&~negate )|( nt[i]&negate );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для образующей точки \f$ P \f$ эллиптической кривой и заданного целого числа \f$ k \f$
+    функция вычисляет кратную точку \f$ Q = [k]P \f$.
+
+    Для вычислений используется таблица точек вида \f$ [(2j+1)2^{wi}]P \f$, вычисляемая
+    при первом вызове функции для заданной кривой и сохраняемая до завершения работы библиотеки.
+    Нечетное значение \f$ k \f$ (если \f$ k \f$ четно, то используется \f$ k+q \f$)
+    представляется в виде \f$ k = \sum_i d_i2^{wi}\f$, где все цифры \f$ d_i \f$ нечетны и
+    \f$ |d_i| < 2^w\f$, после чего кратная точка вычисляется как сумма точек таблицы.
+    Количество сложений точек фиксировано, удвоения точек не выполняются; выбор точки из таблицы
+    выполняется за время, не зависящее от значения \f$ k \f$. Сумма накапливается
+    в координатах Якоби, точки таблицы прибавляются в смешанных координатах.
+    Для кривых, эквивалентных кривым Эдвардса, сумма накапливается в расширенных координатах
+    Эдвардса и переводится в форму Вейерштрасса после завершения вычислений.
+
+    \b Для \b информации:
+     \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+     \li Если таблица не может быть вычислена, то используется функция ak_wpoint_pow().
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах; должен совпадать с размером
+    параметров эллиптической кривой.
+    @param ec Эллиптическая кривая, образующая точка которой возводится в степень.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_fixed_base( ak_wpoint wq, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  size_t i = 0, windows = 0;
+  struct wpoint wt;
+  struct epoint ep, et;
+  ak_wcurve_fixed_base fb = NULL;
+  ak_uint64 *table = NULL, mask, v, sign, absd,
+            kq[ak_mpzn512_size+1], kk[ak_mpzn512_size+1];
+  bool_t minus3 = ak_false;
+  size_t step = 0;
+
+  if(( size != ec->size ) || (( fb = ak_wcurve_get_fixed_base( ec )) == NULL )) {
+    ak_wpoint_pow( wq, &ec->point, k, size, ec );
+    return;
+  }
+  table = fb->table;
+  step = ak_wpoint_fixed_base_entries*fb->coordinates*ec->size;
+  minus3 = ak_wcurve_is_a_minus_three( ec );
+
+ /* выбираем нечетное значение из k и k+q */
+  ak_mpzn_set( kk, k, size ); kk[size] = 0;
+  kq[size] = ak_mpzn_add( kq, k, ec->q, size );
+  mask = ( k[0]&1 ) - 1;
+  for( i = 0; i <= size; i++ ) kk[i] = ( kk[i]&~mask )|( kq[i]&mask );
+
+ /* старшая цифра всегда положительна */
+  windows = ak_wpoint_fixed_base_windows( size );
+  v = ak_mpzn_get_bits( kk, size+1, ( windows-1 )*ak_wpoint_fixed_base_width,
+                                                               ak_wpoint_fixed_base_width )|1;
+  if( fb->coordinates == 3 ) {
+    ak_epoint_fixed_base_select( &et, table + ( windows-1 )*step, v >> 1, 0, ec );
+    ak_epoint_set_as_unit( &ep, ec );
+    ak_epoint_add_internal( &ep, et.x, et.y, et.t, NULL, ec );
+    for( i = windows-1; i > 0; i-- ) {
+       v = ak_mpzn_get_bits( kk, size+1, ( i-1 )*ak_wpoint_fixed_base_width,
+                                                             ak_wpoint_fixed_base_width+1 )|1;
+       v -= (ak_uint64)1 << ak_wpoint_fixed_base_width;
+       sign = ( ak_uint64 )(( ak_int64 )v >> 63 );
+       absd = ( v^sign ) - sign;
+       ak_epoint_fixed_base_select( &et, table + ( i-1 )*step, absd >> 1, sign, ec );
+       ak_epoint_add_internal( &ep, et.x, et.y, et.t, NULL, ec );
+    }
+    ak_epoint_get_wpoint( wq, &ep, &fb->edwards, ec );
+    memset( &ep, 0, sizeof( struct epoint ));
+    memset( &et, 0, sizeof( struct epoint ));
+    goto exit;
+  }
+  ak_wpoint_fixed_base_select( &wt, table + ( windows-1 )*step, v >> 1, 0, ec );
+  ak_wpoint_set_as_unit( wq, ec );
+  ak_wpoint_jacobian_add_affine( wq, wt.x, wt.y, minus3, ec );
+
+ /* остальные цифры d = v - 2^w, где v -- нечетное число из w+1 бит */
+  for( i = windows-1; i > 0; i-- ) {
+     v = ak_mpzn_get_bits( kk, size+1, ( i-1 )*ak_wpoint_fixed_base_width,
+                                                           ak_wpoint_fixed_base_width+1 )|1;
+     v -= (ak_uint64)1 << ak_wpoint_fixed_base_width;
+     sign = ( ak_uint64 )(( ak_int64 )v >> 63 );
+     absd = ( v^sign ) - sign;
+     ak_wpoint_fixed_base_select( &wt, table + ( i-1 )*step, absd >> 1, sign, ec );
+     ak_wpoint_jacobian_add_affine( wq, wt.x, wt.y, minus3, ec );
+  }
+  ak_wpoint_jacobian_get( wq, wq, ec );
+
+ /* очищаем временные данные */
+ exit:
+  memset( kk, 0, sizeof( kk ));
+  memset( kq, 0, sizeof( kq ));
+  memset( &wt, 0, sizeof( struct wpoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет wNAF-представление вычета \f$ k \f$.
+
+    Вычет представляется в виде \f$ k = \sum_i d_i2^i \f$, где каждая цифра \f$ d_i \f$
+    либо равна нулю, либо нечетна и удовлетворяет неравенству \f$ |d_i| < 2^{w-1} \f$;
+    среди любых \f$ w \f$ последовательных цифр не более одной отлично от нуля.
+
+    @param naf Массив, в который помещаются цифры; должен содержать не менее
+    \f$ 64\cdot size + 1 \f$ элементов.
+    @param k Вычет.
+    @param size Размер вычета в машинных словах.
+    @param w Ширина окна.
+    @return Количество цифр представления.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_mpzn_wnaf( ak_int8 *naf, ak_uint64 *k, const size_t size, const size_t w )
+{
+  size_t i = 0, len = 0;
+  ak_int64 d = 0;
+  ak_uint64 t[ak_mpzn512_size+1], c = 0;
+
+  ak_mpzn_set( t, k, size ); t[size] = 0;
+  while( !ak_mpzn_cmp_ui( t, size+1, 0 )) {
+    d = 0;
+    if( t[0]&1 ) {
+      d = ( ak_int64 )( t[0]&(( (ak_uint64)1 << w ) - 1 ));
+      if( d >= ( (ak_int64)1 << ( w-1 ))) d -= ( (ak_int64)1 << w );
+     /* t <- t - d; при d > 0 заема не возникает, поскольку младшие биты t равны d */
+      if( d > 0 ) t[0] -= ( ak_uint64 )d;
+       else {
+         c = ( ak_uint64 )( -d );
+         for( i = 0; ( i <= size ) && c; i++ ) { t[i] += c; c = ( t[i] < c ); }
+       }
+    }
+    naf[len++] = ( ak_int8 )d;
+   /* t <- t/2 */
+    for( i = 0; i < size; i++ ) t[i] = ( t[i] >> 1 )|( t[i+1] << 63 );
+    t[size] >>= 1;
+  }
+ return len;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция прибавляет к точке \f$ R \f$, заданной в координатах Якоби, точку \f$ [d]P \f$,
+    где \f$ d \f$ -- цифра wNAF-представления, а \f$ P \f$ -- точка, для которой вычислены
+    нечетные кратные.
+
+    @param wr Точка \f$ R \f$ в координатах Якоби.
+    @param odd Нечетные кратные точки \f$ P \f$.
+    @param affine Флаг того, что нечетные кратные заданы аффинными координатами
+    во внутреннем представлении; в противном случае -- координатами Якоби.
+    @param d Цифра wNAF-представления.
+    @param minus3 Флаг того, что коэффициент \f$ a \f$ кривой равен \f$ -3 \f$.
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_wpoint_add_wnaf_digit( ak_wpoint wr, struct wpoint *odd,
+                       const bool_t affine, ak_int8 d, const bool_t minus3, ak_wcurve ec )
+{
+  struct wpoint wt;
+  ak_mpznmax zero = ak_mpznmax_zero;
+  ak_wpoint wp = odd + ((( d > 0 ? d : -d ) - 1 ) >> 1 );
+
+  if( d < 0 ) {
+    ak_wpoint_set_wpoint( &wt, wp, ec );
+    ak_wcurve_sub( wt.y, zero, wt.y, ec );
+    wp = &wt;
+  }
+  if( affine ) ak_wpoint_jacobian_add_affine( wr, wp->x, wp->y, minus3, ec );
+   else ak_wpoint_jacobian_add( wr, wp, minus3, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция прибавляет к точке \f$ R \f$ кривой Эдвардса точку \f$ [d]P \f$,
+    где \f$ d \f$ -- цифра wNAF-представления.
+
+    @param er Точка \f$ R \f$ в расширенных координатах.
+    @param odd Нечетные кратные точки \f$ P \f$ в форме Эдвардса, для которых в координате
+    \f$ T \f$ хранится величина \f$ dT \f$.
+    @param affine Флаг того, что нечетные кратные заданы массивом аффинных величин
+    \f$ (u, v, duv) \f$ (см. ak_epoint_set_affine_array()); в противном случае -- массивом
+    точек в расширенных координатах.
+    @param d Цифра wNAF-представления.
+    @param ec Эллиптическая кривая.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_epoint_add_wnaf_digit( ak_epoint er, void *odd, const bool_t affine,
+                                                                        ak_int8 d, ak_wcurve ec )
+{
+  ak_mpznmax nx, nt;
+  ak_uint64 *x, *y, *t, *z = NULL;
+  const size_t idx = ((( d > 0 ? d : -d ) - 1 ) >> 1 );
+
+  if( affine ) {
+    x = ( ak_uint64 *)odd + idx*3*ec->size;
+    y = x + ec->size;
+    t = y + ec->size;
+  } else {
+      ak_epoint ep = ( ak_epoint )odd + idx;
+      x = ep->x; y = ep->y; t = ep->t; z = ep->z;
+    }
+ /* точка -P имеет координаты (-X:Y:-T:Z) */
+  if( d < 0 ) {
+    ak_mpzn_sub( nx, ec->p, x, ec->size ); x = nx;
+    ak_mpzn_sub( nt, ec->p, t, ec->size ); t = nt;
+  }
+  ak_epoint_add_internal( er, x, y, t, z, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление суммы кратных точек \f$ R = [u]P + [v]Q \f$ в форме Эдвардса.
+
+    Вычисления выполняются так же, как и в функции ak_wpoint_pow_sum(), однако сумма
+    накапливается в расширенных координатах Эдвардса.
+
+    @return Функция возвращает \ref ak_false, если точка \f$ Q \f$ является исключительной
+    для отображения в форму Эдвардса; в этом случае результат не вычисляется.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_wpoint_pow_sum_edwards( ak_wpoint wr, ak_uint64 *u, ak_wpoint wq, ak_uint64 *v,
+                                                  size_t size, ak_wcurve_fixed_base fb, ak_wcurve ec )
+{
+  ak_int64 i = 0;
+  size_t j = 0, ulen = 0, vlen = 0;
+  struct epoint er, et, qodd[ 1 << ( ak_wpoint_wnaf_width - 2 )];
+  ak_int8 unaf[ 64*ak_mpzn512_size + 1 ], vnaf[ 64*ak_mpzn512_size + 1 ];
+
+ /* нечетные кратные точки Q вычисляются в расширенных координатах */
+  if( !ak_epoint_set_wpoint( qodd, wq, &fb->edwards, ec )) return ak_false;
+  memcpy( &et, qodd, sizeof( struct epoint ));
+  ak_epoint_double( &et, ak_true, ec );
+  ak_wcurve_mul( et.t, et.t, fb->edwards.d, ec );
+  for( j = 1; j < ( 1 << ( ak_wpoint_wnaf_width - 2 )); j++ ) {
+     memcpy( qodd+j, qodd+j-1, sizeof( struct epoint ));
+     ak_epoint_add_internal( qodd+j, et.x, et.y, et.t, et.z, ec );
+  }
+  for( j = 0; j < ( 1 << ( ak_wpoint_wnaf_width - 2 )); j++ )
+     ak_wcurve_mul( qodd[j].t, qodd[j].t, fb->edwards.d, ec );
+
+  ulen = ak_mpzn_wnaf( unaf, u, size, ak_wpoint_wnaf_base_width );
+  vlen = ak_mpzn_wnaf( vnaf, v, size, ak_wpoint_wnaf_width );
+
+  ak_epoint_set_as_unit( &er, ec );
+  for( i = ( ak_int64 )ak_max( ulen, vlen ) - 1; i >= 0; i-- ) {
+     bool_t uadd = ( i < ( ak_int64 )ulen ) && unaf[i],
+            vadd = ( i < ( ak_int64 )vlen ) && vnaf[i];
+
+    /* координата T необходима только перед сложением */
+     ak_epoint_double( &er, uadd || vadd, ec );
+     if( uadd ) ak_epoint_add_wnaf_digit( &er, fb->eodd, ak_true, unaf[i], ec );
+     if( vadd ) ak_epoint_add_wnaf_digit( &er, qodd, ak_false, vnaf[i], ec );
+  }
+  ak_epoint_get_wpoint( wr, &er, &fb->edwards, ec );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для образующей точки \f$ P \f$ эллиптической кривой, заданной точки \f$ Q \f$ и
+    двух целых чисел \f$ u, v \f$ функция вычисляет точку \f$ R = [u]P + [v]Q \f$.
+
+    Для вычислений используется метод Штрауса (Шамира): оба числа представляются
+    в wNAF-форме, после чего вычисления выполняются в одном цикле с общими удвоениями точки.
+    Нечетные кратные образующей точки вычисляются один раз для каждой кривой и хранятся
+    вместе с таблицей, используемой функцией ak_wpoint_pow_fixed_base();
+    нечетные кратные точки \f$ Q \f$ вычисляются при каждом вызове функции.
+    Сумма накапливается в координатах Якоби; кратные образующей точки, заданные аффинными
+    координатами, прибавляются в смешанных координатах. Для кривых, эквивалентных
+    кривым Эдвардса, вычисления выполняются в расширенных координатах Эдвардса.
+
+    \warning Время работы функции зависит от значений \f$ u \f$ и \f$ v \f$, поэтому функция
+    должна применяться только к открытым данным, например, при проверке электронной подписи.
+
+    \b Для \b информации:
+     \li Функция не приводит результирующую точку \f$ R \f$ к аффинной форме.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param u Степень кратности образующей точки.
+    @param wq Точка \f$ Q \f$.
+    @param v Степень кратности точки \f$ Q \f$.
+    @param size Размер степеней \f$ u \f$ и \f$ v \f$ в машинных словах; должен совпадать
+    с размером параметров эллиптической кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_sum( ak_wpoint wr, ak_uint64 *u, ak_wpoint wq, ak_uint64 *v,
+                                                                     size_t size, ak_wcurve ec )
+{
+  ak_int64 i = 0;
+  size_t j = 0, ulen = 0, vlen = 0;
+  ak_wcurve_fixed_base fb = NULL;
+  struct wpoint wt, *podd = NULL, qodd[ 1 << ( ak_wpoint_wnaf_width - 2 )],
+                                  pcur[ 1 << ( ak_wpoint_wnaf_width - 2 )];
+  ak_int8 unaf[ 64*ak_mpzn512_size + 1 ], vnaf[ 64*ak_mpzn512_size + 1 ];
+  size_t uw = ak_wpoint_wnaf_base_width;
+  bool_t minus3 = ak_false;
+
+  if( size != ec->size ) {
+    ak_wpoint_pow( wr, &ec->point, u, size, ec );
+    ak_wpoint_pow( &wt, wq, v, size, ec );
+    ak_wpoint_add( wr, &wt, ec );
+    return;
+  }
+  minus3 = ak_wcurve_is_a_minus_three( ec );
+
+ /* нечетные кратные образующей точки берутся из таблицы,
+    если таблица не может быть вычислена, то они вычисляются в явном виде */
+  if(( fb = ak_wcurve_get_fixed_base( ec )) != NULL ) {
+    if(( fb->coordinates == 3 ) && ak_wpoint_pow_sum_edwards( wr, u, wq, v, size, fb, ec )) return;
+    podd = fb->odd;
+  }
+  if( podd == NULL ) {
+     uw = ak_wpoint_wnaf_width;
+     ak_wpoint_odd_multiples( podd = pcur, &ec->point, 1 << ( uw - 2 ), ec );
+     ak_wpoint_reduce_batch_internal( pcur, 1 << ( uw - 2 ), ak_true, ec );
+  }
+
+ /* нечетные кратные точки Q вычисляются в координатах Якоби */
+  ak_wpoint_jacobian_set( qodd, wq, ec );
+  ak_wpoint_set_wpoint( &wt, qodd, ec );
+  ak_wpoint_jacobian_double( &wt, minus3, ec );
+  for( j = 1; j < ( 1 << ( ak_wpoint_wnaf_width - 2 )); j++ ) {
+     ak_wpoint_set_wpoint( qodd+j, qodd+j-1, ec );
+     ak_wpoint_jacobian_add( qodd+j, &wt, minus3, ec );
+  }
+
+  ulen = ak_mpzn_wnaf( unaf, u, size, uw );
+  vlen = ak_mpzn_wnaf( vnaf, v, size, ak_wpoint_wnaf_width );
+
+  ak_wpoint_set_as_unit( wr, ec );
+  for( i = ( ak_int64 )ak_max( ulen, vlen ) - 1; i >= 0; i-- ) {
+     ak_wpoint_jacobian_double( wr, minus3, ec );
+     if(( i < ( ak_int64 )ulen ) && unaf[i] )
+       ak_wpoint_add_wnaf_digit( wr, podd, ak_true, unaf[i], minus3, ec );
+     if(( i < ( ak_int64 )vlen ) && vnaf[i] )
+       ak_wpoint_add_wnaf_digit( wr, qodd, ak_false, vnaf[i], minus3, ec );
+  }
+  ak_wpoint_jacobian_get( wr, wr, ec );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -24,6 +24,9 @@
 #ifdef AK_HAVE_FNMATCH_H
  #include <fnmatch.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param filename Имя, для которого проводится проверка
@@ -268,6 +271,8 @@
 
  /* заполняем данные */
   file->size = ( ak_int64 )st.st_size;
+  file->addr = NULL;
+  file->mapsize = 0;
  #ifdef AK_HAVE_WINDOWS_H
   if(( file->hFile = CreateFile( filename,   /* name of the write */
                      GENERIC_READ,           /* open for reading */
@@ -284,7 +289,7 @@
   }
   file->blksize = 4096;
  #else
-  if(( file->fd = open( filename, O_SYNC|O_RDONLY )) < 0 ) {
+  if(( file->fd = open( filename, O_RDONLY | O_BINARY )) < 0 ) {
     if( ak_log_get_level() >= ak_log_maximum )
       ak_error_message_fmt( ak_error_open_file, __func__ ,
                                      "wrong opening a file %s [%s]", filename, strerror( errno ));
@@ -308,6 +313,8 @@
     return ak_error_message( ak_error_null_pointer, __func__, "using null pointer" );
 
   file->size = 0;
+  file->addr = NULL;
+  file->mapsize = 0;
  #ifdef AK_HAVE_WINDOWS_H
   if(( file->hFile = CreateFile( filename,   /* name of the write */
                      GENERIC_WRITE,          /* open for writing */
@@ -413,20 +420,450 @@
 
 /* ----------------------------------------------------------------------------------------------- */
                    /* Отображение файлов в память (обертка вокруг mmap) */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция отображает содержимое файла в память, начиная с заданного смещения, и
+    возвращает указатель на данные, расположенные по этому смещению. Отображаемая область
+    продолжается до конца файла; при отображении на чтение операционной системе сообщается,
+    что данные будут считываться последовательно.
+
+    Если имя файла не задано, то отображается файл, предварительно открытый, например,
+    с помощью функции ak_file_open_to_read(). После завершения работы с данными
+    необходимо вызвать функцию ak_file_unmap(), которая также закрывает файл.
+
+    \note Изменение длины файла другим процессом во время работы с отображенными данными
+    может привести к аварийному завершению программы.
+
+    @param file Контекст файла.
+    @param filename Имя файла или NULL, если используется уже открытый файл.
+    @param state Режим доступа к отображаемым данным.
+    @param offset Смещение (в октетах) от начала файла.
+    @return В случае успеха функция возвращает указатель на данные. В случае ошибки
+    возвращается NULL, а код ошибки может быть получен с помощью вызова функции
+    ak_error_get_value(). В случае ошибки файл, открытый функцией, закрывается.                   */
 /* ----------------------------------------------------------------------------------------------- */
  ak_pointer ak_file_mmap( ak_file file, const char *filename,
                                                      const filestate_t state, const size_t offset )
 {
- /* в ситуациях, когда mmap не определена, сразу выходим */
-#ifndef AK_HAVE_WINDOWS_H
- #ifndef AK_HAVE_SYSMMAN_H
-   return ak_error_undefined_function;
+#if defined( AK_HAVE_SYSMMAN_H ) || defined( AK_HAVE_WINDOWS_H )
+  size_t base = 0, granularity = 0;
+  int error = ak_error_ok;
+ #ifdef AK_HAVE_WINDOWS_H
+  SYSTEM_INFO si;
+  LARGE_INTEGER fsize;
+ #else
+  struct stat st;
+ #endif
+
+  if( file == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to file context" );
+    return NULL;
+  }
+
+ /* открываем файл */
+  if( filename != NULL ) {
+    if( state == readonly ) {
+      if(( error = ak_file_open_to_read( file, filename )) != ak_error_ok ) {
+        ak_error_set_value( error );
+        return NULL;
+      }
+    } else {
+      #ifdef AK_HAVE_WINDOWS_H
+       if(( file->hFile = CreateFile( filename, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL )) == INVALID_HANDLE_VALUE ) {
+         if( ak_log_get_level() >= ak_log_maximum )
+           ak_error_message_fmt( ak_error_open_file, __func__,
+                                                           "wrong opening a file %s", filename );
+         ak_error_set_value( ak_error_open_file );
+         return NULL;
+       }
+       if( !GetFileSizeEx( file->hFile, &fsize )) {
+         CloseHandle( file->hFile );
+         ak_error_set_value( ak_error_access_file );
+         return NULL;
+       }
+       file->size = ( ak_int64 )fsize.QuadPart;
+       file->blksize = 4096;
+      #else
+       if(( file->fd = open( filename, O_RDWR )) < 0 ) {
+         if( ak_log_get_level() >= ak_log_maximum )
+           ak_error_message_fmt( ak_error_open_file, __func__,
+                                     "wrong opening a file %s [%s]", filename, strerror( errno ));
+         ak_error_set_value( ak_error_open_file );
+         return NULL;
+       }
+       if( fstat( file->fd, &st )) {
+         close( file->fd );
+         ak_error_set_value( ak_error_access_file );
+         return NULL;
+       }
+       file->size = ( ak_int64 )st.st_size;
+       file->blksize = ( ak_int64 )st.st_blksize;
+      #endif
+    }
+  }
+  file->addr = NULL;
+  file->mapsize = 0;
+
+ /* проверяем, что отображаемая область не пуста и может быть адресована */
+  if(( file->size <= 0 ) || ( offset >= ( size_t )file->size ) ||
+                                          ( ( ak_uint64 )file->size > ( ak_uint64 )(( size_t )-1 ))) {
+    if( ak_log_get_level() >= ak_log_maximum )
+      ak_error_message( ak_error_wrong_length, __func__, "unsupported length of mapped data" );
+    error = ak_error_wrong_length;
+    goto lab_exit;
+  }
+
+ /* смещение отображаемой области должно быть кратно размеру страницы */
+ #ifdef AK_HAVE_WINDOWS_H
+  GetSystemInfo( &si );
+  granularity = ( size_t )si.dwAllocationGranularity;
+ #else
+  granularity = ( size_t )sysconf( _SC_PAGESIZE );
+ #endif
+  if( granularity == 0 ) granularity = 4096;
+  base = offset - ( offset%granularity );
+  file->mapsize = ( size_t )file->size - base;
+
+ #ifdef AK_HAVE_WINDOWS_H
+  if(( file->hMap = CreateFileMapping( file->hFile, NULL,
+                  state == readonly ? PAGE_READONLY : PAGE_READWRITE, 0, 0, NULL )) == NULL ) {
+    error = ak_error_mmap_file;
+    goto lab_exit;
+  }
+  if(( file->addr = MapViewOfFile( file->hMap, state == readonly ? FILE_MAP_READ : FILE_MAP_WRITE,
+          ( DWORD )(( ak_uint64 )base >> 32 ), ( DWORD )base, file->mapsize )) == NULL ) {
+    CloseHandle( file->hMap );
+    error = ak_error_mmap_file;
+    goto lab_exit;
+  }
+ #else
+  if(( file->addr = mmap( NULL, file->mapsize,
+                            ( state == readonly ) ? PROT_READ : (( state == writeonly ) ? PROT_WRITE :
+                                           PROT_READ | PROT_WRITE ), MAP_SHARED, file->fd,
+                                                              ( off_t )base )) == MAP_FAILED ) {
+    file->addr = NULL;
+    if( ak_log_get_level() >= ak_log_maximum )
+      ak_error_message_fmt( ak_error_mmap_file, __func__,
+                                                 "wrong mapping a file [%s]", strerror( errno ));
+    error = ak_error_mmap_file;
+    goto lab_exit;
+  }
+  #ifdef MADV_SEQUENTIAL
+   if( state == readonly ) madvise( file->addr, file->mapsize, MADV_SEQUENTIAL );
+  #endif
+ #endif
+ return ( ak_uint8 *)file->addr + ( offset - base );
+
+ lab_exit:
+  file->mapsize = 0;
+  if( filename != NULL ) ak_file_close( file );
+  ak_error_set_value( error );
+ return NULL;
+
+#else
+  ( void )file; ( void )filename; ( void )state; ( void )offset;
+  ak_error_set_value( ak_error_undefined_function );
+ return NULL;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет отображение файла в память, созданное функцией ak_file_mmap(),
+    после чего закрывает файл.
+
+    @param file Контекст файла.
+    @param ptr Указатель, возвращенный функцией ak_file_mmap().
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_unmap( ak_file file, ak_pointer ptr )
+{
+  int error = ak_error_ok;
+
+  if( file == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                             "using null pointer to file context" );
+  if(( file->addr == NULL ) || ( ptr == NULL ) || (( ak_uint8 *)ptr < ( ak_uint8 *)file->addr ) ||
+                               (( ak_uint8 *)ptr >= ( ak_uint8 *)file->addr + file->mapsize ))
+    return ak_error_message( ak_error_mmap_file, __func__, "using pointer to unmapped data" );
+
+#ifdef AK_HAVE_WINDOWS_H
+  if( !UnmapViewOfFile( file->addr )) error = ak_error_mmap_file;
+  CloseHandle( file->hMap );
+#else
+ #ifdef AK_HAVE_SYSMMAN_H
+  if( munmap( file->addr, file->mapsize ) != 0 ) error = ak_error_mmap_file;
  #endif
 #endif
+  file->addr = NULL;
+  file->mapsize = 0;
+  if( error != ak_error_ok ) ak_error_message( error, __func__, "wrong unmapping a file" );
+  if( ak_file_close( file ) != ak_error_ok ) error = ak_error_close_file;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                             функции потокового чтения файлов                                    */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заполняет буффер с заданным индексом данными из файла.
+
+    Чтение продолжается до заполнения буффера или до достижения конца файла, поэтому
+    неполный буффер всегда означает, что файл прочитан полностью.
+    @return Количество считанных октетов или -1 в случае ошибки чтения.                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static ssize_t ak_file_reader_fill( ak_file_reader reader, const size_t idx )
+{
+  ssize_t len = 0;
+  size_t total = 0;
+
+  while( total < reader->size ) {
+    if(( len = ak_file_read( &reader->file, reader->buffer[idx] + total,
+                                                                 reader->size - total )) < 0 ) {
+     #ifdef AK_HAVE_ERRNO_H
+      if( errno == EINTR ) continue;
+     #endif
+      return -1;
+    }
+    if( len == 0 ) break;
+    total += ( size_t )len;
+  }
+ return ( ssize_t )total;
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Данные вспомогательного потока опережающего чтения файла. */
+ typedef struct file_reader_thread {
+ /*! \brief Дескриптор потока. */
+  pthread_t thread;
+ /*! \brief Мьютекс, защищающий флаги готовности буфферов. */
+  pthread_mutex_t mutex;
+ /*! \brief Условная переменная, сигнализирующая об изменении флагов. */
+  pthread_cond_t cond;
+ /*! \brief Флаги готовности: буффер заполнен и ожидает обработки пользователем. */
+  bool_t ready[2];
+ /*! \brief Флаг досрочного завершения работы потока. */
+  bool_t stop;
+ } *ak_file_reader_thread;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция опережающего чтения: поочередно заполняет освободившиеся буфферы. */
+ static void *ak_file_reader_run( void *ptr )
+{
+  size_t idx = 0;
+  ak_file_reader reader = ( ak_file_reader )ptr;
+  ak_file_reader_thread th = ( ak_file_reader_thread )reader->thread;
+
+  for( ;; ) {
+    pthread_mutex_lock( &th->mutex );
+    while( th->ready[idx] && !th->stop ) pthread_cond_wait( &th->cond, &th->mutex );
+    if( th->stop ) {
+      pthread_mutex_unlock( &th->mutex );
+      break;
+    }
+    pthread_mutex_unlock( &th->mutex );
 
- ak_error_message( ak_error_undefined_function, __func__, "this function is'nt well developed" );
+   /* чтение выполняется без блокировки: пользователь не обращается к неготовому буфферу */
+    reader->length[idx] = ak_file_reader_fill( reader, idx );
+
+    pthread_mutex_lock( &th->mutex );
+    th->ready[idx] = ak_true;
+    pthread_cond_signal( &th->cond );
+    pthread_mutex_unlock( &th->mutex );
+
+   /* неполный буффер означает конец файла или ошибку чтения */
+    if( reader->length[idx] < ( ssize_t )reader->size ) break;
+    idx ^= 1;
+  }
  return NULL;
 }
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция открывает файл на чтение и подготавливает два буффера заданного размера
+    (см. ak_file_reader_open_file()).
+
+    @param reader Контекст потокового чтения.
+    @param filename Имя файла.
+    @param size Размер одного буффера в октетах.
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_reader_open( ak_file_reader reader, const char *filename, const size_t size )
+{
+  int error = ak_error_ok;
+  struct file file;
+
+  if( reader == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to reader context" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  if(( error = ak_file_open_to_read( &file, filename )) != ak_error_ok ) return error;
+
+ return ak_file_reader_open_file( reader, &file, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция подготавливает два буффера заданного размера для потокового чтения файла,
+    предварительно открытого с помощью функции ak_file_open_to_read(). Контекст файла
+    копируется в контекст потокового чтения, и файл закрывается функцией
+    ak_file_reader_close() (в случае ошибки файл закрывается сразу).
+
+    Если размер файла превышает размер одного буффера и библиотека собрана с поддержкой
+    pthreads, запускается вспомогательный поток, который считывает следующий фрагмент файла
+    одновременно с обработкой текущего. Операционной системе сообщается о последовательном
+    характере доступа к файлу.
+
+    @param reader Контекст потокового чтения.
+    @param file Контекст открытого на чтение файла.
+    @param size Размер одного буффера в октетах; значение приводится к интервалу
+    от \ref ak_file_reader_min_buffer_size до \ref ak_file_reader_max_buffer_size
+    и уменьшается, если файл короче. Размер буффера всегда кратен 4096 октетам,
+    что позволяет обрабатывать полные фрагменты блочными алгоритмами без остатка.
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_reader_open_file( ak_file_reader reader, ak_file file, const size_t size )
+{
+  if( file == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                             "using null pointer to file context" );
+  if( reader == NULL ) {
+    ak_file_close( file );
+    return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to reader context" );
+  }
+  memset( reader, 0, sizeof( struct file_reader ));
+  memcpy( &reader->file, file, sizeof( struct file ));
+
+  reader->size = ak_min( ak_max( size, ak_file_reader_min_buffer_size ),
+                                                   ak_file_reader_max_buffer_size ) & ~(size_t)0xfff;
+  if(( reader->file.size >= 0 ) && (( ak_uint64 )reader->file.size < reader->size ))
+    reader->size = ak_max( 4096, (( size_t )reader->file.size + 0xfff ) & ~(size_t)0xfff );
+  reader->current = ak_file_reader_no_buffer; /* пользователю еще ничего не передано */
+
+ #ifdef AK_HAVE_POSIX_FADVISE
+  posix_fadvise( reader->file.fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+ #endif
+
+ /* буфферы размещаются в одной области памяти */
+  if(( reader->buffer[0] = ak_aligned_malloc( reader->size << 1 )) == NULL ) {
+    ak_file_close( &reader->file );
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                        "memory allocation error for buffers" );
+  }
+  reader->buffer[1] = reader->buffer[0] + reader->size;
+
+ #ifdef AK_HAVE_PTHREAD_H
+ /* поток запускается только в том случае, когда файл не помещается в один буффер */
+  if(( ak_uint64 )reader->file.size > reader->size ) {
+    ak_file_reader_thread th = NULL;
+    if(( th = malloc( sizeof( struct file_reader_thread ))) != NULL ) {
+      memset( th, 0, sizeof( struct file_reader_thread ));
+      pthread_mutex_init( &th->mutex, NULL );
+      pthread_cond_init( &th->cond, NULL );
+      reader->thread = th;
+      if( pthread_create( &th->thread, NULL, ak_file_reader_run, reader ) != 0 ) {
+       /* продолжаем работу без опережающего чтения */
+        pthread_cond_destroy( &th->cond );
+        pthread_mutex_destroy( &th->mutex );
+        free( th );
+        reader->thread = NULL;
+      }
+    }
+  }
+ #endif
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возвращает указатель на очередной фрагмент файла. Данные фрагмента остаются
+    доступными до следующего вызова функции; при этом предыдущий фрагмент освобождается
+    для опережающего чтения. Все фрагменты, кроме последнего, имеют длину, равную размеру
+    буффера, поэтому фрагмент меньшей длины (в том числе нулевой) означает конец файла.
+
+    @param reader Контекст потокового чтения.
+    @param ptr Указатель, по которому будет помещен адрес считанных данных.
+    @return Длина фрагмента в октетах; ноль при достижении конца файла;
+    отрицательное значение в случае ошибки.                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ ssize_t ak_file_reader_next( ak_file_reader reader, ak_pointer *ptr )
+{
+  size_t idx = 0;
+
+  if(( reader == NULL ) || ( ptr == NULL )) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer" );
+    return -1;
+  }
+  *ptr = NULL;
+  if( reader->eof ) return 0;
+ /* первый вызов возвращает нулевой буффер, далее буфферы чередуются */
+  idx = ( reader->current == ak_file_reader_no_buffer ) ? 0 : reader->current^1;
+
+ #ifdef AK_HAVE_PTHREAD_H
+  if( reader->thread != NULL ) {
+    ak_file_reader_thread th = ( ak_file_reader_thread )reader->thread;
+
+    pthread_mutex_lock( &th->mutex );
+   /* освобождаем буффер, обработанный пользователем (если он был ему передан) */
+    if( reader->current != ak_file_reader_no_buffer ) {
+      th->ready[reader->current] = ak_false;
+      pthread_cond_signal( &th->cond );
+    }
+    while( !th->ready[idx] ) pthread_cond_wait( &th->cond, &th->mutex );
+    pthread_mutex_unlock( &th->mutex );
+  } else
+ #endif
+     reader->length[idx] = ak_file_reader_fill( reader, idx );
+
+  reader->current = idx;
+  if( reader->length[idx] < ( ssize_t )reader->size ) reader->eof = ak_true;
+  if( reader->length[idx] < 0 ) {
+    ak_error_message_fmt( ak_error_read_data, __func__, "wrong reading a file [%s]",
+                                                                              strerror( errno ));
+    return -1;
+  }
+  *ptr = reader->buffer[idx];
+
+ return reader->length[idx];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция останавливает вспомогательный поток (если он был запущен), освобождает память
+    и закрывает файл.
+
+    @param reader Контекст потокового чтения.
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_file_reader_close( ak_file_reader reader )
+{
+  if( reader == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to reader context" );
+ #ifdef AK_HAVE_PTHREAD_H
+  if( reader->thread != NULL ) {
+    ak_file_reader_thread th = ( ak_file_reader_thread )reader->thread;
+
+    pthread_mutex_lock( &th->mutex );
+    th->stop = ak_true;
+    pthread_cond_signal( &th->cond );
+    pthread_mutex_unlock( &th->mutex );
+    pthread_join( th->thread, NULL );
+    pthread_cond_destroy( &th->cond );
+    pthread_mutex_destroy( &th->mutex );
+    free( th );
+    reader->thread = NULL;
+  }
+ #endif
+  if( reader->buffer[0] != NULL ) {
+    memset( reader->buffer[0], 0, reader->size << 1 );
+    free( reader->buffer[0] );
+  }
+  reader->buffer[0] = reader->buffer[1] = NULL;
+  reader->size = 0;
+
+ return ak_file_close( &reader->file );
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \example example-file.c                                                                        */
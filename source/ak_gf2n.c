@@ -279,6 +279,50 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений элементов двух последовательностей
+    элементов конечного поля \f$ \mathbb F_{2^{64}}\f$ и прибавляет ее к значению `z`, т.е.
+    \f$ z = z + \sum_{i=0}^{count-1} a_i b_i\f$. Для умножения используется
+    функция ak_gf64_mul_uint64().
+
+    @param z Указатель на элемент поля, к которому прибавляется сумма произведений.
+    @param a Указатель на последовательность из `count` элементов поля.
+    @param b Указатель на последовательность из `count` элементов поля.
+    @param count Количество слагаемых.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf64_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  size_t i = 0;
+  ak_uint64 t = 0;
+
+  for( i = 0; i < count; i++ ) {
+     ak_gf64_mul_uint64( &t, (ak_uint64 *)a + i, (ak_uint64 *)b + i );
+     ((ak_uint64 *)z)[0] ^= t;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений элементов двух последовательностей
+    элементов конечного поля \f$ \mathbb F_{2^{128}}\f$ и прибавляет ее к значению `z`.
+    Для умножения используется функция ak_gf128_mul_uint64().
+
+    @param z Указатель на элемент поля, к которому прибавляется сумма произведений.
+    @param a Указатель на последовательность из `count` элементов поля.
+    @param b Указатель на последовательность из `count` элементов поля.
+    @param count Количество слагаемых.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  size_t i = 0;
+  ak_uint64 t[2];
+
+  for( i = 0; i < count; i++ ) {
+     ak_gf128_mul_uint64( t, (ak_uint64 *)a + 2*i, (ak_uint64 *)b + 2*i );
+     ((ak_uint64 *)z)[0] ^= t[0];
+     ((ak_uint64 *)z)[1] ^= t[1];
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
 
@@ -374,6 +418,131 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений элементов двух последовательностей
+    элементов конечного поля \f$ \mathbb F_{2^{64}}\f$ и прибавляет ее к значению `z`.
+
+    Произведения многочленов, вычисляемые командой PCLMULQDQ, складываются без приведения;
+    приведение по модулю многочлена \f$ f(x) \f$ выполняется один раз для всей суммы
+    так же, как в функции ak_gf64_mul_pcmulqdq().
+
+    @param z Указатель на элемент поля, к которому прибавляется сумма произведений.
+    @param a Указатель на последовательность из `count` элементов поля.
+    @param b Указатель на последовательность из `count` элементов поля.
+    @param count Количество слагаемых.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf64_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  size_t i = 0;
+#ifdef _MSC_VER
+	 __m128i gm, xm, ym, cm, cx;
+
+	 gm.m128i_u64[0] = 0x1B; gm.m128i_u64[1] = 0;
+	 cm = _mm_setzero_si128();
+	 for( i = 0; i < count; i++ ) {
+	    xm.m128i_u64[0] = ((ak_uint64 *)a)[i]; xm.m128i_u64[1] = 0;
+	    ym.m128i_u64[0] = ((ak_uint64 *)b)[i]; ym.m128i_u64[1] = 0;
+	    cm = _mm_xor_si128( cm, _mm_clmulepi64_si128(xm, ym, 0x00));
+	 }
+	 cx.m128i_u64[0] = cm.m128i_u64[1]; cx.m128i_u64[1] = 0;
+
+	 xm = _mm_clmulepi64_si128(cx, gm, 0x00);
+	 xm.m128i_u64[1] ^= cx.m128i_u64[0];
+	 ym.m128i_u64[0] = xm.m128i_u64[1]; ym.m128i_u64[1] = 0;
+	 xm = _mm_clmulepi64_si128(ym, gm, 0x00);
+
+	 ((ak_uint64 *)z)[0] ^= cm.m128i_u64[0] ^ xm.m128i_u64[0];
+#else
+  const __m128i gm = _mm_set_epi64x( 0, 0x1B );
+  __m128i xm, ym, cx, cm = _mm_setzero_si128();
+
+ /* суммируем произведения без приведения */
+  for( i = 0; i < count; i++ ) {
+     xm = _mm_set_epi64x( 0, ((ak_uint64 *)a)[i] );
+     ym = _mm_set_epi64x( 0, ((ak_uint64 *)b)[i] );
+     cm ^= _mm_clmulepi64_si128( xm, ym, 0x00 );
+  }
+
+ /* однократное приведение */
+  cx = _mm_set_epi64x( 0, cm[1] );
+  xm = _mm_clmulepi64_si128( cx, gm, 0x00 ); xm[1] ^= cx[0];
+  ym = _mm_set_epi64x( 0, xm[1] );
+  xm = _mm_clmulepi64_si128( ym, gm, 0x00 );
+
+  ((ak_uint64 *)z)[0] ^= cm[0]^xm[0];
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет сумму попарных произведений элементов двух последовательностей
+    элементов конечного поля \f$ \mathbb F_{2^{128}}\f$ и прибавляет ее к значению `z`.
+
+    Для каждой пары сомножителей вычисляются три произведения 64-битных многочленов
+    (по методу Карацубы), которые складываются без приведения. Приведение по модулю
+    многочлена \f$ f(x) \f$ выполняется один раз для всей суммы так же,
+    как в функции ak_gf128_mul_pcmulqdq().
+
+    @param z Указатель на элемент поля, к которому прибавляется сумма произведений.
+    @param a Указатель на последовательность из `count` элементов поля.
+    @param b Указатель на последовательность из `count` элементов поля.
+    @param count Количество слагаемых.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_gf128_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count )
+{
+  size_t i = 0;
+#ifdef _MSC_VER
+	 __m128i am, bm, cm, dm, km, em;
+	 ak_uint64 x3, D;
+
+	 cm = dm = km = _mm_setzero_si128();
+	 for( i = 0; i < count; i++ ) {
+	    am = _mm_loadu_si128( (__m128i *)a + i );
+	    bm = _mm_loadu_si128( (__m128i *)b + i );
+	    cm = _mm_xor_si128( cm, _mm_clmulepi64_si128(am, bm, 0x00)); // c += a0*b0
+	    dm = _mm_xor_si128( dm, _mm_clmulepi64_si128(am, bm, 0x11)); // d += a1*b1
+	    am = _mm_xor_si128( am, _mm_shuffle_epi32( am, 0x4E ));
+	    bm = _mm_xor_si128( bm, _mm_shuffle_epi32( bm, 0x4E ));
+	    km = _mm_xor_si128( km, _mm_clmulepi64_si128(am, bm, 0x00)); // k += (a0+a1)*(b0+b1)
+	 }
+	 em = _mm_xor_si128( km, _mm_xor_si128( cm, dm )); // e = a0*b1 + a1*b0
+
+	/* приведение */
+	 x3 = dm.m128i_u64[1];
+	 D = dm.m128i_u64[0] ^ em.m128i_u64[1] ^ (x3 >> 63) ^ (x3 >> 62) ^ (x3 >> 57);
+
+	 cm.m128i_u64[0] ^= D ^ (D << 1) ^ (D << 2) ^ (D << 7);
+	 cm.m128i_u64[1] ^= em.m128i_u64[0] ^ x3 ^ (x3 << 1) ^ (D >> 63) ^ (x3 << 2) ^ (D >> 62) ^ (x3 << 7) ^ (D >> 57);
+
+	 ((ak_uint64 *)z)[0] ^= cm.m128i_u64[0];
+	 ((ak_uint64 *)z)[1] ^= cm.m128i_u64[1];
+#else
+	 __m128i am, bm, em, cm = _mm_setzero_si128(), dm = cm, km = cm;
+	 ak_uint64 x3, D;
+
+	 /* умножение со сложением без приведения */
+	 for( i = 0; i < count; i++ ) {
+	    am = _mm_loadu_si128( (__m128i *)a + i );
+	    bm = _mm_loadu_si128( (__m128i *)b + i );
+	    cm ^= _mm_clmulepi64_si128(am, bm, 0x00); // c += a0*b0
+	    dm ^= _mm_clmulepi64_si128(am, bm, 0x11); // d += a1*b1
+	    am ^= _mm_shuffle_epi32( am, 0x4E );
+	    bm ^= _mm_shuffle_epi32( bm, 0x4E );
+	    km ^= _mm_clmulepi64_si128(am, bm, 0x00); // k += (a0+a1)*(b0+b1)
+	 }
+	 em = km ^ cm ^ dm; // e = a0*b1 + a1*b0
+
+	 /* приведение */
+	 x3 = dm[1];
+	 D = dm[0] ^ em[1] ^ (x3 >> 63) ^ (x3 >> 62) ^ (x3 >> 57);
+
+	 cm[0] ^= D ^ (D << 1) ^ (D << 2) ^ (D << 7);
+	 cm[1] ^= em[0] ^ x3 ^ (x3 << 1) ^ (D >> 63) ^ (x3 << 2) ^ (D >> 62) ^ (x3 << 7) ^ (D >> 57);
+
+	 ((ak_uint64 *)z)[0] ^= cm[0];
+	 ((ak_uint64 *)z)[1] ^= cm[1];
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция реализует операцию умножения двух элементов конечного поля \f$ \mathbb F_{2^{256}}\f$,
     порожденного неприводимым многочленом
@@ -877,6 +1046,29 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
  if( ak_log_get_level() >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__, "one thousand iterations for random values is Ok");
 #endif
+
+ /* сумма произведений, вычисляемая с однократным приведением,
+    совпадает с суммой отдельно вычисленных произведений */
+ for( i = 0, z1 = 0; i < 8; i++ ) {
+    ak_gf64_mul_uint64( &z, &values[i], &values[(i+3)&7] );
+    z1 ^= z;
+ }
+ z = 0;
+ ak_gf64_mul_sum_uint64( &z, values, values+3, 5 );
+ ak_gf64_mul_sum_uint64( &z, values+5, values, 3 );
+ if( z != z1 ) {
+   ak_error_message( ak_error_not_equal_data, __func__ , "wrong sum of products with uint64" );
+   return ak_false;
+ }
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ z = 0;
+ ak_gf64_mul_sum_pcmulqdq( &z, values, values+3, 5 );
+ ak_gf64_mul_sum_pcmulqdq( &z, values+5, values, 3 );
+ if( z != z1 ) {
+   ak_error_message( ak_error_not_equal_data, __func__ , "wrong sum of products with pcmulqdq" );
+   return ak_false;
+ }
+#endif
  return ak_true;
 }
 
@@ -892,6 +1084,7 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
  ak_uint8 m8[16] = {
       0xd2, 0x06, 0x35, 0x32, 0xda, 0x10, 0x4e, 0x7e, 0x2e, 0xd1, 0x5e, 0x9a, 0xa0, 0x29, 0x02, 0x04 };
  ak_uint8 result[16], result2[16];
+ ak_uint64 av[16], bv[16];
 
  ak_uint128 a, b, m;
 #ifdef AK_LITTLE_ENDIAN
@@ -964,6 +1157,35 @@ void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b )
    ak_error_message( ak_error_ok, __func__, "one thousand iterations for random values is Ok");
 #endif
 
+ /* сумма произведений, вычисляемая с однократным приведением,
+    совпадает с суммой отдельно вычисленных произведений */
+ for( i = 0; i < 16; i++ ) {
+    av[i] = a.q[i&1] ^ ( 0x9e3779b97f4a7c15LL*( ak_uint64 )i );
+    bv[i] = b.q[i&1] + ( 0xc2b2ae3d27d4eb4fLL*( ak_uint64 )i );
+ }
+ memset( result, 0, 16 );
+ for( i = 0; i < 8; i++ ) {
+    ak_gf128_mul_uint64( result2, av+2*i, bv+2*i );
+    ((ak_uint64 *)result)[0] ^= ((ak_uint64 *)result2)[0];
+    ((ak_uint64 *)result)[1] ^= ((ak_uint64 *)result2)[1];
+ }
+ memset( result2, 0, 16 );
+ ak_gf128_mul_sum_uint64( result2, av, bv, 8 );
+ if( !ak_ptr_is_equal_with_log( result, result2, 16 )) {
+   ak_error_message( ak_error_ok, __func__, "wrong sum of products with uint64" );
+   goto lexit;
+ }
+#ifdef AK_HAVE_BUILTIN_CLMULEPI64
+ memset( result2, 0, 16 );
+ ak_gf128_mul_sum_pcmulqdq( result2, av, bv, 8 );
+ if( !ak_ptr_is_equal_with_log( result, result2, 16 )) {
+   ak_error_message( ak_error_ok, __func__, "wrong sum of products with pcmulqdq" );
+   goto lexit;
+ }
+#endif
+ if( ak_log_get_level() >= ak_log_maximum )
+   ak_error_message( ak_error_ok, __func__, "sum of products with single reduction is Ok");
+
  return ak_true;
 
   lexit: ak_error_set_value( ak_error_not_equal_data );
@@ -5,6 +5,9 @@
 /*  - содержит реализацию алгоритмов итерационного сжатия                                          */
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM512 )
+ #include <immintrin.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Итерационные константы для алгоритма Стрибог (ГОСТ Р 34.11-2012). */
@@ -1226,12 +1229,11 @@
    for( i = 0; i < 8; i++ )
    {
     #ifdef AK_LITTLE_ENDIAN
-      if( carry ) {
-                    ctx->sigma[i] ++;
-                    if( ctx->sigma[i] ) carry = 0;
-      }
-      ctx->sigma[i] += data[i];
-      if( ctx->sigma[i] < data[i] ) carry = 1;
+      ak_uint64 val_sigma = ctx->sigma[i] + carry;
+      carry = ( val_sigma < carry );
+      val_sigma += data[i];
+      carry |= ( val_sigma < data[i] );
+      ctx->sigma[i] = val_sigma;
     #else
       ak_uint64 val_data = bswap_64( data[i] ),
                val_sigma = bswap_64( ctx->sigma[i] );
@@ -1246,6 +1248,327 @@
    }
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработка последовательности блоков сообщения (переносимая реализация).
+    \note Мы предполагаем, что количество блоков отлично от нуля.                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hash_context_streebog_blocks( ak_streebog ctx, const ak_uint64 *dt, size_t quot )
+{
+  do{
+      ak_hash_context_streebog_g( ctx, ctx->n, dt );
+      ak_hash_context_streebog_add( ctx, 512 );
+      ak_hash_context_streebog_sadd( ctx, dt );
+      quot--; dt += 8;
+  } while( quot > 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, применяемое к нескольким независимым состояниям
+    (переносимая реализация).
+    \note Мы предполагаем, что количество состояний не превосходит \ref ak_hash_multi_lanes.     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hash_context_streebog_g_lanes( ak_streebog *ctx,
+                                      const ak_uint64 **n, const ak_uint64 **m, const size_t count )
+{
+  size_t j = 0;
+  for( j = 0; j < count; j++ ) ak_hash_context_streebog_g( ctx[j], ( ak_uint64 *)n[j], m[j] );
+}
+
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM512 )
+/* ----------------------------------------------------------------------------------------------- */
+/*                  реализация с использованием наборов инструкций AVX-512 и GFNI                  */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Атрибут функций, использующих инструкции AVX-512 и GFNI. */
+ #define ak_streebog_gfni_target \
+                             __attribute__(( target( "avx512f,avx512bw,avx512vbmi,gfni" )))
+
+/*! \brief Нелинейная перестановка \f$ \pi \f$ из ГОСТ Р 34.11-2012. */
+ static const ak_uint8 streebog_pi[256] = {
+   0xFC, 0xEE, 0xDD, 0x11, 0xCF, 0x6E, 0x31, 0x16, 0xFB, 0xC4, 0xFA, 0xDA, 0x23, 0xC5, 0x04, 0x4D,
+   0xE9, 0x77, 0xF0, 0xDB, 0x93, 0x2E, 0x99, 0xBA, 0x17, 0x36, 0xF1, 0xBB, 0x14, 0xCD, 0x5F, 0xC1,
+   0xF9, 0x18, 0x65, 0x5A, 0xE2, 0x5C, 0xEF, 0x21, 0x81, 0x1C, 0x3C, 0x42, 0x8B, 0x01, 0x8E, 0x4F,
+   0x05, 0x84, 0x02, 0xAE, 0xE3, 0x6A, 0x8F, 0xA0, 0x06, 0x0B, 0xED, 0x98, 0x7F, 0xD4, 0xD3, 0x1F,
+   0xEB, 0x34, 0x2C, 0x51, 0xEA, 0xC8, 0x48, 0xAB, 0xF2, 0x2A, 0x68, 0xA2, 0xFD, 0x3A, 0xCE, 0xCC,
+   0xB5, 0x70, 0x0E, 0x56, 0x08, 0x0C, 0x76, 0x12, 0xBF, 0x72, 0x13, 0x47, 0x9C, 0xB7, 0x5D, 0x87,
+   0x15, 0xA1, 0x96, 0x29, 0x10, 0x7B, 0x9A, 0xC7, 0xF3, 0x91, 0x78, 0x6F, 0x9D, 0x9E, 0xB2, 0xB1,
+   0x32, 0x75, 0x19, 0x3D, 0xFF, 0x35, 0x8A, 0x7E, 0x6D, 0x54, 0xC6, 0x80, 0xC3, 0xBD, 0x0D, 0x57,
+   0xDF, 0xF5, 0x24, 0xA9, 0x3E, 0xA8, 0x43, 0xC9, 0xD7, 0x79, 0xD6, 0xF6, 0x7C, 0x22, 0xB9, 0x03,
+   0xE0, 0x0F, 0xEC, 0xDE, 0x7A, 0x94, 0xB0, 0xBC, 0xDC, 0xE8, 0x28, 0x50, 0x4E, 0x33, 0x0A, 0x4A,
+   0xA7, 0x97, 0x60, 0x73, 0x1E, 0x00, 0x62, 0x44, 0x1A, 0xB8, 0x38, 0x82, 0x64, 0x9F, 0x26, 0x41,
+   0xAD, 0x45, 0x46, 0x92, 0x27, 0x5E, 0x55, 0x2F, 0x8C, 0xA3, 0xA5, 0x7D, 0x69, 0xD5, 0x95, 0x3B,
+   0x07, 0x58, 0xB3, 0x40, 0x86, 0xAC, 0x1D, 0xF7, 0x30, 0x37, 0x6B, 0xE4, 0x88, 0xD9, 0xE7, 0x89,
+   0xE1, 0x1B, 0x83, 0x49, 0x4C, 0x3F, 0xF8, 0xFE, 0x8D, 0x53, 0xAA, 0x90, 0xCA, 0xD8, 0x85, 0x61,
+   0x20, 0x71, 0x67, 0xA4, 0x2D, 0x2B, 0x09, 0x5B, 0xCB, 0x9B, 0x25, 0xD0, 0xBE, 0xE5, 0x6C, 0x52,
+   0x59, 0xA6, 0x74, 0xD2, 0xE6, 0xF4, 0xB4, 0xC0, 0xD1, 0x66, 0xAF, 0xC2, 0x39, 0x4B, 0x63, 0xB6
+ };
+
+/*! \brief Константы, используемые реализацией преобразования LPS с инструкциями GFNI.
+
+    Преобразование L линейно над \f$ \mathbb F_2 \f$, поэтому вклад \f$ i \f$-го байта строки
+    в \f$ j \f$-й байт результата задается двоичной матрицей размера \f$ 8\times 8 \f$,
+    которая применяется инструкцией `vgf2p8affineqb`. Если в \f$ j \f$-м 64-х битном слове
+    регистра размещена матрица для пары \f$ (i, j) \f$, а сам регистр заполнен копиями
+    \f$ i \f$-й строки, то сумма восьми таких произведений содержит транспонированный
+    результат преобразования; транспонирование выполняется одной инструкцией `vpermb`.
+    Нелинейная перестановка S вычисляется инструкцией `vpermi2b`.                                 */
+ static struct streebog_gfni_params {
+  /*! \brief Нелинейная перестановка. */
+   ak_uint8 pi[256];
+  /*! \brief Матрицы, `matrix[i][j]` определяет вклад i-го байта строки в j-й байт результата. */
+   ak_uint64 matrix[8][8];
+  /*! \brief Индексы транспонирования матрицы байт размера \f$ 8\times 8 \f$. */
+   ak_uint8 transpose[64];
+ } streebog_gfni __attribute__(( aligned( 64 )));
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает константы реализации с инструкциями GFNI по таблице
+    `streebog_Areverse_expand_with_pi`.
+    \return Функция возвращает \ref ak_true, если таблица определяет линейное
+    (после обращения перестановки) преобразование и константы выработаны.                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_hash_streebog_gfni_init_tables( void )
+{
+  int i, j, r, k, a, b;
+  ak_uint8 pinv[256];
+
+  for( a = 0; a < 256; a++ ) pinv[streebog_pi[a]] = ( ak_uint8 )a;
+  for( i = 0; i < 8; i++ ) {
+    /* проверяем линейность i-й части преобразования L */
+     for( a = 0; a < 256; a++ )
+        for( b = 0; b < 256; b++ )
+           if( streebog_Areverse_expand_with_pi[i][pinv[a^b]] !=
+              ( streebog_Areverse_expand_with_pi[i][pinv[a]]^
+                                      streebog_Areverse_expand_with_pi[i][pinv[b]] )) return ak_false;
+    /* строка r матрицы определяет r-й бит результата */
+     for( j = 0; j < 8; j++ ) {
+        ak_uint64 matrix = 0;
+        for( r = 0; r < 8; r++ ) {
+           ak_uint64 row = 0;
+           for( k = 0; k < 8; k++ )
+              row |= (( streebog_Areverse_expand_with_pi[i][pinv[1 << k]] >> ( 8*j + r ))&0x1 ) << k;
+           matrix |= row << ( 8*( 7-r ));
+        }
+        streebog_gfni.matrix[i][j] = matrix;
+     }
+  }
+  memcpy( streebog_gfni.pi, streebog_pi, 256 );
+  for( i = 0; i < 8; i++ )
+     for( j = 0; j < 8; j++ ) streebog_gfni.transpose[8*i+j] = ( ak_uint8 )( 8*j+i );
+ return ak_true;
+}
+
+/*! \brief Загрузка констант реализации в векторные регистры. */
+ #define ak_streebog_gfni_load_constants \
+  __m512i s0 = _mm512_load_si512( streebog_gfni.pi ), \
+          s1 = _mm512_load_si512( streebog_gfni.pi + 64 ), \
+          s2 = _mm512_load_si512( streebog_gfni.pi + 128 ), \
+          s3 = _mm512_load_si512( streebog_gfni.pi + 192 ), \
+          tp = _mm512_load_si512( streebog_gfni.transpose ), \
+          mt[8] = { \
+            _mm512_load_si512( streebog_gfni.matrix[0] ), _mm512_load_si512( streebog_gfni.matrix[1] ), \
+            _mm512_load_si512( streebog_gfni.matrix[2] ), _mm512_load_si512( streebog_gfni.matrix[3] ), \
+            _mm512_load_si512( streebog_gfni.matrix[4] ), _mm512_load_si512( streebog_gfni.matrix[5] ), \
+            _mm512_load_si512( streebog_gfni.matrix[6] ), _mm512_load_si512( streebog_gfni.matrix[7] ) }
+
+/*! \brief Вклад i-й строки в результат преобразования L. */
+ #define ak_streebog_gfni_row( x, i ) _mm512_gf2p8affine_epi64_epi8( \
+                          _mm512_permutexvar_epi64( _mm512_set1_epi64( i ), x ), mt[i], 0 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование LPS, выполняемое над 512-ти битным регистром. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static inline __m512i ak_hash_context_streebog_lps_gfni( __m512i x,
+                   __m512i s0, __m512i s1, __m512i s2, __m512i s3, const __m512i *mt, __m512i tp )
+{
+  __m512i lo = _mm512_permutex2var_epi8( s0, x, s1 ), hi = _mm512_permutex2var_epi8( s2, x, s3 );
+
+  x = _mm512_mask_blend_epi8( _mm512_movepi8_mask( x ), lo, hi );
+  x = _mm512_ternarylogic_epi64(
+        _mm512_ternarylogic_epi64( ak_streebog_gfni_row( x, 0 ),
+                                  ak_streebog_gfni_row( x, 1 ), ak_streebog_gfni_row( x, 2 ), 0x96 ),
+        _mm512_ternarylogic_epi64( ak_streebog_gfni_row( x, 3 ),
+                                  ak_streebog_gfni_row( x, 4 ), ak_streebog_gfni_row( x, 5 ), 0x96 ),
+        _mm512_xor_si512( ak_streebog_gfni_row( x, 6 ), ak_streebog_gfni_row( x, 7 )), 0x96 );
+ return _mm512_permutexvar_epi8( tp, x );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, выполняемое над 512-ти битными регистрами.
+    \return Новое значение переменной h.                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static inline __m512i ak_hash_context_streebog_g_gfni_internal(
+                                                                __m512i h, __m512i n, __m512i m,
+                   __m512i s0, __m512i s1, __m512i s2, __m512i s3, const __m512i *mt, __m512i tp )
+{
+  int idx = 0;
+  __m512i K = ak_hash_context_streebog_lps_gfni( _mm512_xor_si512( h, n ), s0, s1, s2, s3, mt, tp ),
+          T = m;
+
+  for( idx = 0; idx < 12; idx++ ) {
+     T = ak_hash_context_streebog_lps_gfni( _mm512_xor_si512( T, K ), s0, s1, s2, s3, mt, tp );
+     K = ak_hash_context_streebog_lps_gfni(
+             _mm512_xor_si512( K, _mm512_loadu_si512( streebog_c[idx] )), s0, s1, s2, s3, mt, tp );
+  }
+ return _mm512_ternarylogic_epi64( h, T, _mm512_xor_si512( K, m ), 0x96 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сложение двух 512-ти битных чисел по модулю \f$ 2^{512} \f$.
+
+    Слова складываются независимо, после чего переносы вычисляются с помощью масок:
+    маска `g` отмечает слова, в которых возник перенос, маска `p` - слова, передающие
+    поступивший перенос дальше (все единицы). Величина \f$ ((g \ll 1) + p) \oplus p \f$
+    отмечает слова, к которым необходимо прибавить единицу.                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static inline __m512i ak_hash_context_streebog_sadd_gfni(
+                                                                          __m512i sigma, __m512i m )
+{
+  __m512i ones = _mm512_set1_epi64( -1 ), sum = _mm512_add_epi64( sigma, m );
+  unsigned int g = _mm512_cmplt_epu64_mask( sum, m ), p = _mm512_cmpeq_epi64_mask( sum, ones );
+
+ return _mm512_mask_sub_epi64( sum, ( __mmask8 )((( g << 1 ) + p ) ^ p ), sum, ones );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G с использованием инструкций AVX-512 и GFNI. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static void ak_hash_context_streebog_g_gfni( ak_streebog ctx,
+                                                                ak_uint64 *n, const ak_uint64 *m )
+{
+  ak_streebog_gfni_load_constants;
+
+  _mm512_storeu_si512( ctx->h, ak_hash_context_streebog_g_gfni_internal(
+       _mm512_loadu_si512( ctx->h ), n == NULL ? _mm512_setzero_si512() : _mm512_loadu_si512( n ),
+                                        _mm512_loadu_si512( m ), s0, s1, s2, s3, mt, tp ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработка последовательности блоков сообщения с использованием инструкций
+    AVX-512 и GFNI; переменные h и \f$ \Sigma \f$ на протяжении всей обработки хранятся
+    в регистрах. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static void ak_hash_context_streebog_blocks_gfni( ak_streebog ctx,
+                                                                const ak_uint64 *dt, size_t quot )
+{
+  __m512i h = _mm512_loadu_si512( ctx->h ), sigma = _mm512_loadu_si512( ctx->sigma ), m;
+  ak_streebog_gfni_load_constants;
+
+  do{
+      m = _mm512_loadu_si512( dt );
+      h = ak_hash_context_streebog_g_gfni_internal( h,
+                                        _mm512_loadu_si512( ctx->n ), m, s0, s1, s2, s3, mt, tp );
+      ak_hash_context_streebog_add( ctx, 512 );
+      sigma = ak_hash_context_streebog_sadd_gfni( sigma, m );
+      quot--; dt += 8;
+  } while( quot > 0 );
+
+  _mm512_storeu_si512( ctx->h, h );
+  _mm512_storeu_si512( ctx->sigma, sigma );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, применяемое к нескольким независимым состояниям.
+
+    Вычисления для различных состояний чередуются, что позволяет процессору выполнять
+    независимые цепочки преобразований LPS параллельно.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static inline void ak_hash_context_streebog_g_lanes_gfni_internal(
+                ak_streebog *ctx, const ak_uint64 **n, const ak_uint64 **m, const size_t count )
+{
+  int idx = 0;
+  size_t j = 0;
+  __m512i h[ak_hash_multi_lanes], mx[ak_hash_multi_lanes],
+          K[ak_hash_multi_lanes], T[ak_hash_multi_lanes], c;
+  ak_streebog_gfni_load_constants;
+
+  for( j = 0; j < count; j++ ) {
+     h[j] = _mm512_loadu_si512( ctx[j]->h );
+     T[j] = mx[j] = _mm512_loadu_si512( m[j] );
+     K[j] = ak_hash_context_streebog_lps_gfni(
+                 _mm512_xor_si512( h[j], _mm512_loadu_si512( n[j] )), s0, s1, s2, s3, mt, tp );
+  }
+  for( idx = 0; idx < 12; idx++ ) {
+     c = _mm512_loadu_si512( streebog_c[idx] );
+     for( j = 0; j < count; j++ ) {
+        T[j] = ak_hash_context_streebog_lps_gfni( _mm512_xor_si512( T[j], K[j] ),
+                                                                        s0, s1, s2, s3, mt, tp );
+        K[j] = ak_hash_context_streebog_lps_gfni( _mm512_xor_si512( K[j], c ),
+                                                                        s0, s1, s2, s3, mt, tp );
+     }
+  }
+  for( j = 0; j < count; j++ )
+     _mm512_storeu_si512( ctx[j]->h,
+                         _mm512_ternarylogic_epi64( h[j], T[j], _mm512_xor_si512( K[j], mx[j] ), 0x96 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, применяемое к нескольким независимым состояниям
+    с использованием инструкций AVX-512 и GFNI. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_streebog_gfni_target static void ak_hash_context_streebog_g_lanes_gfni( ak_streebog *ctx,
+                                      const ak_uint64 **n, const ak_uint64 **m, const size_t count )
+{
+  switch( count ) {
+    case 4: ak_hash_context_streebog_g_lanes_gfni_internal( ctx, n, m, 4 ); break;
+    case 3: ak_hash_context_streebog_g_lanes_gfni_internal( ctx, n, m, 3 ); break;
+    case 2: ak_hash_context_streebog_g_lanes_gfni_internal( ctx, n, m, 2 ); break;
+    default: ak_hash_context_streebog_g_lanes_gfni_internal( ctx, n, m, 1 ); break;
+  }
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Структура, содержащая указатели на функции, реализующие преобразования
+    функции хеширования Стрибог; значения полей устанавливаются
+    функцией ak_hash_streebog_init_backend(). */
+ static struct streebog_backend {
+  /*! \brief Преобразование G. */
+   void ( *g )( ak_streebog , ak_uint64 * , const ak_uint64 * );
+  /*! \brief Обработка последовательности блоков сообщения. */
+   void ( *blocks )( ak_streebog , const ak_uint64 * , size_t );
+  /*! \brief Преобразование G для нескольких независимых состояний. */
+   void ( *lanes )( ak_streebog * , const ak_uint64 ** , const ak_uint64 ** , const size_t );
+  /*! \brief Наименование используемой реализации. */
+   const char *name;
+ } streebog_backend = {
+   ak_hash_context_streebog_g, ak_hash_context_streebog_blocks,
+   ak_hash_context_streebog_g_lanes, "generic"
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, какие наборы векторных инструкций поддерживаются процессором, и
+    выбирает наиболее быструю из доступных реализаций функции сжатия алгоритма Стрибог.
+    Выбор производится один раз, при инициализации библиотеки;
+    в случае отсутствия поддержки векторных инструкций используется переносимая реализация.
+
+    @return Функция возвращает \ref ak_error_ok (ноль).                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_streebog_init_backend( void )
+{
+  streebog_backend.g = ak_hash_context_streebog_g;
+  streebog_backend.blocks = ak_hash_context_streebog_blocks;
+  streebog_backend.lanes = ak_hash_context_streebog_g_lanes;
+  streebog_backend.name = "generic";
+
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_CPU_SUPPORTS ) \
+                                                          && defined( AK_HAVE_BUILTIN_MM512 )
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) &&
+      __builtin_cpu_supports( "avx512vbmi" ) && __builtin_cpu_supports( "gfni" ) &&
+      ak_hash_streebog_gfni_init_tables( )) {
+    streebog_backend.g = ak_hash_context_streebog_g_gfni;
+    streebog_backend.blocks = ak_hash_context_streebog_blocks_gfni;
+    streebog_backend.lanes = ak_hash_context_streebog_g_lanes_gfni;
+    streebog_backend.name = "avx512-gfni";
+  }
+#endif
+
+  if( ak_log_get_level() >= ak_log_maximum )
+    ak_error_message_fmt( ak_error_ok, __func__,
+                          "streebog hash function uses %s implementation", streebog_backend.name );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
  static int ak_hash_context_streebog_clean( ak_pointer sctx )
 {
@@ -1271,12 +1594,7 @@
   if(( !size ) || ( in == NULL )) return ak_error_ok;
   if(( size - ( quot << 6 )) != 0 ) return ak_error_message( ak_error_wrong_length, __func__,
                                       "data length is not a multiple of the length of the block" );
-  do{
-      ak_hash_context_streebog_g( cx, cx->n, dt );
-      ak_hash_context_streebog_add( cx, 512 );
-      ak_hash_context_streebog_sadd( cx, dt );
-      quot--; dt += 8;
-  } while( quot > 0 );
+  streebog_backend.blocks( cx, dt, quot );
 
  return ak_error_ok;
 }
@@ -1306,11 +1624,11 @@
 
   /* при финализации мы изменяем копию существующей структуры */
   memcpy( &sx, cx, sizeof( struct streebog ));
-  ak_hash_context_streebog_g( &sx, sx.n, m );
+  streebog_backend.g( &sx, sx.n, m );
   ak_hash_context_streebog_add( &sx, size << 3 );
   ak_hash_context_streebog_sadd( &sx, m );
-  ak_hash_context_streebog_g( &sx, NULL, sx.n );
-  ak_hash_context_streebog_g( &sx, NULL, sx.sigma );
+  streebog_backend.g( &sx, NULL, sx.n );
+  streebog_backend.g( &sx, NULL, sx.sigma );
 
  /* копируем нужную часть результирующего массива или выдаем сообщение об ошибке */
     if( cx->hsize == 64 ) memcpy( out, sx.h, ak_min( 64, out_size ));
@@ -1318,6 +1636,65 @@
  return result;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция для каждого из `count` независимых состояний обрабатывает один полный блок сообщения
+    и завершает вычисление хеш-кода. Результат для j-го состояния совпадает с результатом вызова
+    ak_hash_finalize() для контекста, состояние которого равно cx[j], с входными данными
+    длины 64 октета; сами состояния cx[j] не изменяются. Преобразование G на каждом шаге
+    вычисляется одновременно для всех состояний (см. ak_hash_ptr_multi()).
+
+    Функция используется при вычислении HMAC от коротких сообщений, когда состояния функции
+    хеширования после обработки блоков \f$ K \oplus ipad \f$ и \f$ K \oplus opad \f$
+    вычислены заранее (см. ak_hmac_pbkdf2_streebog512()).
+
+    @param cx Массив указателей на состояния функции хеширования.
+    @param m Массив указателей на обрабатываемые блоки сообщений (по 64 октета).
+    @param out Массив указателей на области памяти, куда помещаются результаты; размер каждой
+    области должен быть не менее значения поля hsize соответствующего состояния.
+    @param count Количество состояний, не должно превосходить \ref ak_hash_multi_lanes.           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hash_context_streebog_finalize_block_lanes( ak_streebog *cx, const ak_uint64 **m,
+                                                          ak_uint64 **out, const size_t count )
+{
+  size_t j = 0;
+  ak_uint64 pad[8];
+  struct streebog sx[ak_hash_multi_lanes];
+  ak_streebog ctx[ak_hash_multi_lanes];
+  const ak_uint64 *n[ak_hash_multi_lanes], *mx[ak_hash_multi_lanes];
+  static const ak_uint64 zero[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  memset( pad, 0, sizeof( pad ));
+  (( ak_uint8 *)pad )[0] = 1; /* дополнение пустого последнего блока */
+
+ /* полный блок сообщения */
+  for( j = 0; j < count; j++ ) {
+     memcpy( sx+j, cx[j], sizeof( struct streebog ));
+     ctx[j] = sx+j; n[j] = sx[j].n; mx[j] = m[j];
+  }
+  streebog_backend.lanes( ctx, n, mx, count );
+  for( j = 0; j < count; j++ ) {
+     ak_hash_context_streebog_add( sx+j, 512 );
+     ak_hash_context_streebog_sadd( sx+j, m[j] );
+     mx[j] = pad;
+  }
+ /* дополненный пустой блок */
+  streebog_backend.lanes( ctx, n, mx, count );
+  for( j = 0; j < count; j++ ) {
+     ak_hash_context_streebog_sadd( sx+j, pad );
+     n[j] = zero; mx[j] = sx[j].n;
+  }
+ /* длина сообщения и контрольная сумма */
+  streebog_backend.lanes( ctx, n, mx, count );
+  for( j = 0; j < count; j++ ) mx[j] = sx[j].sigma;
+  streebog_backend.lanes( ctx, n, mx, count );
+
+  for( j = 0; j < count; j++ ) {
+     if( sx[j].hsize == 64 ) memcpy( out[j], sx[j].h, 64 );
+       else memcpy( out[j], sx[j].h+4, 32 );
+  }
+  memset( sx, 0, sizeof( sx ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                               Реализация функция класса hash                                    */
 /* ----------------------------------------------------------------------------------------------- */
@@ -1477,7 +1854,129 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param hctx Контекст функции хеширования
+/*! \brief Состояние одной дорожки при одновременном хешировании нескольких сообщений. */
+ typedef struct streebog_lane {
+  /*! \brief Текущее состояние функции хеширования. */
+   struct streebog sx;
+  /*! \brief Дополненный последний блок сообщения. */
+   ak_uint64 pad[8];
+  /*! \brief Указатель на очередной полный блок сообщения. */
+   const ak_uint64 *ptr;
+  /*! \brief Количество необработанных полных блоков. */
+   size_t blocks;
+  /*! \brief Длина неполного последнего блока (в октетах). */
+   size_t tail;
+  /*! \brief Номер завершающего шага: 0 - дополненный блок, 1 - длина, 2 - контрольная сумма. */
+   int step;
+  /*! \brief Номер сообщения во входном массиве. */
+   size_t index;
+ } *ak_streebog_lane;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет хеш-коды для нескольких независимых сообщений. Сообщения распределяются
+    по \ref ak_hash_multi_lanes дорожкам, для которых преобразование G вычисляется одновременно;
+    при этом обрабатываются как полные блоки сообщений, так и шаги завершения вычислений,
+    что позволяет эффективно обрабатывать большое количество коротких сообщений.
+    Как только обработка одного из сообщений завершается, освободившаяся дорожка
+    занимается следующим сообщением, поэтому длины сообщений могут быть различны.
+
+    Результат совпадает с результатом последовательного вызова функции ak_hash_ptr()
+    для каждого из сообщений; внутреннее состояние контекста hctx не изменяется.
+
+    @param hctx Контекст функции хеширования, определяющий алгоритм и длину хеш-кода.
+    @param count Количество сообщений.
+    @param in Массив указателей на сообщения.
+    @param size Массив длин сообщений (в октетах).
+    @param out Массив указателей на области памяти, куда будут помещены результаты.
+    Размер каждой области должен быть не менее значения поля hsize и может
+    быть определен с помощью вызова функции ak_hash_get_tag_size().
+    @param out_size Размер каждой из областей памяти (в октетах), в которые помещаются результаты.
+
+    @return В случае успеха функция возвращает ноль (\ref ak_error_ok). В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_ptr_multi( ak_hash hctx, const size_t count, const ak_pointer *in,
+                                  const size_t *size, ak_pointer *out, const size_t out_size )
+{
+  size_t j = 0, active = 0, next = 0;
+  struct streebog_lane lanes[ak_hash_multi_lanes];
+  ak_streebog ctx[ak_hash_multi_lanes];
+  const ak_uint64 *n[ak_hash_multi_lanes], *m[ak_hash_multi_lanes];
+  static const ak_uint64 zero[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                            "using null pointer to hash context" );
+  if( !count ) return ak_error_ok;
+  if(( in == NULL ) || ( size == NULL ) || ( out == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__,
+                                             "using null pointer to array of messages or results" );
+  for( j = 0; j < count; j++ ) {
+     if( out[j] == NULL ) return ak_error_message_fmt( ak_error_null_pointer, __func__,
+                                       "using null pointer to result of message %u", (unsigned int)j );
+     if(( in[j] == NULL ) && ( size[j] != 0 ))
+       return ak_error_message_fmt( ak_error_null_pointer, __func__,
+                                              "using null pointer to message %u", (unsigned int)j );
+  }
+
+  do{
+    /* занимаем свободные дорожки очередными сообщениями */
+     while(( active < ak_hash_multi_lanes ) && ( next < count )) {
+        ak_streebog_lane lane = lanes + active;
+        lane->sx.hsize = hctx->data.sctx.hsize;
+        ak_hash_context_streebog_clean( &lane->sx );
+        lane->ptr = ( const ak_uint64 *) in[next];
+        lane->blocks = size[next] >> 6;
+        lane->tail = size[next] - ( lane->blocks << 6 );
+        memset( lane->pad, 0, 64 );
+        if( lane->tail ) memcpy( lane->pad, lane->ptr + 8*lane->blocks, lane->tail );
+        (( ak_uint8 *)lane->pad )[lane->tail] = 1; /* дополнение */
+        lane->step = 0;
+        lane->index = next++;
+        active++;
+     }
+
+    /* вычисляем преобразование G для всех занятых дорожек */
+     for( j = 0; j < active; j++ ) {
+        ak_streebog_lane lane = lanes + j;
+        ctx[j] = &lane->sx;
+        if( lane->blocks ) { n[j] = lane->sx.n; m[j] = lane->ptr; }
+         else switch( lane->step ) {
+                case 0: n[j] = lane->sx.n; m[j] = lane->pad; break;
+                case 1: n[j] = zero; m[j] = lane->sx.n; break;
+                default: n[j] = zero; m[j] = lane->sx.sigma; break;
+              }
+     }
+     streebog_backend.lanes( ctx, n, m, active );
+
+    /* изменяем счетчики и освобождаем дорожки, для которых вычисления завершены */
+     for( j = 0; j < active; ) {
+        ak_streebog_lane lane = lanes + j;
+        if( lane->blocks ) {
+          ak_hash_context_streebog_add( &lane->sx, 512 );
+          ak_hash_context_streebog_sadd( &lane->sx, lane->ptr );
+          lane->blocks--; lane->ptr += 8;
+          j++; continue;
+        }
+        if( lane->step == 0 ) {
+          ak_hash_context_streebog_add( &lane->sx, lane->tail << 3 );
+          ak_hash_context_streebog_sadd( &lane->sx, lane->pad );
+        }
+        if( ++lane->step < 3 ) { j++; continue; }
+
+        if( lane->sx.hsize == 64 ) memcpy( out[lane->index], lane->sx.h, ak_min( 64, out_size ));
+          else memcpy( out[lane->index], lane->sx.h+4, ak_min( 32, out_size ));
+        if( j != --active ) memcpy( lane, lanes + active, sizeof( struct streebog_lane ));
+     }
+  } while(( active > 0 ) || ( next < count ));
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Файл, по возможности, отображается в память и обрабатывается без промежуточного
+    копирования данных (см. функцию ak_mac_file()).
+
+    @param hctx Контекст функции хеширования
     @param filename Имя файла, для котрого вычисляется хеш-код.
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
     Размер выделяемой памяти должен быть не менее значения поля hsize и может
@@ -1611,6 +2110,36 @@
    0xBA, 0x3A, 0x71, 0x5C, 0x1B, 0xCD, 0x81, 0xCB, 0x8E, 0x9F, 0x90, 0xBF, 0x4C, 0x1C, 0x1A, 0x8A
  };
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает результаты одновременного хеширования нескольких сообщений
+    различной длины, расположенных в заданном буфере, с результатами функции ak_hash_ptr().
+    \note Мы предполагаем, что буфер содержит не менее 512 октетов.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_libakrypt_test_streebog_multi( ak_hash ctx, ak_uint8 *buffer )
+{
+  size_t idx = 0, hsize = ak_hash_get_tag_size( ctx );
+  const size_t sizes[10] = { 100, 100, 100, 100, 0, 1, 63, 64, 65, 500 };
+  ak_pointer in[10], out[10];
+  ak_uint8 result[10][64], out2[64];
+  int error = ak_error_ok;
+
+ /* первые сообщения имеют одинаковую длину, поэтому все дорожки освобождаются одновременно */
+  for( idx = 0; idx < 10; idx++ ) { in[idx] = buffer + idx; out[idx] = result[idx]; }
+  if(( error = ak_hash_ptr_multi( ctx, 10, in, sizes, out, hsize )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect hashing of several messages" );
+    return ak_false;
+  }
+  for( idx = 0; idx < 10; idx++ ) {
+     ak_hash_ptr( ctx, in[idx], sizes[idx], out2, hsize );
+     if( !ak_ptr_is_equal_with_log( result[idx], out2, hsize )) {
+       ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+               "the multi-buffer test for message of %u octets is wrong", (unsigned int)sizes[idx] );
+       return ak_false;
+     }
+  }
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*!  @return Если тестирование прошло успешно возвращается \ref ak_true (истина). В противном
      случае возвращается \ref ak_false.                                                            */
@@ -1752,6 +2281,14 @@
   if( audit >= ak_log_maximum )
       ak_error_message_fmt( ak_error_ok, __func__ ,
                                                "the random walk test with %u steps is Ok", steps );
+
+ /* сравниваем одновременное хеширование нескольких сообщений с последовательным */
+  if(( result = ak_libakrypt_test_streebog_multi( &ctx, buffer )) != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__ , "the multi-buffer test is wrong" );
+    goto lab_exit;
+  }
+  if( audit >= ak_log_maximum )
+    ak_error_message( ak_error_ok, __func__ , "the multi-buffer test is Ok" );
  /* уничтожаем контекст */
  lab_exit:
    ak_random_destroy( &rnd );
@@ -1767,6 +2304,7 @@
 {
   ak_uint32 steps;
   struct hash ctx; /* контекст функции хеширования */
+  struct streebog sx, sx2; /* состояния для сравнения реализаций */
   struct random rnd;
   size_t len, offset;
   int error = ak_error_ok;
@@ -1867,6 +2405,37 @@
   if( audit >= ak_log_maximum )
     ak_error_message_fmt( ak_error_ok, __func__ ,
                                                "the random walk test with %u steps is Ok", steps );
+
+ /* сравниваем одновременное хеширование нескольких сообщений с последовательным */
+  if(( result = ak_libakrypt_test_streebog_multi( &ctx, buffer )) != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__ , "the multi-buffer test is wrong" );
+    goto lab_ex;
+  }
+  if( audit >= ak_log_maximum )
+    ak_error_message( ak_error_ok, __func__ , "the multi-buffer test is Ok" );
+
+ /* сравниваем выбранную при инициализации библиотеки реализацию с переносимой;
+    первый блок данных вызывает перенос через все слова контрольной суммы */
+  memset( buffer, 0, 64 );
+  buffer[0] = 1;
+  ak_hash_clean( &ctx );
+  memcpy( &sx, &ctx.data.sctx, sizeof( struct streebog ));
+  memset( sx.sigma, 0xff, 64 );
+  memcpy( &sx2, &sx, sizeof( struct streebog ));
+  streebog_backend.blocks( &sx, ( ak_uint64 *)buffer, sizeof( buffer ) >> 6 );
+  streebog_backend.g( &sx, NULL, sx.sigma );
+  ak_hash_context_streebog_blocks( &sx2, ( ak_uint64 *)buffer, sizeof( buffer ) >> 6 );
+  ak_hash_context_streebog_g( &sx2, NULL, sx2.sigma );
+  if(( result = ak_ptr_is_equal_with_log( &sx, &sx2, 3*64 )) != ak_true ) {
+    ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                          "the comparison of %s and generic implementations is wrong",
+                                                                           streebog_backend.name );
+    goto lab_ex;
+  }
+  if( audit >= ak_log_maximum )
+    ak_error_message_fmt( ak_error_ok, __func__ ,
+           "the comparison of %s and generic implementations is Ok", streebog_backend.name );
+
  /* уничтожаем контекст */
  lab_ex:
    ak_random_destroy( &rnd );
@@ -0,0 +1,744 @@
+/* ----------------------------------------------------------------------------------------------- */
+/*  Copyright (c) 2020 by Axel Kenzo, axelkenzo@mail.ru                                            */
+/*                                                                                                 */
+/*  Файл ak_hash_tree.с                                                                            */
+/*  - содержит реализацию древовидного хеширования с использованием функций Стрибог               */
+/* ----------------------------------------------------------------------------------------------- */
+ #include <libakrypt-internal.h>
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+#ifdef AK_HAVE_UNISTD_H
+ #include <unistd.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup hash-tree-doc Древовидное хеширование
+ @{
+   Древовидное хеширование предназначено для контроля целостности данных большого объема
+   (архивов, образов дисков и т.п.). Данные разбиваются на фрагменты фиксированной длины
+   \f$ C \f$ (по-умолчанию, \ref ak_hash_tree_default_chunk_size октетов);
+   последний фрагмент может быть короче. Для пустых данных используется один фрагмент нулевой длины.
+
+   Пусть \f$ H \f$ - функция хеширования Стрибог256 или Стрибог512. Хеш-коды вычисляются
+   с добавлением в конец хешируемой последовательности октета, определяющего тип вершины дерева:
+
+   - лист дерева (фрагмент данных \f$ M_i \f$): \f$ L_i = H( M_i \| 00 ) \f$,
+   - внутренняя вершина: \f$ N = H( left \| right \| 01 ) \f$, при этом на каждом уровне
+     дерева вершины объединяются попарно слева направо, а последняя вершина нечетного
+     уровня переносится на следующий уровень без изменений,
+   - результат: \f$ R = H( T \| len \| C \| 02 ) \f$, где \f$ T \f$ - вершина дерева,
+     а \f$ len \f$ и \f$ C \f$ - длина данных и длина фрагмента, записанные
+     в виде 64-х битных целых чисел (младший октет вперед).
+
+   Хеш-коды листьев вычисляются независимо друг от друга, поэтому могут вырабатываться
+   одновременно несколькими потоками. Кроме того, сохраненные хеш-коды листьев позволяют
+   продолжать прерванное вычисление (см. ak_hash_tree_leaves_file()), а также проверять
+   отдельные фрагменты файла без его полного чтения (см. ak_hash_tree_verify_file()).         @} */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Октеты, определяющие тип вершины дерева. */
+ #define ak_hash_tree_leaf_tag  ( 0x00 )
+ #define ak_hash_tree_node_tag  ( 0x01 )
+ #define ak_hash_tree_root_tag  ( 0x02 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Данные, необходимые для вычисления хеш-кодов последовательности листьев. */
+ typedef struct hash_tree_leaves {
+  /*! \brief Собственный контекст функции хеширования (для дополнительных потоков). */
+   struct hash hctx;
+  /*! \brief Используемый контекст функции хеширования. */
+   ak_hash hash;
+  /*! \brief Указатель на начало первого фрагмента. */
+   const ak_uint8 *data;
+  /*! \brief Количество данных, начиная с первого фрагмента и до конца сообщения. */
+   ak_uint64 size;
+  /*! \brief Длина фрагмента. */
+   size_t chunk;
+  /*! \brief Количество обрабатываемых листьев. */
+   ak_uint64 count;
+  /*! \brief Область памяти для хеш-кодов листьев. */
+   ak_uint8 *out;
+  /*! \brief Код ошибки, возникшей при вычислениях. */
+   int error;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Флаг успешного запуска потока. */
+   bool_t started;
+  /*! \brief Идентификатор потока. */
+   pthread_t thread;
+#endif
+ } *ak_hash_tree_leaves_ctx;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет хеш-коды последовательности листьев. */
+ static void *ak_hash_tree_leaves_run( void *ptr )
+{
+  ak_uint64 idx = 0;
+  ak_uint8 tag = ak_hash_tree_leaf_tag;
+  ak_hash_tree_leaves_ctx lctx = ( ak_hash_tree_leaves_ctx ) ptr;
+  const size_t hsize = lctx->hash->data.sctx.hsize;
+
+  for( idx = 0; idx < lctx->count; idx++ ) {
+     ak_uint64 offset = idx*lctx->chunk;
+     size_t len = ( size_t ) ak_min( ( ak_uint64 )lctx->chunk, lctx->size - offset );
+
+     if(( lctx->error = ak_hash_clean( lctx->hash )) != ak_error_ok ) break;
+     if(( lctx->error = ak_hash_update( lctx->hash,
+                                 ( ak_pointer )( lctx->data + offset ), len )) != ak_error_ok ) break;
+     if(( lctx->error = ak_hash_finalize( lctx->hash, &tag, 1,
+                                           lctx->out + idx*hsize, hsize )) != ak_error_ok ) break;
+  }
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление хеш-кодов последовательности листьев с использованием нескольких потоков.
+
+    Листья распределяются между потоками равными непрерывными отрезками; первый отрезок
+    обрабатывается вызывающим потоком с использованием контекста `tctx`, остальные - дополнительными
+    потоками, каждый из которых использует собственный контекст функции хеширования.
+
+    @param tctx Контекст древовидного хеширования.
+    @param data Указатель на первый обрабатываемый фрагмент.
+    @param size Количество данных, начиная с первого обрабатываемого фрагмента и до конца сообщения.
+    @param count Количество обрабатываемых листьев.
+    @param out Область памяти для хеш-кодов листьев.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_tree_leaves_internal( ak_hash_tree tctx, const ak_uint8 *data,
+                                           const ak_uint64 size, const ak_uint64 count, ak_uint8 *out )
+{
+  struct hash_tree_leaves main;
+  const size_t hsize = tctx->hctx.data.sctx.hsize;
+#ifdef AK_HAVE_PTHREAD_H
+  int error = ak_error_ok;
+  ak_hash_tree_leaves_ctx ths = NULL;
+  size_t idx = 0, threads = ( size_t ) ak_min( ( ak_uint64 )tctx->threads, count );
+  ak_uint64 part = 0, offset = 0;
+#endif
+
+  memset( &main, 0, sizeof( struct hash_tree_leaves ));
+  main.hash = &tctx->hctx;
+  main.data = data;
+  main.size = size;
+  main.chunk = tctx->chunk;
+  main.count = count;
+  main.out = out;
+
+#ifdef AK_HAVE_PTHREAD_H
+  if( threads > 1 ) {
+    if(( ths = calloc( threads-1, sizeof( struct hash_tree_leaves ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+
+   /* первый отрезок содержит остаток от деления листьев между потоками */
+    part = count/threads;
+    main.count = offset = part + count%threads;
+    for( idx = 0; idx < threads-1; idx++ ) {
+       if(( error = ak_hash_create_oid( &ths[idx].hctx, tctx->hctx.oid )) != ak_error_ok ) {
+         ak_error_message( error, __func__, "incorrect creation of hash function context" );
+         while( idx > 0 ) ak_hash_destroy( &ths[--idx].hctx );
+         free( ths );
+         return error;
+       }
+       ths[idx].hash = &ths[idx].hctx;
+       ths[idx].data = data + offset*tctx->chunk;
+       ths[idx].size = size - offset*tctx->chunk;
+       ths[idx].chunk = tctx->chunk;
+       ths[idx].count = part;
+       ths[idx].out = out + offset*hsize;
+       offset += part;
+    }
+
+    for( idx = 0; idx < threads-1; idx++ )
+       ths[idx].started = ( pthread_create( &ths[idx].thread, NULL,
+                                  ak_hash_tree_leaves_run, ths+idx ) == 0 ) ? ak_true : ak_false;
+    ak_hash_tree_leaves_run( &main );
+
+   /* дожидаемся завершения потоков; отрезки, для которых поток не был создан,
+      обрабатываем самостоятельно */
+    for( idx = 0; idx < threads-1; idx++ ) {
+       if( ths[idx].started ) pthread_join( ths[idx].thread, NULL );
+         else ak_hash_tree_leaves_run( ths+idx );
+       if( ths[idx].error != ak_error_ok ) main.error = ths[idx].error;
+       ak_hash_destroy( &ths[idx].hctx );
+    }
+    free( ths );
+
+  } else
+#endif
+   ak_hash_tree_leaves_run( &main );
+
+  if( main.error != ak_error_ok )
+    ak_error_message( main.error, __func__, "incorrect calculation of leaf hash values" );
+ return main.error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает контекст древовидного хеширования с заданной функцией хеширования. */
+ static int ak_hash_tree_create( ak_hash_tree tctx, ak_function_hash_create *create,
+                                                                                 const char *name )
+{
+  int error = ak_error_ok;
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  if(( error = create( &tctx->hctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect creation of hash function context" );
+  if(( tctx->oid = ak_oid_find_by_name( name )) == NULL ) {
+    ak_hash_destroy( &tctx->hctx );
+    return ak_error_message( error = ak_error_get_value(), __func__,
+                                                         "incorrect searching of hash tree OID" );
+  }
+  tctx->chunk = ak_hash_tree_default_chunk_size;
+  tctx->threads = 1;
+#if defined( AK_HAVE_PTHREAD_H ) && defined( _SC_NPROCESSORS_ONLN )
+ /* по-умолчанию используются все доступные процессоры */
+  if( sysconf( _SC_NPROCESSORS_ONLN ) > 1 ) tctx->threads = ( size_t ) sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! По-умолчанию размер фрагмента равен \ref ak_hash_tree_default_chunk_size октетов,
+    а количество потоков равно количеству доступных процессоров.
+
+    @param tctx Контекст древовидного хеширования.
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_create_streebog256( ak_hash_tree tctx )
+{
+ return ak_hash_tree_create( tctx, ( ak_function_hash_create *) ak_hash_create_streebog256,
+                                                                              "streebog256-tree" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! По-умолчанию размер фрагмента равен \ref ak_hash_tree_default_chunk_size октетов,
+    а количество потоков равно количеству доступных процессоров.
+
+    @param tctx Контекст древовидного хеширования.
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_create_streebog512( ak_hash_tree tctx )
+{
+ return ak_hash_tree_create( tctx, ( ak_function_hash_create *) ak_hash_create_streebog512,
+                                                                              "streebog512-tree" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tctx Контекст древовидного хеширования.
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_destroy( ak_hash_tree tctx )
+{
+  int error = ak_error_ok;
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                     "destroying null pointer to hash tree context" );
+  if(( error = ak_hash_destroy( &tctx->hctx )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect destroying of hash function context" );
+  tctx->oid = NULL;
+  tctx->chunk = 0;
+  tctx->threads = 0;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \note Хеш-коды, вычисленные с различными размерами фрагментов, различны.
+
+    @param tctx Контекст древовидного хеширования.
+    @param chunk Размер фрагмента в октетах, должен быть не менее \ref ak_hash_tree_min_chunk_size.
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_set_chunk_size( ak_hash_tree tctx, const size_t chunk )
+{
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  if( chunk < ak_hash_tree_min_chunk_size ) return ak_error_message( ak_error_wrong_length,
+                                                             __func__, "using too small chunk size" );
+  tctx->chunk = chunk;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Значение не влияет на результат вычислений. Если библиотека собрана без поддержки pthreads,
+    вычисления всегда выполняются вызывающим потоком.
+
+    @param tctx Контекст древовидного хеширования.
+    @param threads Максимальное количество потоков (не менее одного).
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_set_threads( ak_hash_tree tctx, const size_t threads )
+{
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  if( !threads ) return ak_error_message( ak_error_zero_length, __func__,
+                                                              "using zero number of threads" );
+  tctx->threads = threads;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tctx Контекст древовидного хеширования.
+    @return Функция возвращает длину хеш-кода в октетах. В случае возникновения ошибки
+    возвращается ноль.                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ size_t ak_hash_tree_get_tag_size( ak_hash_tree tctx )
+{
+  if( tctx == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to hash tree context" );
+    return 0;
+  }
+ return ak_hash_get_tag_size( &tctx->hctx );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tctx Контекст древовидного хеширования.
+    @param size Длина данных в октетах.
+    @return Функция возвращает количество листьев дерева (для пустых данных - один лист).
+    В случае возникновения ошибки возвращается ноль.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint64 ak_hash_tree_get_leaves_count( ak_hash_tree tctx, const ak_uint64 size )
+{
+  if(( tctx == NULL ) || ( !tctx->chunk )) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to hash tree context" );
+    return 0;
+  }
+  if( !size ) return 1;
+ return ( size - 1 )/tctx->chunk + 1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка параметров диапазона листьев и размера выходного буффера. */
+ static int ak_hash_tree_check_range( ak_hash_tree tctx, const ak_uint64 size,
+                                 const ak_uint64 first, const ak_uint64 count, const size_t out_size )
+{
+  ak_uint64 total = 0;
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  total = ak_hash_tree_get_leaves_count( tctx, size );
+  if(( !count ) || ( first >= total ) || ( count > total - first ))
+    return ak_error_message( ak_error_wrong_index, __func__, "using wrong range of leaves" );
+  if( count > out_size/tctx->hctx.data.sctx.hsize )
+    return ak_error_message( ak_error_wrong_length, __func__, "using small buffer for leaves" );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет хеш-коды листьев с номерами от `first` до `first + count - 1`
+    и последовательно помещает их в область памяти `out`.
+
+    @param tctx Контекст древовидного хеширования.
+    @param in Указатель на данные (все сообщение).
+    @param size Длина сообщения в октетах.
+    @param first Номер первого вычисляемого листа (нумерация начинается с нуля).
+    @param count Количество вычисляемых листьев.
+    @param out Область памяти для хеш-кодов листьев.
+    @param out_size Размер области памяти (в октетах), должен быть не менее
+    `count*ak_hash_tree_get_tag_size()`.
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_leaves( ak_hash_tree tctx, const ak_pointer in, const size_t size,
+                     const ak_uint64 first, const ak_uint64 count, ak_pointer out, const size_t out_size )
+{
+  int error = ak_error_ok;
+
+  if(( in == NULL ) && ( size != 0 )) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                      "using null pointer to data" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to output" );
+  if(( error = ak_hash_tree_check_range( tctx, size, first, count, out_size )) != ak_error_ok )
+    return error;
+
+ return ak_hash_tree_leaves_internal( tctx, ( const ak_uint8 *)in + first*tctx->chunk,
+                                                          size - first*tctx->chunk, count, out );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление хеш-кодов листьев для файла, открытого на чтение.
+
+    Отображает в память часть файла, начиная с фрагмента `first`, и закрывает файл.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hash_tree_leaves_opened_file( ak_hash_tree tctx, ak_file file,
+                                           const ak_uint64 first, const ak_uint64 count, ak_uint8 *out )
+{
+  int error = ak_error_ok;
+  ak_uint8 *data = NULL;
+  const ak_uint64 offset = first*tctx->chunk;
+
+ /* файл нулевой длины не может быть отображен в память */
+  if( !file->size ) {
+    ak_file_close( file );
+    return ak_hash_tree_leaves_internal( tctx, ( const ak_uint8 *)"", 0, 1, out );
+  }
+  if(( data = ak_file_mmap( file, NULL, readonly, ( size_t )offset )) == NULL ) {
+    ak_file_close( file );
+    return ak_error_message( ak_error_get_value(), __func__, "incorrect mapping of file" );
+  }
+  error = ak_hash_tree_leaves_internal( tctx, data, ( ak_uint64 )file->size - offset, count, out );
+  ak_file_unmap( file, data );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет хеш-коды листьев с номерами от `first` до `first + count - 1`
+    для заданного файла. Обрабатываемая часть файла отображается в память. Последовательные
+    вызовы функции для соседних диапазонов позволяют вычислять хеш-коды листьев частями,
+    в том числе продолжать прерванное вычисление.
+
+    @param tctx Контекст древовидного хеширования.
+    @param filename Имя файла.
+    @param first Номер первого вычисляемого листа (нумерация начинается с нуля).
+    @param count Количество вычисляемых листьев.
+    @param out Область памяти для хеш-кодов листьев.
+    @param out_size Размер области памяти (в октетах), должен быть не менее
+    `count*ak_hash_tree_get_tag_size()`.
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_leaves_file( ak_hash_tree tctx, const char *filename,
+                        const ak_uint64 first, const ak_uint64 count, ak_pointer out, const size_t out_size )
+{
+  struct file file;
+  int error = ak_error_ok;
+
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to output" );
+  if(( error = ak_file_open_to_read( &file, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+  if(( error = ak_hash_tree_check_range( tctx,
+                              ( ak_uint64 )file.size, first, count, out_size )) != ak_error_ok ) {
+    ak_file_close( &file );
+    return error;
+  }
+
+ return ak_hash_tree_leaves_opened_file( tctx, &file, first, count, out );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tctx Контекст древовидного хеширования.
+    @param leaves Последовательность хеш-кодов всех листьев дерева.
+    @param count Количество листьев, должно совпадать со значением,
+    возвращаемым функцией ak_hash_tree_get_leaves_count() для длины `size`.
+    @param size Длина хешируемых данных в октетах.
+    @param out Область памяти, куда будет помещен результат.
+    @param out_size Размер области памяти (в октетах).
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_root( ak_hash_tree tctx, const ak_pointer leaves, const ak_uint64 count,
+                                        const ak_uint64 size, ak_pointer out, const size_t out_size )
+{
+  size_t hsize = 0;
+  int error = ak_error_ok;
+  ak_uint64 idx = 0, cnt = count;
+  ak_uint8 *level = NULL, tag[17];
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  if(( leaves == NULL ) || ( out == NULL )) return ak_error_message( ak_error_null_pointer,
+                                                                __func__, "using null pointer" );
+  if( count != ak_hash_tree_get_leaves_count( tctx, size ))
+    return ak_error_message( ak_error_wrong_length, __func__, "using wrong number of leaves" );
+  if( out_size < ( hsize = tctx->hctx.data.sctx.hsize ))
+    return ak_error_message( ak_error_wrong_length, __func__, "using small output buffer" );
+
+  if(( level = malloc( count*hsize )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  memcpy( level, leaves, count*hsize );
+
+ /* вершины каждого уровня объединяются попарно, непарная вершина переносится на следующий уровень */
+  tag[0] = ak_hash_tree_node_tag;
+  while( cnt > 1 ) {
+    for( idx = 0; 2*idx + 1 < cnt; idx++ ) {
+       ak_hash_clean( &tctx->hctx );
+       ak_hash_update( &tctx->hctx, level + 2*idx*hsize, 2*hsize );
+       if(( error = ak_hash_finalize( &tctx->hctx, tag, 1,
+                                                  level + idx*hsize, hsize )) != ak_error_ok ) break;
+    }
+    if( error != ak_error_ok ) break;
+    if( cnt&1 ) memmove( level + idx*hsize, level + ( cnt-1 )*hsize, hsize );
+    cnt = ( cnt+1 ) >> 1;
+  }
+
+ /* к вершине дерева добавляются длина данных и длина фрагмента */
+  if( error == ak_error_ok ) {
+    for( idx = 0; idx < 8; idx++ ) {
+       tag[idx] = ( ak_uint8 )( size >> ( 8*idx ));
+       tag[8+idx] = ( ak_uint8 )(( ak_uint64 )tctx->chunk >> ( 8*idx ));
+    }
+    tag[16] = ak_hash_tree_root_tag;
+    ak_hash_clean( &tctx->hctx );
+    ak_hash_update( &tctx->hctx, level, hsize );
+    error = ak_hash_finalize( &tctx->hctx, tag, sizeof( tag ), out, out_size );
+  }
+  ak_hash_clean( &tctx->hctx );
+  memset( level, 0, count*hsize );
+  free( level );
+
+  if( error != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect calculation of hash tree root" );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tctx Контекст древовидного хеширования.
+    @param in Указатель на входные данные.
+    @param size Размер входных данных в октетах.
+    @param out Область памяти, куда будет помещен результат.
+    @param out_size Размер области памяти (в октетах).
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_ptr( ak_hash_tree tctx, const ak_pointer in, const size_t size,
+                                                            ak_pointer out, const size_t out_size )
+{
+  ak_uint64 count = 0;
+  int error = ak_error_ok;
+  ak_uint8 *leaves = NULL;
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  count = ak_hash_tree_get_leaves_count( tctx, size );
+  if(( leaves = malloc( count*tctx->hctx.data.sctx.hsize )) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+
+  if(( error = ak_hash_tree_leaves( tctx, in, size, 0, count, leaves,
+                                          count*tctx->hctx.data.sctx.hsize )) == ak_error_ok )
+    error = ak_hash_tree_root( tctx, leaves, count, size, out, out_size );
+  free( leaves );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Файл отображается в память, хеш-коды листьев вычисляются одновременно несколькими потоками.
+
+    @param tctx Контекст древовидного хеширования.
+    @param filename Имя файла.
+    @param out Область памяти, куда будет помещен результат.
+    @param out_size Размер области памяти (в октетах).
+    @return В случае успеха возвращается \ref ak_error_ok (ноль). В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_file( ak_hash_tree tctx, const char *filename,
+                                                            ak_pointer out, const size_t out_size )
+{
+  struct file file;
+  ak_uint64 count = 0, size = 0;
+  int error = ak_error_ok;
+  ak_uint8 *leaves = NULL;
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                                 "using null pointer to filename" );
+  if(( error = ak_file_open_to_read( &file, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+
+  count = ak_hash_tree_get_leaves_count( tctx, size = ( ak_uint64 )file.size );
+  if(( leaves = malloc( count*tctx->hctx.data.sctx.hsize )) == NULL ) {
+    ak_file_close( &file );
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  }
+  if(( error = ak_hash_tree_leaves_opened_file( tctx, &file, 0, count, leaves )) == ak_error_ok )
+    error = ak_hash_tree_root( tctx, leaves, count, size, out, out_size );
+  free( leaves );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что сохраненные хеш-коды листьев соответствуют заданному хеш-коду
+    файла, после чего заново вычисляет хеш-коды только тех фрагментов файла, которые
+    пересекаются с диапазоном `[offset, offset + length)`, и сравнивает их с сохраненными.
+
+    @param tctx Контекст древовидного хеширования.
+    @param filename Имя проверяемого файла.
+    @param leaves Сохраненные хеш-коды всех листьев дерева (см. ak_hash_tree_leaves_file()).
+    @param count Количество сохраненных листьев.
+    @param root Хеш-код файла (см. ak_hash_tree_root()).
+    @param offset Смещение проверяемого диапазона от начала файла (в октетах).
+    @param length Длина проверяемого диапазона (в октетах); при нулевом значении
+    проверяется только соответствие хеш-кодов листьев хеш-коду файла.
+    @return Функция возвращает \ref ak_error_ok (ноль), если проверка прошла успешно,
+    и \ref ak_error_not_equal_data, если данные не совпадают. В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hash_tree_verify_file( ak_hash_tree tctx, const char *filename, const ak_pointer leaves,
+                  const ak_uint64 count, const ak_pointer root, const ak_uint64 offset,
+                                                                          const ak_uint64 length )
+{
+  struct file file;
+  size_t hsize = 0;
+  int error = ak_error_ok;
+  ak_uint64 first = 0, last = 0;
+  ak_uint8 *local = NULL, out[64];
+
+  if( tctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                       "using null pointer to hash tree context" );
+  if(( filename == NULL ) || ( leaves == NULL ) || ( root == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__, "using null pointer" );
+  if(( error = ak_file_open_to_read( &file, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+
+ /* проверяем сохраненные хеш-коды листьев */
+  hsize = tctx->hctx.data.sctx.hsize;
+  if(( error = ak_hash_tree_root( tctx, leaves, count,
+                                  ( ak_uint64 )file.size, out, sizeof( out ))) != ak_error_ok ) {
+    ak_file_close( &file );
+    return ak_error_message( error, __func__, "incorrect calculation of hash tree root" );
+  }
+  if( !ak_ptr_is_equal( out, root, hsize )) {
+    ak_file_close( &file );
+    return ak_error_message( ak_error_not_equal_data, __func__,
+                                                  "stored leaves do not match the hash tree root" );
+  }
+  if( !length ) {
+    ak_file_close( &file );
+    return ak_error_ok;
+  }
+  if(( offset >= ( ak_uint64 )file.size ) || ( length > ( ak_uint64 )file.size - offset )) {
+    ak_file_close( &file );
+    return ak_error_message( ak_error_wrong_length, __func__, "using range outside the file" );
+  }
+
+ /* вычисляем хеш-коды фрагментов, пересекающихся с заданным диапазоном */
+  first = offset/tctx->chunk;
+  last = ( offset + length - 1 )/tctx->chunk;
+  if(( local = malloc(( last - first + 1 )*hsize )) == NULL ) {
+    ak_file_close( &file );
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  }
+  if(( error = ak_hash_tree_leaves_opened_file( tctx, &file,
+                                          first, last - first + 1, local )) == ak_error_ok ) {
+    if( !ak_ptr_is_equal( local, ( ak_uint8 *)leaves + first*hsize, ( last - first + 1 )*hsize ))
+      error = ak_error_message_fmt( ak_error_not_equal_data, __func__,
+                       "file %s is modified within chunks from %llu to %llu", filename,
+                                          ( unsigned long long )first, ( unsigned long long )last );
+  }
+  free( local );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                 функции тестирования                                            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление древовидного хеш-кода непосредственно по определению. */
+ static bool_t ak_libakrypt_test_hash_tree_reference( ak_hash_tree tctx, ak_uint8 *data,
+                                                             const size_t size, ak_uint8 *result )
+{
+  ak_uint64 idx = 0, count = ak_hash_tree_get_leaves_count( tctx, size );
+  const size_t hsize = tctx->hctx.data.sctx.hsize, chunk = tctx->chunk;
+  ak_uint8 nodes[8][64], buffer[ak_hash_tree_min_chunk_size + 1];
+
+  if(( count > 8 ) || ( chunk != ak_hash_tree_min_chunk_size )) return ak_false;
+  for( idx = 0; idx < count; idx++ ) {
+     size_t len = ak_min( chunk, size - idx*chunk );
+     memcpy( buffer, data + idx*chunk, len );
+     buffer[len] = ak_hash_tree_leaf_tag;
+     ak_hash_ptr( &tctx->hctx, buffer, len + 1, nodes[idx], hsize );
+  }
+  while( count > 1 ) {
+    for( idx = 0; 2*idx + 1 < count; idx++ ) {
+       memcpy( buffer, nodes[2*idx], hsize );
+       memcpy( buffer + hsize, nodes[2*idx+1], hsize );
+       buffer[2*hsize] = ak_hash_tree_node_tag;
+       ak_hash_ptr( &tctx->hctx, buffer, 2*hsize + 1, nodes[idx], hsize );
+    }
+    if( count&1 ) memcpy( nodes[idx], nodes[count-1], hsize );
+    count = ( count+1 ) >> 1;
+  }
+  memcpy( buffer, nodes[0], hsize );
+  for( idx = 0; idx < 8; idx++ ) {
+     buffer[hsize+idx] = ( ak_uint8 )(( ak_uint64 )size >> ( 8*idx ));
+     buffer[hsize+8+idx] = ( ak_uint8 )(( ak_uint64 )chunk >> ( 8*idx ));
+  }
+  buffer[hsize+16] = ak_hash_tree_root_tag;
+  ak_hash_ptr( &tctx->hctx, buffer, hsize + 17, result, hsize );
+
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка древовидного хеширования для заданного контекста. */
+ static bool_t ak_libakrypt_test_hash_tree_context( ak_hash_tree tctx )
+{
+  size_t idx = 0, jdx = 0;
+  bool_t result = ak_true;
+  ak_uint8 *data = NULL, out1[64], out2[64];
+ /* длины данных: пустые данные, неполный лист, сбалансированное дерево и дерево
+    с непарными вершинами на двух уровнях */
+  const size_t sizes[4] = { 0, 100, 4*ak_hash_tree_min_chunk_size,
+                                                            4*ak_hash_tree_min_chunk_size + 100 };
+
+  if(( data = malloc( sizes[3] )) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    return ak_false;
+  }
+  for( idx = 0; idx < sizes[3]; idx++ ) data[idx] = ( ak_uint8 )( 13*idx + ( idx >> 8 ));
+  ak_hash_tree_set_chunk_size( tctx, ak_hash_tree_min_chunk_size );
+
+  for( idx = 0; idx < 4; idx++ ) {
+     memset( out1, 0, sizeof( out1 ));
+     if( !ak_libakrypt_test_hash_tree_reference( tctx, data, sizes[idx], out1 )) {
+       result = ak_false;
+       break;
+     }
+    /* результат не должен зависеть от количества потоков */
+     for( jdx = 1; jdx < 4; jdx++ ) {
+        memset( out2, 1, sizeof( out2 ));
+        ak_hash_tree_set_threads( tctx, jdx );
+        ak_hash_tree_ptr( tctx, data, sizes[idx], out2, sizeof( out2 ));
+        if( !ak_ptr_is_equal( out1, out2, tctx->hctx.data.sctx.hsize )) {
+          ak_error_message_fmt( ak_error_not_equal_data, __func__,
+                      "wrong %s value for %u bytes with %u threads", tctx->oid->name[0],
+                                                          ( unsigned int )sizes[idx], ( unsigned int )jdx );
+          result = ak_false;
+        }
+     }
+  }
+  free( data );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @return Возвращает ak_true в случае успешного тестирования. В случае возникновения ошибки
+    функция возвращает ak_false. Код ошибки можеть быть получен с помощью
+    вызова ak_error_get_value()                                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_hash_tree( void )
+{
+  struct hash_tree tctx;
+  bool_t result = ak_true;
+  int audit = ak_log_get_level();
+
+  if( ak_hash_tree_create_streebog256( &tctx ) != ak_error_ok ) return ak_false;
+  if( !ak_libakrypt_test_hash_tree_context( &tctx )) result = ak_false;
+  ak_hash_tree_destroy( &tctx );
+
+  if( ak_hash_tree_create_streebog512( &tctx ) != ak_error_ok ) return ak_false;
+  if( !ak_libakrypt_test_hash_tree_context( &tctx )) result = ak_false;
+  ak_hash_tree_destroy( &tctx );
+
+  if( result && ( audit >= ak_log_maximum ))
+    ak_error_message( ak_error_ok, __func__ , "hash tree testing is Ok" );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                 ak_hash_tree.c  */
+/* ----------------------------------------------------------------------------------------------- */
@@ -17,9 +17,128 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление состояний функции хеширования после обработки блоков
+    \f$ K \oplus ipad \f$ и \f$ K \oplus opad \f$.
+
+    Состояния вычисляются один раз для каждого значения ключа и сохраняются в контексте
+    в маскированном виде: на векторы h и \f$ \Sigma \f$ накладывается случайная маска.
+    После этого значение ключа при вычислении имитовставки не используется.
+
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_internal_set_pads( ak_hmac hctx )
+{
+  int error = ak_error_ok;
+  size_t idx = 0, jdx = 0, len = 0, pdx = 0;
+  ak_uint8 buffer[64]; /* буффер для хранения промежуточных значений */
+  const ak_uint8 pad[2] = { 0x36, 0x5C };
+  ak_streebog state[2] = { &hctx->ipad, &hctx->opad };
+
+  if( hctx->mctx.bsize > sizeof( buffer )) return ak_error_message( ak_error_wrong_length,
+                                            __func__, "using hash function with huge block size" );
+  if(( error = ak_random_ptr( &hctx->key.generator,
+                               hctx->pads_mask, sizeof( hctx->pads_mask ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong generation a random mask for hmac states" );
+
+  for( pdx = 0; pdx < 2; pdx++ ) {
+    /* фомируем маскированное значение ключа */
+     len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
+     for( idx = 0; idx < len; idx++, jdx++ ) {
+        buffer[idx] = hctx->key.key[idx] ^ pad[pdx];
+        buffer[idx] ^= hctx->key.key[jdx];
+     }
+     for( ; idx < hctx->mctx.bsize; idx++ ) buffer[idx] = pad[pdx];
+
+    /* обрабатываем первый блок и сохраняем состояние */
+     if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "wrong cleaning of hash function context" );
+       break;
+     }
+     if(( error = ak_hash_update( &hctx->ctx, buffer, hctx->mctx.bsize )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
+       break;
+     }
+     memcpy( state[pdx], &hctx->ctx.data.sctx, sizeof( struct streebog ));
+     for( idx = 0; idx < 8; idx++ ) {
+        state[pdx]->h[idx] ^= hctx->pads_mask[idx];
+        state[pdx]->sigma[idx] ^= hctx->pads_mask[8+idx];
+     }
+  }
+
+ /* очищаем буффер и контекст хеширования */
+  ak_ptr_wipe( buffer, sizeof( buffer ), &hctx->key.generator );
+  ak_hash_clean( &hctx->ctx );
+  if( error != ak_error_ok ) return error;
+
+ /* перемаскируем ключ */
+  hctx->key.set_mask( &hctx->key );
+  hctx->pads_ready = ak_true;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перевод контекста хеширования в сохраненное состояние (снятие маски).
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.
+    \param state Сохраненное маскированное состояние.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_internal_load_pad( ak_hmac hctx, ak_streebog state )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+  ak_streebog sx = &hctx->ctx.data.sctx;
+
+  if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong cleaning of hash function context" );
+
+  memcpy( sx->n, state->n, sizeof( sx->n ));
+  for( idx = 0; idx < 8; idx++ ) {
+     sx->h[idx] = state->h[idx] ^ hctx->pads_mask[idx];
+     sx->sigma[idx] = state->sigma[idx] ^ hctx->pads_mask[8+idx];
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Смена маски, наложенной на сохраненные состояния.
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_internal_remask_pads( ak_hmac hctx )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+  ak_uint64 newmask[16];
+
+  if(( error = ak_random_ptr( &hctx->key.generator, newmask, sizeof( newmask ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong generation a random mask for hmac states" );
+  for( idx = 0; idx < 8; idx++ ) {
+     hctx->ipad.h[idx] ^= newmask[idx];
+     hctx->opad.h[idx] ^= newmask[idx];
+     hctx->ipad.sigma[idx] ^= newmask[8+idx];
+     hctx->opad.sigma[idx] ^= newmask[8+idx];
+  }
+  for( idx = 0; idx < 16; idx++ ) hctx->pads_mask[idx] ^= newmask[idx];
+ return ak_error_ok;
+}
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Очистка контекста алгоритма hmac.
+
+    Контекст хеширования переводится в состояние, сохраненное после обработки блока
+    \f$ K \oplus ipad \f$, поэтому при каждом вызове функции сжатие блока, содержащего ключ,
+    не выполняется (см. ak_hmac_internal_set_pads()).
+
     \param ctx Контекст алгоритма HMAC выработки имитовставки.
     \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
     возвращается код ошибки.                                                                       */
@@ -28,8 +147,6 @@
 {
   int error = ak_error_ok;
   ak_hmac hctx = ( ak_hmac ) ctx;
-  size_t idx = 0, jdx = 0, len = 0;
-  ak_uint8 buffer[64]; /* буффер для хранения промежуточных значений */
 
   if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using a null pointer to hmac key context" );
@@ -40,30 +157,17 @@
   if( hctx->key.resource.value.counter <= 1 ) return ak_error_message( ak_error_low_key_resource,
                                             __func__, "using hmac key context with low resource" );
                       /* нам надо два раза использовать ключ => ресурс должен быть не менее двух */
-  if( hctx->mctx.bsize > sizeof( buffer )) return ak_error_message( ak_error_wrong_length,
-                                            __func__, "using hash function with huge block size" );
 
- /* фомируем маскированное значение ключа */
-  len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
-  for( idx = 0; idx < len; idx++, jdx++ ) {
-     buffer[idx] = hctx->key.key[idx] ^ 0x36;
-     buffer[idx] ^= hctx->key.key[jdx];
+ /* при первом использовании ключа вычисляем состояния */
+  if( !hctx->pads_ready ) {
+    if(( error = ak_hmac_internal_set_pads( hctx )) != ak_error_ok )
+      return ak_error_message( error, __func__, "wrong precomputation of hmac states" );
   }
-  for( ; idx < hctx->mctx.bsize; idx++ ) buffer[idx] = 0x36;
 
- /* инициализируем начальное состояние контекста хеширования */
-  if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong cleaning of hash function context" );
-
- /* обновляем состояние контекста хеширования */
-  if(( error = ak_hash_update( &hctx->ctx, buffer, hctx->mctx.bsize )) != ak_error_ok )
-    ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
-
- /* очищаем буффер */
-  ak_ptr_wipe( buffer, sizeof( buffer ), &hctx->key.generator );
+ /* инициализируем состояние контекста хеширования */
+  if(( error = ak_hmac_internal_load_pad( hctx, &hctx->ipad )) != ak_error_ok )
+    return ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
 
- /* перемаскируем ключ и меняем его ресурс */
-  hctx->key.set_mask( &hctx->key );
   hctx->key.resource.value.counter--; /* мы использовали ключ один раз */
 
  return error;
@@ -112,9 +216,7 @@
 {
   int error = ak_error_ok;
   ak_hmac hctx = ( ak_hmac ) ctx;
-  size_t idx = 0, jdx = 0, len = 0;
-  ak_uint8 temporary[128]; /* первый буффер для хранения промежуточных значений */
-  ak_uint8 keybuffer[128]; /* второй буффер для хранения промежуточных значений */
+  ak_uint8 temporary[128]; /* буффер для хранения промежуточных значений */
 
  /* выполняем проверки */
   if( hctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
@@ -134,27 +236,12 @@
                                                             sizeof( temporary ))) != ak_error_ok )
     return ak_error_message( error, __func__ , "wrong updating of finalized data" );
 
- /* фомируем маскированное значение ключа */
-  len = ak_min( hctx->mctx.bsize, jdx = hctx->key.key_size );
-  for( idx = 0; idx < len; idx++ , jdx++ ) {
-     keybuffer[idx] = hctx->key.key[idx] ^ 0x5C;
-     keybuffer[idx] ^= hctx->key.key[jdx];
-  }
-  for( ; idx < hctx->mctx.bsize; idx++ ) keybuffer[idx] = 0x5C;
-
- /* возвращаем контекст хеширования в начальное состояние */
-  if(( error = ak_hash_clean( &hctx->ctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong cleaning of hash function context" );
-
- /* обновляем состояние контекста хеширования */
-  if(( error = ak_hash_update( &hctx->ctx, keybuffer, hctx->mctx.bsize )) != ak_error_ok )
+ /* переводим контекст хеширования в состояние после обработки блока K xor opad */
+  if(( error = ak_hmac_internal_load_pad( hctx, &hctx->opad )) != ak_error_ok )
     return ak_error_message( error, __func__, "invalid 1st step iteration for hmac key context" );
 
- /* очищаем буффер */
-  ak_ptr_wipe( keybuffer, sizeof( keybuffer ), &hctx->key.generator );
-
- /* ресурс ключа */
-  hctx->key.set_mask( &hctx->key );
+ /* меняем маску сохраненных состояний и ресурс ключа */
+  ak_hmac_internal_remask_pads( hctx );
   hctx->key.resource.value.counter--; /* мы использовали ключ один раз */
 
  /* последний update/finalize и возврат результата */
@@ -188,6 +275,12 @@
   if( oid->mode != algorithm )
     return ak_error_message( ak_error_oid_mode, __func__ , "using oid with wrong mode" );
 
+ /* сохраненные состояния функции хеширования пока не определены */
+  memset( &hctx->ipad, 0, sizeof( struct streebog ));
+  memset( &hctx->opad, 0, sizeof( struct streebog ));
+  memset( hctx->pads_mask, 0, sizeof( hctx->pads_mask ));
+  hctx->pads_ready = ak_false;
+
  /* получаем oid бесключевой функции хеширования */
   if(( hashoid = ak_oid_find_by_name( oid->name[0]+5 )) == NULL )
     return ak_error_message( ak_error_get_value(), __func__ ,
@@ -255,6 +348,10 @@
     ak_error_message( error, __func__, "incorrect destroying of secret key context" );
   if(( error = ak_mac_destroy( &hctx->mctx )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect destroying of mac context" );
+  memset( &hctx->ipad, 0, sizeof( struct streebog ));
+  memset( &hctx->opad, 0, sizeof( struct streebog ));
+  memset( hctx->pads_mask, 0, sizeof( hctx->pads_mask ));
+  hctx->pads_ready = ak_false;
 
  return error;
 }
@@ -299,9 +396,12 @@
         return ak_error_message( error, __func__ , "incorrect assigning a secret key value" );
   }
 
+ /* сохраненные состояния должны быть вычислены заново */
+  hctx->pads_ready = ak_false;
+
  /* устанавливаем ресурс ключа */
-  if(( error = ak_skey_set_resource_values( &hctx->key,
-                          key_using_resource, "hmac_key_count_resource", 0, 0 )) != ak_error_ok )
+  if(( error = ak_skey_set_resource_values_by_index( &hctx->key, key_using_resource,
+                                           hmac_key_count_resource_option, 0, 0 )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect assigning \"hmac_key_count_resource\" option" );
  return error;
 }
@@ -326,9 +426,12 @@
   if(( error = ak_skey_set_key_random( &hctx->key, generator )) != ak_error_ok )
     return ak_error_message( error, __func__ , "incorrect assigning a secret key value" );
 
+ /* сохраненные состояния должны быть вычислены заново */
+  hctx->pads_ready = ak_false;
+
  /* устанавливаем ресурс ключа */
-  if(( error = ak_skey_set_resource_values( &hctx->key,
-                          key_using_resource, "hmac_key_count_resource", 0, 0 )) != ak_error_ok )
+  if(( error = ak_skey_set_resource_values_by_index( &hctx->key, key_using_resource,
+                                           hmac_key_count_resource_option, 0, 0 )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect assigning \"hmac_key_count_resource\" option" );
 
  return error;
@@ -362,9 +465,12 @@
                                           pass, pass_size, salt, salt_size )) != ak_error_ok )
     return ak_error_message( error, __func__ , "incorrect assigning a secret key value" );
 
+ /* сохраненные состояния должны быть вычислены заново */
+  hctx->pads_ready = ak_false;
+
  /* устанавливаем ресурс ключа */
-  if(( error = ak_skey_set_resource_values( &hctx->key,
-                          key_using_resource, "hmac_key_count_resource", 0, 0 )) != ak_error_ok )
+  if(( error = ak_skey_set_resource_values_by_index( &hctx->key, key_using_resource,
+                                           hmac_key_count_resource_option, 0, 0 )) != ak_error_ok )
     ak_error_message( error, __func__, "incorrect assigning \"hmac_key_count_resource\" option" );
 
  return error;
@@ -439,7 +545,10 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \param hctx Контекст алгоритма HMAC выработки имитовставки.
+/*! Файл, по возможности, отображается в память и обрабатывается без промежуточного
+    копирования данных (см. функцию ak_mac_file()).
+
+    \param hctx Контекст алгоритма HMAC выработки имитовставки.
     \param filename Имя файла, для котрого вычисляется имитовставка.
     \param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
     Размер выделяемой памяти должен быть не менее значения поля hsize и может
@@ -489,10 +598,204 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Пароль должен представлять собой ненулевую строку символов в utf8
-    кодировке. Размер вырабатываемого ключевого вектора может колебаться от 32-х до 64-х байт.
+/*! \brief Максимальное количество потоков, используемых функцией ak_hmac_pbkdf2_streebog512(). */
+ #define ak_hmac_pbkdf2_thread_max (8)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Контекст вычисления одного блока \f$ T_i \f$ алгоритма PBKDF2. */
+ typedef struct pbkdf2_block {
+  /*! \brief Состояние функции хеширования после обработки блока \f$ K \oplus ipad \f$. */
+   ak_streebog ipad;
+  /*! \brief Состояние функции хеширования после обработки блока \f$ K \oplus opad \f$. */
+   ak_streebog opad;
+  /*! \brief Текущее значение \f$ U_j \f$. */
+   ak_uint64 u[8];
+  /*! \brief Накопленное значение \f$ T_i = U_1 \oplus \ldots \oplus U_j \f$. */
+   ak_uint64 t[8];
+  /*! \brief Количество оставшихся итераций. */
+   size_t count;
+  /*! \brief Область памяти, куда помещается фрагмент блока \f$ T_i \f$. */
+   ak_uint8 *out;
+  /*! \brief Смещение фрагмента относительно начала блока \f$ T_i \f$ (в октетах). */
+   size_t offset;
+  /*! \brief Длина фрагмента (в октетах). */
+   size_t length;
+ } *ak_pbkdf2_block;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Фрагмент массива блоков алгоритма PBKDF2, обрабатываемый одним потоком. */
+ typedef struct pbkdf2_batch {
+  /*! \brief Массив блоков. */
+   ak_pbkdf2_block blocks;
+  /*! \brief Количество блоков во фрагменте. */
+   size_t count;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Флаг успешного запуска потока. */
+   bool_t started;
+  /*! \brief Идентификатор потока. */
+   pthread_t thread;
+#endif
+ } *ak_pbkdf2_batch;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление значений \f$ U_1 \f$ для всех блоков ключевого вектора, вырабатываемого
+    из одного пароля.
+
+    Значения \f$ U_1 = HMAC( P, S || INT(i)) \f$ вычисляются с помощью обычного интерфейса HMAC,
+    после чего из сохраненных в контексте состояний функции хеширования (см.
+    ak_hmac_internal_set_pads()) удаляется маска и они помещаются в массив `pads`.
+
+    \param pass Пароль.
+    \param pass_size Размер пароля в байтах.
+    \param salt Инициализационный вектор.
+    \param salt_size Размер инициализационного вектора в байтах.
+    \param cnt Количество итераций.
+    \param dklen Длина вырабатываемого ключевого вектора в байтах.
+    \param out Указатель на область памяти, куда будет помещен результат.
+    \param pads Массив из двух состояний функции хеширования.
+    \param blocks Массив контекстов блоков; количество элементов массива должно быть
+    не менее \f$ \lceil dklen/64 \rceil \f$.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_prepare( const ak_pointer pass, const size_t pass_size,
+                  const ak_pointer salt, const size_t salt_size, const size_t cnt,
+                        const size_t dklen, ak_uint8 *out, ak_streebog pads, ak_pbkdf2_block blocks )
+{
+  struct hmac hctx;
+  ak_uint8 counter[4];
+  int error = ak_error_ok;
+  size_t idx = 0, jdx = 0, count = ( dklen + 63 ) >> 6;
+
+ /* создаем контекст алгоритма hmac и определяем его ключ */
+  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
+  if(( error = ak_hmac_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
+    goto lab_exit;
+  }
+
+ /* вычисляем значения первой строки U1 для каждого блока */
+  for( idx = 0; idx < count; idx++ ) {
+     ak_pbkdf2_block blk = blocks + idx;
+
+     counter[0] = ( ak_uint8 )(( idx+1 ) >> 24 );
+     counter[1] = ( ak_uint8 )(( idx+1 ) >> 16 );
+     counter[2] = ( ak_uint8 )(( idx+1 ) >> 8 );
+     counter[3] = ( ak_uint8 )( idx+1 );
+     if(( error = ak_hmac_clean( &hctx )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
+       goto lab_exit;
+     }
+     if(( error = ak_hmac_update( &hctx, salt, salt_size )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect updating of internal hmac context");
+       goto lab_exit;
+     }
+     if(( error = ak_hmac_finalize( &hctx, counter, 4, blk->u, sizeof( blk->u ))) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
+       goto lab_exit;
+     }
+     memcpy( blk->t, blk->u, sizeof( blk->t ));
+     blk->ipad = pads;
+     blk->opad = pads+1;
+     blk->count = ( cnt > 1 ) ? cnt - 1 : 0;
+
+    /* ключевые векторы длины не более 64-х октетов, согласно Р 50.1.111-2016,
+       формируются из младших октетов блока T1, более длинные векторы - конкатенацией
+       блоков T1 || T2 || ... */
+     if( dklen <= 64 ) {
+       blk->out = out;
+       blk->offset = 64 - dklen;
+       blk->length = dklen;
+     } else {
+         blk->out = out + ( idx << 6 );
+         blk->offset = 0;
+         blk->length = ak_min( 64, dklen - ( idx << 6 ));
+       }
+     if( !blk->count ) memcpy( blk->out, ( ak_uint8 *)blk->t + blk->offset, blk->length );
+  }
+
+ /* сохраняем состояния функции хеширования, удаляя из них маску */
+  memcpy( pads, &hctx.ipad, sizeof( struct streebog ));
+  memcpy( pads+1, &hctx.opad, sizeof( struct streebog ));
+  for( jdx = 0; jdx < 8; jdx++ ) {
+     pads[0].h[jdx] ^= hctx.pads_mask[jdx]; pads[0].sigma[jdx] ^= hctx.pads_mask[8+jdx];
+     pads[1].h[jdx] ^= hctx.pads_mask[jdx]; pads[1].sigma[jdx] ^= hctx.pads_mask[8+jdx];
+  }
+
+  lab_exit: ak_hmac_destroy( &hctx );
+  memset( counter, 0, sizeof( counter ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция, вычисляющая блоки \f$ T_i \f$ фрагмента; может выполняться отдельным потоком.
+
+    Блоки распределяются по \ref ak_hash_multi_lanes дорожкам, для которых вычисления функции
+    хеширования выполняются одновременно (см. ak_hash_context_streebog_finalize_block_lanes()).
+    Как только вычисление одного из блоков завершается, освободившаяся дорожка занимается
+    следующим блоком.                                                                              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hmac_pbkdf2_streebog512_run( void *ptr )
+{
+  size_t j = 0, k = 0, active = 0, next = 0;
+  ak_pbkdf2_batch bt = ( ak_pbkdf2_batch ) ptr;
+  ak_pbkdf2_block lanes[ak_hash_multi_lanes];
+  ak_streebog cx[ak_hash_multi_lanes];
+  const ak_uint64 *m[ak_hash_multi_lanes];
+  ak_uint64 *out[ak_hash_multi_lanes], inner[ak_hash_multi_lanes][8];
+
+  do{
+    /* занимаем свободные дорожки очередными блоками */
+     while(( active < ak_hash_multi_lanes ) && ( next < bt->count )) {
+        if( bt->blocks[next].count ) lanes[active++] = bt->blocks + next;
+        next++;
+     }
+     if( !active ) break;
+
+    /* вычисляем очередное значение U = HMAC( P, U ) для всех занятых дорожек */
+     for( j = 0; j < active; j++ ) {
+        cx[j] = lanes[j]->ipad; m[j] = lanes[j]->u; out[j] = inner[j];
+     }
+     ak_hash_context_streebog_finalize_block_lanes( cx, m, out, active );
+     for( j = 0; j < active; j++ ) {
+        cx[j] = lanes[j]->opad; m[j] = inner[j]; out[j] = lanes[j]->u;
+     }
+     ak_hash_context_streebog_finalize_block_lanes( cx, m, out, active );
+
+    /* накапливаем значения T и освобождаем дорожки, для которых вычисления завершены */
+     for( j = 0; j < active; ) {
+        ak_pbkdf2_block blk = lanes[j];
+        for( k = 0; k < 8; k++ ) blk->t[k] ^= blk->u[k];
+        if( --blk->count ) { j++; continue; }
+
+        memcpy( blk->out, ( ak_uint8 *)blk->t + blk->offset, blk->length );
+        memset( blk->u, 0, sizeof( blk->u ));
+        memset( blk->t, 0, sizeof( blk->t ));
+        lanes[j] = lanes[--active];
+     }
+  } while(( active > 0 ) || ( next < bt->count ));
+
+  memset( inner, 0, sizeof( inner ));
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Пароль должен представлять собой ненулевую строку символов в utf8 кодировке.
     При выработке используется алгоритм hmac-streebog512.
 
+    Ключевой вектор, длина которого не превосходит 64-х байт, формируется из младших
+    байт блока \f$ T_1 \f$, как это определено в Р 50.1.111-2016. Более длинный ключевой
+    вектор формируется, согласно RFC 8018, конкатенацией блоков \f$ T_1 || T_2 || \ldots \f$,
+    при этом независимые блоки \f$ T_i \f$ вычисляются одновременно, с использованием
+    нескольких потоков (см. ak_hmac_pbkdf2_streebog512_batch()).
+
+    Первая итерация выполняется с помощью обычного интерфейса HMAC, остальные итерации
+    используют вычисленные один раз состояния функции хеширования после обработки блоков
+    \f$ K \oplus ipad \f$ и \f$ K \oplus opad \f$, поэтому каждая итерация
+    требует только сжатия очередного блока и завершения вычислений
+    (см. ak_hash_context_streebog_finalize_block_lanes()).
+
     @param pass Пароль, строка символов в utf8 кодировке.
     @param pass_size Размер пароля в байтах, должен быть отличен от нуля.
     @param salt Строка с инициализационным вектором (произвольная область памяти). Данное значение
@@ -501,8 +804,8 @@
     @param cnt Параметр, определяющий количество однотипных итераций для выработки ключа; данный
     параметр определяет время работы алгоритма; параметр не является секретным и может храниться или
     передаваться в открытом виде.
-    @param dklen Длина вырабатываемого ключевого вектора в байтах, величина должна принимать
-    значение от 32-х до 64-х.
+    @param dklen Длина вырабатываемого ключевого вектора в байтах, величина должна быть
+    не менее 32-х.
     @param out Указатель на массив, куда будет помещен результат; под данный массив должна быть
     заранее выделена память не менее, чем dklen байт.
 
@@ -513,57 +816,126 @@
          const size_t pass_size, const ak_pointer salt, const size_t salt_size, const size_t cnt,
                                                                const size_t dklen, ak_pointer out )
 {
-  struct hmac hctx;
-  ak_uint8 result[64];
+ return ak_hmac_pbkdf2_streebog512_batch( 1, &pass, &pass_size, &salt, &salt_size,
+                                                   cnt, dklen, &out, ak_hmac_pbkdf2_thread_max );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключевые векторы для `count` пар (пароль, инициализационный вектор);
+    результат для каждой пары совпадает с результатом функции ak_hmac_pbkdf2_streebog512().
+
+    Блоки \f$ T_i \f$ всех вырабатываемых ключевых векторов вычисляются независимо: они
+    распределяются между несколькими потоками, а внутри каждого потока вычисления функции
+    хеширования для нескольких блоков выполняются одновременно (см. ak_hash_ptr_multi()).
+
+    @param count Количество паролей.
+    @param pass Массив указателей на пароли.
+    @param pass_size Массив длин паролей (в байтах), длины должны быть отличны от нуля.
+    @param salt Массив указателей на инициализационные векторы.
+    @param salt_size Массив длин инициализационных векторов (в байтах).
+    @param cnt Количество итераций алгоритма, общее для всех паролей.
+    @param dklen Длина вырабатываемых ключевых векторов в байтах, величина должна быть
+    не менее 32-х.
+    @param out Массив указателей на области памяти, куда будут помещены результаты;
+    размер каждой области должен быть не менее dklen байт.
+    @param threads Максимальное количество используемых потоков (значение ноль
+    эквивалентно одному потоку). Если библиотека собрана без поддержки pthreads,
+    значение игнорируется.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_pbkdf2_streebog512_batch( const size_t count, const ak_pointer *pass,
+                     const size_t *pass_size, const ak_pointer *salt, const size_t *salt_size,
+               const size_t cnt, const size_t dklen, ak_pointer *out, const size_t threads )
+{
+  struct pbkdf2_batch main;
+  ak_streebog pads = NULL;
+  ak_pbkdf2_block blocks = NULL;
   int error = ak_error_ok;
-  size_t idx = 0, jdx = 0;
+  size_t idx = 0, total = 0;
+#ifdef AK_HAVE_PTHREAD_H
+  ak_pbkdf2_batch ths = NULL;
+  size_t part = 0, offset = 0, tcnt = 0;
+#endif
 
  /* в начале, многочисленные проверки входных параметров */
-  if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+  if(( pass == NULL ) || ( pass_size == NULL ) || ( salt == NULL ) ||
+                                                         ( salt_size == NULL ) || ( out == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__,
+                                                 "using null pointer to array of batch elements" );
+  if(( dklen < 32 ) || ((( dklen - 1 ) >> 6 ) >= ( size_t )0xffffffff ))
+    return ak_error_message( ak_error_wrong_length,
+                                 __func__ , "using a wrong length for resulting key vector" );
+  for( idx = 0; idx < count; idx++ ) {
+     if( pass[idx] == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                                  "using null pointer to password" );
-  if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
+     if( !pass_size[idx] ) return ak_error_message( ak_error_wrong_length, __func__ ,
                                                                    "using a zero length password" );
-  if( salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+     if( salt[idx] == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                                      "using null pointer to salt" );
-  if(( dklen < 32 ) || ( dklen > 64 )) return ak_error_message( ak_error_wrong_length,
-                                       __func__ , "using a wrong length for resulting key vector" );
-  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+     if( out[idx] == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                      "using null pointer to resulting key vector" );
- /* создаем контекст алгоритма hmac и определяем его ключ */
-  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
-  if(( error = ak_hmac_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
-    goto lab_exit;
   }
+  if( !count ) return ak_error_ok;
 
- /* начальная инициализация промежуточного вектора */
-  memset( result, 0, 64 );
-  result[3] = 1;
-
- /* вычисляем значение первой строки U1  */
-  if(( error = ak_hmac_clean( &hctx )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
+ /* вычисляем первые значения U1 для всех блоков */
+  total = count*(( dklen + 63 ) >> 6 );
+  if((( pads = calloc( count << 1, sizeof( struct streebog ))) == NULL ) ||
+     (( blocks = calloc( total, sizeof( struct pbkdf2_block ))) == NULL )) {
+    ak_error_message( error = ak_error_out_of_memory, __func__ , "memory allocation error" );
     goto lab_exit;
   }
-  if(( error = ak_hmac_update( &hctx, salt, salt_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect updating of internal hmac context");
-    goto lab_exit;
-  }
-  if(( error = ak_hmac_finalize( &hctx, result, 4, result, sizeof( result ))) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
-    goto lab_exit;
-  }
-  memcpy( out, result+64-dklen, dklen );
-
- /* теперь основной цикл по значению аргумента c */
-  for( idx = 1; idx < cnt; idx++ ) {
-     ak_hmac_ptr( &hctx, result, 64, result, sizeof( result ));
-     for( jdx = 0; jdx < dklen; jdx++ ) ((ak_uint8 *)out)[jdx] ^= result[64-dklen+jdx];
+  for( idx = 0; idx < count; idx++ ) {
+     if(( error = ak_hmac_pbkdf2_streebog512_prepare( pass[idx], pass_size[idx], salt[idx],
+                    salt_size[idx], cnt, dklen, out[idx], pads + ( idx << 1 ),
+                                                 blocks + idx*(( dklen + 63 ) >> 6 ))) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect computation of the first pbkdf2 iteration" );
+       goto lab_exit;
+     }
   }
-  memset( result, 0, 64 );
 
-  lab_exit: ak_hmac_destroy( &hctx );
+ /* выполняем основной цикл, распределяя блоки между потоками */
+  memset( &main, 0, sizeof( struct pbkdf2_batch ));
+  main.blocks = blocks;
+  main.count = total;
+
+#ifdef AK_HAVE_PTHREAD_H
+  tcnt = ak_min( threads, total );
+  if(( tcnt > 1 ) && (( ths = calloc( tcnt-1, sizeof( struct pbkdf2_batch ))) != NULL )) {
+   /* первый фрагмент содержит остаток от деления блоков между потоками */
+    part = total/tcnt;
+    main.count = offset = part + total%tcnt;
+    for( idx = 0; idx < tcnt-1; idx++ ) {
+       ths[idx].blocks = blocks + offset;
+       ths[idx].count = part;
+       offset += part;
+    }
+    for( idx = 0; idx < tcnt-1; idx++ )
+       ths[idx].started = ( pthread_create( &ths[idx].thread, NULL,
+                             ak_hmac_pbkdf2_streebog512_run, ths+idx ) == 0 ) ? ak_true : ak_false;
+    ak_hmac_pbkdf2_streebog512_run( &main );
+
+   /* дожидаемся завершения потоков; фрагменты, для которых поток не был создан,
+      обрабатываем самостоятельно */
+    for( idx = 0; idx < tcnt-1; idx++ ) {
+       if( ths[idx].started ) pthread_join( ths[idx].thread, NULL );
+         else ak_hmac_pbkdf2_streebog512_run( ths+idx );
+    }
+    free( ths );
+  } else
+#endif
+   ak_hmac_pbkdf2_streebog512_run( &main );
+
+  lab_exit:
+   if( blocks != NULL ) {
+     memset( blocks, 0, total*sizeof( struct pbkdf2_block ));
+     free( blocks );
+   }
+   if( pads != NULL ) {
+     memset( pads, 0, ( count << 1 )*sizeof( struct streebog ));
+     free( pads );
+   }
  return error;
 }
 
@@ -777,12 +1149,27 @@
    0x78, 0xcc, 0xb8, 0x79, 0xf6, 0x70, 0x68, 0xcd, 0xac, 0x19, 0x10, 0x74, 0x08, 0x44, 0xe8, 0x30
   };
 
+  ak_uint8 R5[100] = {
+   0xb2, 0xd8, 0xf1, 0x24, 0x5f, 0xc4, 0xd2, 0x92, 0x74, 0x80, 0x20, 0x57, 0xe4, 0xb5, 0x4e, 0x0a,
+   0x07, 0x53, 0xaa, 0x22, 0xfc, 0x53, 0x76, 0x0b, 0x30, 0x1c, 0xf0, 0x08, 0x67, 0x9e, 0x58, 0xfe,
+   0x4b, 0xee, 0x9a, 0xdd, 0xca, 0xe9, 0x9b, 0xa2, 0xb0, 0xb2, 0x0f, 0x43, 0x1a, 0x9c, 0x5e, 0x50,
+   0xf3, 0x95, 0xc8, 0x93, 0x87, 0xd0, 0x94, 0x5a, 0xed, 0xec, 0xa6, 0xeb, 0x40, 0x15, 0xdf, 0xc2,
+   0xbd, 0x24, 0x21, 0xee, 0x9b, 0xb7, 0x11, 0x83, 0xba, 0x88, 0x2c, 0xee, 0xbf, 0xef, 0x25, 0x9f,
+   0x33, 0xf9, 0xe2, 0x7d, 0xc6, 0x17, 0x8c, 0xb8, 0x9d, 0xc3, 0x74, 0x28, 0xcf, 0x9c, 0xc5, 0x2a,
+   0x2b, 0xaa, 0x2d, 0x3a
+  };
+
   ak_uint8 password_one[8] = "password",
            password_two[9] = { 'p', 'a', 's', 's', 0, 'w', 'o', 'r', 'd' },
+           password_three[24] = "passwordPASSWORDpassword",
            salt_one[4]     = "salt",
-           salt_two[5]     = { 's', 'a', 0, 'l', 't' };
+           salt_two[5]     = { 's', 'a', 0, 'l', 't' },
+           salt_three[36]  = "saltSALTsaltSALTsaltSALTsaltSALTsalt";
 
-  ak_uint8 out[64];
+  size_t idx = 0;
+  ak_uint8 out[100], bout[5][200], check[200];
+  ak_pointer pass[5], salt[5], bptr[5];
+  size_t pass_size[5], salt_size[5];
   int error = ak_error_ok;
   int audit = ak_log_get_level();
 
@@ -841,6 +1228,47 @@
   }
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                              "the 4th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* пятый тест из Р 50.1.111-2016 (ключевой вектор из двух блоков) */
+  if(( error = ak_hmac_pbkdf2_streebog512( password_three, 24,
+                                               salt_three, 36, 4096, 100, out )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect transformation password to key");
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( out, R5, 100 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                                 "wrong 5th test for pbkdf2 from R 50.1.111-2016" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                             "the 5th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* сравниваем результат одновременной выработки нескольких ключевых векторов
+    с результатом последовательных вызовов */
+  for( idx = 0; idx < 5; idx++ ) {
+     pass[idx] = password_three + idx; pass_size[idx] = 24 - 4*idx;
+     salt[idx] = salt_three + idx; salt_size[idx] = 36 - 7*idx;
+     bptr[idx] = bout[idx];
+  }
+  if(( error = ak_hmac_pbkdf2_streebog512_batch( 5, pass, pass_size,
+                                            salt, salt_size, 3, 200, bptr, 3 )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect transformation of several passwords to keys");
+    return ak_false;
+  }
+  for( idx = 0; idx < 5; idx++ ) {
+     if(( error = ak_hmac_pbkdf2_streebog512( pass[idx], pass_size[idx],
+                                     salt[idx], salt_size[idx], 3, 200, check )) != ak_error_ok ) {
+       ak_error_message( error,__func__, "incorrect transformation password to key");
+       return ak_false;
+     }
+     if( !ak_ptr_is_equal_with_log( bout[idx], check, 200 )) {
+       ak_error_message( ak_error_not_equal_data, __func__ ,
+                                      "wrong test for simultaneous transformation of passwords" );
+       return ak_false;
+     }
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                      "the test for simultaneous transformation of passwords is Ok" );
  return ak_true;
 }
 
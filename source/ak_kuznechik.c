@@ -6,6 +6,13 @@
 /*    регламентированного ГОСТ Р 34.12-2015                                                        */
 /* ----------------------------------------------------------------------------------------------- */
  #include <libakrypt-internal.h>
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+ #include <emmintrin.h>
+#endif
+#if defined( AK_LITTLE_ENDIAN ) && \
+                        ( defined( AK_HAVE_BUILTIN_MM512 ) || defined( AK_HAVE_BUILTIN_MM256 ))
+ #include <immintrin.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Нелинейное биективное преобразование байт, используемое в алгоритмах
@@ -223,11 +230,18 @@
   for( idx = 0; idx < sizeof( sbox ); idx++ ) pinv[pi[idx]] = ( ak_uint8 )idx;
 }
 
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM512 )
+ static void ak_kuznechik_gfni_init_tables( void );
+#endif
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM256 )
+ static void ak_kuznechik_avx2_init_tables( void );
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
  int ak_bckey_kuznechik_init_tables( const linear_register reg,
                                                           const sbox pi, ak_kuznechik_params par )
 {
-  int i, j, l, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int i, j, l, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
   if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                 "wrong value for \"openssl_compability\" option" );
@@ -267,6 +281,12 @@
   if( error != ak_error_ok )
     return ak_error_message( error, __func__,
                                            "generation of GOST R 34.12-2015 parameters is wrong" );
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM512 )
+  ak_kuznechik_gfni_init_tables();
+#endif
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM256 )
+  ak_kuznechik_avx2_init_tables();
+#endif
   if( audit >= ak_log_maximum ) return ak_error_message( ak_error_ok, __func__ ,
                                               "generation of GOST R 34.12-2015 parameters is Ok" );
  return ak_error_ok;
@@ -313,7 +333,7 @@
   ak_uint8 reverse[64];
   int i = 0, j = 0, l = 0, kdx = 2;
   ak_uint64 a0[2], a1[2], c[2], t[2], idx = 0;
-  ak_int64 oc = ak_libakrypt_get_option_by_name( "openssl_compability" );
+  ak_int64 oc = ak_libakrypt_get_option( openssl_compability_option );
   ak_uint64 *ekey = NULL, *mkey = NULL, *dkey = NULL, *xkey = NULL, *rkey = NULL, *lkey = NULL;
 
  /* выполняем стандартные проверки */
@@ -670,6 +690,1058 @@
   (( ak_uint64 *) out)[1] = x[1] ^ xkey[1];
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество блоков, преобразования которых выполняются одновременно. */
+ #define ak_kuznechik_multi_blocks  (2)
+
+/*! \brief Байт с номером `l` блока `x`, представленного двумя 64-х битными словами;
+    величина `rev` определяет порядок следования байт (0 или 15). */
+#ifdef AK_LITTLE_ENDIAN
+ #define ak_kuznechik_byte( x, l ) \
+                   (( ak_uint8 )( (x)[(( l )^rev ) >> 3] >> (((( l )^rev )&0x7 ) << 3 )))
+#else
+ #define ak_kuznechik_byte( x, l ) \
+             (( ak_uint8 )( (x)[(( l )^rev ) >> 3] >> (( 7 - ((( l )^rev )&0x7 )) << 3 )))
+#endif
+
+#ifdef AK_HAVE_BUILTIN_XOR_SI128
+/*! \brief Сложение с накопленными значениями `v0` и `v1` строк таблицы `tab`, соответствующих
+    байтам с номером `l` блоков `x0` и `x1`; строка таблицы загружается одной командой. */
+ #define ak_kuznechik_lookup( tab, l ) \
+   v0 = _mm_xor_si128( v0, _mm_loadu_si128(( const __m128i *) tab[l][ak_kuznechik_byte( x0, l )] )); \
+   v1 = _mm_xor_si128( v1, _mm_loadu_si128(( const __m128i *) tab[l][ak_kuznechik_byte( x1, l )] ))
+
+/*! \brief Табличное преобразование двух блоков `x0` и `x1` с использованием таблицы `tab`. */
+ #define ak_kuznechik_transform( tab ) \
+   v0 = _mm_setzero_si128(); v1 = _mm_setzero_si128();                                            \
+   ak_kuznechik_lookup( tab,  0 );                                             \
+   ak_kuznechik_lookup( tab,  1 );                                             \
+   ak_kuznechik_lookup( tab,  2 );                                             \
+   ak_kuznechik_lookup( tab,  3 );                                             \
+   ak_kuznechik_lookup( tab,  4 );                                             \
+   ak_kuznechik_lookup( tab,  5 );                                             \
+   ak_kuznechik_lookup( tab,  6 );                                             \
+   ak_kuznechik_lookup( tab,  7 );                                             \
+   ak_kuznechik_lookup( tab,  8 );                                             \
+   ak_kuznechik_lookup( tab,  9 );                                             \
+   ak_kuznechik_lookup( tab, 10 );                                             \
+   ak_kuznechik_lookup( tab, 11 );                                             \
+   ak_kuznechik_lookup( tab, 12 );                                             \
+   ak_kuznechik_lookup( tab, 13 );                                             \
+   ak_kuznechik_lookup( tab, 14 );                                             \
+   ak_kuznechik_lookup( tab, 15 );                                             \
+   x0[0] = ( ak_uint64 )_mm_cvtsi128_si64( v0 );                                                  \
+   x0[1] = ( ak_uint64 )_mm_cvtsi128_si64( _mm_unpackhi_epi64( v0, v0 ));                         \
+   x1[0] = ( ak_uint64 )_mm_cvtsi128_si64( v1 );                                                  \
+   x1[1] = ( ak_uint64 )_mm_cvtsi128_si64( _mm_unpackhi_epi64( v1, v1 ))
+#else
+/*! \brief Сложение с накопленными значениями `t0`, `s0`, `t1` и `s1` строк таблицы `tab`,
+    соответствующих байтам с номером `l` блоков `x0` и `x1`. */
+ #define ak_kuznechik_lookup( tab, l ) \
+   t0 ^= tab[l][ak_kuznechik_byte( x0, l )][0]; s0 ^= tab[l][ak_kuznechik_byte( x0, l )][1];      \
+   t1 ^= tab[l][ak_kuznechik_byte( x1, l )][0]; s1 ^= tab[l][ak_kuznechik_byte( x1, l )][1]
+
+/*! \brief Табличное преобразование двух блоков `x0` и `x1` с использованием таблицы `tab`. */
+ #define ak_kuznechik_transform( tab ) \
+   t0 = s0 = t1 = s1 = 0;                                                                          \
+   ak_kuznechik_lookup( tab,  0 );                                             \
+   ak_kuznechik_lookup( tab,  1 );                                             \
+   ak_kuznechik_lookup( tab,  2 );                                             \
+   ak_kuznechik_lookup( tab,  3 );                                             \
+   ak_kuznechik_lookup( tab,  4 );                                             \
+   ak_kuznechik_lookup( tab,  5 );                                             \
+   ak_kuznechik_lookup( tab,  6 );                                             \
+   ak_kuznechik_lookup( tab,  7 );                                             \
+   ak_kuznechik_lookup( tab,  8 );                                             \
+   ak_kuznechik_lookup( tab,  9 );                                             \
+   ak_kuznechik_lookup( tab, 10 );                                             \
+   ak_kuznechik_lookup( tab, 11 );                                             \
+   ak_kuznechik_lookup( tab, 12 );                                             \
+   ak_kuznechik_lookup( tab, 13 );                                             \
+   ak_kuznechik_lookup( tab, 14 );                                             \
+   ak_kuznechik_lookup( tab, 15 );                                             \
+   x0[0] = t0; x0[1] = s0; x1[0] = t1; x1[1] = s1
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует алгоритм зашифрования последовательности независимых блоков
+    информации шифром Кузнечик (согласно ГОСТ Р 34.12-2015).
+
+    Блоки обрабатываются парами: на каждом раунде табличные преобразования двух блоков
+    выполняются вперемешку, что позволяет процессору совмещать обращения к таблицам
+    `kuznechik_parameters.enc`. Все 16 обращений к таблицам развернуты, а байты блоков
+    извлекаются сдвигами, так что блоки остаются в регистрах процессора. При наличии
+    128-ми битных регистров строка таблицы загружается одной командой.
+    Оставшийся блок зашифровывается отдельно.
+
+    Функция вызывается только с константным значением `rev`, что позволяет компилятору
+    вычислить номера байт на этапе компиляции.
+
+    \param skey Контекст секретного ключа.
+    \param inptr Указатель на последовательность входных блоков.
+    \param outptr Указатель на область памяти, куда помещаются зашифрованные блоки
+    (этот указатель может совпадать с inptr).
+    \param blocks Количество обрабатываемых блоков.
+    \param rev Величина, определяющая порядок следования байт во входном блоке:
+    0 для канонического представления и 15 для режима совместимости с openssl.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_kuznechik_encrypt_blocks_generic( ak_skey skey, ak_uint64 *inptr,
+                                               ak_uint64 *outptr, size_t blocks, const size_t rev )
+{
+  size_t i = 0;
+  ak_uint64 *ekey = ( ak_uint64 *)skey->data;
+  ak_uint64 *mkey = ( ak_uint64 *)skey->data + 40;
+  ak_uint64 x0[2], x1[2];
+ #ifdef AK_HAVE_BUILTIN_XOR_SI128
+  __m128i v0, v1;
+ #else
+  ak_uint64 t0, s0, t1, s1;
+ #endif
+
+  while( blocks >= ak_kuznechik_multi_blocks ) {
+    x0[0] = inptr[0]; x0[1] = inptr[1];
+    x1[0] = inptr[2]; x1[1] = inptr[3];
+    for( i = 0; i < 18; i += 2 ) {
+       x0[0] ^= ekey[i]; x0[0] ^= mkey[i]; x0[1] ^= ekey[i+1]; x0[1] ^= mkey[i+1];
+       x1[0] ^= ekey[i]; x1[0] ^= mkey[i]; x1[1] ^= ekey[i+1]; x1[1] ^= mkey[i+1];
+       ak_kuznechik_transform( kuznechik_parameters.enc );
+    }
+    x0[0] ^= ekey[18]; x0[1] ^= ekey[19];
+    x1[0] ^= ekey[18]; x1[1] ^= ekey[19];
+    outptr[0] = x0[0] ^ mkey[18]; outptr[1] = x0[1] ^ mkey[19];
+    outptr[2] = x1[0] ^ mkey[18]; outptr[3] = x1[1] ^ mkey[19];
+    inptr += 2*ak_kuznechik_multi_blocks; outptr += 2*ak_kuznechik_multi_blocks;
+    blocks -= ak_kuznechik_multi_blocks;
+  }
+
+ /* обрабатываем оставшийся блок */
+  if( blocks ) {
+    if( rev ) ak_kuznechik_encrypt_with_mask_oc( skey, inptr, outptr );
+      else ak_kuznechik_encrypt_with_mask( skey, inptr, outptr );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует алгоритм расшифрования последовательности независимых блоков
+    информации шифром Кузнечик (согласно ГОСТ Р 34.12-2015).
+
+    Параметры функции совпадают с параметрами функции ak_kuznechik_encrypt_blocks_generic().       */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_kuznechik_decrypt_blocks_generic( ak_skey skey, ak_uint64 *inptr,
+                                               ak_uint64 *outptr, size_t blocks, const size_t rev )
+{
+  ssize_t i = 0;
+  size_t l = 0;
+  ak_uint64 *dkey = ( ak_uint64 *)skey->data + 20;
+  ak_uint64 *xkey = ( ak_uint64 *)skey->data + 60;
+  ak_uint64 x0[2], x1[2];
+ #ifdef AK_HAVE_BUILTIN_XOR_SI128
+  __m128i v0, v1;
+ #else
+  ak_uint64 t0, s0, t1, s1;
+ #endif
+
+  while( blocks >= ak_kuznechik_multi_blocks ) {
+    x0[0] = inptr[0]; x0[1] = inptr[1];
+    x1[0] = inptr[2]; x1[1] = inptr[3];
+    for( l = 0; l < 16; l++ ) {
+       (( ak_uint8 *)x0 )[l] = kuznechik_parameters.pi[(( ak_uint8 *)x0 )[l]];
+       (( ak_uint8 *)x1 )[l] = kuznechik_parameters.pi[(( ak_uint8 *)x1 )[l]];
+    }
+    for( i = 19; i > 1; i -= 2 ) {
+       ak_kuznechik_transform( kuznechik_parameters.dec );
+       x0[1] ^= dkey[i]; x0[1] ^= xkey[i]; x0[0] ^= dkey[i-1]; x0[0] ^= xkey[i-1];
+       x1[1] ^= dkey[i]; x1[1] ^= xkey[i]; x1[0] ^= dkey[i-1]; x1[0] ^= xkey[i-1];
+    }
+    for( l = 0; l < 16; l++ ) {
+       (( ak_uint8 *)x0 )[l] = kuznechik_parameters.pinv[(( ak_uint8 *)x0 )[l]];
+       (( ak_uint8 *)x1 )[l] = kuznechik_parameters.pinv[(( ak_uint8 *)x1 )[l]];
+    }
+    x0[0] ^= dkey[0]; x0[1] ^= dkey[1];
+    x1[0] ^= dkey[0]; x1[1] ^= dkey[1];
+    outptr[0] = x0[0] ^ xkey[0]; outptr[1] = x0[1] ^ xkey[1];
+    outptr[2] = x1[0] ^ xkey[0]; outptr[3] = x1[1] ^ xkey[1];
+    inptr += 2*ak_kuznechik_multi_blocks; outptr += 2*ak_kuznechik_multi_blocks;
+    blocks -= ak_kuznechik_multi_blocks;
+  }
+
+ /* обрабатываем оставшийся блок */
+  if( blocks ) {
+    if( rev ) ak_kuznechik_decrypt_with_mask_oc( skey, inptr, outptr );
+      else ak_kuznechik_decrypt_with_mask( skey, inptr, outptr );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифрования последовательности блоков, используемая по-умолчанию.
+
+    Функция вызывает ak_kuznechik_encrypt_blocks_generic() с константным значением
+    порядка следования байт.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_encrypt_blocks_internal( ak_skey skey, ak_pointer in, ak_pointer out,
+                                                                size_t blocks, const size_t rev )
+{
+  if( rev ) ak_kuznechik_encrypt_blocks_generic( skey, in, out, blocks, 15 );
+    else ak_kuznechik_encrypt_blocks_generic( skey, in, out, blocks, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция расшифрования последовательности блоков, используемая по-умолчанию.
+
+    Функция вызывает ak_kuznechik_decrypt_blocks_generic() с константным значением
+    порядка следования байт.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_decrypt_blocks_internal( ak_skey skey, ak_pointer in, ak_pointer out,
+                                                                size_t blocks, const size_t rev )
+{
+  if( rev ) ak_kuznechik_decrypt_blocks_generic( skey, in, out, blocks, 15 );
+    else ak_kuznechik_decrypt_blocks_generic( skey, in, out, blocks, 0 );
+}
+
+#if defined( AK_LITTLE_ENDIAN ) && \
+                        ( defined( AK_HAVE_BUILTIN_MM512 ) || defined( AK_HAVE_BUILTIN_MM256 ))
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция извлекает из развернутых таблиц `kuznechik_parameters` столбцы матриц
+    линейных преобразований, используемых при зашифровании и расшифровании.
+
+    Столбцы - это строки таблиц, соответствующие единичному значению перестановки.
+    Функция проверяет, что все строки таблиц представляют собой произведения столбцов
+    на значения нелинейной перестановки.
+
+    \param cenc Массив для столбцов матрицы, используемой при зашифровании.
+    \param cdec Массив для столбцов матрицы, используемой при расшифровании.
+    \return Функция возвращает \ref ak_true, если таблицы имеют ожидаемый вид.
+    В противном случае возвращается \ref ak_false.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_kuznechik_extract_columns( ak_uint8 cenc[16][16], ak_uint8 cdec[16][16] )
+{
+  int a, l, j;
+
+  for( l = 0; l < 16; l++ ) {
+     memcpy( cenc[l], kuznechik_parameters.enc[l][kuznechik_parameters.pinv[1]], 16 );
+     memcpy( cdec[l], kuznechik_parameters.dec[l][kuznechik_parameters.pi[1]], 16 );
+  }
+  for( l = 0; l < 16; l++ )
+     for( a = 0; a < 256; a++ )
+        for( j = 0; j < 16; j++ ) {
+           if((( ak_uint8 *)kuznechik_parameters.enc[l][a] )[j] !=
+               ak_bckey_context_kuznechik_mul_gf256( cenc[l][j], kuznechik_parameters.pi[a] ))
+             return ak_false;
+           if((( ak_uint8 *)kuznechik_parameters.dec[l][a] )[j] !=
+               ak_bckey_context_kuznechik_mul_gf256( cdec[l][j], kuznechik_parameters.pinv[a] ))
+             return ak_false;
+        }
+ return ak_true;
+}
+#endif
+
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM512 )
+/* ----------------------------------------------------------------------------------------------- */
+/*                  реализация с использованием наборов инструкций AVX-512 и GFNI                  */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Атрибут функций, использующих инструкции AVX-512 и GFNI. */
+ #define ak_kuznechik_gfni_target \
+                             __attribute__(( target( "avx512f,avx512bw,avx512vbmi,gfni" )))
+
+/*! \brief Константы, используемые реализацией алгоритма Кузнечик с инструкциями GFNI.
+
+    Инструкция `vgf2p8mulb` выполняет умножение в поле \f$ \mathbb F_{2^8} \f$, определяемом
+    многочленом \f$ x^8 + x^4 + x^3 + x + 1\f$, тогда как ГОСТ Р 34.12-2015 использует многочлен
+    \f$ x^8 + x^7 + x^6 + x + 1\f$. Поэтому все вычисления производятся в образе изоморфизма
+    \f$ \varphi \f$ между этими полями: изоморфизм линеен над \f$ \mathbb F_2 \f$,
+    следовательно, он перестановочен со сложением с раундовыми ключами и масками, а
+    его применение к входным данным и ключам выполняется инструкцией `vgf2p8affineqb`.
+    Нелинейная перестановка в образе изоморфизма вычисляется инструкцией `vpermi2b`,
+    линейное преобразование - умножением байт, продублированных инструкцией `vpshufb`,
+    на столбцы матрицы преобразования. */
+ static struct kuznechik_gfni_params {
+  /*! \brief Нелинейная перестановка \f$ \varphi\pi\varphi^{-1} \f$. */
+   ak_uint8 pi[256];
+  /*! \brief Обратная нелинейная перестановка \f$ \varphi\pi^{-1}\varphi^{-1} \f$. */
+   ak_uint8 pinv[256];
+  /*! \brief Столбцы матрицы, используемой при зашифровании, в образе изоморфизма. */
+   ak_uint8 enc[16][16];
+  /*! \brief Столбцы матрицы, используемой при расшифровании, в образе изоморфизма. */
+   ak_uint8 dec[16][16];
+  /*! \brief Матрица изоморфизма \f$ \varphi \f$ в формате инструкции `vgf2p8affineqb`. */
+   ak_uint64 phi;
+  /*! \brief Матрица обратного изоморфизма в формате инструкции `vgf2p8affineqb`. */
+   ak_uint64 phinv;
+  /*! \brief Флаг корректной выработки констант. */
+   bool_t ready;
+ } kuznechik_gfni __attribute__(( aligned( 64 )));
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение в поле, определяемом многочленом \f$ x^8 + x^4 + x^3 + x + 1\f$. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint8 ak_kuznechik_gfni_mul( ak_uint8 x, ak_uint8 y )
+{
+  ak_uint8 z = 0;
+  while( y ) {
+    if( y&0x1 ) z ^= x;
+    x = ((ak_uint8)(x << 1)) ^ ( x & 0x80 ? 0x1B : 0x00 );
+    y >>= 1;
+  }
+ return z;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Представление линейного отображения байт, заданного таблицей значений,
+    в формате матрицы инструкции `vgf2p8affineqb`. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_kuznechik_gfni_matrix( const ak_uint8 *map )
+{
+  int i, k;
+  ak_uint64 matrix = 0;
+
+  for( i = 0; i < 8; i++ ) {
+     ak_uint64 row = 0;
+     for( k = 0; k < 8; k++ ) row |= (( ak_uint64 )(( map[1 << k] >> i )&0x1 )) << k;
+     matrix |= row << ( 8*( 7-i ));
+  }
+ return matrix;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает константы реализации с инструкциями GFNI.
+
+    Константы вычисляются по развернутым таблицам `kuznechik_parameters`, поэтому функция
+    вызывается при каждом пересчете таблиц. Перед использованием проверяется, что
+    отображение \f$ \varphi \f$ является изоморфизмом полей, а строки таблиц представляют
+    собой произведения столбцов матрицы на значения нелинейной перестановки.
+    В случае неудачи флаг `ready` опускается и используется переносимая реализация.      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_gfni_init_tables( void )
+{
+  int a, b, k, l, j;
+  ak_uint8 phi[256], phinv[256], g = 0, gk[8], cenc[16][16], cdec[16][16];
+
+  kuznechik_gfni.ready = ak_false;
+
+ /* ищем корень многочлена x^8 + x^7 + x^6 + x + 1 в поле с многочленом x^8 + x^4 + x^3 + x + 1 */
+  for( a = 2; a < 256; a++ ) {
+     ak_uint8 x = ( ak_uint8 )a, x2 = ak_kuznechik_gfni_mul( x, x ),
+              x4 = ak_kuznechik_gfni_mul( x2, x2 ), x6 = ak_kuznechik_gfni_mul( x4, x2 ),
+              x7 = ak_kuznechik_gfni_mul( x6, x ), x8 = ak_kuznechik_gfni_mul( x4, x4 );
+     if(( x8^x7^x6^x^1 ) == 0 ) { g = x; break; }
+  }
+  if( g == 0 ) return;
+
+ /* изоморфизм переводит x^k в g^k */
+  gk[0] = 1;
+  for( k = 1; k < 8; k++ ) gk[k] = ak_kuznechik_gfni_mul( gk[k-1], g );
+  for( a = 0; a < 256; a++ ) {
+     ak_uint8 v = 0;
+     for( k = 0; k < 8; k++ ) if(( a >> k )&0x1 ) v ^= gk[k];
+     phi[a] = v; phinv[v] = ( ak_uint8 )a;
+  }
+  for( a = 0; a < 256; a++ )
+     for( b = 0; b < 256; b++ )
+        if( phi[ak_bckey_context_kuznechik_mul_gf256(( ak_uint8 )a, ( ak_uint8 )b )] !=
+                                                   ak_kuznechik_gfni_mul( phi[a], phi[b] )) return;
+
+ /* столбцы матриц - строки таблиц, соответствующие единичному значению перестановки */
+  if( !ak_kuznechik_extract_columns( cenc, cdec )) return;
+
+ /* переносим все в образ изоморфизма */
+  for( a = 0; a < 256; a++ ) {
+     kuznechik_gfni.pi[a] = phi[kuznechik_parameters.pi[phinv[a]]];
+     kuznechik_gfni.pinv[a] = phi[kuznechik_parameters.pinv[phinv[a]]];
+  }
+  for( l = 0; l < 16; l++ )
+     for( j = 0; j < 16; j++ ) {
+        kuznechik_gfni.enc[l][j] = phi[cenc[l][j]];
+        kuznechik_gfni.dec[l][j] = phi[cdec[l][j]];
+     }
+  kuznechik_gfni.phi = ak_kuznechik_gfni_matrix( phi );
+  kuznechik_gfni.phinv = ak_kuznechik_gfni_matrix( phinv );
+  kuznechik_gfni.ready = ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Нелинейная перестановка 64-х байт, заданная таблицей `s0`, `s1`, `s2`, `s3`. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_gfni_target static inline __m512i ak_kuznechik_gfni_sbox( __m512i x,
+                                                  __m512i s0, __m512i s1, __m512i s2, __m512i s3 )
+{
+  __m512i lo = _mm512_permutex2var_epi8( s0, x, s1 ), hi = _mm512_permutex2var_epi8( s2, x, s3 );
+ return _mm512_mask_blend_epi8( _mm512_movepi8_mask( x ), lo, hi );
+}
+
+/*! \brief Сложение трех 512-ти битных векторов. */
+ #define ak_kuznechik_gfni_xor3( a, b, c ) _mm512_ternarylogic_epi64( a, b, c, 0x96 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Линейное преобразование четырех блоков, заданное столбцами матрицы `cols`;
+    байт с номером `l^rev` каждого блока умножается на `l`-й столбец. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_gfni_target static inline __m512i ak_kuznechik_gfni_linear( __m512i x,
+                                                 const ak_uint8 *cols, const size_t rev )
+{
+  int l;
+  __m512i t[16];
+
+  for( l = 0; l < 16; l++ )
+     t[l] = _mm512_gf2p8mul_epi8( _mm512_shuffle_epi8( x, _mm512_set1_epi8(( char )( l^rev ))),
+                      _mm512_broadcast_i32x4( _mm_load_si128(( const __m128i *)( cols + 16*l ))));
+ return ak_kuznechik_gfni_xor3(
+           ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_xor3( t[0], t[1], t[2] ),
+                                   ak_kuznechik_gfni_xor3( t[3], t[4], t[5] ),
+                                   ak_kuznechik_gfni_xor3( t[6], t[7], t[8] )),
+           ak_kuznechik_gfni_xor3( t[9], t[10], t[11] ),
+           ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_xor3( t[12], t[13], t[14] ), t[15],
+                                                                        _mm512_setzero_si512( )));
+}
+
+/*! \brief Загрузка 128-ми битного ключа в каждую четверть вектора с переводом в образ изоморфизма. */
+ #define ak_kuznechik_gfni_key( ptr, phi ) _mm512_gf2p8affine_epi64_epi8( \
+                 _mm512_broadcast_i32x4( _mm_loadu_si128(( const __m128i *)( ptr ))), phi, 0 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует алгоритм зашифрования последовательности независимых блоков
+    информации шифром Кузнечик с использованием наборов инструкций AVX-512 и GFNI.
+
+    Каждый 512-ти битный регистр содержит четыре блока, в основном цикле одновременно
+    обрабатываются восемь блоков; оставшиеся блоки обрабатываются с использованием масок
+    загрузки и сохранения. Раундовые ключи и маски переводятся в образ изоморфизма раздельно
+    и складываются с блоками одной инструкцией, так что значение ключа без маски
+    не вычисляется. Параметры функции совпадают с параметрами функции
+    ak_kuznechik_encrypt_blocks_generic().                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_gfni_target static inline void ak_kuznechik_encrypt_blocks_gfni_internal(
+                  ak_skey skey, ak_uint64 *inptr, ak_uint64 *outptr, size_t blocks, const size_t rev )
+{
+  int i = 0;
+  size_t cnt = 0;
+  __mmask8 mask = 0;
+  ak_uint64 *ekey = ( ak_uint64 *)skey->data;
+  ak_uint64 *mkey = ( ak_uint64 *)skey->data + 40;
+  __m512i ke[10], km[10], x, y,
+          phi = _mm512_set1_epi64(( long long )kuznechik_gfni.phi ),
+          phinv = _mm512_set1_epi64(( long long )kuznechik_gfni.phinv ),
+          s0 = _mm512_load_si512( kuznechik_gfni.pi ),
+          s1 = _mm512_load_si512( kuznechik_gfni.pi + 64 ),
+          s2 = _mm512_load_si512( kuznechik_gfni.pi + 128 ),
+          s3 = _mm512_load_si512( kuznechik_gfni.pi + 192 );
+
+  for( i = 0; i < 10; i++ ) {
+     ke[i] = ak_kuznechik_gfni_key( ekey + 2*i, phi );
+     km[i] = ak_kuznechik_gfni_key( mkey + 2*i, phi );
+  }
+
+  while( blocks >= 8 ) {
+    x = _mm512_gf2p8affine_epi64_epi8( _mm512_loadu_si512( inptr ), phi, 0 );
+    y = _mm512_gf2p8affine_epi64_epi8( _mm512_loadu_si512( inptr + 8 ), phi, 0 );
+    for( i = 0; i < 9; i++ ) {
+       x = ak_kuznechik_gfni_xor3( x, ke[i], km[i] );
+       y = ak_kuznechik_gfni_xor3( y, ke[i], km[i] );
+       x = ak_kuznechik_gfni_linear( ak_kuznechik_gfni_sbox( x, s0, s1, s2, s3 ),
+                                                                       kuznechik_gfni.enc[0], rev );
+       y = ak_kuznechik_gfni_linear( ak_kuznechik_gfni_sbox( y, s0, s1, s2, s3 ),
+                                                                       kuznechik_gfni.enc[0], rev );
+    }
+    x = ak_kuznechik_gfni_xor3( x, ke[9], km[9] );
+    y = ak_kuznechik_gfni_xor3( y, ke[9], km[9] );
+    _mm512_storeu_si512( outptr, _mm512_gf2p8affine_epi64_epi8( x, phinv, 0 ));
+    _mm512_storeu_si512( outptr + 8, _mm512_gf2p8affine_epi64_epi8( y, phinv, 0 ));
+    inptr += 16; outptr += 16; blocks -= 8;
+  }
+
+ /* обрабатываем оставшиеся блоки, по четыре за раз */
+  while( blocks > 0 ) {
+    cnt = ak_min( blocks, 4 );
+    mask = ( __mmask8 )(( 1u << ( 2*cnt )) - 1 );
+    x = _mm512_gf2p8affine_epi64_epi8( _mm512_maskz_loadu_epi64( mask, inptr ), phi, 0 );
+    for( i = 0; i < 9; i++ ) {
+       x = ak_kuznechik_gfni_xor3( x, ke[i], km[i] );
+       x = ak_kuznechik_gfni_linear( ak_kuznechik_gfni_sbox( x, s0, s1, s2, s3 ),
+                                                                       kuznechik_gfni.enc[0], rev );
+    }
+    x = ak_kuznechik_gfni_xor3( x, ke[9], km[9] );
+    _mm512_mask_storeu_epi64( outptr, mask, _mm512_gf2p8affine_epi64_epi8( x, phinv, 0 ));
+    inptr += 2*cnt; outptr += 2*cnt; blocks -= cnt;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует алгоритм расшифрования последовательности независимых блоков
+    информации шифром Кузнечик с использованием наборов инструкций AVX-512 и GFNI.
+
+    Функция повторяет вычисления функции ak_kuznechik_decrypt_with_mask(): используются
+    раундовые ключи и маски расшифрования и столбцы матрицы, извлеченные из таблиц
+    `kuznechik_parameters.dec`. Начальное применение прямой перестановки взаимно уничтожается
+    с применением обратной перестановки в первом раунде и поэтому не выполняется.
+    Параметры функции совпадают с параметрами функции ak_kuznechik_encrypt_blocks_generic().       */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_gfni_target static inline void ak_kuznechik_decrypt_blocks_gfni_internal(
+                  ak_skey skey, ak_uint64 *inptr, ak_uint64 *outptr, size_t blocks, const size_t rev )
+{
+  int i = 0;
+  size_t cnt = 0;
+  __mmask8 mask = 0;
+  ak_uint64 *dkey = ( ak_uint64 *)skey->data + 20;
+  ak_uint64 *xkey = ( ak_uint64 *)skey->data + 60;
+  __m512i kd[10], kx[10], x, y,
+          phi = _mm512_set1_epi64(( long long )kuznechik_gfni.phi ),
+          phinv = _mm512_set1_epi64(( long long )kuznechik_gfni.phinv ),
+          s0 = _mm512_load_si512( kuznechik_gfni.pinv ),
+          s1 = _mm512_load_si512( kuznechik_gfni.pinv + 64 ),
+          s2 = _mm512_load_si512( kuznechik_gfni.pinv + 128 ),
+          s3 = _mm512_load_si512( kuznechik_gfni.pinv + 192 );
+
+  for( i = 0; i < 10; i++ ) {
+     kd[i] = ak_kuznechik_gfni_key( dkey + 2*i, phi );
+     kx[i] = ak_kuznechik_gfni_key( xkey + 2*i, phi );
+  }
+
+  while( blocks >= 8 ) {
+    x = _mm512_gf2p8affine_epi64_epi8( _mm512_loadu_si512( inptr ), phi, 0 );
+    y = _mm512_gf2p8affine_epi64_epi8( _mm512_loadu_si512( inptr + 8 ), phi, 0 );
+    x = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_linear( x, kuznechik_gfni.dec[0], rev ), kd[9], kx[9] );
+    y = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_linear( y, kuznechik_gfni.dec[0], rev ), kd[9], kx[9] );
+    for( i = 8; i > 0; i-- ) {
+       x = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_linear(
+              ak_kuznechik_gfni_sbox( x, s0, s1, s2, s3 ), kuznechik_gfni.dec[0], rev ), kd[i], kx[i] );
+       y = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_linear(
+              ak_kuznechik_gfni_sbox( y, s0, s1, s2, s3 ), kuznechik_gfni.dec[0], rev ), kd[i], kx[i] );
+    }
+    x = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_sbox( x, s0, s1, s2, s3 ), kd[0], kx[0] );
+    y = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_sbox( y, s0, s1, s2, s3 ), kd[0], kx[0] );
+    _mm512_storeu_si512( outptr, _mm512_gf2p8affine_epi64_epi8( x, phinv, 0 ));
+    _mm512_storeu_si512( outptr + 8, _mm512_gf2p8affine_epi64_epi8( y, phinv, 0 ));
+    inptr += 16; outptr += 16; blocks -= 8;
+  }
+
+ /* обрабатываем оставшиеся блоки, по четыре за раз */
+  while( blocks > 0 ) {
+    cnt = ak_min( blocks, 4 );
+    mask = ( __mmask8 )(( 1u << ( 2*cnt )) - 1 );
+    x = _mm512_gf2p8affine_epi64_epi8( _mm512_maskz_loadu_epi64( mask, inptr ), phi, 0 );
+    x = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_linear( x, kuznechik_gfni.dec[0], rev ), kd[9], kx[9] );
+    for( i = 8; i > 0; i-- )
+       x = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_linear(
+              ak_kuznechik_gfni_sbox( x, s0, s1, s2, s3 ), kuznechik_gfni.dec[0], rev ), kd[i], kx[i] );
+    x = ak_kuznechik_gfni_xor3( ak_kuznechik_gfni_sbox( x, s0, s1, s2, s3 ), kd[0], kx[0] );
+    _mm512_mask_storeu_epi64( outptr, mask, _mm512_gf2p8affine_epi64_epi8( x, phinv, 0 ));
+    inptr += 2*cnt; outptr += 2*cnt; blocks -= cnt;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Зашифрование последовательности блоков с использованием инструкций GFNI;
+    если константы не выработаны, используется переносимая реализация. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_gfni_target static void ak_kuznechik_encrypt_blocks_gfni( ak_skey skey,
+                                 ak_pointer in, ak_pointer out, size_t blocks, const size_t rev )
+{
+  if( !kuznechik_gfni.ready ) ak_kuznechik_encrypt_blocks_internal( skey, in, out, blocks, rev );
+   else {
+     if( rev ) ak_kuznechik_encrypt_blocks_gfni_internal( skey, in, out, blocks, 15 );
+       else ak_kuznechik_encrypt_blocks_gfni_internal( skey, in, out, blocks, 0 );
+   }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Расшифрование последовательности блоков с использованием инструкций GFNI;
+    если константы не выработаны, используется переносимая реализация. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_gfni_target static void ak_kuznechik_decrypt_blocks_gfni( ak_skey skey,
+                                 ak_pointer in, ak_pointer out, size_t blocks, const size_t rev )
+{
+  if( !kuznechik_gfni.ready ) ak_kuznechik_decrypt_blocks_internal( skey, in, out, blocks, rev );
+   else {
+     if( rev ) ak_kuznechik_decrypt_blocks_gfni_internal( skey, in, out, blocks, 15 );
+       else ak_kuznechik_decrypt_blocks_gfni_internal( skey, in, out, blocks, 0 );
+   }
+}
+#endif
+
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_MM256 )
+/* ----------------------------------------------------------------------------------------------- */
+/*                          реализация с использованием набора инструкций AVX2                     */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Атрибут функций, использующих инструкции AVX2. */
+ #define ak_kuznechik_avx2_target __attribute__(( target( "avx2" )))
+
+/*! \brief Количество блоков, одновременно обрабатываемых реализацией с инструкциями AVX2. */
+ #define ak_kuznechik_avx2_blocks  (32)
+
+/*! \brief Константы, используемые реализацией алгоритма Кузнечик с инструкциями AVX2.
+
+    Реализация одновременно обрабатывает 32 блока, хранящихся в транспонированном виде:
+    \f$ k \f$-й 256-ти битный вектор содержит \f$ k \f$-е байты всех блоков.
+
+    Нелинейная перестановка вычисляется шестнадцатью инструкциями `vpshufb` по разностям
+    строк таблицы замен: байты с нулевым старшим битом последовательно складываются с
+    насыщением с `0x10`, и \f$ m \f$-я разность учитывается только для байт, старший
+    полубайт которых не превосходит \f$ 7-m \f$; байты с единичным старшим битом
+    обрабатываются так же после инвертирования этого бита.
+
+    Линейное преобразование вычисляется как шестнадцать тактов линейного регистра сдвига,
+    при этом сдвиг регистра сводится к перенумерации векторов. Коэффициенты регистра
+    симметричны, поэтому ячейки с одинаковыми коэффициентами складываются до умножения,
+    а сумма произведений вычисляется по схеме Горнера умножениями на многочлен \f$ x \f$.
+    Коэффициенты берутся из `gost_lvec` и известны при компиляции. Исключение составляет
+    ячейка, вычисленная на предыдущем такте: чтобы не удлинять цепочку зависимостей,
+    она умножается на свой коэффициент двумя инструкциями `vpshufb` по таблицам
+    произведений коэффициента на младший и старший полубайты.
+
+    В отличие от переносимой реализации, адреса всех загружаемых констант не зависят
+    от обрабатываемых данных и ключа. Поэтому на процессорах без поддержки AVX-512
+    эта реализация выбирается вместо табличной, хотя и уступает ей в скорости. */
+ static struct kuznechik_avx2_params {
+  /*! \brief Разности строк таблицы нелинейной перестановки,
+      продублированные в обеих половинах вектора. */
+   ak_uint8 pi[16][32];
+  /*! \brief Разности строк таблицы обратной нелинейной перестановки. */
+   ak_uint8 pinv[16][32];
+  /*! \brief Произведения коэффициента при первой (и пятнадцатой) ячейке на младшие полубайты. */
+   ak_uint8 mlo[32];
+  /*! \brief Произведения коэффициента при первой (и пятнадцатой) ячейке на старшие полубайты. */
+   ak_uint8 mhi[32];
+  /*! \brief Флаг корректной выработки констант. */
+   bool_t ready;
+ } kuznechik_avx2 __attribute__(( aligned( 32 )));
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Такт линейного регистра сдвига над байтами, повторяющий вычисления
+    функции ak_kuznechik_avx2_step() и используемый для проверки констант.
+
+    Функция помещает в ячейку `x[dst]` сумму ячейки `x[src]` и произведений ячеек
+    `x[base+1]`, ..., `x[base+15]` на коэффициенты регистра. При `dst = 16+t`,
+    `src = base = t` вычисляется \f$ t \f$-й такт регистра, при `dst = base = 15-t`,
+    `src = 31-t` - \f$ t \f$-й такт обратного преобразования. Ячейка `x[base+fresh]`,
+    вычисленная на предыдущем такте (`fresh` равно 15 для регистра и 1 для обратного
+    преобразования), умножается на коэффициент отдельно. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_avx2_check_step( ak_uint8 *x, size_t dst, size_t src, size_t base,
+                                                                              const size_t fresh )
+{
+  int i, k;
+  ak_uint8 s[9], z = 0;
+
+  s[1] = x[base+16-fresh];
+  for( i = 2; i < 8; i++ ) s[i] = x[base+i]^x[base+16-i];
+  s[8] = x[base+8];
+  for( k = 7; k >= 0; k-- ) {
+     z = ak_bckey_context_kuznechik_mul_gf256( z, 2 );
+     for( i = 1; i < 9; i++ ) if(( gost_lvec[i] >> k )&0x1 ) z ^= s[i];
+  }
+  x[dst] = z^x[src]^( ak_uint8 )( kuznechik_avx2.mlo[x[base+fresh]&0x0f]^
+                                                        kuznechik_avx2.mhi[x[base+fresh] >> 4] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает разности строк таблицы замен `pi` для реализации
+    с инструкциями AVX2. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_avx2_sbox_rows( const sbox pi, ak_uint8 (*rows)[32] )
+{
+  int h, m, a;
+
+  for( h = 0; h < 2; h++ )
+     for( m = 0; m < 8; m++ ) {
+        int j = 7 + 8*h - m;
+        for( a = 0; a < 16; a++ )
+           rows[8*h+m][a] = rows[8*h+m][a+16] =
+                                    ( ak_uint8 )( pi[16*j+a]^( m ? pi[16*j+16+a] : 0 ));
+     }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает константы реализации с инструкциями AVX2.
+
+    Константы вычисляются по таблицам `kuznechik_parameters`, поэтому функция вызывается
+    при каждом пересчете таблиц. Перед использованием проверяется, что регистр совпадает
+    с регистром из ГОСТ Р 34.12-2015, а шестнадцать тактов регистра и обратного к нему
+    преобразования совпадают с линейными преобразованиями, заданными столбцами
+    развернутых таблиц. В случае неудачи флаг `ready` опускается и используется
+    переносимая реализация.                                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_avx2_init_tables( void )
+{
+  int i, j, l, r = 15*(int) ak_libakrypt_get_option( openssl_compability_option );
+  ak_uint8 cenc[16][16], cdec[16][16], x[32];
+
+  kuznechik_avx2.ready = ak_false;
+  if(( r != 0 ) && ( r != 15 )) return;
+  if( memcmp( kuznechik_parameters.reg, gost_lvec, sizeof( linear_register ))) return;
+  for( i = 1; i < 8; i++ ) if( gost_lvec[i] != gost_lvec[16-i] ) return;
+  if( !ak_kuznechik_extract_columns( cenc, cdec )) return;
+
+  ak_kuznechik_avx2_sbox_rows( kuznechik_parameters.pi, kuznechik_avx2.pi );
+  ak_kuznechik_avx2_sbox_rows( kuznechik_parameters.pinv, kuznechik_avx2.pinv );
+  for( i = 0; i < 16; i++ ) {
+     kuznechik_avx2.mlo[i] = kuznechik_avx2.mlo[i+16] =
+                             ak_bckey_context_kuznechik_mul_gf256( gost_lvec[1], ( ak_uint8 )i );
+     kuznechik_avx2.mhi[i] = kuznechik_avx2.mhi[i+16] =
+                      ak_bckey_context_kuznechik_mul_gf256( gost_lvec[1], ( ak_uint8 )( i << 4 ));
+  }
+
+ /* проверяем такты регистра на векторах, содержащих единицу в l-й ячейке;
+    байт с номером j блока хранится в ячейке j^r */
+  for( l = 0; l < 16; l++ ) {
+     memset( x, 0, sizeof( x ));
+     x[l] = 1;
+     for( i = 0; i < 16; i++ ) ak_kuznechik_avx2_check_step( x, 16+i, i, i, 15 );
+     for( j = 0; j < 16; j++ ) if( x[16+(j^r)] != cenc[l][j] ) return;
+
+     memset( x, 0, sizeof( x ));
+     x[16+l] = 1;
+     for( i = 0; i < 16; i++ ) ak_kuznechik_avx2_check_step( x, 15-i, 31-i, 15-i, 1 );
+     for( j = 0; j < 16; j++ ) if( x[j^r] != cdec[l][j] ) return;
+  }
+  kuznechik_avx2.ready = ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Нелинейная перестановка двух векторов `in[0]`, `in[1]`, заданная разностями
+    строк таблицы `rows`; результат помещается в `out[0]`, `out[1]`. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_sbox( __m256i *out,
+                                                   const __m256i *in, ak_uint8 (*rows)[32] )
+{
+  int m;
+  __m256i t, c = _mm256_set1_epi8( 0x10 ), h = _mm256_set1_epi8(( char )0x80 ),
+          a0 = in[0], a1 = in[1], b0 = _mm256_xor_si256( a0, h ), b1 = _mm256_xor_si256( a1, h ),
+          z0 = _mm256_setzero_si256(), z1 = _mm256_setzero_si256();
+
+  for( m = 0; m < 8; m++ ) {
+     t = _mm256_load_si256(( const __m256i *) rows[m] );
+     z0 = _mm256_xor_si256( z0, _mm256_shuffle_epi8( t, a0 ));
+     z1 = _mm256_xor_si256( z1, _mm256_shuffle_epi8( t, a1 ));
+     t = _mm256_load_si256(( const __m256i *) rows[8+m] );
+     z0 = _mm256_xor_si256( z0, _mm256_shuffle_epi8( t, b0 ));
+     z1 = _mm256_xor_si256( z1, _mm256_shuffle_epi8( t, b1 ));
+     a0 = _mm256_adds_epu8( a0, c ); a1 = _mm256_adds_epu8( a1, c );
+     b0 = _mm256_adds_epu8( b0, c ); b1 = _mm256_adds_epu8( b1, c );
+  }
+  out[0] = z0; out[1] = z1;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Такт линейного регистра сдвига над векторами (см. ak_kuznechik_avx2_check_step()). */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_step( __m256i *x,
+                                        size_t dst, size_t src, size_t base, const size_t fresh )
+{
+  int i, k;
+  __m256i s[9], z = _mm256_setzero_si256(), zero = _mm256_setzero_si256(),
+          poly = _mm256_set1_epi8(( char )0xc3 ), mask = _mm256_set1_epi8( 0x0f );
+
+  s[1] = x[base+16-fresh];
+  for( i = 2; i < 8; i++ ) s[i] = _mm256_xor_si256( x[base+i], x[base+16-i] );
+  s[8] = x[base+8];
+  for( k = 7; k >= 0; k-- ) {
+     if( k < 7 ) z = _mm256_xor_si256( _mm256_add_epi8( z, z ),
+                                   _mm256_and_si256( _mm256_cmpgt_epi8( zero, z ), poly ));
+     for( i = 1; i < 9; i++ ) if(( gost_lvec[i] >> k )&0x1 ) z = _mm256_xor_si256( z, s[i] );
+  }
+  z = _mm256_xor_si256( z, _mm256_shuffle_epi8(
+             _mm256_load_si256(( const __m256i *) kuznechik_avx2.mlo ),
+                                                    _mm256_and_si256( x[base+fresh], mask )));
+  z = _mm256_xor_si256( z, _mm256_shuffle_epi8(
+             _mm256_load_si256(( const __m256i *) kuznechik_avx2.mhi ),
+                              _mm256_and_si256( _mm256_srli_epi16( x[base+fresh], 4 ), mask )));
+  x[dst] = _mm256_xor_si256( z, x[src] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Побайтное транспонирование матрицы из шестнадцати векторов,
+    выполняемое независимо в каждой 128-ми битной половине векторов. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_transpose( __m256i *x )
+{
+  int i, r;
+  __m256i y[16];
+
+  for( r = 0; r < 4; r++ ) {
+     for( i = 0; i < 8; i++ ) {
+        y[2*i] = _mm256_unpacklo_epi8( x[i], x[i+8] );
+        y[2*i+1] = _mm256_unpackhi_epi8( x[i], x[i+8] );
+     }
+     for( i = 0; i < 16; i++ ) x[i] = y[i];
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Загрузка 32-х блоков в транспонированном виде: байт с номером `j^rev`
+    помещается в вектор `x[j]`. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_load( __m256i *x,
+                                                       const ak_uint64 *inptr, const size_t rev )
+{
+  size_t i;
+  __m256i y[16];
+
+  for( i = 0; i < 16; i++ )
+     y[i] = _mm256_inserti128_si256( _mm256_castsi128_si256(
+                                   _mm_loadu_si128(( const __m128i *)( inptr + 2*i ))),
+                                   _mm_loadu_si128(( const __m128i *)( inptr + 2*i + 32 )), 1 );
+  ak_kuznechik_avx2_transpose( y );
+  for( i = 0; i < 16; i++ ) x[i] = y[i^rev];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сохранение 32-х блоков, хранящихся в транспонированном виде. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_store( ak_uint64 *outptr,
+                                                              const __m256i *x, const size_t rev )
+{
+  size_t i;
+  __m256i y[16];
+
+  for( i = 0; i < 16; i++ ) y[i] = x[i^rev];
+  ak_kuznechik_avx2_transpose( y );
+  for( i = 0; i < 16; i++ ) {
+     _mm_storeu_si128(( __m128i *)( outptr + 2*i ), _mm256_castsi256_si128( y[i] ));
+     _mm_storeu_si128(( __m128i *)( outptr + 2*i + 32 ), _mm256_extracti128_si256( y[i], 1 ));
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размножение байт раундовых ключей (или масок) в транспонированном виде. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_keys( __m256i (*k)[16],
+                                                         const ak_uint64 *key, const size_t rev )
+{
+  size_t i, j;
+  for( i = 0; i < 10; i++ )
+     for( j = 0; j < 16; j++ )
+        k[i][j] = _mm256_set1_epi8(( char )(( const ak_uint8 *)( key + 2*i ))[j^rev] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Зашифрование 32-х блоков, хранящихся в транспонированном виде в векторах
+    `x[0]`, ..., `x[15]`; результат помещается в векторы `x[16]`, ..., `x[31]`. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_encrypt( __m256i *x,
+                                                          __m256i (*ke)[16], __m256i (*km)[16] )
+{
+  size_t i, k, t;
+  __m256i *y = x;
+
+  for( i = 0; i < 9; i++ ) {
+     for( k = 0; k < 16; k++ )
+        y[k] = _mm256_xor_si256( _mm256_xor_si256( y[k], ke[i][k] ), km[i][k] );
+     for( k = 0; k < 16; k += 2 ) ak_kuznechik_avx2_sbox( x+k, y+k, kuznechik_avx2.pi );
+     for( t = 0; t < 16; t++ ) ak_kuznechik_avx2_step( x, 16+t, t, t, 15 );
+     y = x + 16;
+  }
+  for( k = 0; k < 16; k++ )
+     y[k] = _mm256_xor_si256( _mm256_xor_si256( y[k], ke[9][k] ), km[9][k] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Расшифрование 32-х блоков, хранящихся в транспонированном виде в векторах
+    `x[16]`, ..., `x[31]`; результат помещается в те же векторы.
+
+    Вычисления повторяют вычисления функции ak_kuznechik_decrypt_blocks_gfni_internal(). */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_avx2_decrypt( __m256i *x,
+                                                          __m256i (*kd)[16], __m256i (*kx)[16] )
+{
+  size_t i, k, t;
+
+  for( t = 0; t < 16; t++ ) ak_kuznechik_avx2_step( x, 15-t, 31-t, 15-t, 1 );
+  for( k = 0; k < 16; k++ )
+     x[k] = _mm256_xor_si256( _mm256_xor_si256( x[k], kd[9][k] ), kx[9][k] );
+  for( i = 8; i > 0; i-- ) {
+     for( k = 0; k < 16; k += 2 ) ak_kuznechik_avx2_sbox( x+16+k, x+k, kuznechik_avx2.pinv );
+     for( t = 0; t < 16; t++ ) ak_kuznechik_avx2_step( x, 15-t, 31-t, 15-t, 1 );
+     for( k = 0; k < 16; k++ )
+        x[k] = _mm256_xor_si256( _mm256_xor_si256( x[k], kd[i][k] ), kx[i][k] );
+  }
+  for( k = 0; k < 16; k += 2 ) ak_kuznechik_avx2_sbox( x+16+k, x+k, kuznechik_avx2.pinv );
+  for( k = 0; k < 16; k++ )
+     x[16+k] = _mm256_xor_si256( _mm256_xor_si256( x[16+k], kd[0][k] ), kx[0][k] );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует алгоритм зашифрования (или расшифрования) последовательности
+    независимых блоков информации шифром Кузнечик с использованием набора инструкций AVX2.
+
+    Блоки обрабатываются группами по \ref ak_kuznechik_avx2_blocks; оставшиеся блоки
+    обрабатываются переносимой реализацией, поскольку обработка неполной группы занимает
+    столько же времени, сколько и полной. Как и в реализации с инструкциями GFNI, раундовые
+    ключи и маски складываются с блоками раздельно. Параметры функции совпадают
+    с параметрами функции ak_kuznechik_encrypt_blocks_generic(), параметр `decrypt`
+    определяет направление преобразования. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static inline void ak_kuznechik_blocks_avx2_internal(
+                                   ak_skey skey, ak_uint64 *inptr, ak_uint64 *outptr,
+                                             size_t blocks, const size_t rev, const bool_t decrypt )
+{
+  __m256i x[32], kr[10][16], km[10][16];
+
+  ak_kuznechik_avx2_keys( kr, ( ak_uint64 *)skey->data + ( decrypt ? 20 : 0 ), rev );
+  ak_kuznechik_avx2_keys( km, ( ak_uint64 *)skey->data + ( decrypt ? 60 : 40 ), rev );
+
+  while( blocks >= ak_kuznechik_avx2_blocks ) {
+    if( decrypt ) {
+      ak_kuznechik_avx2_load( x+16, inptr, rev );
+      ak_kuznechik_avx2_decrypt( x, kr, km );
+    } else {
+      ak_kuznechik_avx2_load( x, inptr, rev );
+      ak_kuznechik_avx2_encrypt( x, kr, km );
+    }
+    ak_kuznechik_avx2_store( outptr, x+16, rev );
+    inptr += 2*ak_kuznechik_avx2_blocks; outptr += 2*ak_kuznechik_avx2_blocks;
+    blocks -= ak_kuznechik_avx2_blocks;
+  }
+
+ /* обрабатываем оставшиеся блоки */
+  if( blocks ) {
+    if( decrypt ) ak_kuznechik_decrypt_blocks_internal( skey, inptr, outptr, blocks, rev );
+      else ak_kuznechik_encrypt_blocks_internal( skey, inptr, outptr, blocks, rev );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Зашифрование последовательности блоков с использованием инструкций AVX2;
+    если константы не выработаны, используется переносимая реализация. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static void ak_kuznechik_encrypt_blocks_avx2( ak_skey skey,
+                                 ak_pointer in, ak_pointer out, size_t blocks, const size_t rev )
+{
+  if( !kuznechik_avx2.ready || ( blocks < ak_kuznechik_avx2_blocks ))
+    ak_kuznechik_encrypt_blocks_internal( skey, in, out, blocks, rev );
+   else {
+     if( rev ) ak_kuznechik_blocks_avx2_internal( skey, in, out, blocks, 15, ak_false );
+       else ak_kuznechik_blocks_avx2_internal( skey, in, out, blocks, 0, ak_false );
+   }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Расшифрование последовательности блоков с использованием инструкций AVX2;
+    если константы не выработаны, используется переносимая реализация. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_kuznechik_avx2_target static void ak_kuznechik_decrypt_blocks_avx2( ak_skey skey,
+                                 ak_pointer in, ak_pointer out, size_t blocks, const size_t rev )
+{
+  if( !kuznechik_avx2.ready || ( blocks < ak_kuznechik_avx2_blocks ))
+    ak_kuznechik_decrypt_blocks_internal( skey, in, out, blocks, rev );
+   else {
+     if( rev ) ak_kuznechik_blocks_avx2_internal( skey, in, out, blocks, 15, ak_true );
+       else ak_kuznechik_blocks_avx2_internal( skey, in, out, blocks, 0, ak_true );
+   }
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Тип функции, реализующей преобразование последовательности блоков. */
+ typedef void ( ak_kuznechik_function_blocks )( ak_skey, ak_pointer, ak_pointer,
+                                                                           size_t, const size_t );
+
+/*! \brief Реализация преобразований последовательности блоков. */
+ struct kuznechik_backend {
+  /*! \brief Функция зашифрования последовательности блоков. */
+   ak_kuznechik_function_blocks *encrypt;
+  /*! \brief Функция расшифрования последовательности блоков. */
+   ak_kuznechik_function_blocks *decrypt;
+  /*! \brief Наименование реализации. */
+   const char *name;
+ };
+
+/*! \brief Реализации преобразований последовательности блоков в порядке убывания
+    предпочтения; последней указывается переносимая реализация. */
+ static const struct kuznechik_backend kuznechik_backends[] = {
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_CPU_SUPPORTS ) \
+                                                          && defined( AK_HAVE_BUILTIN_MM512 )
+   { ak_kuznechik_encrypt_blocks_gfni, ak_kuznechik_decrypt_blocks_gfni, "avx512-gfni" },
+#endif
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_CPU_SUPPORTS ) \
+                                                          && defined( AK_HAVE_BUILTIN_MM256 )
+   { ak_kuznechik_encrypt_blocks_avx2, ak_kuznechik_decrypt_blocks_avx2, "avx2" },
+#endif
+   { ak_kuznechik_encrypt_blocks_internal, ak_kuznechik_decrypt_blocks_internal, "generic" }
+ };
+
+/*! \brief Реализация преобразований последовательности блоков, выбранная
+    функцией ak_bckey_kuznechik_init_backend(). */
+ static struct kuznechik_backend kuznechik_backend = {
+   ak_kuznechik_encrypt_blocks_internal, ak_kuznechik_decrypt_blocks_internal, "generic"
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет, поддерживаются ли процессором наборы инструкций,
+    используемые реализацией `backend`. */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_kuznechik_backend_is_supported( const struct kuznechik_backend *backend )
+{
+#if defined( AK_LITTLE_ENDIAN ) && defined( AK_HAVE_BUILTIN_CPU_SUPPORTS )
+  __builtin_cpu_init();
+ #ifdef AK_HAVE_BUILTIN_MM512
+  if( backend->encrypt == ak_kuznechik_encrypt_blocks_gfni )
+    return ( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) &&
+             __builtin_cpu_supports( "avx512vbmi" ) && __builtin_cpu_supports( "gfni" ));
+ #endif
+ #ifdef AK_HAVE_BUILTIN_MM256
+  if( backend->encrypt == ak_kuznechik_encrypt_blocks_avx2 )
+    return ( __builtin_cpu_supports( "avx2" ) != 0 );
+ #endif
+#endif
+ return backend->encrypt == ak_kuznechik_encrypt_blocks_internal;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, какие наборы векторных инструкций поддерживаются процессором, и
+    выбирает первую из доступных реализаций преобразования последовательности блоков
+    в порядке, заданном массивом `kuznechik_backends`.
+    Выбор производится один раз, при инициализации библиотеки;
+    в случае отсутствия поддержки векторных инструкций используется переносимая реализация.
+
+    @return Функция возвращает \ref ak_error_ok (ноль).                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_kuznechik_init_backend( void )
+{
+  size_t i = 0;
+
+  while( !ak_kuznechik_backend_is_supported( kuznechik_backends + i )) i++;
+  kuznechik_backend = kuznechik_backends[i];
+
+  if( ak_log_get_level() >= ak_log_maximum )
+    ak_error_message_fmt( ak_error_ok, __func__,
+                      "kuznechik block cipher uses %s implementation", kuznechik_backend.name );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Зашифрование последовательности независимых блоков (каноническое представление). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_encrypt_blocks_with_mask( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  kuznechik_backend.encrypt( skey, in, out, blocks, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Расшифрование последовательности независимых блоков (каноническое представление). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_decrypt_blocks_with_mask( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  kuznechik_backend.decrypt( skey, in, out, blocks, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Зашифрование последовательности независимых блоков (режим совместимости с openssl). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_encrypt_blocks_with_mask_oc( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  kuznechik_backend.encrypt( skey, in, out, blocks, 15 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Расшифрование последовательности независимых блоков (режим совместимости с openssl). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_decrypt_blocks_with_mask_oc( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  kuznechik_backend.decrypt( skey, in, out, blocks, 15 );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! После инициализации устанавливаются обработчики (функции класса). Однако само значение
     ключу не присваивается - поле `bkey->key` остается неопределенным.
@@ -679,7 +1751,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_bckey_create_kuznechik( ak_bckey bkey )
 {
-  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                "using null pointer to block cipher key context" );
@@ -706,10 +1778,14 @@
   if( oc ) {
     bkey->encrypt = ak_kuznechik_encrypt_with_mask_oc;
     bkey->decrypt = ak_kuznechik_decrypt_with_mask_oc;
+    bkey->encrypt_blocks = ak_kuznechik_encrypt_blocks_with_mask_oc;
+    bkey->decrypt_blocks = ak_kuznechik_decrypt_blocks_with_mask_oc;
   }
    else {
     bkey->encrypt = ak_kuznechik_encrypt_with_mask;
     bkey->decrypt = ak_kuznechik_decrypt_with_mask;
+    bkey->encrypt_blocks = ak_kuznechik_encrypt_blocks_with_mask;
+    bkey->decrypt_blocks = ak_kuznechik_decrypt_blocks_with_mask;
   }
  return error;
 }
@@ -723,7 +1799,7 @@
   ak_uint8 out[16];
   struct kuznechik_params parameters;
   int error = ak_error_ok, audit = ak_log_get_level(),
-      oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+      oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
   ak_uint8 esum[16] = {
                  0x5b,0x80,0x54,0xb3,0x4e,0x81,0x09,0x94,0xcc,0x83,0x8b,0x8e,0x53,0xba,0x9d,0x18 };
@@ -829,12 +1905,12 @@
 /* ----------------------------------------------------------------------------------------------- */
  static bool_t ak_libakrypt_test_kuznechik_complete( void )
 {
-  size_t i = 0;
+  size_t i = 0, j = 0;
   struct bckey bkey;
-  ak_uint8 myout[256];
+  ak_uint8 myout[2160], blk[16];
   bool_t result = ak_true;
   int error = ak_error_ok, audit = ak_log_get_level(),
-      oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+      oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
  /* тестовый ключ из ГОСТ Р 34.13-2015, приложение А.1 */
   ak_uint8 key[32] = {
@@ -1177,6 +2253,45 @@
   }
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                           "the cmac integrity test from GOST R 34.13-2015 is Ok" );
+
+ /* --------------------------------------------------------------------------- */
+ /* 11. Сравниваем обработку последовательности блоков с поблочной обработкой.  */
+ /* --------------------------------------------------------------------------- */
+  /* число блоков выбирается так, чтобы задействовать как основной цикл векторных
+     реализаций, так и обработку остатка; проверяется как выбранная при инициализации
+     библиотеки реализация, так и все остальные реализации, поддерживаемые процессором */
+  for( i = 0; i < 720; i++ ) myout[i] = in[i&0x3f]^( ak_uint8 )i;
+  for( j = 0; j <= sizeof( kuznechik_backends )/sizeof( struct kuznechik_backend ); j++ ) {
+     const struct kuznechik_backend *backend = &kuznechik_backend;
+     if( j > 0 ) {
+       backend = kuznechik_backends + ( j - 1 );
+       if( !ak_kuznechik_backend_is_supported( backend )) continue;
+     }
+     if( j == 0 ) bkey.encrypt_blocks( &bkey.key, myout, myout+720, 45 );
+       else backend->encrypt( &bkey.key, myout, myout+720, 45, oc ? 15 : 0 );
+     for( i = 0; i < 720; i += 16 ) {
+        bkey.encrypt( &bkey.key, myout+i, blk );
+        if( !ak_ptr_is_equal_with_log( blk, myout+720+i, 16 )) {
+          ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                                   "the multiple blocks encryption test is wrong (%s%s)",
+                                                    backend->name, j ? "" : ", default" );
+          result = ak_false;
+          goto exit;
+        }
+     }
+     if( j == 0 ) bkey.decrypt_blocks( &bkey.key, myout+720, myout+1440, 45 );
+       else backend->decrypt( &bkey.key, myout+720, myout+1440, 45, oc ? 15 : 0 );
+     if( !ak_ptr_is_equal_with_log( myout, myout+1440, 720 )) {
+       ak_error_message_fmt( ak_error_not_equal_data, __func__ ,
+                                   "the multiple blocks decryption test is wrong (%s%s)",
+                                                    backend->name, j ? "" : ", default" );
+       result = ak_false;
+       goto exit;
+     }
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                     "the multiple blocks encryption/decryption test is Ok" );
+
  /* освобождаем ключ и выходим */
   exit:
   if(( error = ak_bckey_destroy( &bkey )) != ak_error_ok ) {
@@ -1191,7 +2306,7 @@
  bool_t ak_libakrypt_test_kuznechik( void )
 {
   int audit = audit = ak_log_get_level();
-  int oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
  /* мы тестируем алгоритм Магма в двух режимах совместимисти,
     вызывая для этого функцию тестирования дважды
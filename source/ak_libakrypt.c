@@ -82,6 +82,10 @@
   #ifdef AK_HAVE_BUILTIN_MULQ_GCC
    ak_error_message( ak_error_ok, __func__ , "library applies assembler code for mulq command" );
   #endif
+  #ifdef AK_HAVE_BUILTIN_MULX_ADX
+   ak_error_message( ak_error_ok, __func__ ,
+                          "library contains assembler code for mulx, adcx and adox commands" );
+  #endif
   #ifdef AK_HAVE_PTHREAD_H
    ak_error_message( ak_error_ok, __func__ , "library runs with pthreads support" );
   #endif
@@ -130,6 +134,12 @@
     return ak_false;
   }
 
+ /* тестируем древовидное хеширование */
+  if( ak_libakrypt_test_hash_tree() != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect hash tree testing" );
+    return ak_false;
+  }
+
   if( audit >= ak_log_maximum )
    ak_error_message( ak_error_ok, __func__ , "testing hash functions ended successfully" );
 
@@ -330,6 +340,12 @@
      return ak_false;
    }
 
+ /* проверяем соответствие массива опций их индексам */
+   if( ak_libakrypt_test_options() != ak_true ) {
+     ak_error_message( ak_error_get_value(), __func__ , "wrong order of library options" );
+     return ak_false;
+   }
+
  /* считываем настройки криптографических алгоритмов */
    if( ak_libakrypt_load_options() != ak_true ) {
      ak_error_message( ak_error_get_value(), __func__ ,
@@ -356,6 +372,13 @@
     ak_error_message( error, __func__, "initialization of context manager is wrong" );
      return ak_false;
    }
+   ak_bckey_kuznechik_init_backend();
+
+ /* выбираем реализацию функции хеширования Стрибог */
+   ak_hash_streebog_init_backend();
+
+ /* выбираем реализацию умножения Монтгомери */
+   ak_mpzn_init_backend();
 
  /* в случае, когда компилируются сетевые функции, инициализируем работу с сокетами */
 #ifdef AK_HAVE_WINDOWS_H
@@ -408,6 +431,9 @@
   #endif
 #endif
 
+ /* освобождаем таблицы, вычисленные для эллиптических кривых */
+  ak_wcurve_destroy_fixed_base_tables();
+
   if( ak_log_get_level() != ak_log_none )
     ak_error_message( ak_error_ok, __func__ , "all crypto mechanisms successfully destroyed" );
 
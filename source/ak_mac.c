@@ -190,6 +190,17 @@
 /*! Функция вычисляет результат сжимающего отображения для заданного файла и помещает
     его в область памяти, на которую указывает out.
 
+    Файл отображается в память и обрабатывается целиком, без копирования данных;
+    опережающее чтение отображенных данных выполняет операционная система.
+    Если отобразить файл в память не удалось (например, размер файла превышает
+    размер адресного пространства или файл не поддерживает отображение), то
+    уже открытый файл считывается большими фрагментами с помощью функции
+    ak_file_reader_next(); при этом чтение следующего фрагмента выполняется
+    одновременно с обработкой текущего.
+
+    \note Как и в функции ak_mac_ptr(), внутренняя структура, хранящая промежуточные данные,
+    не очищается.
+
     @param mctx Указатель на контекст итерационного сжатия.
     @param filename имя сжимаемого файла
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
@@ -202,11 +213,11 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_mac_file( ak_mac mctx, const char* filename, ak_pointer out, const size_t out_size )
 {
-  size_t len = 0;
+  ssize_t len = 0;
   struct file file;
+  struct file_reader reader;
   int error = ak_error_ok;
-  size_t block_size = 4096; /* оптимальная длина блока для Windows пока не ясна */
-  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+  ak_pointer data = NULL; /* данные файла, отображенного в память или считанного фрагмента */
 
  /* выполняем необходимые проверки */
   if( mctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -225,31 +236,41 @@
     return ak_mac_finalize( mctx, "", 0, out, out_size );
   }
 
- /* готовим область для хранения данных */
-  block_size = ak_max( ( size_t )file.blksize, mctx->bsize );
- /* здесь мы выделяем локальный буффер для считывания/обработки данных */
-  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
-    ak_file_close( &file );
-    return ak_error_message( ak_error_out_of_memory, __func__ ,
-                                                      "memory allocation error for local buffer" );
+ /* пытаемся обработать файл, отображенный в память; функция ak_file_unmap() закрывает файл */
+  if(( data = ak_file_mmap( &file, NULL, readonly, 0 )) != NULL ) {
+    error = ak_mac_finalize( mctx, data, ( size_t )file.size, out, out_size );
+    ak_file_unmap( &file, data );
+    return error;
+  }
+
+ /* обрабатываем тот же открытый файл фрагментами; длина каждого фрагмента, кроме последнего,
+    равна размеру буффера и кратна длине блока входных данных */
+  if(( error = ak_file_reader_open_file( &reader, &file, ( size_t )
+              ak_libakrypt_get_option( file_reader_buffer_size_option ))) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+
+  while(( len = ak_file_reader_next( &reader, &data )) == ( ssize_t )reader.size ) {
+    if(( error = ak_mac_update( mctx, data, reader.size )) != ak_error_ok ) {
+      ak_error_message( error, __func__ , "incorrect updating input data" );
+      goto lab_exit;
+    }
   }
- /* теперь обрабатываем файл с данными */
-  read_label: len = ( size_t ) ak_file_read( &file, localbuffer, block_size );
-  if( len == block_size ) {
-    ak_mac_update( mctx, localbuffer, block_size ); /* добавляем считанные данные */
-    goto read_label;
-  } else {
-           size_t qcnt = len / mctx->bsize,
-                  tail = len - qcnt*mctx->bsize;
-           if( qcnt ) ak_mac_update( mctx, localbuffer, qcnt*mctx->bsize );
-           error = ak_mac_finalize( mctx,
-                                             localbuffer + qcnt*mctx->bsize, tail, out, out_size );
-         }
- /* очищаем за собой данные, содержащиеся в контексте */
-  ak_mac_clean( mctx );
- /* закрываем данные */
-  ak_file_close( &file );
-  free( localbuffer );
+
+  if( len < 0 ) error = ak_error_message_fmt( ak_error_read_data, __func__,
+                                                             "wrong reading a file %s", filename );
+   else {
+     size_t qcnt = ( size_t )len / mctx->bsize,
+            tail = ( size_t )len - qcnt*mctx->bsize;
+     if( qcnt ) {
+       if(( error = ak_mac_update( mctx, data, qcnt*mctx->bsize )) != ak_error_ok ) {
+         ak_error_message( error, __func__ , "incorrect updating input data" );
+         goto lab_exit;
+       }
+     }
+     error = ak_mac_finalize( mctx, ( ak_uint8 *)data + qcnt*mctx->bsize, tail, out, out_size );
+   }
+
+  lab_exit: ak_file_reader_close( &reader );
  return error;
 }
 
@@ -355,7 +355,7 @@
   register ak_uint32 n3, n4, p = 0;
 
  /* вырабатываем случайную траекторию */
-  skey->generator.random( &skey->generator, &mv, sizeof( ak_uint32 ));
+  ak_skey_get_random_from_pool( skey, &mv, sizeof( ak_uint32 ));
 
  /* формируем вектор раундовых поворотов */
   m[0] = m[33] = 0;
@@ -430,7 +430,7 @@
   register ak_uint32 n3, n4, p = 0;
 
  /* вырабатываем случайную траекторию */
-  skey->generator.random( &skey->generator, &mv, sizeof( ak_uint32 ));
+  ak_skey_get_random_from_pool( skey, &mv, sizeof( ak_uint32 ));
 
  /* формируем вектор раундовых поворотов */
   m[0] = m[33] = 0;
@@ -505,7 +505,7 @@
   register ak_uint32 n3, n4, p = 0;
 
  /* вырабатываем случайную траекторию */
-  skey->generator.random( &skey->generator, &mv, sizeof( ak_uint32 ));
+  ak_skey_get_random_from_pool( skey, &mv, sizeof( ak_uint32 ));
 
  /* формируем вектор раундовых поворотов */
   m[0] = m[1] = m[32] = m[33] = 0;
@@ -581,7 +581,7 @@
   register ak_uint32 n3, n4, p = 0;
 
  /* вырабатываем случайную траекторию */
-  skey->generator.random( &skey->generator, &mv, sizeof( ak_uint32 ));
+  ak_skey_get_random_from_pool( skey, &mv, sizeof( ak_uint32 ));
 
  /* формируем вектор раундовых поворотов */
   m[0] = m[1] = m[32] = m[33] = 0;
@@ -639,6 +639,145 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество блоков, которые обрабатываются одновременно и для которых используется
+    одна и та же случайная траектория. */
+ #define ak_magma_multi_blocks  (4)
+
+/*! \brief Порядок использования раундовых ключей при зашифровании. */
+ static const ak_uint8 magma_encrypt_order[32] = {
+   7, 6, 5, 4, 3, 2, 1, 0, 7, 6, 5, 4, 3, 2, 1, 0, 7, 6, 5, 4, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+/*! \brief Порядок использования раундовых ключей при расшифровании. */
+ static const ak_uint8 magma_decrypt_order[32] = {
+   7, 6, 5, 4, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция реализует преобразование последовательности независимых блоков информации
+    алгоритмом ГОСТ 34.12-2015 (Магма).
+
+    Блоки обрабатываются группами по \ref ak_magma_multi_blocks штук. Для каждой группы
+    вырабатывается одна случайная траектория, после чего раундовые преобразования блоков группы
+    выполняются вперемешку. Результат преобразования совпадает с результатом
+    поблочного применения функций ak_magma_encrypt_with_random_walk() и
+    ak_magma_decrypt_with_random_walk() (или их аналогов для режима совместимости с openssl).
+
+    @param skey Контекст секретного ключа.
+    @param in Последовательность блоков входной информации.
+    @param out Последовательность блоков выходной информации.
+    @param blocks Количество обрабатываемых блоков.
+    @param order Порядок использования раундовых ключей.
+    @param oc Флаг режима совместимости с openssl.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_magma_blocks_with_random_walk( ak_skey skey, ak_pointer in,
+                      ak_pointer out, size_t blocks, const ak_uint8 *order, const bool_t oc )
+{
+  ak_uint8 m[34];
+  size_t j = 0, cnt = 0;
+  ak_uint32 i, mv = 0, first, last, n3[ak_magma_multi_blocks], n4[ak_magma_multi_blocks];
+  ak_uint32 (*kp)[8] = ((struct magma_encrypted_keys *)skey->data)->inkey;
+  ak_uint32 (*mp)[8] = ((struct magma_encrypted_keys *)skey->data)->inmask;
+  ak_uint32 *inptr = ( ak_uint32 *)in, *outptr = ( ak_uint32 *)out, p = 0;
+
+  while( blocks > 0 ) {
+    cnt = ak_min( blocks, ak_magma_multi_blocks );
+
+   /* вырабатываем случайную траекторию, общую для всей группы блоков */
+    ak_skey_get_random_from_pool( skey, &mv, sizeof( ak_uint32 ));
+
+   /* формируем вектор раундовых поворотов */
+    if( oc ) {
+      m[0] = m[1] = m[32] = m[33] = 0;
+      for( i = 1; i < 31; i++ ) m[i+1] = (ak_uint8)(( mv >> i) & 0x01 );
+    } else {
+        m[0] = m[33] = 0;
+        for( i = 0; i < 32; i++ ) m[i+1] = (ak_uint8)(( mv >> i) & 0x01 );
+      }
+    first = m[1] * 0xffffffff; last = m[32] * 0xffffffff;
+
+   /* начинаем движение */
+    for( j = 0; j < cnt; j++ ) {
+      #ifdef AK_LITTLE_ENDIAN
+       if( oc ) { n4[j] = bswap_32( inptr[2*j] )^first; n3[j] = bswap_32( inptr[2*j+1] ); }
+         else { n3[j] = inptr[2*j]^first; n4[j] = inptr[2*j+1]; }
+      #else
+       if( oc ) { n4[j] = inptr[2*j]^first; n3[j] = inptr[2*j+1]; }
+         else { n3[j] = bswap_32( inptr[2*j] )^first; n4[j] = bswap_32( inptr[2*j+1] ); }
+      #endif
+    }
+    for( i = 1; i < 33; i += 2 ) {
+       for( j = 0; j < cnt; j++ ) {
+          p = n3[j]; p -= mp[m[i]][order[i-1]]; p += kp[m[i]][order[i-1]] + m[i];
+          n4[j] ^= ak_magma_gostf_boxes( p, m[i+1] ^ m[i-1], m[i] );
+       }
+       for( j = 0; j < cnt; j++ ) {
+          p = n4[j]; p -= mp[m[i+1]][order[i]]; p += kp[m[i+1]][order[i]] + m[i+1];
+          n3[j] ^= ak_magma_gostf_boxes( p, m[i+2] ^ m[i], m[i+1] );
+       }
+    }
+    for( j = 0; j < cnt; j++ ) {
+      #ifdef AK_LITTLE_ENDIAN
+       if( oc ) { outptr[2*j+1] = bswap_32( n4[j] )^last; outptr[2*j] = bswap_32( n3[j] ); }
+         else { outptr[2*j] = n4[j]^last; outptr[2*j+1] = n3[j]; }
+      #else
+       if( oc ) { outptr[2*j+1] = n4[j]^last; outptr[2*j] = n3[j]; }
+         else { outptr[2*j] = bswap_32( n4[j] )^last; outptr[2*j+1] = bswap_32( n3[j] ); }
+      #endif
+    }
+    inptr += 2*cnt; outptr += 2*cnt; blocks -= cnt;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифрования последовательности независимых блоков информации
+    алгоритмом ГОСТ 34.12-2015 (Магма).
+
+    @param skey Контекст секретного ключа.
+    @param in Последовательность блоков входной информации (открытый текст).
+    @param out Последовательность блоков выходной информации (шифртекст).
+    @param blocks Количество обрабатываемых блоков.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_encrypt_blocks_with_random_walk( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  ak_magma_blocks_with_random_walk( skey, in, out, blocks, magma_encrypt_order, ak_false );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция расшифрования последовательности независимых блоков информации
+    алгоритмом ГОСТ 34.12-2015 (Магма).
+
+    @param skey Контекст секретного ключа.
+    @param in Последовательность блоков входной информации (шифртекст).
+    @param out Последовательность блоков выходной информации (открытый текст).
+    @param blocks Количество обрабатываемых блоков.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_decrypt_blocks_with_random_walk( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  ak_magma_blocks_with_random_walk( skey, in, out, blocks, magma_decrypt_order, ak_false );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция зашифрования последовательности независимых блоков информации
+    алгоритмом ГОСТ 34.12-2015 (Магма) в режиме совместимости с openssl.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_encrypt_blocks_with_random_walk_oc( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  ak_magma_blocks_with_random_walk( skey, in, out, blocks, magma_encrypt_order, ak_true );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция расшифрования последовательности независимых блоков информации
+    алгоритмом ГОСТ 34.12-2015 (Магма) в режиме совместимости с openssl.                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_magma_decrypt_blocks_with_random_walk_oc( ak_skey skey,
+                                                    ak_pointer in, ak_pointer out, size_t blocks )
+{
+  ak_magma_blocks_with_random_walk( skey, in, out, blocks, magma_decrypt_order, ak_true );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция уничтожения развернутых ключей для маскированной магмы
 
@@ -747,7 +886,7 @@
    #endif
 
     /* создаем маску*/
-     if(( error = ak_random_ptr( &skey->generator, skey->key+32, 32 )) != ak_error_ok )
+     if(( error = ak_skey_get_random_from_pool( skey, skey->key+32, 32 )) != ak_error_ok )
        return ak_error_message( error, __func__ , "wrong random mask generation for key buffer" );
 
     /* накладываем маску на ключ */
@@ -760,7 +899,7 @@
   } else { /* если маска уже установлена, то мы сменяем ее на новую */
 
            /* для очень длинных ключей маска не изменяется */ /* выше проверка, что длина маски равна 32!! */
-            if(( error = ak_random_ptr( &skey->generator, newmask, 32 )) != ak_error_ok )
+            if(( error = ak_skey_get_random_from_pool( skey, newmask, 32 )) != ak_error_ok )
               return ak_error_message( error, __func__ ,
                                                   "wrong random mask generation for key buffer" );
            /* меняем маску для вектора, хранящегося в структуре skey */
@@ -772,7 +911,7 @@
           /* меняем маску для внутреннего представления ключевой информации */
             if(( data = ( struct magma_encrypted_keys *)skey->data ) == NULL ) return error;
             for( jdx = 0; jdx < 2; jdx++ ) {
-              if(( error = ak_random_ptr( &skey->generator, newmask, 32 )) != ak_error_ok )
+              if(( error = ak_skey_get_random_from_pool( skey, newmask, 32 )) != ak_error_ok )
                 return ak_error_message( error, __func__ ,
                                                   "wrong random mask generation for key buffer" );
               for( idx = 0; idx < 8; idx++ ) {
@@ -914,7 +1053,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_bckey_create_magma( ak_bckey bkey )
 {
-  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+  int error = ak_error_ok, oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                "using null pointer to block cipher key context" );
@@ -946,10 +1085,14 @@
   if( oc ) {
     bkey->encrypt = ak_magma_encrypt_with_random_walk_oc;
     bkey->decrypt = ak_magma_decrypt_with_random_walk_oc;
+    bkey->encrypt_blocks = ak_magma_encrypt_blocks_with_random_walk_oc;
+    bkey->decrypt_blocks = ak_magma_decrypt_blocks_with_random_walk_oc;
   }
    else {
     bkey->encrypt = ak_magma_encrypt_with_random_walk;
     bkey->decrypt = ak_magma_decrypt_with_random_walk;
+    bkey->encrypt_blocks = ak_magma_encrypt_blocks_with_random_walk;
+    bkey->decrypt_blocks = ak_magma_decrypt_blocks_with_random_walk;
   }
   return error;
 }
@@ -1105,7 +1248,7 @@
   ak_uint8 myout[256];
   bool_t result = ak_true;
   int error = ak_error_ok, audit = ak_log_get_level(),
-      oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+      oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
  /* Проверка используемого режима совместимости */
   if(( oc < 0 ) || ( oc > 1 )) {
@@ -1425,6 +1568,28 @@
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                               "the ctr-hmac integrity test for random data is Ok" );
 
+ /* 13. Сравниваем обработку последовательности блоков с поблочной обработкой */
+  for( i = 0; i < 80; i++ ) myout[i] = ( ak_uint8 )( i*31 + 7 );
+  mkey.encrypt_blocks( &mkey.key, myout, myout+80, 10 );
+  for( i = 0; i < 80; i += 8 ) {
+     mkey.encrypt( &mkey.key, myout+i, icode );
+     if( !ak_ptr_is_equal_with_log( icode, myout+80+i, 8 )) {
+       ak_error_message( ak_error_not_equal_data, __func__ ,
+                                          "the multiple blocks encryption test is wrong" );
+       result = ak_false;
+       goto exit;
+     }
+  }
+  mkey.decrypt_blocks( &mkey.key, myout+80, myout+80, 10 );
+  if( !ak_ptr_is_equal_with_log( myout, myout+80, 80 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                          "the multiple blocks decryption test is wrong" );
+    result = ak_false;
+    goto exit;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                     "the multiple blocks encryption/decryption test is Ok" );
+
  /* освобождаем ключ и выходим */
   exit:
   if(( error = ak_bckey_destroy( &mkey )) != ak_error_ok ) {
@@ -1438,7 +1603,7 @@
 /* ----------------------------------------------------------------------------------------------- */
  bool_t ak_libakrypt_test_magma( void )
 {
- int oc = (int) ak_libakrypt_get_option_by_name( "openssl_compability" );
+ int oc = (int) ak_libakrypt_get_option( openssl_compability_option );
 
  /* мы тестируем алгоритм Магма в двух режимах совместимисти,
     вызывая для этого функцию тестирования дважды
@@ -159,6 +159,115 @@
 
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает последовательные значения счетчика.
+
+    @param ctr Текущее значение счетчика; после выполнения функции содержит следующее значение.
+    @param bsize Длина блока алгоритма шифрования (8 или 16 октетов).
+    @param half Индекс изменяемой половины счетчика: 0 для счетчика Y, 1 для счетчика Z.
+    @param out Массив, в который помещаются значения счетчика.
+    @param count Количество вырабатываемых значений.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mgm_counters( ak_uint128 *ctr, const size_t bsize, const int half,
+                                                                 ak_uint64 *out, const size_t count )
+{
+  size_t idx = 0;
+
+  for( idx = 0; idx < count; idx++ ) {
+    if( bsize&0x10 ) {
+      *out++ = ctr->q[0]; *out++ = ctr->q[1];
+#ifdef AK_LITTLE_ENDIAN
+      ctr->q[half]++;
+#else
+      ctr->q[half] = bswap_64( bswap_64( ctr->q[half] ) + 1 );
+#endif
+    } else {
+      *out++ = ctr->q[0];
+#ifdef AK_LITTLE_ENDIAN
+      ctr->w[half]++;
+#else
+      ctr->w[half] = bswap_32( bswap_32( ctr->w[half] ) + 1 );
+#endif
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция обрабатывает последовательность полных блоков данных.
+
+    Блоки обрабатываются группами по \ref ak_bckey_gamma_blocks. Для каждой группы
+    значения счетчика Z зашифровываются за один вызов функции bckey.encrypt_blocks,
+    а сумма произведений полученных множителей на блоки шифртекста (или дополнительных данных)
+    вычисляется с однократным приведением по модулю (функции ak_gf64_mul_sum и ak_gf128_mul_sum).
+
+    Гамма для следующей группы блоков вырабатывается до вычисления имитовставки
+    для текущей группы; тем самым зашифрование значений счетчика Y и умножения в конечном поле
+    не зависят друг от друга и могут выполняться процессором одновременно.
+
+    @param ctx Контекст внутреннего состояния алгоритма.
+    @param encryptionKey Ключ шифрования; если NULL, то данные только аутентифицируются.
+    @param authenticationKey Ключ имитозащиты; если NULL, то данные только зашифровываются.
+    @param inp Указатель на входные данные.
+    @param outp Указатель на выходные данные.
+    @param blocks Количество обрабатываемых блоков.
+    @param encrypt Флаг зашифрования; если флаг ложен, то имитовставка вычисляется
+    от входных данных.                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mgm_update_blocks( ak_mgm_ctx ctx, ak_bckey encryptionKey,
+                  ak_bckey authenticationKey, ak_uint64 *inp, ak_uint64 *outp, size_t blocks,
+                                                                              const bool_t encrypt )
+{
+  int current = 0;
+  size_t idx = 0, cnt = 0, next = 0,
+         bsize = ( encryptionKey != NULL ) ? encryptionKey->bsize : authenticationKey->bsize,
+         words = bsize >> 3;
+  ak_uint64 ctrs[2*ak_bckey_gamma_blocks], hvals[2*ak_bckey_gamma_blocks],
+            gamma[2][2*ak_bckey_gamma_blocks];
+
+ /* гамма для первой группы блоков */
+  if(( encryptionKey != NULL ) && ( blocks > 0 )) {
+    cnt = ak_min( blocks, ak_bckey_gamma_blocks );
+    ak_mgm_counters( &ctx->ycount, bsize, 0, ctrs, cnt );
+    encryptionKey->encrypt_blocks( &encryptionKey->key, ctrs, gamma[0], cnt );
+  }
+
+  while( blocks > 0 ) {
+    cnt = ak_min( blocks, ak_bckey_gamma_blocks );
+    next = ak_min( blocks - cnt, ak_bckey_gamma_blocks );
+
+   /* множители, используемые при вычислении имитовставки */
+    if( authenticationKey != NULL ) {
+      ak_mgm_counters( &ctx->zcount, bsize, 1, ctrs, cnt );
+      authenticationKey->encrypt_blocks( &authenticationKey->key, ctrs, hvals, cnt );
+    }
+
+    if( encryptionKey == NULL ) { /* только аутентификация дополнительных данных */
+      if( words == 2 ) ak_gf128_mul_sum( &ctx->sum, hvals, inp, cnt );
+        else ak_gf64_mul_sum( &ctx->sum, hvals, inp, cnt );
+    } else {
+        if( encrypt )
+          for( idx = 0; idx < words*cnt; idx++ ) outp[idx] = inp[idx] ^ gamma[current][idx];
+       /* гамма для следующей группы блоков */
+        if( next ) {
+          ak_mgm_counters( &ctx->ycount, bsize, 0, ctrs, next );
+          encryptionKey->encrypt_blocks( &encryptionKey->key, ctrs, gamma[current^1], next );
+        }
+       /* имитовставка вычисляется от шифртекста */
+        if( authenticationKey != NULL ) {
+          if( words == 2 ) ak_gf128_mul_sum( &ctx->sum, hvals, encrypt ? outp : inp, cnt );
+            else ak_gf64_mul_sum( &ctx->sum, hvals, encrypt ? outp : inp, cnt );
+        }
+        if( !encrypt )
+          for( idx = 0; idx < words*cnt; idx++ ) outp[idx] = inp[idx] ^ gamma[current][idx];
+      }
+
+    inp += words*cnt;
+    if( outp != NULL ) outp += words*cnt;
+    blocks -= cnt;
+    current ^= 1;
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция обрабатывает очередной блок дополнительных данных и
     обновляет внутреннее состояние переменных алгоритма MGM, участвующих в алгоритме
@@ -204,7 +313,8 @@
  if( absize == 16 ) { /* обработка 128-битным шифром */
 
    ctx->abitlen += ( blocks  << 7 );
-   for( ; blocks > 0; blocks--, aptr += 16 ) { astep128( aptr ); }
+   ak_mgm_update_blocks( ctx, NULL, authenticationKey, (ak_uint64 *)aptr, NULL, blocks, ak_false );
+   aptr += ( blocks << 4 );
    if( tail ) {
     memset( temp, 0, 16 );
     memcpy( temp+absize-tail, aptr, (size_t)tail );
@@ -217,7 +327,8 @@
  } else { /* обработка 64-битным шифром */
 
    ctx->abitlen += ( blocks << 6 );
-   for( ; blocks > 0; blocks--, aptr += 8 ) { astep64( aptr ); }
+   ak_mgm_update_blocks( ctx, NULL, authenticationKey, (ak_uint64 *)aptr, NULL, blocks, ak_false );
+   aptr += ( blocks << 3 );
    if( tail ) {
     memset( temp, 0, 8 );
     memcpy( temp+absize-tail, aptr, (size_t)tail );
@@ -350,32 +461,6 @@
  return ak_error_ok;
 }
 
-/* ----------------------------------------------------------------------------------------------- */
-#ifdef AK_LITTLE_ENDIAN
- #define estep64  encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e ); \
-                  outp[0] = inp[0] ^ e.q[0]; \
-                  ctx->ycount.w[0]++;
-
- #define estep128 encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e ); \
-                  outp[0] = inp[0] ^ e.q[0]; \
-                  outp[1] = inp[1] ^ e.q[1]; \
-                  ctx->ycount.q[0]++;
-
-#else
- #define estep64  encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e ); \
-                  outp[0] = inp[0] ^ e.q[0]; \
-                  ctx->ycount.w[0] = bswap_32( ctx->ycount.w[0] ); \
-                  ctx->ycount.w[0]++; \
-                  ctx->ycount.w[0] = bswap_32( ctx->ycount.w[0] );
-
- #define estep128 encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e ); \
-                  outp[0] = inp[0] ^ e.q[0]; \
-                  outp[1] = inp[1] ^ e.q[1]; \
-                  ctx->ycount.q[0] = bswap_64( ctx->ycount.q[0] ); \
-                  ctx->ycount.q[0]++; \
-                  ctx->ycount.q[0] = bswap_64( ctx->ycount.q[0] );
-#endif
-
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция зашифровывает очередной фрагмент данных и
     обновляет внутреннее состояние переменных алгоритма MGM, участвующих в алгоритме
@@ -436,9 +521,8 @@
 
     if( absize&0x10 ) { /* режим работы для 128-битного шифра */
      /* основная часть */
-      for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
-         estep128;
-      }
+      ak_mgm_update_blocks( ctx, encryptionKey, NULL, inp, outp, blocks, ak_true );
+      inp += 2*blocks; outp += 2*blocks;
       /* хвост */
       if( tail ) {
         encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e );
@@ -451,9 +535,8 @@
 
     } else { /* режим работы для 64-битного шифра */
        /* основная часть */
-        for( ; blocks > 0; blocks--, inp++, outp++ ) {
-           estep64;
-        }
+        ak_mgm_update_blocks( ctx, encryptionKey, NULL, inp, outp, blocks, ak_true );
+        inp += blocks; outp += blocks;
        /* хвост */
         if( tail ) {
           encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e );
@@ -469,10 +552,8 @@
 
      if( absize&0x10 ) { /* режим работы для 128-битного шифра */
       /* основная часть */
-      for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
-         estep128;
-         astep128( outp );
-      }
+      ak_mgm_update_blocks( ctx, encryptionKey, authenticationKey, inp, outp, blocks, ak_true );
+      inp += 2*blocks; outp += 2*blocks;
       /* хвост */
       if( tail ) {
         memset( temp, 0, 16 );
@@ -489,10 +570,8 @@
 
     } else { /* режим работы для 64-битного шифра */
       /* основная часть */
-       for( ; blocks > 0; blocks--, inp++, outp++ ) {
-          estep64;
-          astep64( outp );
-       }
+       ak_mgm_update_blocks( ctx, encryptionKey, authenticationKey, inp, outp, blocks, ak_true );
+       inp += blocks; outp += blocks;
        /* хвост */
        if( tail ) {
          memset( temp, 0, 8 );
@@ -572,9 +651,8 @@
                                     /* это полная копия кода, содержащегося в функции .. _encryption_ ... */
     if( absize&0x10 ) { /* режим работы для 128-битного шифра */
      /* основная часть */
-      for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
-         estep128;
-      }
+      ak_mgm_update_blocks( ctx, encryptionKey, NULL, inp, outp, blocks, ak_false );
+      inp += 2*blocks; outp += 2*blocks;
       /* хвост */
       if( tail ) {
         encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e );
@@ -587,9 +665,8 @@
 
     } else { /* режим работы для 64-битного шифра */
        /* основная часть */
-        for( ; blocks > 0; blocks--, inp++, outp++ ) {
-           estep64;
-        }
+        ak_mgm_update_blocks( ctx, encryptionKey, NULL, inp, outp, blocks, ak_false );
+        inp += blocks; outp += blocks;
        /* хвост */
         if( tail ) {
           encryptionKey->encrypt( &encryptionKey->key, &ctx->ycount, &e );
@@ -605,10 +682,8 @@
 
      if( absize&0x10 ) { /* режим работы для 128-битного шифра */
       /* основная часть */
-      for( ; blocks > 0; blocks--, inp += 2, outp += 2 ) {
-         astep128( inp );
-         estep128;
-      }
+      ak_mgm_update_blocks( ctx, encryptionKey, authenticationKey, inp, outp, blocks, ak_false );
+      inp += 2*blocks; outp += 2*blocks;
       /* хвост */
       if( tail ) {
         memset( temp, 0, 16 );
@@ -625,10 +700,8 @@
 
     } else { /* режим работы для 64-битного шифра */
       /* основная часть */
-       for( ; blocks > 0; blocks--, inp++, outp++ ) {
-          astep64( inp );
-          estep64;
-       }
+       ak_mgm_update_blocks( ctx, encryptionKey, authenticationKey, inp, outp, blocks, ak_false );
+       inp += blocks; outp += blocks;
        /* хвост */
        if( tail ) {
          memset( temp, 0, 8 );
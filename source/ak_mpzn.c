@@ -4,7 +4,10 @@
 /*  Файл ak_mpzn.c                                                                                 */
 /*  - содержит реализации функций для вычислений с большими целыми числами                         */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+ #include <cpuid.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup math-doc Математические функции
@@ -685,6 +688,31 @@
   if( t[size] != cy ) memcpy( z, t, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычитает из вычета x вычет y по модулю p, то есть вычисляет значение
+    сравнения \f$ z \equiv x - y \pmod{p}\f$, где \f$ 0 \leq x, y < p \f$.
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
+    аргументы. Время работы функции не зависит от значений аргументов.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Уменьшаемое
+    @param y Вычитаемое
+    @param p Модуль, по которому производится операция вычитания
+    @param size Размер модуля в словах (значение константы ak_mpzn256_size или ak_mpzn512_size )   */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_sub_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 mask = 0;
+  ak_mpznmax t;
+
+ /* при возникновении заема к разности прибавляется модуль */
+  mask = ( ak_uint64 )0 - ak_mpzn_sub( z, x, y, size );
+  for( i = 0; i < size; i++ ) t[i] = p[i]&mask;
+  ak_mpzn_add( z, z, t, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция умножает вычет x на 2, после чего приводит полученную сумму
     по модулю p, то есть вычисляет значение сравнения \f$ z \equiv 2x \pmod{p}\f$.
@@ -720,30 +748,15 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
-    произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
-    \f$ y \equiv y_0r \pmod{p} \f$ функция вычисляет значение,
-    удовлетворяющее сравнению \f$ z \equiv x_0y_0r \pmod{p}\f$.
-    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
-    перемножаемые вычеты.
-
-    @param z Указатель на вычет, в который помещается результат
-    @param x Левый аргумент опреации сложения
-    @param y Правый аргумент операции сложения
-    @param p Модуль, по которому производятся вычисления
-    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
-    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
-    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
-                                                                          \ref ak_mpzn512_size).   */
+/*! \brief Переносимая реализация вычисления полного произведения t = xy длины 2*size слов.
+    Массив t не должен пересекаться с x и y.                                                       */
 /* ----------------------------------------------------------------------------------------------- */
- inline void ak_mpzn_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
-                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+ static inline void ak_mpzn_mul_wide_portable( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y,
+                                                                                const size_t size )
 {
   size_t i = 0, j = 0, ij = 0;
-  ak_uint64 av = 0, bv = 0, cy = 0;
-  ak_mpznmax t = ak_mpznmax_zero;
 
-  // ak_mpzn_mul( t, x, y, size );
+  memset( t, 0, 2*size*sizeof( ak_uint64 ));
   for( i = 0; i < size; i++ ) {
      ak_uint64 c = 0, m = x[i];
      for( j = 0, ij = i; j < size; j++ , ij++ ) {
@@ -758,6 +771,73 @@
      }
      t[ij] = c;
   }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Завершающий шаг вычисления квадрата: сумма попарных произведений \f$ x_ix_j, i < j\f$,
+    хранящаяся в t, удваивается сдвигом, после чего добавляются квадраты \f$ x_i^2 \f$.          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_wide_diagonal( ak_uint64 *t, ak_uint64 *x, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 c = 0, w1, w0, cy;
+
+ /* удваиваем сумму попарных произведений */
+  for( i = 2*size-1; i > 0; i-- ) t[i] = ( t[i] << 1 )|( t[i-1] >> 63 );
+  t[0] <<= 1;
+
+ /* добавляем квадраты */
+  for( i = 0, c = 0; i < size; i++ ) {
+     umul_ppmm( w1, w0, x[i], x[i] );
+     t[2*i] += c;
+     cy = t[2*i] < c;
+     t[2*i] += w0;
+     cy += t[2*i] < w0;
+     w1 += cy;                    /* w1 < 2^64 - 1, переполнение невозможно */
+     t[2*i+1] += w1;
+     c = t[2*i+1] < w1;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация вычисления квадрата t = x^2 длины 2*size слов.
+
+    Попарные произведения \f$ x_ix_j, i < j\f$ вычисляются один раз, что почти вдвое
+    сокращает количество умножений слов по сравнению с вычислением произведения x*x.             */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_wide_portable( ak_uint64 *t, ak_uint64 *x, const size_t size )
+{
+  size_t i = 0, j = 0, ij = 0;
+  ak_uint64 c = 0, w1, w0, cy;
+
+  memset( t, 0, 2*size*sizeof( ak_uint64 ));
+  for( i = 0; i < size; i++ ) {
+     ak_uint64 m = x[i];
+     for( j = i+1, ij = 2*i+1, c = 0; j < size; j++ , ij++ ) {
+        umul_ppmm( w1, w0, m, x[j] );
+        t[ij] += c;
+        cy = t[ij] < c;
+
+        t[ij] += w0;
+        cy += t[ij] < w0;
+        c = w1 + cy;
+     }
+     t[ij] = c;
+  }
+  ak_mpzn_sqr_wide_diagonal( t, x, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация приведения Монтгомери.
+
+    Для вычета t длины 2*size+1 слов, меньшего \f$ pr \f$ и имеющего нулевое старшее слово,
+    функция вычисляет \f$ z \equiv tr^{-1} \pmod{p}\f$. Содержимое t изменяется.                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_redc_portable( ak_uint64 *z, ak_uint64 *t, ak_uint64 *p,
+                                                               ak_uint64 n0, const size_t size )
+{
+  size_t i = 0, j = 0, ij = 0;
+  ak_uint64 av = 0, bv = 0, cy = 0;
 
   //  ak_mpzn_mul( u, t, n, size );
   //  ak_mpzn_mul( u, u, p, size );
@@ -795,6 +875,476 @@
   if( cy != t[2*size] ) memcpy( z, t+size, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация умножения Монтгомери.
+
+    Функция вызывается с константными значениями `size`, равными \ref ak_mpzn256_size или
+    \ref ak_mpzn512_size, что позволяет компилятору полностью развернуть циклы,
+    а также с произвольными значениями `size` для остальных модулей.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_portable( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_mpznmax t = ak_mpznmax_zero;
+
+  ak_mpzn_mul_wide_portable( t, x, y, size );
+  ak_mpzn_redc_portable( z, t, p, n0, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация возведения в квадрат в представлении Монтгомери. */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_montgomery_portable( ak_uint64 *z, ak_uint64 *x,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_mpznmax t = ak_mpznmax_zero;
+
+  ak_mpzn_sqr_wide_portable( t, x, size );
+  ak_mpzn_redc_portable( z, t, p, n0, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация умножения Монтгомери для 256-ти битных модулей. */
+ static void ak_mpzn_mul_montgomery_256_portable( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                      ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_portable( z, x, y, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация умножения Монтгомери для 512-ти битных модулей. */
+ static void ak_mpzn_mul_montgomery_512_portable( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                      ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_mul_montgomery_portable( z, x, y, p, n0, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация возведения в квадрат для 256-ти битных модулей. */
+ static void ak_mpzn_sqr_montgomery_256_portable( ak_uint64 *z, ak_uint64 *x,
+                                                                      ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_sqr_montgomery_portable( z, x, p, n0, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Переносимая реализация возведения в квадрат для 512-ти битных модулей. */
+ static void ak_mpzn_sqr_montgomery_512_portable( ak_uint64 *z, ak_uint64 *x,
+                                                                      ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_mpzn_sqr_montgomery_portable( z, x, p, n0, ak_mpzn512_size );
+}
+
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+/* ----------------------------------------------------------------------------------------------- */
+/*                 реализация умножения Монтгомери с использованием команд mulx/adcx/adox          */
+/* ----------------------------------------------------------------------------------------------- */
+/* Промежуточное значение t (2*size+1 слов) хранится в памяти, операнды ассемблерной вставки:
+   %0 - t, %1 - x, %2 - y, %3 - p, %4 - n0.
+   Каждая строка вычисляет t[i..i+size] += rdx*src[0..size-1] с использованием двух независимых
+   цепочек переносов: флаг CF (adcx) для слагаемых t, флаг OF (adox) для старших половин
+   произведений. Старшая половина предыдущего произведения хранится в регистре r10.              */
+ #define ak_adx_step( src, i, j )                                    \
+   "mulxq 8*" #j "(" src "), %%r8, %%r9\n\t"                         \
+   "adoxq %%r10, %%r8\n\t"                                           \
+   "adcxq 8*(" #i "+" #j ")(%0), %%r8\n\t"                           \
+   "movq %%r8, 8*(" #i "+" #j ")(%0)\n\t"                            \
+   "movq %%r9, %%r10\n\t"
+
+ #define ak_adx_row_end( i, n )                                      \
+   "movl $0, %%r8d\n\t"                                              \
+   "adoxq %%r8, %%r10\n\t"                                           \
+   "adcxq 8*(" #i "+" #n ")(%0), %%r10\n\t"                          \
+   "movq %%r10, 8*(" #i "+" #n ")(%0)\n\t"
+
+/* распространение переноса в старшие слова t */
+ #define ak_adx_carry( k ) "adcq $0, 8*" #k "(%0)\n\t"
+
+ #define ak_adx_steps4( src, i ) \
+   ak_adx_step( src, i, 0 ) ak_adx_step( src, i, 1 ) ak_adx_step( src, i, 2 ) ak_adx_step( src, i, 3 )
+ #define ak_adx_steps8( src, i ) ak_adx_steps4( src, i )                                 \
+   ak_adx_step( src, i, 4 ) ak_adx_step( src, i, 5 ) ak_adx_step( src, i, 6 ) ak_adx_step( src, i, 7 )
+
+/* строка умножения: t[i..i+n] += x[i]*y */
+ #define ak_adx_mul_row( i, n ) \
+   "movq 8*" #i "(%1), %%rdx\n\t" "xorl %%r10d, %%r10d\n\t" \
+    ak_adx_steps##n( "%2", i ) ak_adx_row_end( i, n )
+
+/* строка попарных произведений при возведении в квадрат: t[2i+1..i+n] += x[i]*x[i+1..n-1] */
+ #define ak_adx_sqr_row( i ) "movq 8*" #i "(%1), %%rdx\n\t" "xorl %%r10d, %%r10d\n\t"
+
+/* строка редукции: m = t[i]*n0, t[i..] += m*p */
+ #define ak_adx_red_row( i, n ) \
+   "movq 8*" #i "(%0), %%rdx\n\t" "imulq %4, %%rdx\n\t" "xorl %%r10d, %%r10d\n\t" \
+    ak_adx_steps##n( "%3", i ) ak_adx_row_end( i, n )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычитание модуля и запись результата умножения Монтгомери. */
+ static inline void ak_mpzn_mul_montgomery_adx_finalize( ak_uint64 *z, ak_uint64 *t,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 av = 0, bv = 0, cy = 0, mask = 0, r[ak_mpzn512_size];
+
+  for( i = 0; i < size; i++ ) {
+     av = t[size+i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - p[i];
+     cy += av > bv;
+     r[i] = av;
+  }
+ /* если вычитание привело к заему, не компенсированному старшим словом, оставляем t */
+  mask = ( ak_uint64 )0 - ( ak_uint64 )( cy != t[2*size] );
+  for( i = 0; i < size; i++ ) z[i] = ( r[i]&~mask )|( t[size+i]&mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение Монтгомери для 256-ти битных модулей с использованием команд mulx/adcx/adox. */
+ static void ak_mpzn_mul_montgomery_256_adx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                      ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[ 2*ak_mpzn256_size + 1 ] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  __asm__ volatile (
+    ak_adx_mul_row( 0, 4 )
+    ak_adx_mul_row( 1, 4 )
+    ak_adx_mul_row( 2, 4 )
+    ak_adx_mul_row( 3, 4 )
+    ak_adx_red_row( 0, 4 ) ak_adx_carry( 5 ) ak_adx_carry( 6 ) ak_adx_carry( 7 ) ak_adx_carry( 8 )
+    ak_adx_red_row( 1, 4 ) ak_adx_carry( 6 ) ak_adx_carry( 7 ) ak_adx_carry( 8 )
+    ak_adx_red_row( 2, 4 ) ak_adx_carry( 7 ) ak_adx_carry( 8 )
+    ak_adx_red_row( 3, 4 ) ak_adx_carry( 8 )
+    :
+    : "r" ( t ), "r" ( x ), "r" ( y ), "r" ( p ), "rm" ( n0 )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+
+  ak_mpzn_mul_montgomery_adx_finalize( z, t, p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Умножение Монтгомери для 512-ти битных модулей с использованием команд mulx/adcx/adox. */
+ static void ak_mpzn_mul_montgomery_512_adx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                      ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[ 2*ak_mpzn512_size + 1 ] = {
+                                   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  __asm__ volatile (
+    ak_adx_mul_row( 0, 8 )
+    ak_adx_mul_row( 1, 8 )
+    ak_adx_mul_row( 2, 8 )
+    ak_adx_mul_row( 3, 8 )
+    ak_adx_mul_row( 4, 8 )
+    ak_adx_mul_row( 5, 8 )
+    ak_adx_mul_row( 6, 8 )
+    ak_adx_mul_row( 7, 8 )
+    ak_adx_red_row( 0, 8 ) ak_adx_carry( 9 ) ak_adx_carry( 10 ) ak_adx_carry( 11 )
+      ak_adx_carry( 12 ) ak_adx_carry( 13 ) ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 1, 8 ) ak_adx_carry( 10 ) ak_adx_carry( 11 ) ak_adx_carry( 12 )
+      ak_adx_carry( 13 ) ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 2, 8 ) ak_adx_carry( 11 ) ak_adx_carry( 12 ) ak_adx_carry( 13 )
+      ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 3, 8 ) ak_adx_carry( 12 ) ak_adx_carry( 13 ) ak_adx_carry( 14 )
+      ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 4, 8 ) ak_adx_carry( 13 ) ak_adx_carry( 14 ) ak_adx_carry( 15 )
+      ak_adx_carry( 16 )
+    ak_adx_red_row( 5, 8 ) ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 6, 8 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 7, 8 ) ak_adx_carry( 16 )
+    :
+    : "r" ( t ), "r" ( x ), "r" ( y ), "r" ( p ), "rm" ( n0 )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+
+  ak_mpzn_mul_montgomery_adx_finalize( z, t, p, ak_mpzn512_size );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_mul_wide_256_portable( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y )
+{
+  ak_mpzn_mul_wide_portable( t, x, y, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_mul_wide_512_portable( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y )
+{
+  ak_mpzn_mul_wide_portable( t, x, y, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_sqr_wide_256_portable( ak_uint64 *t, ak_uint64 *x )
+{
+  ak_mpzn_sqr_wide_portable( t, x, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_sqr_wide_512_portable( ak_uint64 *t, ak_uint64 *x )
+{
+  ak_mpzn_sqr_wide_portable( t, x, ak_mpzn512_size );
+}
+
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Полное произведение 256-ти битных вычетов с использованием команд mulx/adcx/adox. */
+ static void ak_mpzn_mul_wide_256_adx( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y )
+{
+  memset( t, 0, 2*ak_mpzn256_size*sizeof( ak_uint64 ));
+  __asm__ volatile (
+    ak_adx_mul_row( 0, 4 )
+    ak_adx_mul_row( 1, 4 )
+    ak_adx_mul_row( 2, 4 )
+    ak_adx_mul_row( 3, 4 )
+    :
+    : "r" ( t ), "r" ( x ), "r" ( y )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Полное произведение 512-ти битных вычетов с использованием команд mulx/adcx/adox. */
+ static void ak_mpzn_mul_wide_512_adx( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y )
+{
+  memset( t, 0, 2*ak_mpzn512_size*sizeof( ak_uint64 ));
+  __asm__ volatile (
+    ak_adx_mul_row( 0, 8 )
+    ak_adx_mul_row( 1, 8 )
+    ak_adx_mul_row( 2, 8 )
+    ak_adx_mul_row( 3, 8 )
+    ak_adx_mul_row( 4, 8 )
+    ak_adx_mul_row( 5, 8 )
+    ak_adx_mul_row( 6, 8 )
+    ak_adx_mul_row( 7, 8 )
+    :
+    : "r" ( t ), "r" ( x ), "r" ( y )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Квадрат 256-ти битного вычета с использованием команд mulx/adcx/adox:
+    попарные произведения вычисляются ассемблерной вставкой, квадраты слов добавляются
+    функцией ak_mpzn_sqr_wide_diagonal(). */
+ static void ak_mpzn_sqr_wide_256_adx( ak_uint64 *t, ak_uint64 *x )
+{
+  memset( t, 0, 2*ak_mpzn256_size*sizeof( ak_uint64 ));
+  __asm__ volatile (
+    ak_adx_sqr_row( 0 ) ak_adx_step( "%1", 0, 1 ) ak_adx_step( "%1", 0, 2 )
+      ak_adx_step( "%1", 0, 3 ) ak_adx_row_end( 0, 4 )
+    ak_adx_sqr_row( 1 ) ak_adx_step( "%1", 1, 2 ) ak_adx_step( "%1", 1, 3 ) ak_adx_row_end( 1, 4 )
+    ak_adx_sqr_row( 2 ) ak_adx_step( "%1", 2, 3 ) ak_adx_row_end( 2, 4 )
+    :
+    : "r" ( t ), "r" ( x )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+  ak_mpzn_sqr_wide_diagonal( t, x, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Квадрат 512-ти битного вычета с использованием команд mulx/adcx/adox. */
+ static void ak_mpzn_sqr_wide_512_adx( ak_uint64 *t, ak_uint64 *x )
+{
+  memset( t, 0, 2*ak_mpzn512_size*sizeof( ak_uint64 ));
+  __asm__ volatile (
+    ak_adx_sqr_row( 0 ) ak_adx_step( "%1", 0, 1 ) ak_adx_step( "%1", 0, 2 )
+      ak_adx_step( "%1", 0, 3 ) ak_adx_step( "%1", 0, 4 ) ak_adx_step( "%1", 0, 5 )
+      ak_adx_step( "%1", 0, 6 ) ak_adx_step( "%1", 0, 7 ) ak_adx_row_end( 0, 8 )
+    ak_adx_sqr_row( 1 ) ak_adx_step( "%1", 1, 2 ) ak_adx_step( "%1", 1, 3 )
+      ak_adx_step( "%1", 1, 4 ) ak_adx_step( "%1", 1, 5 ) ak_adx_step( "%1", 1, 6 )
+      ak_adx_step( "%1", 1, 7 ) ak_adx_row_end( 1, 8 )
+    ak_adx_sqr_row( 2 ) ak_adx_step( "%1", 2, 3 ) ak_adx_step( "%1", 2, 4 )
+      ak_adx_step( "%1", 2, 5 ) ak_adx_step( "%1", 2, 6 ) ak_adx_step( "%1", 2, 7 )
+      ak_adx_row_end( 2, 8 )
+    ak_adx_sqr_row( 3 ) ak_adx_step( "%1", 3, 4 ) ak_adx_step( "%1", 3, 5 )
+      ak_adx_step( "%1", 3, 6 ) ak_adx_step( "%1", 3, 7 ) ak_adx_row_end( 3, 8 )
+    ak_adx_sqr_row( 4 ) ak_adx_step( "%1", 4, 5 ) ak_adx_step( "%1", 4, 6 )
+      ak_adx_step( "%1", 4, 7 ) ak_adx_row_end( 4, 8 )
+    ak_adx_sqr_row( 5 ) ak_adx_step( "%1", 5, 6 ) ak_adx_step( "%1", 5, 7 ) ak_adx_row_end( 5, 8 )
+    ak_adx_sqr_row( 6 ) ak_adx_step( "%1", 6, 7 ) ak_adx_row_end( 6, 8 )
+    :
+    : "r" ( t ), "r" ( x )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+  ak_mpzn_sqr_wide_diagonal( t, x, ak_mpzn512_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Возведение в квадрат по 256-ти битному модулю в представлении Монтгомери
+    с использованием команд mulx/adcx/adox. Операнды %1 и %2 ассемблерной вставки
+    строками редукции не используются. */
+ static void ak_mpzn_sqr_montgomery_256_adx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[ 2*ak_mpzn256_size + 1 ];
+
+  ak_mpzn_sqr_wide_256_adx( t, x );
+  t[ 2*ak_mpzn256_size ] = 0;
+  __asm__ volatile (
+    ak_adx_red_row( 0, 4 ) ak_adx_carry( 5 ) ak_adx_carry( 6 ) ak_adx_carry( 7 ) ak_adx_carry( 8 )
+    ak_adx_red_row( 1, 4 ) ak_adx_carry( 6 ) ak_adx_carry( 7 ) ak_adx_carry( 8 )
+    ak_adx_red_row( 2, 4 ) ak_adx_carry( 7 ) ak_adx_carry( 8 )
+    ak_adx_red_row( 3, 4 ) ak_adx_carry( 8 )
+    :
+    : "r" ( t ), "r" ( x ), "r" ( x ), "r" ( p ), "rm" ( n0 )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+
+  ak_mpzn_mul_montgomery_adx_finalize( z, t, p, ak_mpzn256_size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Возведение в квадрат по 512-ти битному модулю в представлении Монтгомери
+    с использованием команд mulx/adcx/adox. */
+ static void ak_mpzn_sqr_montgomery_512_adx( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, ak_uint64 n0 )
+{
+  ak_uint64 t[ 2*ak_mpzn512_size + 1 ];
+
+  ak_mpzn_sqr_wide_512_adx( t, x );
+  t[ 2*ak_mpzn512_size ] = 0;
+  __asm__ volatile (
+    ak_adx_red_row( 0, 8 ) ak_adx_carry( 9 ) ak_adx_carry( 10 ) ak_adx_carry( 11 )
+      ak_adx_carry( 12 ) ak_adx_carry( 13 ) ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 1, 8 ) ak_adx_carry( 10 ) ak_adx_carry( 11 ) ak_adx_carry( 12 )
+      ak_adx_carry( 13 ) ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 2, 8 ) ak_adx_carry( 11 ) ak_adx_carry( 12 ) ak_adx_carry( 13 )
+      ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 3, 8 ) ak_adx_carry( 12 ) ak_adx_carry( 13 ) ak_adx_carry( 14 )
+      ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 4, 8 ) ak_adx_carry( 13 ) ak_adx_carry( 14 ) ak_adx_carry( 15 )
+      ak_adx_carry( 16 )
+    ak_adx_red_row( 5, 8 ) ak_adx_carry( 14 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 6, 8 ) ak_adx_carry( 15 ) ak_adx_carry( 16 )
+    ak_adx_red_row( 7, 8 ) ak_adx_carry( 16 )
+    :
+    : "r" ( t ), "r" ( x ), "r" ( x ), "r" ( p ), "rm" ( n0 )
+    : "rdx", "r8", "r9", "r10", "cc", "memory" );
+
+  ak_mpzn_mul_montgomery_adx_finalize( z, t, p, ak_mpzn512_size );
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Структура, содержащая указатели на функции умножения для вычетов
+    фиксированной длины; значения полей устанавливаются функцией ak_mpzn_init_backend(). */
+ static struct mpzn_backend {
+  /*! \brief Умножение Монтгомери по 256-ти битному модулю. */
+   void ( *mul256 )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 );
+  /*! \brief Умножение Монтгомери по 512-ти битному модулю. */
+   void ( *mul512 )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 );
+  /*! \brief Возведение в квадрат по 256-ти битному модулю в представлении Монтгомери. */
+   void ( *sqr256 )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 );
+  /*! \brief Возведение в квадрат по 512-ти битному модулю в представлении Монтгомери. */
+   void ( *sqr512 )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 );
+  /*! \brief Полное произведение 256-ти битных вычетов. */
+   void ( *mulw256 )( ak_uint64 * , ak_uint64 * , ak_uint64 * );
+  /*! \brief Полное произведение 512-ти битных вычетов. */
+   void ( *mulw512 )( ak_uint64 * , ak_uint64 * , ak_uint64 * );
+  /*! \brief Квадрат 256-ти битного вычета. */
+   void ( *sqrw256 )( ak_uint64 * , ak_uint64 * );
+  /*! \brief Квадрат 512-ти битного вычета. */
+   void ( *sqrw512 )( ak_uint64 * , ak_uint64 * );
+  /*! \brief Наименование используемой реализации. */
+   const char *name;
+ } mpzn_backend = {
+   ak_mpzn_mul_montgomery_256_portable, ak_mpzn_mul_montgomery_512_portable,
+   ak_mpzn_sqr_montgomery_256_portable, ak_mpzn_sqr_montgomery_512_portable,
+   ak_mpzn_mul_wide_256_portable, ak_mpzn_mul_wide_512_portable,
+   ak_mpzn_sqr_wide_256_portable, ak_mpzn_sqr_wide_512_portable, "generic"
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, поддерживает ли процессор команды mulx (BMI2) и adcx/adox (ADX), и
+    выбирает реализацию умножения Монтгомери, а также вычисления полного произведения
+    (используемого арифметикой по псевдомерсенновым модулям) для 256-ти и 512-ти битных вычетов.
+    Выбор производится один раз, при инициализации библиотеки;
+    в случае отсутствия поддержки используется переносимая реализация.
+
+    @return Функция возвращает \ref ak_error_ok (ноль).                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_mpzn_init_backend( void )
+{
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+#endif
+
+  mpzn_backend.mul256 = ak_mpzn_mul_montgomery_256_portable;
+  mpzn_backend.mul512 = ak_mpzn_mul_montgomery_512_portable;
+  mpzn_backend.sqr256 = ak_mpzn_sqr_montgomery_256_portable;
+  mpzn_backend.sqr512 = ak_mpzn_sqr_montgomery_512_portable;
+  mpzn_backend.mulw256 = ak_mpzn_mul_wide_256_portable;
+  mpzn_backend.mulw512 = ak_mpzn_mul_wide_512_portable;
+  mpzn_backend.sqrw256 = ak_mpzn_sqr_wide_256_portable;
+  mpzn_backend.sqrw512 = ak_mpzn_sqr_wide_512_portable;
+  mpzn_backend.name = "generic";
+
+#ifdef AK_HAVE_BUILTIN_MULX_ADX
+ /* cpuid, лист 7: бит 8 регистра ebx - BMI2, бит 19 - ADX */
+  if( __get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) &&
+                                            ( ebx&( 1 << 8 )) && ( ebx&( 1 << 19 ))) {
+    mpzn_backend.mul256 = ak_mpzn_mul_montgomery_256_adx;
+    mpzn_backend.mul512 = ak_mpzn_mul_montgomery_512_adx;
+    mpzn_backend.sqr256 = ak_mpzn_sqr_montgomery_256_adx;
+    mpzn_backend.sqr512 = ak_mpzn_sqr_montgomery_512_adx;
+    mpzn_backend.mulw256 = ak_mpzn_mul_wide_256_adx;
+    mpzn_backend.mulw512 = ak_mpzn_mul_wide_512_adx;
+    mpzn_backend.sqrw256 = ak_mpzn_sqr_wide_256_adx;
+    mpzn_backend.sqrw512 = ak_mpzn_sqr_wide_512_adx;
+    mpzn_backend.name = "mulx-adx";
+  }
+#endif
+
+  if( ak_log_get_level() >= ak_log_maximum )
+    ak_error_message_fmt( ak_error_ok, __func__,
+                          "montgomery multiplication uses %s implementation", mpzn_backend.name );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
+    произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
+    \f$ y \equiv y_0r \pmod{p} \f$ функция вычисляет значение,
+    удовлетворяющее сравнению \f$ z \equiv x_0y_0r \pmod{p}\f$.
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
+    перемножаемые вычеты.
+
+    Для модулей длины \ref ak_mpzn256_size и \ref ak_mpzn512_size используются развернутые
+    реализации, выбираемые при инициализации библиотеки (см. ak_mpzn_init_backend()).
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент опреации сложения
+    @param y Правый аргумент операции сложения
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_mul_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: mpzn_backend.mul256( z, x, y, p, n0 ); break;
+    case ak_mpzn512_size: mpzn_backend.mul512( z, x, y, p, n0 ); break;
+    default: ak_mpzn_mul_montgomery_portable( z, x, y, p, n0, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возводит в квадрат вычет x, заданный в представлении Монтгомери, то есть
+    для \f$ x \equiv x_0r \pmod{p} \f$ вычисляет значение \f$ z \equiv x_0^2r \pmod{p}\f$.
+    Результат совпадает с результатом вызова ak_mpzn_mul_montgomery( z, x, x, p, n0, size ),
+    однако попарные произведения слов вычета вычисляются один раз, что сокращает
+    количество умножений слов. Указатель на z может совпадать с указателем на x.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Вычет, возводимый в квадрат
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях (см. ak_mpzn_mul_montgomery())
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_sqr_montgomery( ak_uint64 *z, ak_uint64 *x,
+                                                   ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size: mpzn_backend.sqr256( z, x, p, n0 ); break;
+    case ak_mpzn512_size: mpzn_backend.sqr512( z, x, p, n0 ); break;
+    default: ak_mpzn_sqr_montgomery_portable( z, x, p, n0, size );
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, где \f$ r \f$
     заданная степень двойки, вычисляется вычет \f$ z \f$,
@@ -802,6 +1352,16 @@
     Результат \f$ z \f$  является значением вычета \f$ x^k \pmod{p}\f$ в представлении Монтгомери.
     Величины \f$ k \f$  и \f$ p \f$ задаются как обычные вычеты и \f$ p \f$  отлично от нуля.
 
+    Используется метод скользящего окна: вычисляются нечетные степени
+    \f$ x, x^3, \ldots, x^{2^w-1} \f$, после чего степень \f$ k \f$ просматривается
+    от старших битов к младшим, и каждое окно из не более чем \f$ w \f$ битов,
+    заканчивающееся единичным битом, обрабатывается одним умножением. Ширина окна равна 4
+    для 256-ти битных модулей и 5 для модулей большего размера; возведение в квадрат
+    выполняется функцией ak_mpzn_sqr_montgomery().
+
+    \warning Время работы функции зависит от значения степени \f$ k \f$, поэтому функция
+    предназначена для открытых значений степени, например \f$ p-2 \f$ или \f$ q-2 \f$.
+
     @param z Вычет, в который помещается результат
     @param x Вычет, который возводится в степень \f$ k \f$
     @param k Степень, в которую возводится вычет \f$ x \f$
@@ -814,33 +1374,581 @@
  void ak_mpzn_modpow_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *k,
                                                    ak_uint64 *p, ak_uint64 n0, const size_t size )
 {
-  ak_uint64 uk = 0;
-  size_t s = size-1;
-  long long int i, j;
+  size_t j = 0, l = 0;
+  long long int i = 0;
+  bool_t first = ak_true;
+  ak_uint64 value = 0, table[16][ ak_mpzn512_size ];
+  const size_t w = ( size > ak_mpzn256_size ) ? 5 : 4;
   ak_mpznmax res = ak_mpznmax_zero; // это константа r (mod p) = r-p
+
   if( ak_mpzn_sub( res, res, p, size ) == 0 ) {
     ak_error_message( ak_error_undefined_value,
                                           "using an unexpected value of prime modulo", __func__ );
     return;
   }
-  while( k[s] == 0 ) {
-     if( s > 0 ) --s;
-      else {
-             ak_mpzn_set( z, res, size );
-             return;
-           }
-  }
-  for( i = s; i >= 0; i-- ) {
-     uk = k[i];
-     for( j = 0; j < 64; j++ ) {
-        ak_mpzn_mul_montgomery( res, res, res, p, n0, size );
-        if( uk&0x8000000000000000LL ) ak_mpzn_mul_montgomery( res, res, x, p, n0, size );
-        uk <<= 1;
+  if( size > ak_mpzn512_size ) {
+    ak_error_message( ak_error_wrong_length, __func__, "using an unexpected length of modulo" );
+    return;
+  }
+
+ /* находим старший ненулевой бит степени */
+  for( i = 64*size - 1; i >= 0; i-- ) if(( k[i >> 6] >> ( i&0x3f ))&1 ) break;
+  if( i < 0 ) {
+    ak_mpzn_set( z, res, size );
+    return;
+  }
+
+ /* таблица нечетных степеней x, x^3, ..., x^{2^w - 1} */
+  ak_mpzn_set( table[0], x, size );
+  ak_mpzn_sqr_montgomery( res, x, p, n0, size );
+  for( j = 1; j < ((size_t)1 << ( w-1 )); j++ )
+     ak_mpzn_mul_montgomery( table[j], table[j-1], res, p, n0, size );
+
+  while( i >= 0 ) {
+     if((( k[i >> 6] >> ( i&0x3f ))&1 ) == 0 ) {
+       ak_mpzn_sqr_montgomery( res, res, p, n0, size );
+       i--;
+       continue;
      }
+    /* окно [l, i] из не более чем w битов, младший бит которого равен единице */
+     l = ( i+1 > (long long int)w ) ? ( size_t )( i+1-w ) : 0;
+     while((( k[l >> 6] >> ( l&0x3f ))&1 ) == 0 ) l++;
+     for( j = ( size_t )i, value = 0; ; j-- ) {
+        value = ( value << 1 )|(( k[j >> 6] >> ( j&0x3f ))&1 );
+        if( j == l ) break;
+     }
+     if( first ) {
+       ak_mpzn_set( res, table[value >> 1], size );
+       first = ak_false;
+     } else {
+         for( j = l; j <= ( size_t )i; j++ ) ak_mpzn_sqr_montgomery( res, res, p, n0, size );
+         ak_mpzn_mul_montgomery( res, res, table[value >> 1], p, n0, size );
+       }
+     i = ( long long int )l - 1;
   }
   memcpy( z, res, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для заданных ненулевых вычетов \f$ x_1, \ldots, x_n \f$, представленных в форме Монтгомери,
+    функция вычисляет обратные вычеты \f$ x_1^{-1}, \ldots, x_n^{-1} \pmod{p} \f$ (также в форме
+    Монтгомери) и помещает их на место исходных значений.
+
+    Используется метод Монтгомери совместного обращения: вычисляются произведения
+    \f$ c_i = x_1\cdots x_i \f$, затем обращается только одно значение \f$ c_n \f$,
+    после чего обратные элементы восстанавливаются с помощью \f$ 3(n-1) \f$ умножений.
+    Значение \f$ c_n \f$ обращается функцией ak_mpzn_inverse_montgomery(), поэтому
+    результат совпадает с результатом ее последовательного вызова для каждого из вычетов.
+
+    @param x Массив указателей на обращаемые вычеты
+    @param count Количество вычетов
+    @param buffer Область памяти для хранения промежуточных произведений;
+    должна содержать не менее `count*size` машинных слов
+    @param p Простой модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях по модулю \f$ p \f$
+    @param r2 Константа \f$ r^2 \pmod{p} \f$
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_batch_montgomery( ak_uint64 **x, const size_t count, ak_uint64 *buffer,
+                                    ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+  size_t i = 0;
+  ak_mpznmax u, t;
+
+  if( !count ) return;
+ /* прямой проход: buffer[i] = x[0]*...*x[i] */
+  ak_mpzn_set( buffer, x[0], size );
+  for( i = 1; i < count; i++ )
+     ak_mpzn_mul_montgomery( buffer +i*size, buffer +(i-1)*size, x[i], p, n0, size );
+
+ /* единственное обращение */
+  ak_mpzn_inverse_montgomery( u, buffer +(count-1)*size, p, r2, size );
+
+ /* обратный проход: u = (x[0]*...*x[i])^{-1} */
+  for( i = count-1; i > 0; i-- ) {
+     ak_mpzn_mul_montgomery( t, u, buffer +(i-1)*size, p, n0, size );
+     ak_mpzn_mul_montgomery( u, u, x[i], p, n0, size );
+     ak_mpzn_set( x[i], t, size );
+  }
+  ak_mpzn_set( x[0], u, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                 обращение вычетов методом Бернштейна-Янга (safegcd, divsteps)                   */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество знаковых 62-х битных разрядов, достаточное для чисел длины 512 бит. */
+ #define ak_mpzn_s62_max   ( 9 )
+/*! \brief Маска младших 62-х битов. */
+ #define ak_mpzn_s62_mask  ( 0x3fffffffffffffffLL )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Матрица перехода, вычисляемая за 62 шага алгоритма divsteps и домноженная на 2^62. */
+ struct mpzn_divsteps {
+   ak_int64 u, v, q, r;
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Прибавление к 128-ми битному знаковому значению (hi, lo) произведения a*b
+    знаковых 64-х битных значений.                                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_s128_mul_add( ak_uint64 *hi, ak_uint64 *lo,
+                                                                const ak_int64 a, const ak_int64 b )
+{
+  ak_uint64 h, l, ua = ( ak_uint64 )a, ub = ( ak_uint64 )b;
+
+  umul_ppmm( h, l, ua, ub );
+ /* переход от беззнакового произведения к знаковому */
+  h -= (( ak_uint64 )0 - ( ua >> 63 ))&ub;
+  h -= (( ak_uint64 )0 - ( ub >> 63 ))&ua;
+  *lo += l;
+  *hi += h + ( *lo < l );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Арифметический сдвиг 128-ми битного знакового значения (hi, lo) вправо на 62 бита. */
+ static inline void ak_mpzn_s128_shift( ak_uint64 *hi, ak_uint64 *lo )
+{
+  *lo = ( *lo >> 62 )|( *hi << 2 );
+  *hi = ( *hi >> 62 )|((( ak_uint64 )0 - ( *hi >> 63 )) << 2 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Маска, равная единицам, если знаковое значение x отрицательно, и нулю в противном случае. */
+ static inline ak_uint64 ak_mpzn_s62_sign( const ak_int64 x )
+{
+  return ( ak_uint64 )0 - (( ak_uint64 )x >> 63 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перевод вычета в знаковые 62-х битные разряды (все разряды неотрицательны). */
+ static void ak_mpzn_to_s62( ak_int64 *r, const size_t n, ak_uint64 *x, const size_t size )
+{
+  size_t i = 0, bit = 0, w = 0, s = 0;
+  ak_uint64 v = 0;
+
+  for( i = 0; i < n; i++ ) {
+     bit = 62*i; w = bit >> 6; s = bit&0x3f;
+     v = 0;
+     if( w < size ) {
+       v = x[w] >> s;
+       if(( s > 2 ) && ( w+1 < size )) v |= x[w+1] << ( 64 - s );
+     }
+     r[i] = ( ak_int64 )( v&ak_mpzn_s62_mask );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обратный перевод из 62-х битных неотрицательных разрядов в вычет. */
+ static void ak_mpzn_from_s62( ak_uint64 *x, const size_t size, ak_int64 *r, const size_t n )
+{
+  size_t i = 0, bit = 0, w = 0, s = 0;
+
+  memset( x, 0, size*sizeof( ak_uint64 ));
+  for( i = 0; i < n; i++ ) {
+     bit = 62*i; w = bit >> 6; s = bit&0x3f;
+     if( w < size ) x[w] |= ( ak_uint64 )r[i] << s;
+     if(( s > 2 ) && ( w+1 < size )) x[w+1] |= ( ak_uint64 )r[i] >> ( 64 - s );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Нормализация разрядов: младшие разряды приводятся к интервалу \f$ [0, 2^{62}) \f$,
+    перенос передается в старший (знаковый) разряд.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_s62_carry( ak_int64 *r, const size_t n )
+{
+  size_t i = 0;
+  ak_uint64 c = 0;
+
+  for( i = 0; i < n-1; i++ ) {
+     c = (( ak_uint64 )r[i] >> 62 )|( ak_mpzn_s62_sign( r[i] ) << 2 );
+     r[i] = ( ak_int64 )(( ak_uint64 )r[i]&ak_mpzn_s62_mask );
+     r[i+1] = ( ak_int64 )(( ak_uint64 )r[i+1] + c );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выполнение 62-х шагов divstep для младших слов f0 и g0.
+
+    Шаг алгоритма переводит тройку \f$ (\delta, f, g) \f$ в тройку
+    \f$ (1-\delta, g, (g-f)/2) \f$, если \f$ \delta > 0 \f$ и \f$ g \f$ нечетно,
+    и в тройку \f$ (1+\delta, f, (g + (g \bmod 2)f)/2) \f$ в противном случае.
+    Все ветвления заменены операциями с масками.
+
+    @return Функция возвращает новое значение \f$ \delta \f$.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_int64 ak_mpzn_divsteps_62( ak_int64 delta, ak_uint64 f0, ak_uint64 g0,
+                                                                       struct mpzn_divsteps *t )
+{
+  int i = 0;
+  ak_uint64 u = 1, v = 0, q = 0, r = 1, f = f0, g = g0, c1, c2, x, y, z;
+
+  for( i = 0; i < 62; i++ ) {
+     c1 = ak_mpzn_s62_sign( -delta );   /* delta > 0 */
+     c2 = ( ak_uint64 )0 - ( g&1 );       /* g нечетно */
+     x = ( f^c1 ) - c1;
+     y = ( u^c1 ) - c1;
+     z = ( v^c1 ) - c1;
+     g += x&c2; q += y&c2; r += z&c2;
+     c1 &= c2;
+     delta = ( ak_int64 )((( ak_uint64 )delta^c1 ) - c1 ) + 1;
+     f += g&c1; u += q&c1; v += r&c1;
+     g >>= 1; u <<= 1; v <<= 1;
+  }
+  t->u = ( ak_int64 )u; t->v = ( ak_int64 )v;
+  t->q = ( ak_int64 )q; t->r = ( ak_int64 )r;
+ return delta;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ (f, g) \leftarrow t\cdot(f, g)/2^{62} \f$; деление выполняется нацело. */
+ static void ak_mpzn_update_fg_62( ak_int64 *f, ak_int64 *g, const size_t n,
+                                                                       struct mpzn_divsteps *t )
+{
+  size_t i = 0;
+  ak_uint64 fh = 0, fl = 0, gh = 0, gl = 0;
+
+  ak_mpzn_s128_mul_add( &fh, &fl, t->u, f[0] );
+  ak_mpzn_s128_mul_add( &fh, &fl, t->v, g[0] );
+  ak_mpzn_s128_mul_add( &gh, &gl, t->q, f[0] );
+  ak_mpzn_s128_mul_add( &gh, &gl, t->r, g[0] );
+  ak_mpzn_s128_shift( &fh, &fl );
+  ak_mpzn_s128_shift( &gh, &gl );
+  for( i = 1; i < n; i++ ) {
+     ak_mpzn_s128_mul_add( &fh, &fl, t->u, f[i] );
+     ak_mpzn_s128_mul_add( &fh, &fl, t->v, g[i] );
+     ak_mpzn_s128_mul_add( &gh, &gl, t->q, f[i] );
+     ak_mpzn_s128_mul_add( &gh, &gl, t->r, g[i] );
+     f[i-1] = ( ak_int64 )( fl&ak_mpzn_s62_mask );
+     g[i-1] = ( ak_int64 )( gl&ak_mpzn_s62_mask );
+     ak_mpzn_s128_shift( &fh, &fl );
+     ak_mpzn_s128_shift( &gh, &gl );
+  }
+  f[n-1] = ( ak_int64 )fl;
+  g[n-1] = ( ak_int64 )gl;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление \f$ (d, e) \leftarrow t\cdot(d, e)/2^{62} \pmod{m} \f$.
+
+    К произведению прибавляется такое кратное модуля, что результат делится на \f$ 2^{62} \f$.
+    Если на входе значения \f$ d, e \f$ лежат в интервале \f$ (-2m, m) \f$, то и результат
+    лежит в этом интервале.                                                                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_update_de_62( ak_int64 *d, ak_int64 *e, const size_t n,
+                          struct mpzn_divsteps *t, ak_int64 *m, const ak_uint64 minv )
+{
+  size_t i = 0;
+  ak_uint64 dh = 0, dl = 0, eh = 0, el = 0, sd, se, md, me;
+
+ /* для отрицательных d, e заранее прибавляем модуль, умноженный на элементы матрицы */
+  sd = ak_mpzn_s62_sign( d[n-1] );
+  se = ak_mpzn_s62_sign( e[n-1] );
+  md = (( ak_uint64 )t->u&sd ) + (( ak_uint64 )t->v&se );
+  me = (( ak_uint64 )t->q&sd ) + (( ak_uint64 )t->r&se );
+
+  ak_mpzn_s128_mul_add( &dh, &dl, t->u, d[0] );
+  ak_mpzn_s128_mul_add( &dh, &dl, t->v, e[0] );
+  ak_mpzn_s128_mul_add( &eh, &el, t->q, d[0] );
+  ak_mpzn_s128_mul_add( &eh, &el, t->r, e[0] );
+
+ /* подбираем md, me так, чтобы младшие 62 бита суммы обнулились */
+  md -= ( minv*dl + md )&ak_mpzn_s62_mask;
+  me -= ( minv*el + me )&ak_mpzn_s62_mask;
+  ak_mpzn_s128_mul_add( &dh, &dl, m[0], ( ak_int64 )md );
+  ak_mpzn_s128_mul_add( &eh, &el, m[0], ( ak_int64 )me );
+  ak_mpzn_s128_shift( &dh, &dl );
+  ak_mpzn_s128_shift( &eh, &el );
+
+  for( i = 1; i < n; i++ ) {
+     ak_mpzn_s128_mul_add( &dh, &dl, t->u, d[i] );
+     ak_mpzn_s128_mul_add( &dh, &dl, t->v, e[i] );
+     ak_mpzn_s128_mul_add( &dh, &dl, m[i], ( ak_int64 )md );
+     ak_mpzn_s128_mul_add( &eh, &el, t->q, d[i] );
+     ak_mpzn_s128_mul_add( &eh, &el, t->r, e[i] );
+     ak_mpzn_s128_mul_add( &eh, &el, m[i], ( ak_int64 )me );
+     d[i-1] = ( ak_int64 )( dl&ak_mpzn_s62_mask );
+     e[i-1] = ( ak_int64 )( el&ak_mpzn_s62_mask );
+     ak_mpzn_s128_shift( &dh, &dl );
+     ak_mpzn_s128_shift( &eh, &el );
+  }
+  d[n-1] = ( ak_int64 )dl;
+  e[n-1] = ( ak_int64 )el;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет обратный вычет по простому модулю \f$ p \f$ методом Бернштейна-Янга
+    (D.J. Bernstein, B.-Y. Yang, Fast constant-time gcd computation and modular inversion, 2019).
+
+    Если указатель r2 отличен от NULL и содержит значение \f$ r^2 \pmod{p} \f$, то вычет x
+    считается заданным в представлении Монтгомери \f$ x = x_0r \f$, и вычисляется
+    \f$ z \equiv x_0^{-1}r \pmod{p} \f$, то есть результат совпадает с результатом вызова
+    ak_mpzn_modpow_montgomery() со степенью \f$ p-2 \f$. Если r2 равен NULL, то вычисляется
+    обычный обратный вычет \f$ z \equiv x^{-1} \pmod{p} \f$. Для \f$ x = 0 \f$ результат
+    равен нулю.
+
+    Вычисления выполняются над знаковыми 62-х битными разрядами; количество шагов divstep
+    фиксировано и равно \f$ \lceil (49d + 57)/17 \rceil \f$, округленному вверх до кратного 62,
+    где \f$ d = 64\cdot size\f$. Шаги не содержат ветвлений, поэтому время работы функции
+    не зависит от значения обращаемого вычета, и ее можно применять к секретным значениям.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Обращаемый вычет, \f$ x < p \f$
+    @param p Простой нечетный модуль, по которому производятся вычисления
+    @param r2 Константа \f$ r^2 \pmod{p} \f$ или NULL
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p,
+                                                                ak_uint64 *r2, const size_t size )
+{
+  size_t i = 0, j = 0, n = 0, rounds = 0;
+  ak_int64 delta = 1;
+  ak_uint64 minv = 0, sign = 0, mask = 0;
+  struct mpzn_divsteps t;
+  ak_int64 m[ ak_mpzn_s62_max ], f[ ak_mpzn_s62_max ], g[ ak_mpzn_s62_max ],
+           d[ ak_mpzn_s62_max ], e[ ak_mpzn_s62_max ];
+
+  if(( size == 0 ) || ( size > ak_mpzn512_size )) {
+    ak_error_message( ak_error_wrong_length, __func__, "using an unexpected length of modulo" );
+    return;
+  }
+  if(( p[0]&1 ) == 0 ) {
+    ak_error_message( ak_error_undefined_value, __func__, "using an even value of modulo" );
+    return;
+  }
+
+  n = ( 64*size )/62 + 1;
+  rounds = (( 49*64*size + 57 + 16 )/17 + 61 )/62;
+
+ /* обратный к модулю по модулю 2^62 (итерации Ньютона) */
+  for( minv = p[0], i = 0; i < 5; i++ ) minv *= 2 - p[0]*minv;
+
+  ak_mpzn_to_s62( m, n, p, size );
+  ak_mpzn_to_s62( f, n, p, size );
+  ak_mpzn_to_s62( g, n, x, size );
+  memset( d, 0, sizeof( d ));
+  if( r2 == NULL ) {
+    memset( e, 0, sizeof( e ));
+    e[0] = 1;
+  } else ak_mpzn_to_s62( e, n, r2, size );
+
+ /* основной цикл: d*x = f, e*x = g (mod p) */
+  for( j = 0; j < rounds; j++ ) {
+     delta = ak_mpzn_divsteps_62( delta, ( ak_uint64 )f[0]|(( ak_uint64 )f[1] << 62 ),
+                                         ( ak_uint64 )g[0]|(( ak_uint64 )g[1] << 62 ), &t );
+     ak_mpzn_update_de_62( d, e, n, &t, m, minv );
+     ak_mpzn_update_fg_62( f, g, n, &t );
+  }
+
+ /* теперь g = 0, f = 1 или -1; приводим d*sign(f) к интервалу [0, p) */
+  sign = ak_mpzn_s62_sign( f[n-1] );
+  mask = ak_mpzn_s62_sign( d[n-1] );
+  for( i = 0; i < n; i++ ) d[i] = ( ak_int64 )(( ak_uint64 )d[i] + (( ak_uint64 )m[i]&mask ));
+  ak_mpzn_s62_carry( d, n );
+  for( i = 0; i < n; i++ ) d[i] = ( ak_int64 )((( ak_uint64 )d[i]^sign ) - sign );
+  ak_mpzn_s62_carry( d, n );
+  mask = ak_mpzn_s62_sign( d[n-1] );
+  for( i = 0; i < n; i++ ) d[i] = ( ak_int64 )(( ak_uint64 )d[i] + (( ak_uint64 )m[i]&mask ));
+  ak_mpzn_s62_carry( d, n );
+
+  ak_mpzn_from_s62( z, size, d, n );
+  memset( d, 0, sizeof( d ));
+  memset( e, 0, sizeof( e ));
+  memset( f, 0, sizeof( f ));
+  memset( g, 0, sizeof( g ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                     арифметика по модулям вида p = 2^n - c (псевдомерсенновы числа)             */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что модуль \f$ p \f$ имеет вид \f$ p = 2^n - c\f$, где \f$ n = 64\cdot size\f$,
+    а \f$ 0 < c < 2^{32} \f$. Для таких модулей, например для модуля
+    \f$ p = 2^{256} - 617 \f$ кривой id-tc26-gost-3410-2012-256-paramSetA или
+    \f$ p = 2^{512} - 569 \f$ кривой id-tc26-gost-3410-2012-512-paramSetA,
+    приведение по модулю выполняется без умножения на длинную константу.
+
+    @param p Проверяемый модуль
+    @param size Размер модуля в словах
+    @return Функция возвращает \ref ak_true, если модуль имеет указанный вид;
+    в противном случае возвращается \ref ak_false.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_mpzn_is_pseudo_mersenne( ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 c = ( ak_uint64 )0 - p[0];
+
+  if(( size == 0 ) || ( size > ak_mpzn512_size )) return ak_false;
+  for( i = 1; i < size; i++ ) if( p[i] != ( ak_uint64 )-1 ) return ak_false;
+  if(( c == 0 ) || ( c >= 0x100000000LL )) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Приведение вычета t длины 2*size слов по модулю \f$ p = 2^n - c\f$.
+
+    Используется сравнение \f$ 2^n \equiv c \pmod{p}\f$: старшая половина вычета умножается
+    на \f$ c \f$ и складывается с младшей, после чего аналогично приводится
+    оставшееся старшее слово. Заключительное вычитание модуля выполняется без ветвлений.          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_reduce_pseudo_mersenne( ak_uint64 *z, ak_uint64 *t,
+                                                             const ak_uint64 c, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 r[ ak_mpzn512_size ], s[ ak_mpzn512_size ], hi, lo, cy, mask;
+
+ /* r + hi*2^n = t_0 + c*t_1, при этом hi <= c */
+  for( i = 0, hi = 0; i < size; i++ ) {
+     umul_ppmm( cy, lo, c, t[size+i] );
+     lo += hi;
+     cy += lo < hi;
+     r[i] = t[i] + lo;
+     hi = cy + ( r[i] < lo );
+  }
+
+ /* r = r + hi*c; возможный перенос снова заменяется на c */
+  for( i = 0, cy = hi*c; i < size; i++ ) {
+     r[i] += cy;
+     cy = r[i] < cy;
+  }
+  for( i = 0, cy *= c; i < size; i++ ) {
+     r[i] += cy;
+     cy = r[i] < cy;
+  }
+
+ /* r < 2^n; если r >= p, то r - p = r + c - 2^n */
+  for( i = 0, cy = c; i < size; i++ ) {
+     s[i] = r[i] + cy;
+     cy = s[i] < cy;
+  }
+  mask = ( ak_uint64 )0 - cy;
+  for( i = 0; i < size; i++ ) z[i] = ( s[i]&mask )|( r[i]&~mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет \f$ z \equiv xy \pmod{p}\f$ для модуля \f$ p = 2^n - c\f$
+    (см. ak_mpzn_is_pseudo_mersenne()). В отличие от умножения Монтгомери, вычеты
+    используются в обычном представлении. Указатель на z может совпадать с указателями на x и y.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый множитель, \f$ x < p \f$
+    @param y Правый множитель, \f$ y < p \f$
+    @param p Модуль, по которому производятся вычисления
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                 ak_uint64 *p, const size_t size )
+{
+  ak_uint64 t[ 2*ak_mpzn512_size ];
+
+  switch( size ) {
+    case ak_mpzn256_size: mpzn_backend.mulw256( t, x, y ); break;
+    case ak_mpzn512_size: mpzn_backend.mulw512( t, x, y ); break;
+    default: ak_mpzn_mul_wide_portable( t, x, y, size );
+  }
+  ak_mpzn_reduce_pseudo_mersenne( z, t, ( ak_uint64 )0 - p[0], size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет \f$ z \equiv x^2 \pmod{p}\f$ для модуля \f$ p = 2^n - c\f$.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Возводимый в квадрат вычет, \f$ x < p \f$
+    @param p Модуль, по которому производятся вычисления
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  ak_uint64 t[ 2*ak_mpzn512_size ];
+
+  switch( size ) {
+    case ak_mpzn256_size: mpzn_backend.sqrw256( t, x ); break;
+    case ak_mpzn512_size: mpzn_backend.sqrw512( t, x ); break;
+    default: ak_mpzn_sqr_wide_portable( t, x, size );
+  }
+  ak_mpzn_reduce_pseudo_mersenne( z, t, ( ak_uint64 )0 - p[0], size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет \f$ z \equiv x + y \pmod{p}\f$ для модуля \f$ p = 2^n - c\f$.
+    Вместо вычитания модуля к сумме прибавляется константа \f$ c \f$, а выбор результата
+    выполняется без ветвлений.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левое слагаемое, \f$ x < p \f$
+    @param y Правое слагаемое, \f$ y < p \f$
+    @param p Модуль, по которому производятся вычисления
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_add_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                 ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 r[ ak_mpzn512_size ], s[ ak_mpzn512_size ], cy = 0, cs = 0, mask;
+
+  for( i = 0, cs = ( ak_uint64 )0 - p[0]; i < size; i++ ) {
+     r[i] = x[i] + cy;
+     cy = r[i] < cy;
+     r[i] += y[i];
+     cy += r[i] < y[i];
+
+     s[i] = r[i] + cs;
+     cs = s[i] < cs;
+  }
+ /* сумма не меньше p тогда и только тогда, когда возник перенос в x+y или в x+y+c */
+  mask = ( ak_uint64 )0 - ( cy|cs );
+  for( i = 0; i < size; i++ ) z[i] = ( s[i]&mask )|( r[i]&~mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет \f$ z \equiv x - y \pmod{p}\f$ для модуля \f$ p = 2^n - c\f$.
+    При возникновении заема к разности прибавляется модуль, что эквивалентно
+    вычитанию константы \f$ c \f$.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Уменьшаемое, \f$ x < p \f$
+    @param y Вычитаемое, \f$ y < p \f$
+    @param p Модуль, по которому производятся вычисления
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sub_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                 ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 av, bv, cy = 0;
+
+  for( i = 0; i < size; i++ ) {
+     av = x[i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - y[i];
+     cy += av > bv;
+     z[i] = av;
+  }
+  for( i = 0, cy *= ( ak_uint64 )0 - p[0]; i < size; i++ ) {
+     av = z[i];
+     z[i] = av - cy;
+     cy = z[i] > av;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет обратный элемент \f$ z \equiv x^{-1} \pmod{p} \f$
+    для модуля \f$ p = 2^n - c\f$. Поскольку вычеты хранятся в обычном представлении,
+    используется функция ak_mpzn_inverse_montgomery() без перевода в представление Монтгомери.
+    Для \f$ x = 0 \f$ результат равен нулю.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Обращаемый вычет, \f$ x < p \f$
+    @param p Простой модуль, по которому производятся вычисления
+    @param size Размер модуля в словах                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  ak_mpzn_inverse_montgomery( z, x, p, NULL, size );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /* преобразование "туда и обратно" */
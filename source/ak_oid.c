@@ -44,6 +44,7 @@
     "aead",
     "xcrypt",
     "descriptor",
+    "tree mode",
     "undefined mode"
 };
 
@@ -90,6 +91,7 @@
   - `1.2.643.2.52.1.5` базовые режимы работы блочных шифров,
   - `1.2.643.2.52.1.6` расширенные режимы работы блочных шифров,
   - `1.2.643.2.52.1.7` алгоритмы выработки имитовставки,
+  - `1.2.643.2.52.1.8` алгоритмы древовидного хеширования,
 
   - `1.2.643.2.52.1.10` алгоритмы выработки электронной подписи,
   - `1.2.643.2.52.1.11` алгоритмы проверки электронной подписи,
@@ -131,6 +133,10 @@
  static const char *asn1_streebog256_i[] = { "1.2.643.7.1.1.2.2", NULL };
  static const char *asn1_streebog512_n[] = { "streebog512", "md_gost12_512", NULL };
  static const char *asn1_streebog512_i[] = { "1.2.643.7.1.1.2.3", NULL };
+ static const char *asn1_streebog256_tree_n[] = { "streebog256-tree", NULL };
+ static const char *asn1_streebog256_tree_i[] = { "1.2.643.2.52.1.8.1", NULL };
+ static const char *asn1_streebog512_tree_n[] = { "streebog512-tree", NULL };
+ static const char *asn1_streebog512_tree_i[] = { "1.2.643.2.52.1.8.2", NULL };
  static const char *asn1_hmac_streebog256_n[] = { "hmac-streebog256", "HMAC-md_gost12_256", NULL };
  static const char *asn1_hmac_streebog256_i[] = { "1.2.643.7.1.1.4.1", NULL };
  static const char *asn1_hmac_streebog512_n[] = { "hmac-streebog512", "HMAC-md_gost12_512", NULL };
@@ -494,6 +500,16 @@ static struct oid libakrypt_oids[] =
                               ( ak_function_destroy_object *) ak_hash_destroy, NULL, NULL, NULL },
                               ak_object_undefined, (ak_function_run_object *) ak_hash_ptr, NULL }},
 
+ { hash_function, tree_mode, asn1_streebog256_tree_i, asn1_streebog256_tree_n, NULL,
+  {{ sizeof( struct hash_tree ), ( ak_function_create_object *) ak_hash_tree_create_streebog256,
+                         ( ak_function_destroy_object *) ak_hash_tree_destroy, NULL, NULL, NULL },
+                         ak_object_undefined, (ak_function_run_object *) ak_hash_tree_ptr, NULL }},
+
+ { hash_function, tree_mode, asn1_streebog512_tree_i, asn1_streebog512_tree_n, NULL,
+  {{ sizeof( struct hash_tree ), ( ak_function_create_object *) ak_hash_tree_create_streebog512,
+                         ( ak_function_destroy_object *) ak_hash_tree_destroy, NULL, NULL, NULL },
+                         ak_object_undefined, (ak_function_run_object *) ak_hash_tree_ptr, NULL }},
+
  { hmac_function, algorithm, asn1_hmac_streebog256_i, asn1_hmac_streebog256_n, NULL,
                             { ak_object_hmac_streebog256,
                               ak_object_undefined, (ak_function_run_object *) ak_hmac_ptr, NULL }},
@@ -768,6 +784,27 @@ static struct oid libakrypt_oids[] =
 
 /* ----------------------------------------------------------------------------------------------- */
 /*                           функции для создания объектов по oid                                  */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выделение памяти под контекст объекта (или массив контекстов).
+
+    Контексты, содержащие секретные ключи, наследуют выравнивание поля `key` структуры skey
+    (32 октета), поэтому память выделяется с тем же выравниванием; в противном случае
+    компилятор может использовать для доступа к полям контекста выровненные векторные инструкции
+    и обращение к памяти, выделенной функцией malloc(), приведет к аварийному завершению.
+
+    \param size Размер контекста объекта (в октетах).
+    \return Указатель на выделенную память; память освобождается функцией free().                 */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_object_aligned_malloc( const size_t size )
+{
+ return
+#if defined( AK_HAVE_STDALIGN_H ) && !defined( __MINGW32__ )
+  aligned_alloc( 32, ( size + 31 )&~(( size_t )31 ));
+#else
+  malloc( size );
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param oid Идентификатор создаваемого объекта
     \return Функция возвращает указатель на контекст созданного объекта. В случае возникновения
@@ -793,7 +830,7 @@ static struct oid libakrypt_oids[] =
     return NULL;
   }
 
-  if(( ctx = malloc( oid->func.first.size )) != NULL ) {
+  if(( ctx = ak_object_aligned_malloc( oid->func.first.size )) != NULL ) {
     if(( error = ((ak_function_create_object*)oid->func.first.create )( ctx )) != ak_error_ok ) {
       ak_error_message_fmt( error, __func__, "creation of the %s object failed",
                                                       ak_libakrypt_get_engine_name( oid->engine ));
@@ -833,7 +870,7 @@ static struct oid libakrypt_oids[] =
     return NULL;
   }
 
-  if(( ctx = malloc( oid->func.second.size )) != NULL ) {
+  if(( ctx = ak_object_aligned_malloc( oid->func.second.size )) != NULL ) {
     if(( error = ((ak_function_create_object*)oid->func.second.create )( ctx )) != ak_error_ok ) {
       ak_error_message_fmt( error, __func__, "creation of the %s object failed",
                                                       ak_libakrypt_get_engine_name( oid->engine ));
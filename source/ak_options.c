@@ -4,7 +4,7 @@
 /*  Файл ak_options.с                                                                              */
 /*  - содержит реализацию функций для работы с опциями библиотеки                                  */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_ERRNO_H
@@ -19,6 +19,8 @@
  typedef struct option {
   /*! \brief Человекочитаемое имя опции, используется для поиска и установки значения */
    char *name;
+  /*! \brief Индекс опции, должен совпадать с номером опции в массиве `options` */
+   option_index_t index;
   /*! \brief Численное значение опции (31 значащий бит + знак) */
    ak_int64 value;
   /*! \brief Минимально возможное значение */
@@ -28,31 +30,38 @@
  } *ak_option;
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Константные значения опций (значения по-умолчанию) */
+/*! Константные значения опций (значения по-умолчанию);
+    порядок опций должен совпадать с порядком значений типа option_index_t, что проверяется
+    функцией ak_libakrypt_test_options() при инициализации библиотеки */
  static struct option options[] = {
-     { "log_level", ak_log_standard, 0, 2 },
-     { "context_manager_size", 32, 32, 65536 },
-     { "context_manager_max_size", 4096, 4096, 2147483648 },
-     { "pbkdf2_iteration_count", 2000, 1000, 65536 },
-     { "hmac_key_count_resource", 65536, 1024, 2147483648 },
-     { "digital_signature_count_resource", 65536, 1024, 2147483648 },
+     { "log_level", log_level_option, ak_log_standard, 0, 2 },
+     { "context_manager_size", context_manager_size_option, 32, 32, 65536 },
+     { "context_manager_max_size", context_manager_max_size_option, 4096, 4096, 2147483648 },
+     { "pbkdf2_iteration_count", pbkdf2_iteration_count_option, 2000, 1000, 65536 },
+     { "hmac_key_count_resource", hmac_key_count_resource_option, 65536, 1024, 2147483648 },
+     { "digital_signature_count_resource", digital_signature_count_resource_option,
+                                                                         65536, 1024, 2147483648 },
 
   /* значение константы задает максимальный объем зашифрованной информации на одном ключе в 4 Mб:
                                  524288 блока x 8 байт на блок = 4.194.304 байт = 4096 Кб = 4 Mб   */
-     { "magma_cipher_resource", 524288, 1024, 2147483648 },
+     { "magma_cipher_resource", magma_cipher_resource_option, 524288, 1024, 2147483648 },
 
   /* значение константы задает максимальный объем зашифрованной информации на одном ключе в 32 Mб:
                              2097152 блока x 16 байт на блок = 33.554.432 байт = 32768 Кб = 32 Mб  */
-     { "kuznechik_cipher_resource", 2097152, 8196, 2147483648 },
-     { "acpkm_message_count", 4096, 128, 65536 },
-     { "acpkm_section_magma_block_count", 128, 128, 16777216 },
-     { "acpkm_section_kuznechik_block_count", 512, 512, 16777216 },
+     { "kuznechik_cipher_resource", kuznechik_cipher_resource_option, 2097152, 8196, 2147483648 },
+     { "acpkm_message_count", acpkm_message_count_option, 4096, 128, 65536 },
+     { "acpkm_section_magma_block_count", acpkm_section_magma_block_count_option,
+                                                                           128, 128, 16777216 },
+     { "acpkm_section_kuznechik_block_count", acpkm_section_kuznechik_block_count_option,
+                                                                           512, 512, 16777216 },
 
   /* при значении равным единицы, формат шифрования данных соответствует варианту OpenSSL */
-     { "openssl_compability", 0, 0, 1 },
+     { "openssl_compability", openssl_compability_option, 0, 0, 1 },
   /* флаг использования цвета при выводе сообщений библиотеки */
-     { "use_color_output", 1, 0, 1 },
-     { NULL, 0, 0, 0 } /* завершающая константа, должна всегда принимать нулевые значения */
+     { "use_color_output", use_color_output_option, 1, 0, 1 },
+  /* размер буффера (в октетах) для потокового чтения файлов: от 1 Мб до 16 Мб */
+     { "file_reader_buffer_size", file_reader_buffer_size_option, 4194304, 1048576, 16777216 },
+     { NULL, 0, 0, 0, 0 } /* завершающая константа, должна всегда принимать нулевые значения */
  };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -73,6 +82,29 @@
   return ( sizeof( options )/( sizeof( struct option ))-1 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что индекс каждой опции, указанный в массиве `options`, совпадает
+    с ее номером в этом массиве. Тем самым гарантируется, что функция ak_libakrypt_get_option()
+    возвращает значение именно той опции, которая задана значением типа option_index_t.
+
+    \return В случае успешной проверки возвращает \ref ak_true (истина).
+    В противном случае возвращается \ref ak_false.                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_options( void )
+{
+  size_t i = 0;
+
+  for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
+     if(( size_t )options[i].index != i ) {
+       ak_error_message_fmt( ak_error_wrong_option, __func__ ,
+                  "option %s has index %u instead of %u", options[i].name,
+                                               (unsigned int) options[i].index, (unsigned int) i );
+       return ak_false;
+     }
+  }
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param index Индекс опции, должен быть от нуля до значения,
     возвращаемого функцией ak_libakrypt_options_count().
@@ -87,7 +119,10 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! \param name Имя опции
+/*! Функция выполняет поиск опции по имени и сохранена для совместимости; при многократном
+    обращении к опциям следует использовать функцию ak_libakrypt_get_option().
+
+    \param name Имя опции
     \return Значение опции с заданным именем. Если имя указано неверно, то возвращается
     ошибка \ref ak_error_wrong_option.                                                             */
 /* ----------------------------------------------------------------------------------------------- */
@@ -96,11 +131,27 @@
   size_t i = 0;
   ak_int64 result = ak_error_wrong_option;
   for( i = 0; i < ak_libakrypt_options_count(); i++ ) {
-     if( strncmp( name, options[i].name, strlen( options[i].name )) == 0 ) result = options[i].value;
+     if( strncmp( name, options[i].name, strlen( options[i].name )) == 0 )
+       result = ak_libakrypt_get_option(( option_index_t ) i );
   }
  return result;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция не выполняет поиска опции по имени и может использоваться в тех местах,
+    где значение опции запрашивается при каждом вызове функции (например, при зашифровании
+    каждого пакета данных).
+
+    \param index Индекс опции.
+    \return Значение опции с заданным индексом. Если индекс указан неверно, то возвращается
+    ошибка \ref ak_error_wrong_option.                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_int64 ak_libakrypt_get_option( const option_index_t index )
+{
+  if(( size_t )index >= ak_libakrypt_options_count( )) return ak_error_wrong_option;
+ return options[index].value;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param index Индекс опции, должен быть от нуля до значения,
     возвращаемого функцией ak_libakrypt_options_count().
@@ -412,7 +463,7 @@
  if( ak_file_open_to_read( &fd, name ) == ak_error_ok ) {
    ak_file_close( &fd );
    if(( error = ak_ini_parse( name, ak_libakrypt_load_option_from_file, NULL )) == ak_error_ok ) {
-     if( ak_libakrypt_get_option_by_name( "log_level" ) > ak_log_standard )
+     if( ak_libakrypt_get_option( log_level_option ) > ak_log_standard )
        ak_error_message_fmt( ak_error_ok, __func__, "all options was read from %s file", name );
      return ak_true;
    } else {
@@ -431,7 +482,7 @@
  if( ak_file_open_to_read( &fd, name ) == ak_error_ok ) {
    ak_file_close( &fd );
    if(( error = ak_ini_parse( name, ak_libakrypt_load_option_from_file, NULL )) == ak_error_ok ) {
-     if( ak_libakrypt_get_option_by_name( "log_level" ) > ak_log_standard )
+     if( ak_libakrypt_get_option( log_level_option ) > ak_log_standard )
        ak_error_message_fmt( ak_error_ok, __func__, "all options was read from %s file", name );
      return ak_true;
    } else {
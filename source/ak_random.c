@@ -197,13 +197,21 @@
 
 /* ----------------------------------------------------------------------------------------------- */
 /*                                 реализация класса rng_lcg                                       */
+/*! \brief Константы линейного сравнения, определяющего генератор lcg. */
+ #define ak_lcg_a  (125643267795740073ULL)
+ #define ak_lcg_c  (506098983240188723ULL)
+/*! \brief Константы, позволяющие вычислить состояние генератора lcg на четыре шага вперед:
+    \f$ x_{n+4} \equiv a^4x_n + c(a^3+a^2+a+1) \pmod{2^{64}}. \f$ */
+ #define ak_lcg_a4 ( ak_lcg_a*ak_lcg_a*ak_lcg_a*ak_lcg_a )
+ #define ak_lcg_c4 ( ak_lcg_c*( ak_lcg_a*ak_lcg_a*ak_lcg_a + ak_lcg_a*ak_lcg_a + ak_lcg_a + 1 ))
+
 /* ----------------------------------------------------------------------------------------------- */
  static int ak_random_lcg_next( ak_random rnd )
 {
   if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                       "use a null pointer to a random generator" );
-  rnd->data.val *= 125643267795740073ULL;
-  rnd->data.val += 506098983240188723ULL;
+  rnd->data.val *= ak_lcg_a;
+  rnd->data.val += ak_lcg_c;
 
  return ak_error_ok;
 }
@@ -242,6 +250,21 @@
                                                                     "use a null pointer to data" );
   if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
                                                            "use a data vector with wrong length" );
+ /* длинные последовательности вырабатываются четырьмя независимыми потоками,
+    каждый из которых пропускает по три состояния генератора */
+  if( size >= 16 ) {
+    ak_uint64 x0 = rnd->data.val, x1 = x0*ak_lcg_a + ak_lcg_c,
+              x2 = x1*ak_lcg_a + ak_lcg_c, x3 = x2*ak_lcg_a + ak_lcg_c;
+    for( ; idx + 4 <= size; idx += 4 ) {
+       value[idx] = (ak_uint8)( x0 >> 16 ); x0 = x0*ak_lcg_a4 + ak_lcg_c4;
+       value[idx+1] = (ak_uint8)( x1 >> 16 ); x1 = x1*ak_lcg_a4 + ak_lcg_c4;
+       value[idx+2] = (ak_uint8)( x2 >> 16 ); x2 = x2*ak_lcg_a4 + ak_lcg_c4;
+       value[idx+3] = (ak_uint8)( x3 >> 16 ); x3 = x3*ak_lcg_a4 + ak_lcg_c4;
+    }
+    rnd->data.val = x0;
+    if( idx == size ) return ak_error_ok;
+  }
+
   lab_start:
     value[idx] = (ak_uint8) ( rnd->data.val >> 16 );
     rnd->next( rnd );
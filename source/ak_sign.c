@@ -9,6 +9,9 @@
 #ifdef AK_HAVE_TIME_H
  #include <time.h>
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Установление или изменение маски секретного ключа ассиметричного криптографического
@@ -37,7 +40,7 @@
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpznmax u, zeta;
+  ak_mpznmax zeta;
   ak_wcurve wc = NULL;
   int error = ak_error_ok;
   ak_uint64 *key = NULL, *mask = NULL;
@@ -80,10 +83,7 @@
      ak_mpzn_mul_montgomery( key, key, mask, wc->q, wc->nq, wc->size);
 
     /* вычисляем обратное значение для маски */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( mask, // m <- m^{q-2} (mod q)
-                                    mask, u, wc->q, wc->nq, wc->size );
+     ak_mpzn_inverse_montgomery( mask, mask, wc->q, wc->r2q, wc->size ); // m <- m^{-1} (mod q)
     /* меняем значение флага */
      skey->flags |= ak_key_flag_set_mask;
 
@@ -100,9 +100,7 @@
     /* домножаем ключ на случайное число */
      ak_mpzn_mul_montgomery( key, key, zeta, wc->q, wc->nq, wc->size );
     /* вычисляем обратное значение zeta */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( zeta, zeta, u, wc->q, wc->nq, wc->size ); // z <- z^{q-2} (mod q)
+     ak_mpzn_inverse_montgomery( zeta, zeta, wc->q, wc->r2q, wc->size ); // z <- z^{-1} (mod q)
 
     /* домножаем маску на обратное значение zeta */
      ak_mpzn_mul_montgomery( mask, mask, zeta, wc->q, wc->nq, wc->size );
@@ -594,7 +592,7 @@
 
  /* поскольку функция не экспортируется, мы оставляем все проверки функциям верхнего уровня */
  /* вычисляем r */
-  ak_wpoint_pow( &wr, &wc->point, k, wc->size, wc );
+  ak_wpoint_pow_fixed_base( &wr, k, wc->size, wc );
   ak_wpoint_reduce( &wr, wc );
   ak_mpzn_rem( r, wr.x, wc->q, wc->size );
 
@@ -738,7 +736,10 @@
     @return Функция возвращает NULL, если указатель out не есть NULL, в противном случае
     возвращается указатель на буффер, содержащий вектор с электронной подписью. В случае
     возникновения ошибки возвращается NULL, при этом код ошибки может быть получен с помощью
-    вызова функции ak_error_get_value().                                                           */
+    вызова функции ak_error_get_value().
+
+    Хеш-код файла вычисляется функцией ak_hash_file(), которая, по возможности,
+    отображает файл в память.                                                                      */
 /* ----------------------------------------------------------------------------------------------- */
  int ak_signkey_sign_file( ak_signkey sctx, ak_random generator, const char *filename,
                                                                    ak_pointer out, size_t out_size )
@@ -875,7 +876,7 @@
  /* теперь определяем открытый ключ */
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)sctx->key.key, one,
                                                       pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_wpoint_pow( &pctx->qpoint, &pctx->wc->point, k, pctx->wc->size, pctx->wc );
+  ak_wpoint_pow_fixed_base( &pctx->qpoint, k, pctx->wc->size, pctx->wc );
 
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)( sctx->key.key + sctx->key.key_size ),
                                                   one, pctx->wc->q, pctx->wc->nq, pctx->wc->size);
@@ -955,22 +956,22 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! @param pctx контекст открытого ключа.
-    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
-    @param hsize размер хеш-кода, в байтах.
-    @param sign электронная подпись, для которой выполняется проверка.
-    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
-    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
-    вызова функции ak_error_get_value().                                                           */
+/*! \brief Функция проверяет входные данные и импортирует электронную подпись.
+
+    Функция вычисляет значения \f$ r \f$, \f$ s \f$, а также значение \f$ v \f$,
+    равное вычету \f$ h \pmod{q} \f$ (или единице, если вычет равен нулю) в представлении
+    Монтгомери; обращение \f$ v \f$ выполняется вызывающей функцией.
+
+    @return Функция возвращает истину, если входные данные корректны.                             */
 /* ----------------------------------------------------------------------------------------------- */
- bool_t ak_verifykey_verify_hash( ak_verifykey pctx,
-                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+ static bool_t ak_verifykey_verify_import( ak_verifykey pctx, const ak_pointer hash,
+                                   const size_t hsize, ak_pointer sign, ak_uint64 *r, ak_uint64 *s,
+                                                                                    ak_uint64 *v )
 {
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpzn512 v, z1, z2, u, r, s, h;
-  struct wpoint cpoint, tpoint;
+  ak_mpzn512 h;
 
   if( pctx == NULL ) {
     ak_error_message( ak_error_null_pointer, __func__,
@@ -1005,10 +1006,18 @@
   if( ak_mpzn_cmp_ui( v, pctx->wc->size, 0 )) ak_mpzn_set_ui( v, pctx->wc->size, 1 );
   ak_mpzn_mul_montgomery( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
-  /* вычисляем v (в представлении Монтгомери) */
-  ak_mpzn_set_ui( u, pctx->wc->size, 2 );
-  ak_mpzn_sub( u, pctx->wc->q, u, pctx->wc->size );
-  ak_mpzn_modpow_montgomery( v, v, u, pctx->wc->q, pctx->wc->nq, pctx->wc->size ); // v <- v^{q-2} (mod q)
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет точку \f$ C = [z_1]P + [z_2]Q \f$ для заданных значений
+    \f$ r \f$, \f$ s \f$ и обратного (в представлении Монтгомери) значения \f$ v \f$.
+    Точка не приводится к аффинной форме.                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_verify_point( ak_verifykey pctx, ak_uint64 *r, ak_uint64 *s,
+                                                                  ak_uint64 *v, ak_wpoint cpoint )
+{
+  ak_mpzn512 z1, z2;
 
   /* вычисляем z1 */
   ak_mpzn_mul_montgomery( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
@@ -1021,20 +1030,51 @@
   ak_mpzn_mul_montgomery( z2, z2, v, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
   ak_mpzn_mul_montgomery( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
- /* сложение точек и проверка */
-  ak_wpoint_pow( &cpoint, &pctx->wc->point, z1, pctx->wc->size, pctx->wc );
-  ak_wpoint_pow( &tpoint, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
-  ak_wpoint_add( &cpoint, &tpoint, pctx->wc );
-  ak_wpoint_reduce( &cpoint, pctx->wc );
-  ak_mpzn_rem( cpoint.x, cpoint.x, pctx->wc->q, pctx->wc->size );
+ /* сложение точек */
+  ak_wpoint_pow_sum( cpoint, z1, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция сравнивает абсциссу приведенной к аффинной форме точки \f$ C \f$
+    со значением \f$ r \f$.                                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_verifykey_verify_compare( ak_verifykey pctx, ak_wpoint cpoint, ak_uint64 *r )
+{
+  ak_mpzn_rem( cpoint->x, cpoint->x, pctx->wc->q, pctx->wc->size );
 
-  if( ak_mpzn_cmp( cpoint.x, r, pctx->wc->size )) {
-    ak_ptr_is_equal_with_log( cpoint.x, r, pctx->wc->size*sizeof( ak_uint64 ));
+  if( ak_mpzn_cmp( cpoint->x, r, pctx->wc->size )) {
+    ak_ptr_is_equal_with_log( cpoint->x, r, pctx->wc->size*sizeof( ak_uint64 ));
     return ak_false;
   }
  return ak_true;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param pctx контекст открытого ключа.
+    @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
+    @param hsize размер хеш-кода, в байтах.
+    @param sign электронная подпись, для которой выполняется проверка.
+    @return Функция возыращает истину, если подпись верна. Если функция не верна или если
+    возникла ошибка, то возвращается ложь. Код Ошибки может получен с помощью
+    вызова функции ak_error_get_value().                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_verifykey_verify_hash( ak_verifykey pctx,
+                                        const ak_pointer hash, const size_t hsize, ak_pointer sign )
+{
+  ak_mpzn512 v, r, s;
+  struct wpoint cpoint;
+
+  if( !ak_verifykey_verify_import( pctx, hash, hsize, sign, r, s, v )) return ak_false;
+
+  /* вычисляем v (в представлении Монтгомери) */
+  ak_mpzn_inverse_montgomery( v, v, pctx->wc->q, pctx->wc->r2q, pctx->wc->size ); // v <- v^{-1} (mod q)
+
+ /* вычисление точки и проверка */
+  ak_verifykey_verify_point( pctx, r, s, v, &cpoint );
+  ak_wpoint_reduce( &cpoint, pctx->wc );
+ return ak_verifykey_verify_compare( pctx, &cpoint, r );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param pctx контекст открытого ключа.
     @param in область памяти для которой проверяется электронная подпись.
@@ -1116,6 +1156,226 @@
  return ak_verifykey_verify_hash( pctx, hash, pctx->ctx.data.sctx.hsize, sign );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество подписей, обрабатываемых совместно (с общим обращением вычетов). */
+ #define ak_verifykey_batch_block           (32)
+/*! \brief Минимальное количество подписей, проверяемых одним потоком. */
+ #define ak_verifykey_batch_thread_min     (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Фрагмент массива подписей, проверяемый одним потоком. */
+ typedef struct verifykey_batch {
+  /*! \brief Массив открытых ключей. */
+   ak_verifykey *keys;
+  /*! \brief Массив сообщений или хеш-кодов. */
+   ak_pointer *data;
+  /*! \brief Массив длин сообщений или хеш-кодов. */
+   size_t *sizes;
+  /*! \brief Массив подписей. */
+   ak_pointer *signs;
+  /*! \brief Массив результатов проверки. */
+   bool_t *results;
+  /*! \brief Количество подписей во фрагменте. */
+   size_t count;
+  /*! \brief Флаг того, что массив data содержит хеш-коды. */
+   bool_t hashed;
+#ifdef AK_HAVE_PTHREAD_H
+  /*! \brief Флаг успешного запуска потока. */
+   bool_t started;
+  /*! \brief Идентификатор потока. */
+   pthread_t thread;
+#endif
+ } *ak_verifykey_batch;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка не более \ref ak_verifykey_batch_block подписей.
+
+    Хеш-коды сообщений, вырабатываемые с помощью одной функции хеширования, вычисляются
+    одновременно функцией ak_hash_ptr_multi(), не изменяющей контекст хеширования ключа.
+    Обращение вычетов по модулю порядка подгруппы, а также приведение точек к аффинной форме
+    выполняются совместно для всех подписей, использующих одну эллиптическую кривую.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_verify_batch_block( ak_verifykey_batch bt, const size_t offset,
+                                                                               const size_t count )
+{
+  size_t i = 0, j = 0, cnt = 0;
+  ak_wcurve wc = NULL;
+  ak_uint8 hashes[ ak_verifykey_batch_block ][64];
+  ak_pointer hin[ ak_verifykey_batch_block ], hout[ ak_verifykey_batch_block ];
+  size_t hsizes[ ak_verifykey_batch_block ], idx[ ak_verifykey_batch_block ];
+  ak_uint64 *vp[ ak_verifykey_batch_block ];
+  ak_uint64 buffer[ ak_verifykey_batch_block*ak_mpzn512_size ];
+  ak_mpzn512 r[ ak_verifykey_batch_block ], s[ ak_verifykey_batch_block ],
+                                                                     v[ ak_verifykey_batch_block ];
+  struct wpoint cpoint[ ak_verifykey_batch_block ];
+  bool_t valid[ ak_verifykey_batch_block ], done[ ak_verifykey_batch_block ];
+  ak_verifykey *keys = bt->keys + offset;
+  bool_t *results = bt->results + offset;
+
+  for( i = 0; i < count; i++ ) {
+     results[i] = done[i] = ak_false;
+     if(( valid[i] = (( keys[i] != NULL ) && ( keys[i]->wc != NULL ))) != ak_true )
+       ak_error_message( ak_error_null_pointer, __func__, "using null pointer to public key" );
+     if( valid[i] && ( bt->data[offset+i] == NULL )) {
+       ak_error_message( ak_error_null_pointer, __func__, "using null pointer to verifying value" );
+       valid[i] = ak_false;
+     }
+  }
+
+ /* вычисляем хеш-коды сообщений, группируя их по используемой функции хеширования */
+  if( !bt->hashed ) {
+    for( i = 0; i < count; i++ ) {
+       if( !valid[i] || done[i] ) continue;
+       for( j = i, cnt = 0; j < count; j++ ) {
+          if( !valid[j] || done[j] || ( keys[j]->ctx.oid != keys[i]->ctx.oid )) continue;
+          hin[cnt] = bt->data[offset+j];
+          hsizes[cnt] = bt->sizes[offset+j];
+          hout[cnt] = hashes[j];
+          idx[cnt++] = j;
+          done[j] = ak_true;
+       }
+       if( ak_hash_ptr_multi( &keys[i]->ctx, cnt, hin, hsizes, hout, 64 ) != ak_error_ok ) {
+         ak_error_message( ak_error_get_value(), __func__, "wrong calculation of hash values" );
+         while( cnt-- > 0 ) valid[idx[cnt]] = ak_false;
+       }
+    }
+  }
+
+ /* импортируем подписи */
+  for( i = 0; i < count; i++ ) {
+     done[i] = ak_false;
+     if( !valid[i] ) continue;
+     if( bt->hashed ) valid[i] = ak_verifykey_verify_import( keys[i], bt->data[offset+i],
+                                         bt->sizes[offset+i], bt->signs[offset+i], r[i], s[i], v[i] );
+      else valid[i] = ak_verifykey_verify_import( keys[i], hashes[i],
+                            keys[i]->ctx.data.sctx.hsize, bt->signs[offset+i], r[i], s[i], v[i] );
+  }
+
+ /* для каждой эллиптической кривой обращаем вычеты v, вычисляем точки C,
+    приводим их к аффинной форме и сравниваем с r */
+  for( i = 0; i < count; i++ ) {
+     if( !valid[i] || done[i] ) continue;
+     for( j = i, cnt = 0, wc = keys[i]->wc; j < count; j++ ) {
+        if( !valid[j] || done[j] || ( keys[j]->wc != wc )) continue;
+        idx[cnt] = j;
+        vp[cnt++] = v[j];
+        done[j] = ak_true;
+     }
+     ak_mpzn_inverse_batch_montgomery( vp, cnt, buffer, wc->q, wc->nq, wc->r2q, wc->size );
+     for( j = 0; j < cnt; j++ )
+        ak_verifykey_verify_point( keys[idx[j]], r[idx[j]], s[idx[j]], v[idx[j]], cpoint+j );
+     ak_wpoint_reduce_batch( cpoint, cnt, wc );
+     for( j = 0; j < cnt; j++ )
+        results[idx[j]] = ak_verifykey_verify_compare( keys[idx[j]], cpoint+j, r[idx[j]] );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция, выполняемая отдельным потоком. */
+ static void *ak_verifykey_verify_batch_run( void *ptr )
+{
+  size_t offset = 0;
+  ak_verifykey_batch bt = ( ak_verifykey_batch ) ptr;
+
+  for( offset = 0; offset < bt->count; offset += ak_verifykey_batch_block )
+     ak_verifykey_verify_batch_block( bt, offset,
+                                    ak_min( bt->count - offset, ak_verifykey_batch_block ));
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет массив из `count` электронных подписей, для каждой из которых задается
+    открытый ключ, сообщение (или хеш-код сообщения) и значение подписи. Результат проверки
+    каждой подписи помещается в соответствующий элемент массива `results`; результат совпадает
+    с результатом функций ak_verifykey_verify_ptr() или ak_verifykey_verify_hash().
+
+    По сравнению с последовательной проверкой подписей функция
+     \li вычисляет хеш-коды нескольких сообщений одновременно (см. ak_hash_ptr_multi());
+     \li использует общие для всех подписей на одной эллиптической кривой таблицы кратных
+         образующей точки (см. ak_wpoint_pow_sum());
+     \li заменяет обращения вычетов, выполняемые для каждой подписи при вычислении
+         \f$ h^{-1} \pmod{q} \f$ и при приведении точки к аффинной форме, совместным обращением
+         (см. ak_mpzn_inverse_batch_montgomery() и ak_wpoint_reduce_batch());
+     \li распределяет подписи между несколькими потоками.
+
+    Контексты открытых ключей не изменяются, поэтому один и тот же ключ может
+    встречаться в массиве `keys` произвольное количество раз.
+
+    @param keys Массив указателей на контексты открытых ключей.
+    @param data Массив указателей на сообщения или, если `hashed` истинно, на хеш-коды сообщений.
+    @param sizes Массив длин сообщений или хеш-кодов (в октетах).
+    @param signs Массив указателей на проверяемые подписи.
+    @param count Количество проверяемых подписей.
+    @param hashed Истина, если массив `data` содержит хеш-коды сообщений.
+    @param results Массив, в который помещаются результаты проверки подписей.
+    @param threads Максимальное количество используемых потоков (значение ноль
+    эквивалентно одному потоку). Если библиотека собрана без поддержки pthreads,
+    значение игнорируется.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok (что не означает
+    корректность подписей, результаты проверки которых помещаются в массив `results`).
+    В противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_verify_batch( ak_verifykey *keys, ak_pointer *data, size_t *sizes,
+                                    ak_pointer *signs, const size_t count, const bool_t hashed,
+                                                          bool_t *results, const size_t threads )
+{
+  struct verifykey_batch main;
+#ifdef AK_HAVE_PTHREAD_H
+  ak_verifykey_batch ths = NULL;
+  size_t idx = 0, part = 0, offset = 0,
+         cnt = ak_min( threads, count/ak_verifykey_batch_thread_min );
+#endif
+
+  if(( keys == NULL ) || ( data == NULL ) || ( sizes == NULL ) ||
+                                                         ( signs == NULL ) || ( results == NULL ))
+    return ak_error_message( ak_error_null_pointer, __func__,
+                                                 "using null pointer to array of batch elements" );
+  if( !count ) return ak_error_ok;
+
+  memset( &main, 0, sizeof( struct verifykey_batch ));
+  main.keys = keys;
+  main.data = data;
+  main.sizes = sizes;
+  main.signs = signs;
+  main.results = results;
+  main.count = count;
+  main.hashed = hashed;
+
+#ifdef AK_HAVE_PTHREAD_H
+  if(( cnt > 1 ) && (( ths = calloc( cnt-1, sizeof( struct verifykey_batch ))) != NULL )) {
+   /* первый фрагмент содержит остаток от деления подписей между потоками */
+    part = count/cnt;
+    main.count = offset = part + count%cnt;
+    for( idx = 0; idx < cnt-1; idx++ ) {
+       ths[idx] = main;
+       ths[idx].keys = keys + offset;
+       ths[idx].data = data + offset;
+       ths[idx].sizes = sizes + offset;
+       ths[idx].signs = signs + offset;
+       ths[idx].results = results + offset;
+       ths[idx].count = part;
+       offset += part;
+    }
+    for( idx = 0; idx < cnt-1; idx++ )
+       ths[idx].started = ( pthread_create( &ths[idx].thread, NULL,
+                              ak_verifykey_verify_batch_run, ths+idx ) == 0 ) ? ak_true : ak_false;
+    ak_verifykey_verify_batch_run( &main );
+
+   /* дожидаемся завершения потоков; фрагменты, для которых поток не был создан,
+      обрабатываем самостоятельно */
+    for( idx = 0; idx < cnt-1; idx++ ) {
+       if( ths[idx].started ) pthread_join( ths[idx].thread, NULL );
+         else ak_verifykey_verify_batch_run( ths+idx );
+    }
+    free( ths );
+  } else
+#endif
+   ak_verifykey_verify_batch_run( &main );
+
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param vk контекст открытого ключа электронной подписи
     @param ni строка, содержащая имя или идентификатор, определяющий тип помещаемых
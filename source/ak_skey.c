@@ -4,7 +4,7 @@
 /*  Файл ak_skey.c                                                                                 */
 /*  - содержит реализации функций, предназначенных для хранения и обработки ключевой информации.   */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_TIME_H
@@ -52,6 +52,22 @@
   return counter_resource_names[rt];
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \param mp Политика проверки контрольной суммы и смены маски ключа.
+    \return Функция возвращает константную строку на человеко читаемое имя политики.              */
+/* ----------------------------------------------------------------------------------------------- */
+ const char *ak_libakrypt_get_mask_policy_name( const mask_policy_t mp )
+{
+  const char *mask_policy_names[] = {
+    "every call",
+    "every N calls",
+    "every N bytes",
+    "every N seconds"
+  };
+
+  return mask_policy_names[mp];
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Выработанный функцией номер является уникальным (в рамках библиотеки) и может однозначно
     идентифицировать некоторый объект, например, секретный ключ.
@@ -292,6 +308,7 @@
   skey->icode = 0; /* контрольная сумма ключа не задана */
   skey->data = NULL; /* внутренние данные ключа не определены */
   memset( &(skey->resource), 0, sizeof( struct resource )); /* ресурс ключа не определен */
+  skey->pool.offset = ak_key_mask_pool_size; /* запас случайных масок пока не выработан */
 
  /* инициализируем генератор масок */
   if(( error = ak_random_create_lcg( &skey->generator )) != ak_error_ok ) {
@@ -373,6 +390,7 @@
 /*! Функция вырабатывает случайный вектор \f$ v \f$ длины, совпадающей с длиной ключа,
     и заменяет значение ключа \f$ k \f$ на величину \f$ k \oplus v \f$.
     Значение вектора \f$ v \f$ сохраняется в контексте секретного ключа.
+    Случайный вектор берется из запаса масок ключа, см. ak_skey_get_random_from_pool().
 
     @param skey Контекст секретного ключа.
     @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
@@ -393,8 +411,8 @@
  /* проверяем, установлена ли маска ранее */
   if((( skey->flags)&ak_key_flag_set_mask ) == 0 ) {
     /* создаем маску*/
-     if(( error = ak_random_ptr( &skey->generator,
-                             skey->key+skey->key_size, (ssize_t)skey->key_size )) != ak_error_ok )
+     if(( error = ak_skey_get_random_from_pool( skey,
+                                     skey->key+skey->key_size, skey->key_size )) != ak_error_ok )
        return ak_error_message( error, __func__ ,
                                                  "wrong generation a random mask for key buffer" );
     /* накладываем маску на ключ */
@@ -411,7 +429,7 @@
 
          /* сначала обрабатываем полные блоки */
           for( jdx = 0; jdx < blocks; jdx++, offset += sizeof( newmask )) {
-             if(( error = ak_random_ptr( &skey->generator,
+             if(( error = ak_skey_get_random_from_pool( skey,
                                                      newmask, sizeof( newmask ))) != ak_error_ok )
                return ak_error_message( error, __func__ ,
                                                  "wrong generation a random mask for key buffer" );
@@ -422,8 +440,8 @@
           }
          /* потом обрабатываем хвост */
           if( tail ) {
-            if(( error = ak_random_ptr( &skey->generator,
-                                                       newmask, (ssize_t)tail )) != ak_error_ok )
+            if(( error = ak_skey_get_random_from_pool( skey,
+                                                               newmask, tail )) != ak_error_ok )
               return ak_error_message( error, __func__ ,
                                                   "wrong random mask generation for key buffer" );
             for( idx = 0; idx < tail; idx++ ) {
@@ -529,6 +547,140 @@
     else return ak_false;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! По умолчанию (политика \ref every_call_mask_policy) контрольная сумма ключа проверяется,
+    а маска ключа сменяется при каждом вызове функции, использующей ключ (например, режима
+    шифрования). Для коротких сообщений эти действия требуют больше времени, чем собственно
+    зашифрование, поэтому функция позволяет выполнять их только при каждом `value`-м вызове,
+    после обработки каждых `value` октетов или по истечении `value` секунд.
+
+    \param skey Контекст секретного ключа.
+    \param type Тип политики.
+    \param value Период проверки и смены маски; для политики \ref every_call_mask_policy
+    значение игнорируется, для остальных политик должно быть отлично от нуля.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_set_mask_policy( ak_skey skey, const mask_policy_t type, const ak_uint64 value )
+{
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  switch( type ) {
+    case every_call_mask_policy:
+      break;
+    case call_count_mask_policy:
+    case byte_count_mask_policy:
+    case time_interval_mask_policy:
+      if( !value ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                      "using a zero period for key mask policy" );
+      break;
+    default: return ak_error_message( ak_error_undefined_value, __func__ ,
+                                                            "using undefined key mask policy" );
+  }
+
+  skey->resource.mask.type = type;
+  skey->resource.mask.value = value;
+  skey->resource.mask.counter = 0;
+  skey->resource.mask.last = time( NULL );
+  skey->flags &= ~ak_key_flag_mask_due;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается в начале каждой функции, использующей ключ, вместо метода check_icode.
+    Если в соответствии с политикой ключа (см. ak_skey_set_mask_policy()) проверка
+    на данном вызове не требуется, функция только изменяет счетчик политики и возвращает истину.
+    В противном случае выполняется проверка контрольной суммы, а ключ помечается как
+    подлежащий перемаскированию функцией ak_skey_set_mask_with_policy().
+
+    \param skey Контекст секретного ключа.
+    \param size Количество октетов, обрабатываемых при данном вызове.
+    \return В случае совпадения контрольной суммы ключа, а также в случае, когда проверка
+    не выполнялась, функция возвращает истину (\ref ak_true). В противном случае,
+    возвращается ложь (\ref ak_false).                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_skey_check_icode_with_policy( ak_skey skey, const size_t size )
+{
+  time_t now = 0;
+  ak_key_mask_policy mp = &skey->resource.mask;
+
+  switch( mp->type ) {
+    case call_count_mask_policy:
+      if( ++mp->counter < mp->value ) return ak_true;
+      break;
+    case byte_count_mask_policy:
+      if(( mp->counter += size ) < mp->value ) return ak_true;
+      break;
+    case time_interval_mask_policy:
+      if(( now = time( NULL )) - mp->last < ( time_t )mp->value ) return ak_true;
+      mp->last = now;
+      break;
+    default:
+      return skey->check_icode( skey );
+  }
+
+  mp->counter = 0;
+  skey->flags |= ak_key_flag_mask_due;
+ return skey->check_icode( skey );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вызывается в конце каждой функции, использующей ключ, вместо метода set_mask.
+    Маска сменяется, если этого требует политика \ref every_call_mask_policy или если
+    при последнем вызове функции ak_skey_check_icode_with_policy() была выполнена проверка
+    контрольной суммы ключа.
+
+    \param skey Контекст секретного ключа.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_set_mask_with_policy( ak_skey skey )
+{
+  if( skey->resource.mask.type != every_call_mask_policy ) {
+    if( !( skey->flags&ak_key_flag_mask_due )) return ak_error_ok;
+    skey->flags &= ~ak_key_flag_mask_due;
+  }
+ return skey->set_mask( skey );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция копирует в заданную область памяти очередной фрагмент запаса случайных данных,
+    выработанных генератором масок ключа. При исчерпании запаса он заполняется заново
+    одним обращением к генератору. Тем самым, функции смены маски и функции
+    маскированного зашифрования не обращаются к генератору при каждом вызове.
+
+    Значение смещения считывается однократно, поэтому при одновременном использовании ключа
+    несколькими потоками выход за границы буфера невозможен; в худшем случае разные потоки
+    получат один и тот же фрагмент случайных данных.
+
+    \param skey Контекст секретного ключа.
+    \param out Область памяти, в которую помещаются случайные данные.
+    \param size Количество копируемых октетов.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_get_random_from_pool( ak_skey skey, ak_pointer out, const size_t size )
+{
+  int error = ak_error_ok;
+  size_t offset = skey->pool.offset;
+
+ /* слишком большие фрагменты вырабатываются генератором напрямую */
+  if( size > ak_key_mask_pool_size )
+    return ak_random_ptr( &skey->generator, out, ( ssize_t )size );
+
+  if(( offset > ak_key_mask_pool_size ) || ( size > ak_key_mask_pool_size - offset )) {
+    if(( error = ak_random_ptr( &skey->generator,
+                                 skey->pool.buffer, ak_key_mask_pool_size )) != ak_error_ok )
+      return ak_error_message( error, __func__ , "wrong refill of key mask pool" );
+    offset = 0;
+  }
+  skey->pool.offset = offset + size;
+  memcpy( out, skey->pool.buffer + offset, size );
+
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Присвоение времени происходит следующим образом. Если `not_before` равно нулю, то
     устанавливается текущее время. Если `not_after` равно нулю или меньше, чем `not_before`,
@@ -615,6 +767,36 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция аналогична функции ak_skey_set_resource_values(), однако опция, значение которой
+    присваивается счетчику ресурса, задается индексом, а не именем; функция используется
+    при каждой смене значения ключа (например, при выработке производных ключей в режиме ACPKM).
+
+    \param skey Контекст секретного ключа.
+    \param type Тип присваиваемого ресурса.
+    \param option Индекс опции, значение которой присваивается.
+    \param not_before Время, начиная с которого ключ действителен. Значение, равное нулю,
+    означает, что будет установлено текущее время.
+    \param not_after Время, начиная с которого ключ недействителен.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_skey_set_resource_values_by_index( ak_skey skey, counter_resource_t type,
+                                 const option_index_t option, time_t not_before, time_t not_after )
+{
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  ak_skey_set_validity( skey, not_before, not_after );
+  switch( skey->resource.value.type = type ) {
+    case block_counter_resource:
+    case key_using_resource:
+      if(( skey->resource.value.counter =
+                   ak_libakrypt_get_option( option )) != ak_error_wrong_option ) return ak_error_ok;
+        else return ak_error_wrong_option;
+  }
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \param skey Контекст секретного ключа.
     \param label Указатель на последовательность символов
@@ -789,7 +971,7 @@
                                                              "using a password with zero length" );
  /* присваиваем буффер и маскируем его */
   if(( error = ak_hmac_pbkdf2_streebog512( pass, pass_size, salt, salt_size,
-                   (const size_t) ak_libakrypt_get_option_by_name( "pbkdf2_iteration_count" ),
+                   (const size_t) ak_libakrypt_get_option( pbkdf2_iteration_count_option ),
                                                      skey->key_size, skey->key )) != ak_error_ok )
     return ak_error_message( error, __func__ , "wrong generation a secret key data" );
   memset( skey->key+skey->key_size, 0, skey->key_size ); /* обнуляем массив масок */
@@ -861,6 +1043,9 @@
                               skey->resource.value.type == block_counter_resource ? bc : rc );
   fprintf( fp, " not before: %s", ctime( &skey->resource.time.not_before ));
   fprintf( fp, " not after:  %s", ctime( &skey->resource.time.not_after ));
+  fprintf( fp, " mask policy: %s (%lu)\n",
+                               ak_libakrypt_get_mask_policy_name( skey->resource.mask.type ),
+                                                       (unsigned long)skey->resource.mask.value );
   fprintf( fp, "flags: [set_key = ");
    if( skey->flags&ak_key_flag_set_key ) fprintf( fp, "SET"); else fprintf( fp, "NOT SET");
   fprintf( fp, ", set_mask = ");
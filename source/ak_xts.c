@@ -45,10 +45,10 @@
   ak_uint64 tweak[2], t[2], *tptr = t;
 
  /* проверяем целостность ключа */
-  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &encryptionKey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                "incorrect integrity code of encryption key value" );
-  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &authenticationKey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                            "incorrect integrity code of authentication key value" );
 
@@ -128,9 +128,9 @@
    ak_error_message( error, __func__ , "wrong wiping of tweak value" );
 
  /* перемаскируем ключ */
-  if(( error = encryptionKey->key.set_mask( &encryptionKey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &encryptionKey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of encryption key" );
-  if(( error = authenticationKey->key.set_mask( &authenticationKey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &authenticationKey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of authentication key" );
 
   return error;
@@ -180,10 +180,10 @@
   ak_uint64 tweak[2], t[2], *tptr = t;
 
  /* проверяем целостность ключа */
-  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &encryptionKey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                "incorrect integrity code of encryption key value" );
-  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
+  if( ak_skey_check_icode_with_policy( &authenticationKey->key, size ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                            "incorrect integrity code of authentication key value" );
 
@@ -263,9 +263,9 @@
    ak_error_message( error, __func__ , "wrong wiping of tweak value" );
 
  /* перемаскируем ключ */
-  if(( error = encryptionKey->key.set_mask( &encryptionKey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &encryptionKey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of encryption key" );
-  if(( error = authenticationKey->key.set_mask( &authenticationKey->key )) != ak_error_ok )
+  if(( error = ak_skey_set_mask_with_policy( &authenticationKey->key )) != ak_error_ok )
     ak_error_message( error, __func__ , "wrong remasking of authentication key" );
 
   return error;
@@ -16,6 +16,13 @@
  extern const ak_uint64 streebog_Areverse_expand_with_pi[8][256];
 /** @} */
 
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup options-doc
+ @{ */
+/*! \brief Проверка соответствия порядка опций библиотеки значениям типа option_index_t. */
+ bool_t ak_libakrypt_test_options( void );
+/** @} */
+
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup skey-doc Cекретные ключи криптографических механизмов
  @{ */
@@ -24,6 +31,16 @@
 /*! \brief Формирование имени файла, в который будет помещаться секретный или открытый ключ. */
  int ak_skey_generate_file_name_from_buffer( ak_uint8 * , const size_t ,
                                                          char * , const size_t , export_format_t );
+/*! \brief Функция устанавливает ресурс, заданный индексом опции, и временной итервал
+    действия ключа. */
+ int ak_skey_set_resource_values_by_index( ak_skey , counter_resource_t ,
+                                                        const option_index_t , time_t , time_t );
+/*! \brief Проверка контрольной суммы ключа в соответствии с установленной политикой. */
+ bool_t ak_skey_check_icode_with_policy( ak_skey , const size_t );
+/*! \brief Смена маски ключа в соответствии с установленной политикой. */
+ int ak_skey_set_mask_with_policy( ak_skey );
+/*! \brief Получение случайных данных из запаса масок ключа. */
+ int ak_skey_get_random_from_pool( ak_skey , ak_pointer , const size_t );
 /*! \brief Инициализация секретного ключа алгоритма блочного шифрования. */
  int ak_bckey_create( ak_bckey , size_t , size_t );
 /*! \brief Инициализация ключа алгоритма блочного шифрования значением другого ключа */
@@ -31,6 +48,12 @@
 /*! \brief Процедура вычисления производного ключа в соответствии с алгоритмом ACPKM
     из рекомендаций Р 1323565.1.012-2018. */
  int ak_bckey_next_acpkm_key( ak_bckey );
+/*! \brief Максимальное количество блоков гаммы, вырабатываемых в режимах гаммирования
+    за один вызов функции bckey.encrypt_blocks. */
+ #define ak_bckey_gamma_blocks  (8)
+/*! \brief Минимальное количество блоков, обрабатываемых одним потоком
+    при многопоточной реализации режимов гаммирования. */
+ #define ak_bckey_thread_min_blocks  (4096)
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция вырабатывает пару ключей алгоритма блочного шифрования из заданного
@@ -51,6 +74,24 @@
                                                                 const sbox , ak_kuznechik_params );
 /*! \brief Инициализация внутренних переменных значениями, регламентируемыми ГОСТ Р 34.12-2015. */
  int ak_bckey_kuznechik_init_gost_tables( void );
+/*! \brief Выбор реализации алгоритма Кузнечик в зависимости от возможностей процессора. */
+ int ak_bckey_kuznechik_init_backend( void );
+/*! \brief Выбор реализации функции хеширования Стрибог в зависимости от возможностей процессора. */
+ int ak_hash_streebog_init_backend( void );
+/*! \brief Создание точной копии ключа алгоритма блочного шифрования. */
+ int ak_bckey_create_copy( ak_bckey , ak_bckey );
+/*! \brief Выделение памяти под контексты, содержащие секретные ключи, с выравниванием
+    по границе 32 октетов. */
+ ak_pointer ak_object_aligned_malloc( const size_t );
+/** @} */
+
+/* ----------------------------------------------------------------------------------------------- */
+/** \addtogroup curves-doc Эллиптические кривые
+ @{ */
+/*! \brief Выбор реализации умножения Монтгомери в зависимости от возможностей процессора. */
+ int ak_mpzn_init_backend( void );
+/*! \brief Освобождение памяти, занятой таблицами кратных образующих точек эллиптических кривых. */
+ void ak_wcurve_destroy_fixed_base_tables( void );
 /** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -72,6 +113,12 @@
  int ak_mac_ptr( ak_mac , ak_pointer , const size_t , ak_pointer , const size_t );
 /*! \brief Применение сжимающего отображения к заданному файлу. */
  int ak_mac_file( ak_mac , const char* , ak_pointer , const size_t );
+/*! \brief Количество сообщений, обрабатываемых функцией ak_hash_ptr_multi() одновременно. */
+ #define ak_hash_multi_lanes (4)
+/*! \brief Обработка одного полного блока и завершение вычисления хеш-кода Стрибог
+    для нескольких независимых состояний. */
+ void ak_hash_context_streebog_finalize_block_lanes( ak_streebog * , const ak_uint64 ** ,
+                                                                ak_uint64 ** , const size_t );
 /** @} */
 
 /** \addtogroup aead-doc
@@ -107,6 +107,42 @@ extern "C" {
 /* ----------------------------------------------------------------------------------------------- */
 /** \addtogroup options-doc Инициализация и настройка параметров библиотеки
  @{ */
+/*! \brief Индексы опций библиотеки.
+
+    Значения совпадают с индексами, используемыми функциями ak_libakrypt_get_option_name() и
+    ak_libakrypt_get_option_by_index(), и позволяют получать значение опции без поиска по имени
+    (см. ak_libakrypt_get_option()).                                                               */
+ typedef enum {
+  /*! \brief Уровень аудита библиотеки. */
+   log_level_option,
+  /*! \brief Начальный размер структуры хранения контекстов. */
+   context_manager_size_option,
+  /*! \brief Максимальный размер структуры хранения контекстов. */
+   context_manager_max_size_option,
+  /*! \brief Количество итераций алгоритма PBKDF2. */
+   pbkdf2_iteration_count_option,
+  /*! \brief Ресурс ключа алгоритма HMAC. */
+   hmac_key_count_resource_option,
+  /*! \brief Ресурс секретного ключа электронной подписи. */
+   digital_signature_count_resource_option,
+  /*! \brief Ресурс ключа блочного шифра Магма. */
+   magma_cipher_resource_option,
+  /*! \brief Ресурс ключа блочного шифра Кузнечик. */
+   kuznechik_cipher_resource_option,
+  /*! \brief Количество сообщений, обрабатываемых в режиме ACPKM. */
+   acpkm_message_count_option,
+  /*! \brief Длина секции (в блоках) режима ACPKM для блочного шифра Магма. */
+   acpkm_section_magma_block_count_option,
+  /*! \brief Длина секции (в блоках) режима ACPKM для блочного шифра Кузнечик. */
+   acpkm_section_kuznechik_block_count_option,
+  /*! \brief Флаг совместимости с библиотекой OpenSSL. */
+   openssl_compability_option,
+  /*! \brief Флаг использования цвета при выводе сообщений. */
+   use_color_output_option,
+  /*! \brief Размер буффера для потокового чтения файлов. */
+   file_reader_buffer_size_option
+} option_index_t;
+
 /*! \brief Функция инициализации библиотеки. */
  dll_export bool_t ak_libakrypt_create( ak_function_log * );
 /*! \brief Функция завершает работу с библиотекой. */
@@ -123,6 +159,8 @@ extern "C" {
  dll_export ak_int64 ak_libakrypt_get_option_by_name( const char * );
 /*! \brief Функция возвращает значение опции по ее индексу. */
  dll_export ak_int64 ak_libakrypt_get_option_by_index( const size_t );
+/*! \brief Функция возвращает значение опции по ее индексу, заданному перечислением. */
+ dll_export ak_int64 ak_libakrypt_get_option( const option_index_t );
 /*! \brief Функция устанавливает значение заданной опции. */
  dll_export int ak_libakrypt_set_option( const char * , const ak_int64 );
 /*! \brief Функция считывает значения опций библиотеки из файла. */
@@ -154,6 +192,8 @@ extern "C" {
  dll_export bool_t ak_libakrypt_test_streebog256( void );
 /*! \brief Проверка корректной работы функции хеширования Стрибог-512 */
  dll_export bool_t ak_libakrypt_test_streebog512( void );
+/*! \brief Проверка корректной работы древовидного хеширования. */
+ dll_export bool_t ak_libakrypt_test_hash_tree( void );
 /*! \brief Функция проверяет корректность реализации алгоритмов хэширования. */
  dll_export bool_t ak_libakrypt_test_hash_functions( void );
 /*! \brief Функция проверяет корректность реализации алгоритмов выработки имитовставки. */
@@ -309,6 +349,8 @@ extern "C" {
      xcrypt,
    /*! \brief описатель для типов данных, помещаемых в asn1 дерево */
      descriptor,
+   /*! \brief режим древовидного хеширования */
+     tree_mode,
    /*! \brief неопределенный режим, может возвращаться как ошибка */
      undefined_mode
 } oid_modes_t;
@@ -499,6 +541,10 @@ extern "C" {
 /*! \brief Флаг, который определяет, можно ли использовать значение внутреннего буффера в режиме omac. */
  #define ak_key_flag_omac_buffer_used   (0x0000000000000200ULL)
 
+/*! \brief Флаг, который определяет, что при очередном использовании ключа
+    контрольная сумма была проверена и ключ должен быть перемаскирован. */
+ #define ak_key_flag_mask_due           (0x0000000000000400ULL)
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Способ выделения памяти для хранения секретной информации. */
  typedef enum {
@@ -538,6 +584,47 @@ extern "C" {
     key_using_resource,
 } counter_resource_t;
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перечисление определяет, как часто при использовании ключа проверяется его контрольная
+    сумма и сменяется маска. */
+ typedef enum {
+  /*! \brief Проверка и перемаскирование при каждом вызове (значение по умолчанию). */
+    every_call_mask_policy,
+  /*! \brief Проверка и перемаскирование после заданного количества вызовов. */
+    call_count_mask_policy,
+  /*! \brief Проверка и перемаскирование после обработки заданного количества октетов. */
+    byte_count_mask_policy,
+  /*! \brief Проверка и перемаскирование по истечении заданного количества секунд. */
+    time_interval_mask_policy
+} mask_policy_t;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Политика проверки контрольной суммы и смены маски ключа. */
+ typedef struct key_mask_policy {
+  /*! \brief Тип политики. */
+    mask_policy_t type;
+  /*! \brief Дополнение */
+    ak_uint8 padding[4];
+  /*! \brief Период: количество вызовов, октетов или секунд. */
+    ak_uint64 value;
+  /*! \brief Количество вызовов или октетов, обработанных после последней проверки. */
+    ak_uint64 counter;
+  /*! \brief Время последней проверки. */
+    time_t last;
+} *ak_key_mask_policy;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер запаса случайных данных, используемых для смены маски ключа (в октетах). */
+ #define ak_key_mask_pool_size           (512)
+
+/*! \brief Запас случайных данных, заранее выработанных генератором масок ключа. */
+ typedef struct key_mask_pool {
+  /*! \brief Выработанные случайные данные. */
+    ak_uint8 buffer[ak_key_mask_pool_size];
+  /*! \brief Количество уже использованных октетов буфера. */
+    size_t offset;
+} *ak_key_mask_pool;
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Тип и значение счетчика ресурса ключа. */
  typedef struct key_resource_counter {
@@ -565,6 +652,8 @@ extern "C" {
    struct key_resource_counter value;
   /*! \brief Временной интервал использования ключа. */
    struct time_interval time;
+  /*! \brief Политика проверки контрольной суммы и смены маски ключа. */
+   struct key_mask_policy mask;
  } *ak_resource;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -585,6 +674,8 @@ extern "C" {
    ak_uint32 icode;
   /*! \brief генератор случайных масок ключа */
    struct random generator;
+  /*! \brief запас случайных масок ключа */
+   struct key_mask_pool pool;
   /*! \brief ресурс использования ключа */
    struct resource resource;
   /*! \brief указатель на внутренние данные ключа */
@@ -610,6 +701,8 @@ extern "C" {
  dll_export int ak_libakrypt_generate_unique_number( ak_pointer , const size_t );
 /*! \brief Получение человекочитаемого имени для типа ключевого ресурса. */
  dll_export const char *ak_libakrypt_get_counter_resource_name( const counter_resource_t );
+/*! \brief Получение человекочитаемого имени для политики смены маски ключа. */
+ dll_export const char *ak_libakrypt_get_mask_policy_name( const mask_policy_t );
 /*! \brief Функция выделения памяти для ключевой информации. */
  dll_export int ak_skey_alloc_memory( ak_skey , size_t , memory_allocation_policy_t );
 /*! \brief Функция освобождения выделенной ранее памяти. */
@@ -645,6 +738,8 @@ extern "C" {
 /*! \brief Функция устанавливает ресурс и временной итервал действия ключа. */
  dll_export int ak_skey_set_resource_values( ak_skey , counter_resource_t ,
                                                                   const char * , time_t , time_t );
+/*! \brief Функция устанавливает политику проверки контрольной суммы и смены маски ключа. */
+ dll_export int ak_skey_set_mask_policy( ak_skey , const mask_policy_t , const ak_uint64 );
 /*! \brief Фукция присваивает пользовательскую метку ключу. */
  dll_export int ak_skey_set_label( ak_skey, const char * , const size_t );
 
@@ -660,6 +755,8 @@ extern "C" {
  typedef int ( ak_function_bckey_create ) ( ak_bckey );
 /*! \brief Функция зашифрования/расширования одного блока информации. */
  typedef void ( ak_function_bckey )( ak_skey, ak_pointer, ak_pointer );
+/*! \brief Функция зашифрования/расширования последовательности независимых блоков информации. */
+ typedef void ( ak_function_bckey_multi )( ak_skey, ak_pointer, ak_pointer, size_t );
 /*! \brief Функция, предназначенная для зашифрования/расшифрования области памяти заданного размера */
  typedef int ( ak_function_bckey_encrypt )( ak_bckey, ak_pointer, ak_pointer, size_t,
                                                                                 ak_pointer, size_t );
@@ -680,6 +777,12 @@ extern "C" {
    ak_function_bckey *encrypt;
   /*! \brief Функция расширования одного блока информации. */
    ak_function_bckey *decrypt;
+  /*! \brief Функция зашифрования нескольких независимых блоков информации.
+      \details Блоки обрабатываются одновременно (с чередованием раундовых преобразований),
+      что позволяет использовать функцию в режимах простой замены и гаммирования. */
+   ak_function_bckey_multi *encrypt_blocks;
+  /*! \brief Функция расшифрования нескольких независимых блоков информации. */
+   ak_function_bckey_multi *decrypt_blocks;
   /*! \brief Функция развертки ключа. */
    ak_function_skey *schedule_keys;
   /*! \brief Функция уничтожения развернутых ключей. */
@@ -751,6 +854,9 @@ extern "C" {
 /*! \brief Шифрование данных в режиме гаммирования из ГОСТ Р 34.13-2015
    (counter mode, ctr). */
  dll_export int ak_bckey_ctr( ak_bckey , ak_pointer , ak_pointer , size_t , ak_pointer , size_t );
+/*! \brief Шифрование данных в режиме гаммирования с использованием нескольких потоков. */
+ dll_export int ak_bckey_ctr_parallel( ak_bckey , ak_pointer , ak_pointer , size_t ,
+                                                                   ak_pointer , size_t , size_t );
 /*! \brief Шифрование данных в режиме гаммирования с обратной связью по выходу
    (output feedback, ofb). */
  dll_export int ak_bckey_ofb( ak_bckey , ak_pointer , ak_pointer , size_t , ak_pointer , size_t );
@@ -765,6 +871,9 @@ extern "C" {
 /*! \brief Шифрование данных в режиме `CTR-ACPKM` из Р 1323565.1.017—2018. */
  dll_export int ak_bckey_ctr_acpkm( ak_bckey , ak_pointer , ak_pointer , size_t , size_t ,
                                                                              ak_pointer , size_t );
+/*! \brief Шифрование данных в режиме `CTR-ACPKM` с использованием нескольких потоков. */
+ dll_export int ak_bckey_ctr_acpkm_parallel( ak_bckey , ak_pointer , ak_pointer , size_t ,
+                                                           size_t , ak_pointer , size_t , size_t );
 /*! \brief Зашифрование данных в режиме `XTS`. */
  dll_export int ak_bckey_encrypt_xts( ak_bckey ,  ak_bckey , ak_pointer , ak_pointer , size_t ,
                                                                              ak_pointer , size_t );
@@ -886,8 +995,68 @@ extern "C" {
  dll_export int ak_hash_finalize( ak_hash , const ak_pointer , const size_t , ak_pointer , const size_t );
 /*! \brief Хеширование заданной области памяти. */
  dll_export int ak_hash_ptr( ak_hash , const ak_pointer , const size_t , ak_pointer , const size_t );
+/*! \brief Одновременное хеширование нескольких независимых областей памяти. */
+ dll_export int ak_hash_ptr_multi( ak_hash , const size_t , const ak_pointer * ,
+                                                     const size_t * , ak_pointer * , const size_t );
 /*! \brief Хеширование заданного файла. */
  dll_export int ak_hash_file( ak_hash , const char*, ak_pointer , const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Размер фрагмента данных (листа дерева) при древовидном хешировании по-умолчанию (1 Мб). */
+ #define ak_hash_tree_default_chunk_size  ( 1048576 )
+/*! \brief Минимально допустимый размер фрагмента данных при древовидном хешировании. */
+ #define ak_hash_tree_min_chunk_size      ( 4096 )
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Контекст древовидного хеширования. */
+/*! \details Данные разбиваются на фрагменты фиксированной длины, для каждого из которых
+    независимо вычисляется хеш-код (лист дерева); хеш-коды листьев объединяются в дерево Меркла.
+    Хеш-коды листьев могут вычисляться одновременно несколькими потоками, а также
+    сохраняться для последующей проверки отдельных фрагментов данных.                              */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct hash_tree {
+  /*! \brief OID алгоритма древовидного хеширования */
+   ak_oid oid;
+  /*! \brief Контекст базовой функции хеширования. */
+   struct hash hctx;
+  /*! \brief Размер фрагмента данных (в октетах). */
+   size_t chunk;
+  /*! \brief Максимальное количество потоков, вычисляющих хеш-коды фрагментов. */
+   size_t threads;
+ } *ak_hash_tree;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Инициализация контекста древовидного хеширования на основе функции Стрибог256. */
+ dll_export int ak_hash_tree_create_streebog256( ak_hash_tree );
+/*! \brief Инициализация контекста древовидного хеширования на основе функции Стрибог512. */
+ dll_export int ak_hash_tree_create_streebog512( ak_hash_tree );
+/*! \brief Уничтожение контекста древовидного хеширования. */
+ dll_export int ak_hash_tree_destroy( ak_hash_tree );
+/*! \brief Установка размера фрагмента данных. */
+ dll_export int ak_hash_tree_set_chunk_size( ak_hash_tree , const size_t );
+/*! \brief Установка максимального количества потоков. */
+ dll_export int ak_hash_tree_set_threads( ak_hash_tree , const size_t );
+/*! \brief Функция возвращает размер вырабатываемого хеш-кода (в октетах). */
+ dll_export size_t ak_hash_tree_get_tag_size( ak_hash_tree );
+/*! \brief Функция возвращает количество листьев дерева для данных заданной длины. */
+ dll_export ak_uint64 ak_hash_tree_get_leaves_count( ak_hash_tree , const ak_uint64 );
+/*! \brief Вычисление хеш-кодов заданного диапазона листьев для области памяти. */
+ dll_export int ak_hash_tree_leaves( ak_hash_tree , const ak_pointer , const size_t ,
+                                   const ak_uint64 , const ak_uint64 , ak_pointer , const size_t );
+/*! \brief Вычисление хеш-кодов заданного диапазона листьев для файла. */
+ dll_export int ak_hash_tree_leaves_file( ak_hash_tree , const char * ,
+                                   const ak_uint64 , const ak_uint64 , ak_pointer , const size_t );
+/*! \brief Вычисление корня дерева по хеш-кодам листьев. */
+ dll_export int ak_hash_tree_root( ak_hash_tree , const ak_pointer , const ak_uint64 ,
+                                                   const ak_uint64 , ak_pointer , const size_t );
+/*! \brief Древовидное хеширование заданной области памяти. */
+ dll_export int ak_hash_tree_ptr( ak_hash_tree , const ak_pointer , const size_t ,
+                                                                       ak_pointer , const size_t );
+/*! \brief Древовидное хеширование заданного файла. */
+ dll_export int ak_hash_tree_file( ak_hash_tree , const char * , ak_pointer , const size_t );
+/*! \brief Проверка фрагмента файла с использованием сохраненных хеш-кодов листьев дерева. */
+ dll_export int ak_hash_tree_verify_file( ak_hash_tree , const char * , const ak_pointer ,
+                       const ak_uint64 , const ak_pointer , const ak_uint64 , const ak_uint64 );
 /** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -915,6 +1084,14 @@ extern "C" {
    struct mac mctx;
   /*! \brief Контекст функции хеширования */
    struct hash ctx;
+  /*! \brief Состояния функции хеширования после обработки блоков \f$ K \oplus ipad \f$ и
+      \f$ K \oplus opad \f$; на векторы h и \f$ \Sigma \f$ наложена маска. */
+   struct streebog ipad, opad;
+  /*! \brief Маска, наложенная на векторы h (первые 8 слов) и \f$ \Sigma \f$ (последние 8 слов)
+      сохраненных состояний. */
+   ak_uint64 pads_mask[16];
+  /*! \brief Признак того, что сохраненные состояния соответствуют текущему значению ключа. */
+   bool_t pads_ready;
 } *ak_hmac;
 
 /*! \brief Создание секретного ключа алгоритма выработки имитовставки HMAC на основе функции Стрибог256. */
@@ -958,6 +1135,10 @@ extern "C" {
 /*! \brief Развертка ключевого вектора из пароля (согласно Р 50.1.111-2016, раздел 4) */
  dll_export int ak_hmac_pbkdf2_streebog512( const ak_pointer , const size_t ,
                    const ak_pointer , const size_t, const size_t , const size_t , ak_pointer );
+/*! \brief Развертка ключевых векторов для нескольких паролей. */
+ dll_export int ak_hmac_pbkdf2_streebog512_batch( const size_t , const ak_pointer * ,
+             const size_t * , const ak_pointer * , const size_t * , const size_t , const size_t ,
+                                                                 ak_pointer * , const size_t );
 /** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1079,14 +1260,44 @@ extern "C" {
 /*! \brief Сложение двух вычетов в представлении Монтгомери. */
  dll_export void ak_mpzn_add_montgomery( ak_uint64 *, ak_uint64 *,
                                                          ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычитание двух вычетов в представлении Монтгомери. */
+ dll_export void ak_mpzn_sub_montgomery( ak_uint64 *, ak_uint64 *,
+                                                         ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Удвоение на двойку в представлении Монтгомери. */
  dll_export void ak_mpzn_lshift_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Умножение двух вычетов в представлении Монтгомери. */
  dll_export void ak_mpzn_mul_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение в квадрат вычета в представлении Монтгомери. */
+ dll_export void ak_mpzn_sqr_montgomery( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
 /*! \brief Модульное возведение в степень в представлении Монтгомери. */
  dll_export void ak_mpzn_modpow_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Обращение вычета методом Бернштейна-Янга с постоянным временем работы. */
+ dll_export void ak_mpzn_inverse_montgomery( ak_uint64 *, ak_uint64 *,
+                                                         ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Совместное обращение нескольких вычетов в представлении Монтгомери. */
+ dll_export void ak_mpzn_inverse_batch_montgomery( ak_uint64 **, const size_t , ak_uint64 *,
+                                               ak_uint64 *, ak_uint64, ak_uint64 *, const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка того, что модуль имеет вид \f$ 2^n - c \f$ для небольшой константы \f$ c \f$. */
+ dll_export bool_t ak_mpzn_is_pseudo_mersenne( ak_uint64 *, const size_t );
+/*! \brief Умножение двух вычетов по модулю вида \f$ 2^n - c \f$. */
+ dll_export void ak_mpzn_mul_pseudo_mersenne( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                     ak_uint64 *, const size_t );
+/*! \brief Возведение вычета в квадрат по модулю вида \f$ 2^n - c \f$. */
+ dll_export void ak_mpzn_sqr_pseudo_mersenne( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Сложение двух вычетов по модулю вида \f$ 2^n - c \f$. */
+ dll_export void ak_mpzn_add_pseudo_mersenne( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                     ak_uint64 *, const size_t );
+/*! \brief Вычитание двух вычетов по модулю вида \f$ 2^n - c \f$. */
+ dll_export void ak_mpzn_sub_pseudo_mersenne( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                     ak_uint64 *, const size_t );
+/*! \brief Обращение вычета по модулю вида \f$ 2^n - c \f$. */
+ dll_export void ak_mpzn_inverse_pseudo_mersenne( ak_uint64 *, ak_uint64 *,
+                                                                     ak_uint64 *, const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /*! \brief Преобразование ak_mpznxxx в mpz_t. */
@@ -1109,7 +1320,8 @@ extern "C" {
     в проективных координатах, т.е. точка представляется в виде вектора \f$ P=(x:y:z) \f$,
     удовлетворяющего сравнению \f$ y^2z \equiv x^3 + axz^2 + bz^3 \pmod{p} \f$.
     В дальнейшем, при проведении вычислений, для координат точки используется
-    представление Монтгомери.                                                                      */
+    представление Монтгомери, либо обычное представление, если для кривой определена
+    специализированная арифметика (см. \ref wfield).                                                                      */
 /* ----------------------------------------------------------------------------------------------- */
  struct wpoint
 {
@@ -1142,8 +1354,46 @@ extern "C" {
  dll_export void ak_wpoint_add( ak_wpoint , ak_wpoint , ak_wcurve );
 /*! \brief Приведение проективной точки к аффинному виду. */
  dll_export void ak_wpoint_reduce( ak_wpoint , ak_wcurve );
+/*! \brief Совместное приведение массива проективных точек к аффинному виду. */
+ dll_export void ak_wpoint_reduce_batch( ak_wpoint , const size_t , ak_wcurve );
 /*! \brief Вычисление кратной точки эллиптической кривой. */
  dll_export void ak_wpoint_pow( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной образующей точки эллиптической кривой с использованием
+    предварительно вычисленной таблицы. */
+ dll_export void ak_wpoint_pow_fixed_base( ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление суммы кратных образующей точки и заданной точки эллиптической кривой. */
+ dll_export void ak_wpoint_pow_sum( ak_wpoint , ak_uint64 *, ak_wpoint , ak_uint64 *,
+                                                                              size_t , ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Набор функций, реализующих арифметику конечного поля для модуля эллиптической кривой.
+
+    Функции используются для вычислений с координатами точек вместо арифметики Монтгомери,
+    если модуль кривой допускает более быстрое приведение (см. \ref ak_wfield_pseudo_mersenne).
+    Вычеты при этом хранятся в обычном представлении; умножение на коэффициенты \f$ a \f$ и
+    \f$ b \f$, хранящиеся в представлении Монтгомери, выполняется функцией
+    ak_mpzn_mul_montgomery() и дает обычное произведение.                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ struct wfield
+{
+ /*! \brief Умножение двух вычетов. */
+  void ( *mul )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 * , const size_t );
+ /*! \brief Возведение вычета в квадрат. */
+  void ( *sqr )( ak_uint64 * , ak_uint64 * , ak_uint64 * , const size_t );
+ /*! \brief Сложение двух вычетов. */
+  void ( *add )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 * , const size_t );
+ /*! \brief Вычитание двух вычетов. */
+  void ( *sub )( ak_uint64 * , ak_uint64 * , ak_uint64 * , ak_uint64 * , const size_t );
+ /*! \brief Вычисление обратного элемента. */
+  void ( *inverse )( ak_uint64 * , ak_uint64 * , ak_uint64 * , const size_t );
+ /*! \brief Проверка того, что модуль допускает использование данной арифметики. */
+  bool_t ( *check )( ak_uint64 * , const size_t );
+ /*! \brief Наименование арифметики. */
+  const char *name;
+};
+
+/*! \brief Арифметика по модулям вида \f$ p = 2^n - c \f$, где \f$ c < 2^{32} \f$. */
+ extern const struct wfield ak_wfield_pseudo_mersenne;
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Класс, реализующий эллиптическую кривую, заданную в короткой форме Вейерштрасса
@@ -1188,6 +1438,9 @@ extern "C" {
  /*! \brief Строка, содержащая символьную запись модуля \f$ p \f$.
      \details Используется для проверки корректного хранения параметров кривой в памяти. */
   const char *pchar;
+ /*! \brief Специализированная арифметика по модулю \f$ p \f$.
+     \details Если значение равно NULL, то координаты точек вычисляются в арифметике Монтгомери. */
+  const struct wfield *field;
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1251,6 +1504,10 @@ extern "C" {
  dll_export void ak_gf256_mul_uint64( ak_pointer z, ak_pointer x, ak_pointer y );
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$. */
  dll_export void ak_gf512_mul_uint64( ak_pointer z, ak_pointer x, ak_pointer y );
+/*! \brief Сложение попарных произведений элементов поля \f$ \mathbb F_{2^{64}}\f$. */
+ dll_export void ak_gf64_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сложение попарных произведений элементов поля \f$ \mathbb F_{2^{128}}\f$. */
+ dll_export void ak_gf128_mul_sum_uint64( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
 
 #ifdef AK_HAVE_BUILTIN_CLMULEPI64
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{64}}\f$. */
@@ -1261,17 +1518,25 @@ extern "C" {
  dll_export void ak_gf256_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b );
 /*! \brief Умножение двух элементов поля \f$ \mathbb F_{2^{512}}\f$. */
  dll_export void ak_gf512_mul_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b );
+/*! \brief Сложение попарных произведений элементов поля \f$ \mathbb F_{2^{64}}\f$. */
+ dll_export void ak_gf64_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
+/*! \brief Сложение попарных произведений элементов поля \f$ \mathbb F_{2^{128}}\f$. */
+ dll_export void ak_gf128_mul_sum_pcmulqdq( ak_pointer z, ak_pointer a, ak_pointer b, size_t count );
 
  #define ak_gf64_mul ak_gf64_mul_pcmulqdq
  #define ak_gf128_mul ak_gf128_mul_pcmulqdq
  #define ak_gf256_mul ak_gf256_mul_pcmulqdq
  #define ak_gf512_mul ak_gf512_mul_pcmulqdq
+ #define ak_gf64_mul_sum ak_gf64_mul_sum_pcmulqdq
+ #define ak_gf128_mul_sum ak_gf128_mul_sum_pcmulqdq
 #else
 
  #define ak_gf64_mul ak_gf64_mul_uint64
  #define ak_gf128_mul ak_gf128_mul_uint64
  #define ak_gf256_mul ak_gf256_mul_uint64
  #define ak_gf512_mul ak_gf512_mul_uint64
+ #define ak_gf64_mul_sum ak_gf64_mul_sum_uint64
+ #define ak_gf128_mul_sum ak_gf128_mul_sum_uint64
 #endif
 
 /* Размеры конечных полей (в октетах) */
@@ -1847,6 +2112,10 @@ extern "C" {
                                                                        const size_t , ak_pointer );
 /*! \brief Проверка электронной подписи для заданного файла. */
  dll_export bool_t ak_verifykey_verify_file( ak_verifykey , const char * , ak_pointer );
+/*! \brief Проверка массива электронных подписей, выработанных для различных сообщений
+    и различных ключей. */
+ dll_export int ak_verifykey_verify_batch( ak_verifykey * , ak_pointer * , size_t * ,
+                            ak_pointer * , const size_t , const bool_t , bool_t * , const size_t );
 /** @} *//** @} */
 
 /* ----------------------------------------------------------------------------------------------- */